@@ -5,6 +5,7 @@ from __future__ import print_function
 import os
 import sys
 import glob
+import shutil
 import argparse
 import datetime
 from collections import OrderedDict
@@ -26,10 +27,17 @@ from test_utils import (
     check_multistream_classic,
     setup_subdirs_and_fill_in_global_param_driver_match_test,
     check_drivers_match_fluxes,
+    setup_subdirs_and_fill_in_global_param_runs,
+    check_classic_runs_match, find_global_param_file,
+    pop_run_environment, run_environment,
+    reverse_lines_keep_size_and_mtime,
+    reverse_binary_state_cells_keep_size_and_mtime, check_param_index,
+    setup_binary_forcing_runs,
     plot_science_tests)
 from test_image_driver import (test_image_driver_no_output_file_nans,
                                setup_subdirs_and_fill_in_global_param_mpi_test,
-                               check_mpi_fluxes, check_mpi_states)
+                               check_mpi_fluxes, check_mpi_states,
+                               check_image_runs_match)
 from test_restart import (prepare_restart_run_periods,
                           setup_subdirs_and_fill_in_global_param_restart_test,
                           check_exact_restart_fluxes,
@@ -393,6 +401,10 @@ def run_system(config_file, dict_drivers, test_data_dir, out_dir):
             run_periods = prepare_restart_run_periods(
                 test_dict['restart'],
                 dirs['state'])
+            # (3) Whether to run the split runs again after reversing the
+            # cells of their initial state files
+            reverse_state_cells = test_dict['restart'].get(
+                'reverse_state_cells', 'FALSE').upper() == 'TRUE'
 
         # If mpi test, prepare a list of number of processors to be run
         elif 'mpi' in test_dict['check']:
@@ -404,6 +416,36 @@ def run_system(config_file, dict_drivers, test_data_dir, out_dir):
                                  'mpi test!')
             list_n_proc = test_dict['mpi']['n_proc']
 
+        # If parameter index test, run with the original snow band file and
+        # again after editing it without changing its size or modification
+        # time
+        elif 'param_index' in test_dict['check']:
+            if driver != 'classic':
+                raise ValueError('Only support classic driver for parameter '
+                                 'index tests!')
+            list_run_names = ['original', 'edited']
+
+        # If binary forcing test, run with the forcing as ASCII and as BINARY
+        # in both byte orders
+        elif 'binary_forcing' in test_dict['check']:
+            if driver != 'classic':
+                raise ValueError('Only support classic driver for binary '
+                                 'forcing tests!')
+            list_run_names = ['ascii', 'binary_little', 'binary_big']
+
+        # If options-match test, prepare a list of the runs to be compared
+        elif 'options_match' in test_dict['check']:
+            if len(dict_drivers) > 1:
+                raise ValueError('Only support single driver for '
+                                 'options-match tests!')
+            list_run_names = list(test_dict['options_match'].keys())
+            if len(list_run_names) < 2:
+                raise ValueError('Need at least two runs in options_match to '
+                                 'run options-match test!')
+            list_run_env = [
+                pop_run_environment(test_dict['options_match'][run_name])
+                for run_name in list_run_names]
+
         # create template string
         dict_s = {}
         for dr, global_param in dict_global_param.items():
@@ -428,6 +470,15 @@ def run_system(config_file, dict_drivers, test_data_dir, out_dir):
                 setup_subdirs_and_fill_in_global_param_mpi_test(
                     s, list_n_proc, dirs['results'], dirs['state'],
                     test_data_dir)
+        # --- if parameter index, binary forcing or options-match test,
+        # multiple runs --- #
+        elif 'param_index' in test_dict['check'] or\
+                'binary_forcing' in test_dict['check'] or\
+                'options_match' in test_dict['check']:
+            s = dict_s[driver]
+            list_global_param = setup_subdirs_and_fill_in_global_param_runs(
+                s, list_run_names, dirs['results'], dirs['state'],
+                test_data_dir)
         # --- if driver-match test, one run for each driver --- #
         elif 'driver_match' in test_dict['check']:
             # Set up subdirectories and output directories in global file for
@@ -458,14 +509,35 @@ def run_system(config_file, dict_drivers, test_data_dir, out_dir):
         if 'exact_restart' in test_dict['check']:
             if 'STATE_FORMAT' in replacements:
                 state_format = replacements['STATE_FORMAT']
+            if reverse_state_cells and (driver != 'classic' or
+                                        state_format != 'BINARY'):
+                raise ValueError('Only support classic driver binary state '
+                                 'files for reverse_state_cells!')
         if 'exact_restart' in test_dict['check'] or\
-           'mpi' in test_dict['check']:  # if multiple runs
+           'mpi' in test_dict['check'] or\
+           'param_index' in test_dict['check'] or\
+           'binary_forcing' in test_dict['check']:  # if multiple runs
             for j, gp in enumerate(list_global_param):
                 # save a copy of replacements for the next global file
                 replacements_cp = replacements.copy()
                 # replace global options for this global file
                 list_global_param[j] = replace_global_values(gp, replacements)
                 replacements = replacements_cp
+        elif 'options_match' in test_dict['check']:  # if multiple runs
+            for j, gp in enumerate(list_global_param):
+                # add the options of this run to a copy of replacements;
+                # $test_dir in an option is the test directory, so that a
+                # run can read a file written by an earlier run
+                replacements_run = replacements.copy()
+                for key, value in \
+                        test_dict['options_match'][list_run_names[j]].items():
+                    if isinstance(value, str):
+                        value = string.Template(value).safe_substitute(
+                            test_dir=dirs['test'])
+                    replacements_run[key] = value
+                # replace global options for this global file
+                list_global_param[j] = replace_global_values(gp,
+                                                             replacements_run)
         elif 'driver_match' in test_dict['check']:  # if cross-driver runs
             for dr, gp in dict_global_param.items():
                 # save a copy of replacements for the next global file
@@ -477,6 +549,27 @@ def run_system(config_file, dict_drivers, test_data_dir, out_dir):
         else:  # if single run
             global_param = replace_global_values(global_param, replacements)
 
+        # If parameter index test, index a copy of the snow band file, which
+        # is edited between the runs
+        if 'param_index' in test_dict['check']:
+            snowband_file = os.path.join(dirs['test'], 'snowbands.txt')
+            shutil.copyfile(
+                find_global_param_file(''.join(list_global_param[0]),
+                                       'SNOW_BAND'),
+                snowband_file)
+            for j, gp in enumerate(list_global_param):
+                list_global_param[j] = [
+                    '{0: <20} {1} {2}\n'.format('SNOW_BAND', line.split()[1],
+                                                snowband_file)
+                    if line.split()[0] == 'SNOW_BAND' else line
+                    for line in gp]
+
+        # If binary forcing test, write the forcing files of each run
+        if 'binary_forcing' in test_dict['check']:
+            list_global_param = setup_binary_forcing_runs(
+                list_global_param, list_run_names,
+                os.path.join(dirs['test'], 'forcings'))
+
         # write global parameter file
         if 'exact_restart' in test_dict['check']:
             list_test_global_file = []
@@ -502,6 +595,19 @@ def run_system(config_file, dict_drivers, test_data_dir, out_dir):
                 with open(test_global_file, mode='w') as f:
                     for line in gp:
                         f.write(line)
+        elif 'param_index' in test_dict['check'] or\
+                'binary_forcing' in test_dict['check'] or\
+                'options_match' in test_dict['check']:
+            list_test_global_file = []
+            for j, gp in enumerate(list_global_param):
+                test_global_file = os.path.join(
+                    dirs['test'],
+                    '{}_globalparam_{}.txt'.format(
+                        testname, list_run_names[j]))
+                list_test_global_file.append(test_global_file)
+                with open(test_global_file, mode='w') as f:
+                    for line in gp:
+                        f.write(line)
         elif 'driver_match' in test_dict['check']:
             dict_test_global_file = {}
             for dr, gp in dict_global_param.items():
@@ -539,6 +645,22 @@ def run_system(config_file, dict_drivers, test_data_dir, out_dir):
                     # Check return code
                     check_returncode(vic_exe,
                                      test_dict.pop('expected_retval', 0))
+                # Run the split runs that read an initial state file again,
+                # with the cells of the state file in the reverse order of
+                # the soil parameter file; its cached index, written by the
+                # first read, is left stale because the size and modification
+                # time of the state file do not change
+                if reverse_state_cells:
+                    for j, test_global_file in enumerate(
+                            list_test_global_file):
+                        if run_periods[j]['init_state'] is None:
+                            continue
+                        reverse_binary_state_cells_keep_size_and_mtime(
+                            run_periods[j]['init_state'])
+                        returncode = vic_exe.run(test_global_file,
+                                                 logdir=dirs['logs'],
+                                                 **run_kwargs)
+                        check_returncode(vic_exe, 0)
             elif 'mpi' in test_dict['check']:
                 for j, test_global_file in enumerate(list_test_global_file):
                     # Overwrite mpi_proc in option kwargs
@@ -554,6 +676,34 @@ def run_system(config_file, dict_drivers, test_data_dir, out_dir):
                     # Check return code
                     check_returncode(vic_exe,
                                      test_dict.pop('expected_retval', 0))
+            elif 'param_index' in test_dict['check']:
+                for j, test_global_file in enumerate(list_test_global_file):
+                    # Edit the indexed snow band file before the second run
+                    if j > 0:
+                        reverse_lines_keep_size_and_mtime(snowband_file)
+                    returncode = vic_exe.run(test_global_file,
+                                             logdir=dirs['logs'],
+                                             **run_kwargs)
+                    # Check return code
+                    check_returncode(vic_exe,
+                                     test_dict.pop('expected_retval', 0))
+            elif 'binary_forcing' in test_dict['check']:
+                for j, test_global_file in enumerate(list_test_global_file):
+                    returncode = vic_exe.run(test_global_file,
+                                             logdir=dirs['logs'],
+                                             **run_kwargs)
+                    # Check return code
+                    check_returncode(vic_exe,
+                                     test_dict.pop('expected_retval', 0))
+            elif 'options_match' in test_dict['check']:
+                for j, test_global_file in enumerate(list_test_global_file):
+                    with run_environment(list_run_env[j]):
+                        returncode = vic_exe.run(test_global_file,
+                                                 logdir=dirs['logs'],
+                                                 **run_kwargs)
+                    # Check return code
+                    check_returncode(vic_exe,
+                                     test_dict.pop('expected_retval', 0))
             elif 'driver_match' in test_dict['check']:
                 for dr in dict_test_global_file.keys():
                     # Reset mpi_proc in option kwargs to None for classic
@@ -646,6 +796,32 @@ def run_system(config_file, dict_drivers, test_data_dir, out_dir):
                     check_mpi_fluxes(dirs['results'], list_n_proc)
                     check_mpi_states(dirs['state'], list_n_proc)
 
+                # check that an edited parameter file is indexed again
+                if 'param_index' in test_dict['check']:
+                    check_param_index(snowband_file)
+                    check_classic_runs_match(dirs['results'], list_run_names)
+                    check_classic_runs_match(dirs['state'], list_run_names)
+
+                # check that BINARY forcing gives the results of the same
+                # forcing in ASCII
+                if 'binary_forcing' in test_dict['check']:
+                    check_classic_runs_match(dirs['results'], list_run_names)
+                    check_classic_runs_match(dirs['state'], list_run_names)
+
+                # check that runs with different options match
+                if 'options_match' in test_dict['check']:
+                    if driver == 'classic':
+                        check_classic_runs_match(dirs['results'],
+                                                 list_run_names)
+                        check_classic_runs_match(dirs['state'],
+                                                 list_run_names)
+                    elif driver == 'image':
+                        check_image_runs_match(dirs['results'],
+                                               list_run_names)
+                        check_image_runs_match(dirs['state'], list_run_names)
+                    else:
+                        raise ValueError('unknown driver')
+
                 # check that results from different drivers match
                 if 'driver_match' in test_dict['check']:
                     check_drivers_match_fluxes(list(dict_drivers.keys()),
@@ -293,3 +293,44 @@ def check_mpi_states(state_basedir, list_n_proc):
                                    ds_first_run[var].values,
                                    err_msg='States are not an exact match '
                                    'for variable: {}'.format(var))
+
+
+def check_image_runs_match(basedir, list_run_names):
+    ''' Check whether the netCDF output of multiple runs is identical, image
+        driver
+
+    Parameters
+    ----------
+    basedir: <str>
+        Base directory of output fluxes or states; runs are output to
+        subdirectories, named after the runs, under the base directory
+    list_run_names: <list>
+        A list of names of the runs to be compared; the first run is the base
+        for comparison
+
+    Require
+    ----------
+    os
+    glob
+    numpy
+    xarray
+    '''
+
+    # Output files of the first run - as base
+    base_dir = os.path.join(basedir, list_run_names[0])
+    fnames = sorted(os.path.basename(f) for f in
+                    glob.glob(os.path.join(base_dir, '*.nc')))
+
+    # Loop over all rest runs and compare files with the base run
+    for run_name in list_run_names[1:]:
+        run_dir = os.path.join(basedir, run_name)
+        for fname in fnames:
+            ds_first_run = xr.open_dataset(os.path.join(base_dir, fname))
+            ds_current_run = xr.open_dataset(os.path.join(run_dir, fname))
+            for var in ds_first_run.data_vars:
+                npt.assert_array_equal(ds_current_run[var].values,
+                                       ds_first_run[var].values,
+                                       err_msg='{} is not an exact match in '
+                                       'runs {} and {} for variable: '
+                                       '{}'.format(fname, list_run_names[0],
+                                                   run_name, var))
@@ -49,9 +49,8 @@ def prepare_restart_run_periods(restart_dict, state_basedir):
             restart_dict['split_dates'],
             '%Y-%m-%d')]
     else:
-        list_split_dates = datetime.datetime.strptime(
-            restart_dict['split_dates'],
-            '%Y-%m-%d')
+        list_split_dates = [datetime.datetime.strptime(split_date, '%Y-%m-%d')
+                            for split_date in restart_dict['split_dates']]
 
     # --- Prepare running periods --- #
     # run_periods is a list of running periods, including the full-period run,
@@ -2,9 +2,13 @@
 import os
 import re
 import glob
+import gzip
+import filecmp
+import struct
 import traceback
 import warnings
 from collections import OrderedDict, namedtuple
+from contextlib import contextmanager
 import multiprocessing as mp
 
 # Computation libs
@@ -25,6 +29,7 @@ from tonic.testing import check_completed, check_for_nans, VICTestError
 
 OUTPUT_WIDTH = 100
 ERROR_TAIL = 20  # lines
+RUN_ENVIRONMENT_VARIABLES = ('OMP_NUM_THREADS', )
 
 VICOutFile = namedtuple('vic_out_file',
                         ('dirpath', 'prefix', 'lat', 'lon', 'suffix'))
@@ -98,10 +103,13 @@ def replace_global_values(gp, replace):
 
     if replace:
         for key, val in replace.items():
-            try:
-                value = ' '.join(val)
-            except:
+            if isinstance(val, str):
                 value = val
+            else:
+                try:
+                    value = ' '.join(val)
+                except:
+                    value = val
             gpl.append('{0: <20} {1}\n'.format(key, value))
 
     return gpl
@@ -147,6 +155,31 @@ def pop_run_kwargs(config):
     return run_kwargs
 
 
+def pop_run_environment(options):
+    '''pop the options that are environment variables of a VIC run (e.g. the
+       number of OpenMP threads) rather than global parameters'''
+    run_env = OrderedDict()
+    for key in RUN_ENVIRONMENT_VARIABLES:
+        if key in options:
+            run_env[key] = str(options.pop(key))
+    return run_env
+
+
+@contextmanager
+def run_environment(run_env):
+    '''set environment variables for the VIC runs inside the with block'''
+    saved = {key: os.environ.get(key) for key in run_env}
+    os.environ.update(run_env)
+    try:
+        yield
+    finally:
+        for key, value in saved.items():
+            if value is None:
+                os.environ.pop(key, None)
+            else:
+                os.environ[key] = value
+
+
 def check_returncode(exe, expected=0):
     '''check return code given by VIC, raise error if appropriate'''
     if exe.returncode == expected:
@@ -508,6 +541,321 @@ def check_drivers_match_fluxes(list_drivers, result_basedir):
                                         'drivers'.format(var))
 
 
+def setup_subdirs_and_fill_in_global_param_runs(
+        s, list_run_names, result_basedir, state_basedir, test_data_dir):
+    ''' Fill in global parameter output directories for multiple runs of one
+        driver whose results are compared
+
+    Parameters
+    ----------
+    s: <string.Template>
+        Template of the global param file to be filled in
+    list_run_names: <list>
+        A list of names of the runs to be compared
+    result_basedir: <str>
+        Base directory of output fluxes results; runs are output to
+        subdirectories, named after the runs, under the base directory
+    state_basedir: <str>
+        Base directory of output state results; runs are output to
+        subdirectories, named after the runs, under the base directory
+    test_data_dir: <str>
+        Base directory of test data
+
+    Returns
+    ----------
+    list_global_param: <list>
+        A list of global parameter strings to be run with parameters filled in
+
+    Require
+    ----------
+    os
+    '''
+
+    list_global_param = []
+    for run_name in list_run_names:
+        # Set up subdirectories for results and states
+        result_dir = os.path.join(result_basedir, run_name)
+        state_dir = os.path.join(state_basedir, run_name)
+        os.makedirs(result_dir, exist_ok=True)
+        os.makedirs(state_dir, exist_ok=True)
+
+        # Fill in global parameter options
+        list_global_param.append(s.safe_substitute(test_data_dir=test_data_dir,
+                                                   result_dir=result_dir,
+                                                   state_dir=state_dir))
+
+    return(list_global_param)
+
+
+def check_classic_runs_match(basedir, list_run_names):
+    ''' Check whether the output files of multiple runs are identical, classic
+        driver
+
+    Parameters
+    ----------
+    basedir: <str>
+        Base directory of output fluxes or states; runs are output to
+        subdirectories, named after the runs, under the base directory
+    list_run_names: <list>
+        A list of names of the runs to be compared; the first run is the base
+        for comparison
+
+    Require
+    ----------
+    os
+    filecmp
+    '''
+
+    # Output files of the first run - as base
+    base_dir = os.path.join(basedir, list_run_names[0])
+    fnames = sorted(os.listdir(base_dir))
+
+    # Loop over all rest runs and compare files with the base run
+    for run_name in list_run_names[1:]:
+        run_dir = os.path.join(basedir, run_name)
+        if sorted(os.listdir(run_dir)) != fnames:
+            raise VICTestError('Runs {} and {} have different output '
+                               'files'.format(list_run_names[0], run_name))
+        for fname in fnames:
+            if not filecmp.cmp(os.path.join(base_dir, fname),
+                               os.path.join(run_dir, fname), shallow=False):
+                raise VICTestError('{} is different in runs {} and '
+                                   '{}'.format(fname, list_run_names[0],
+                                               run_name))
+
+
+def find_global_param_file(gp, param_name):
+    ''' Return the file name given by a global parameter
+
+    Parameters
+    ----------
+    gp: <str>
+        Global parameter file, read in by read()
+    param_name: <str>
+        The name of the global parameter to find; the file name is the last
+        value of the parameter (e.g. SNOW_BAND <nbands> <file>)
+
+    Returns
+    ----------
+    line_list[-1]: <str>
+        The file name
+    '''
+    for line in iter(gp.splitlines()):
+        line_list = line.split('#')[0].split()
+        if line_list == []:
+            continue
+        if line_list[0] == param_name:
+            return line_list[-1]
+
+
+def reverse_lines_keep_size_and_mtime(filename):
+    ''' Reverse the order of the lines of a file without changing its size or
+        modification time, like an edit of the file within the same second
+        that a cached index of the file cannot detect from its metadata
+
+    Parameters
+    ----------
+    filename: <str>
+        File with one record per line, e.g. a snow band file
+
+    Require
+    ----------
+    os
+    '''
+    st = os.stat(filename)
+    with open(filename, 'r') as f:
+        lines = f.read().splitlines(True)
+    if len(lines) < 2 or not lines[-1].endswith('\n'):
+        raise ValueError('{} must have at least two complete lines to be '
+                         'reordered'.format(filename))
+    with open(filename, 'w') as f:
+        f.writelines(lines[::-1])
+    os.utime(filename, ns=(st.st_atime_ns, st.st_mtime_ns))
+
+
+def reverse_binary_state_cells_keep_size_and_mtime(filename):
+    ''' Reverse the order of the grid cells of a classic driver binary state
+        file without changing its size or modification time, so that a cached
+        index of the file cannot detect the change from its metadata
+
+    Parameters
+    ----------
+    filename: <str>
+        Binary state file written by the classic driver
+
+    Require
+    ----------
+    os
+    struct
+    '''
+
+    # date (3 int) and number of layers and nodes (2 size_t), unpadded
+    header_size = struct.calcsize('=3i') + 2 * struct.calcsize('N')
+    # cell number, number of vegetation tiles and snow bands, and the number
+    # of bytes of the rest of the record (4 int)
+    record_fmt = '=4i'
+
+    st = os.stat(filename)
+    with open(filename, 'rb') as f:
+        data = f.read()
+    records = []
+    offset = header_size
+    while offset < len(data):
+        nbytes = struct.unpack_from(record_fmt, data, offset)[3]
+        end = offset + struct.calcsize(record_fmt) + nbytes
+        records.append(data[offset:end])
+        offset = end
+    if len(records) < 2 or offset != len(data):
+        raise ValueError('{} must have at least two complete cell records to '
+                         'be reordered'.format(filename))
+    with open(filename, 'wb') as f:
+        f.write(data[:header_size])
+        f.writelines(records[::-1])
+    os.utime(filename, ns=(st.st_atime_ns, st.st_mtime_ns))
+
+
+def setup_binary_forcing_runs(list_global_param, list_run_names,
+                              forcing_basedir):
+    ''' Write the ASCII forcing files of a classic driver run as BINARY
+        files, little-endian and big-endian, and the same values as ASCII
+        files, and point the forcing options of each run to its files
+
+    Parameters
+    ----------
+    list_global_param: <list>
+        A list of global parameter files, as lists of lines, one for each of
+        the runs 'ascii', 'binary_little' and 'binary_big'
+    list_run_names: <list>
+        A list of names of the runs; the forcing files of a run are written
+        to a subdirectory, named after the run, under forcing_basedir
+    forcing_basedir: <str>
+        Base directory of the forcing files written
+
+    Returns
+    ----------
+    list_global_param: <list>
+        The global parameter files with the forcing options replaced
+
+    Require
+    ----------
+    os
+    glob
+    gzip
+    numpy
+    '''
+
+    gp = list_global_param[0]
+    prefix = [line.split()[1] for line in gp
+              if line.split() and line.split()[0] == 'FORCING1'][0]
+    force_types = [line.split()[1] for line in gp
+                   if line.split() and line.split()[0] == 'FORCE_TYPE']
+    fnames = sorted(glob.glob(prefix + '*'))
+    data = [np.loadtxt(fname, ndmin=2) for fname in fnames]
+
+    # Pick for each column the largest multiplier (a power of 10, so that the
+    # values divided by it are written exactly in ASCII) that fits in a short
+    # int, signed if the column has negative values
+    values = np.concatenate(data)
+    signed = values.min(axis=0) < 0
+    limit = np.where(signed, np.iinfo(np.int16).max, np.iinfo(np.uint16).max)
+    decimals = np.zeros(len(force_types), dtype=int)
+    for d in range(3, 0, -1):
+        fits = (decimals == 0) & \
+            (np.abs(values).max(axis=0) * 10 ** d <= limit)
+        decimals[fits] = d
+
+    for run_name in list_run_names:
+        os.makedirs(os.path.join(forcing_basedir, run_name), exist_ok=True)
+    for fname, d in zip(fnames, data):
+        quantized = np.round(d * 10. ** decimals).astype(np.int64)
+        basename = os.path.basename(fname)
+        # ASCII, with the values the BINARY files hold
+        np.savetxt(os.path.join(forcing_basedir, 'ascii', basename),
+                   quantized / 10. ** decimals,
+                   fmt=['%.{}f'.format(n) for n in decimals], delimiter='\t')
+        # BINARY, as two's complement for the signed columns
+        records = (quantized & 0xFFFF).astype(np.uint16)
+        with open(os.path.join(forcing_basedir, 'binary_little', basename),
+                  'wb') as f:
+            f.write(records.astype('<u2').tobytes())
+        # big-endian with a VIC header (4 identifiers and the number of
+        # bytes of the header), which also moves the records off the page
+        # boundaries, and compressed, as open_file() uncompresses it
+        with gzip.open(os.path.join(forcing_basedir, 'binary_big',
+                                    basename + '.gz'), 'wb') as f:
+            f.write(np.array([0xFFFF] * 4 + [10], dtype='>u2').tobytes())
+            f.write(records.astype('>u2').tobytes())
+
+    for j, run_name in enumerate(list_run_names):
+        lines = []
+        for line in list_global_param[j]:
+            key = line.split()[0] if line.split() else None
+            if key == 'FORCING1':
+                lines.append('{0: <20} {1}\n'.format(
+                    key, os.path.join(forcing_basedir, run_name,
+                                      os.path.basename(prefix))))
+            elif key == 'FORCE_FORMAT' and run_name == 'ascii':
+                lines.append('{0: <20} {1}\n'.format(key, 'ASCII'))
+            elif key == 'FORCE_FORMAT':
+                lines.append('{0: <20} {1}\n'.format(key, 'BINARY'))
+                lines.append('{0: <20} {1}\n'.format(
+                    'FORCE_ENDIAN',
+                    'LITTLE' if run_name == 'binary_little' else 'BIG'))
+            elif key == 'FORCE_TYPE' and run_name != 'ascii':
+                i = len([l for l in lines if l.split()[:1] == [key]])
+                if force_types[i] == 'SKIP':
+                    lines.append('{0: <20} {1}\n'.format(key, 'SKIP'))
+                else:
+                    lines.append('{0: <20} {1} {2} {3}\n'.format(
+                        key, force_types[i],
+                        'SIGNED' if signed[i] else 'UNSIGNED',
+                        10 ** decimals[i]))
+            else:
+                lines.append(line)
+        list_global_param[j] = lines
+
+    return list_global_param
+
+
+def check_param_index(filename):
+    ''' Check that the cached index of a one-line-per-cell parameter file
+        (e.g. a snow band file), written by the classic driver, points each
+        cell to its line in the file
+
+    Parameters
+    ----------
+    filename: <str>
+        Indexed parameter file; the index is cached in <filename>.idx
+
+    Require
+    ----------
+    struct
+    '''
+
+    # param_index_header_struct and param_index_entry_struct
+    header_fmt = '8sHiqqN'
+    entry_fmt = 'iq'
+
+    with open(filename, 'rb') as f:
+        data = f.read()
+    with open(filename + '.idx', 'rb') as f:
+        index = f.read()
+
+    magic, _, _, size, _, n = struct.unpack_from(header_fmt, index)
+    if magic != b'VICPIDX1' or size != len(data):
+        raise VICTestError('Index of {} was not rebuilt'.format(filename))
+    for i in range(n):
+        gridcel, offset = struct.unpack_from(
+            entry_fmt, index,
+            struct.calcsize(header_fmt) + i * struct.calcsize(entry_fmt))
+        if offset > 0 and data[offset - 1:offset] != b'\n':
+            raise VICTestError('Index of {} points cell {} into the middle '
+                               'of a line'.format(filename, gridcel))
+        if int(data[offset:].split()[0]) != gridcel:
+            raise VICTestError('Index of {} points cell {} to another '
+                               'cell'.format(filename, gridcel))
+
+
 def tsplit(string, delimiters):
     '''Behaves like str.split but supports multiple delimiters. '''
 
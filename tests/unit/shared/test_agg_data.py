@@ -0,0 +1,128 @@
+import numpy as np
+import pytest
+from vic import lib as vic_lib
+from vic import ffi
+
+np.random.seed(1234)
+
+ncells = 7
+nelem = 3
+
+
+def as_ptr(array):
+    return ffi.cast('double *', array.ctypes.data)
+
+
+@pytest.fixture()
+def src_agg():
+    # [ncells, nelem] values in out_data and [nelem, ncells] values in aggdata
+    src = np.random.random((ncells, nelem)) - 0.5
+    agg = np.random.random((nelem, ncells)) - 0.5
+    return src, agg
+
+
+def test_agg_copy(src_agg):
+    src, agg = src_agg
+    vic_lib.agg_copy(ncells, nelem, as_ptr(src), as_ptr(agg))
+    np.testing.assert_array_equal(agg, src.T)
+
+
+def test_agg_sum(src_agg):
+    src, agg = src_agg
+    expected = agg + src.T
+    vic_lib.agg_sum(ncells, nelem, as_ptr(src), as_ptr(agg))
+    np.testing.assert_array_equal(agg, expected)
+
+
+def test_agg_max(src_agg):
+    src, agg = src_agg
+    expected = np.maximum(agg, src.T)
+    vic_lib.agg_max(ncells, nelem, as_ptr(src), as_ptr(agg))
+    np.testing.assert_array_equal(agg, expected)
+
+
+def test_agg_min(src_agg):
+    src, agg = src_agg
+    expected = np.minimum(agg, src.T)
+    vic_lib.agg_min(ncells, nelem, as_ptr(src), as_ptr(agg))
+    np.testing.assert_array_equal(agg, expected)
+
+
+def test_agg_divide(src_agg):
+    src, agg = src_agg
+    expected = agg / 4.
+    vic_lib.agg_divide(nelem * ncells, 4., as_ptr(agg))
+    np.testing.assert_array_equal(agg, expected)
+
+
+@pytest.fixture()
+def out_metadata_nelem():
+    # alloc_out_data and alloc_aggdata size the blocks from out_metadata;
+    # give the soil moisture nelem elements and all other variables one
+    saved = [vic_lib.out_metadata[varid].nelem
+             for varid in range(vic_lib.N_OUTVAR_TYPES)]
+    for varid in range(vic_lib.N_OUTVAR_TYPES):
+        vic_lib.out_metadata[varid].nelem = 1
+    vic_lib.out_metadata[vic_lib.OUT_SOIL_MOIST].nelem = nelem
+    yield
+    for varid, n in enumerate(saved):
+        vic_lib.out_metadata[varid].nelem = n
+
+
+def test_agg_stream_data(out_metadata_nelem):
+    nsteps = 4
+    varids = [vic_lib.OUT_PREC, vic_lib.OUT_SOIL_MOIST, vic_lib.OUT_SWE,
+              vic_lib.OUT_SOIL_MOIST, vic_lib.OUT_PREC, vic_lib.OUT_SWE]
+    aggtypes = [vic_lib.AGG_TYPE_SUM, vic_lib.AGG_TYPE_AVG,
+                vic_lib.AGG_TYPE_MAX, vic_lib.AGG_TYPE_MIN,
+                vic_lib.AGG_TYPE_BEG, vic_lib.AGG_TYPE_END]
+    nvars = len(varids)
+
+    out_data = ffi.new('double **[]', ncells)
+    vic_lib.alloc_out_data(ncells, out_data)
+
+    stream = ffi.new('stream_struct *')
+    stream.nvars = nvars
+    stream.ngridcells = ncells
+    varid = ffi.new('unsigned int []', varids)
+    aggtype = ffi.new('unsigned short int []', aggtypes)
+    stream.varid = varid
+    stream.aggtype = aggtype
+    vic_lib.alloc_aggdata(stream)
+    stream.agg_alarm.freq = vic_lib.FREQ_NSTEPS
+    stream.agg_alarm.n = nsteps
+    stream.agg_alarm.next_count = nsteps
+    stream.agg_alarm.count = 0
+    # a date that differs from the (unset) date of the alarm, so that the
+    # alarm is only raised by the step count
+    dmy = ffi.new('dmy_struct *')
+    dmy.year = 2000
+
+    # values of each output variable of each cell for each step
+    values = {v: np.random.random((nsteps, ncells,
+                                   vic_lib.out_metadata[v].nelem)) - 0.5
+              for v in set(varids)}
+    for step in range(nsteps):
+        for v, value in values.items():
+            for i in range(ncells):
+                for k in range(vic_lib.out_metadata[v].nelem):
+                    out_data[i][v][k] = value[step, i, k]
+        vic_lib.agg_stream_data(stream, dmy, out_data)
+    assert stream.agg_alarm.count == nsteps
+
+    # aggdata starts at zero, which also takes part in the maximum and minimum
+    reduce = {vic_lib.AGG_TYPE_SUM: lambda x: x.sum(axis=0),
+              vic_lib.AGG_TYPE_AVG: lambda x: x.sum(axis=0) / nsteps,
+              vic_lib.AGG_TYPE_MAX: lambda x: np.maximum(x.max(axis=0), 0.),
+              vic_lib.AGG_TYPE_MIN: lambda x: np.minimum(x.min(axis=0), 0.),
+              vic_lib.AGG_TYPE_BEG: lambda x: x[0],
+              vic_lib.AGG_TYPE_END: lambda x: x[-1]}
+    for j in range(nvars):
+        expected = reduce[aggtypes[j]](values[varids[j]])
+        for i in range(ncells):
+            for k in range(vic_lib.out_metadata[varids[j]].nelem):
+                np.testing.assert_allclose(stream.aggdata[i][j][k][0],
+                                           expected[i, k], rtol=1e-14)
+
+    vic_lib.free_aggdata(stream)
+    stream.aggdata = ffi.NULL
@@ -0,0 +1,38 @@
+import numpy as np
+import pytest
+from vic import lib as vic_lib
+from vic import ffi
+
+np.random.seed(1234)
+
+nrecs = 11
+ncols = 3
+multiplier = 100.
+
+
+@pytest.mark.parametrize('byteorder', ['<', '>'])
+@pytest.mark.parametrize('is_signed', [True, False])
+def test_decode_binary_forcing(byteorder, is_signed):
+    dtype = np.dtype('i2' if is_signed else 'u2')
+    info = np.iinfo(dtype)
+    values = np.random.randint(info.min, info.max + 1, size=(nrecs, ncols))
+    # include the extremes, which are the values most easily misread
+    values[0, :] = info.min
+    values[1, :] = info.max
+    records = values.astype(dtype.newbyteorder(byteorder)).tobytes()
+    swap = dtype.newbyteorder(byteorder) != dtype.newbyteorder('=')
+
+    src = ffi.from_buffer('unsigned char[]', records)
+    for col in range(ncols):
+        actual = np.zeros(nrecs)
+        vic_lib.decode_binary_forcing(
+            src + col * dtype.itemsize, ncols * dtype.itemsize, nrecs, swap,
+            is_signed, multiplier, ffi.cast('double *', actual.ctypes.data))
+        np.testing.assert_array_equal(actual, values[:, col] / multiplier)
+
+
+def test_decode_binary_forcing_no_dst():
+    records = bytes(nrecs * ncols * 2)
+    src = ffi.from_buffer('unsigned char[]', records)
+    vic_lib.decode_binary_forcing(src, ncols * 2, nrecs, False, True,
+                                  multiplier, ffi.NULL)
@@ -0,0 +1,79 @@
+import numpy as np
+from vic.vic import ffi
+from vic import lib as vic_lib
+
+
+def make_fda_heat_eqn_workspace(keep):
+    '''Workspace of fda_heat_eqn() for a frozen 5 node profile with 3 layers,
+    a bottom boundary and no exponential grid transformation'''
+    nnodes = 5
+    nlayers = 3
+
+    def array(values):
+        cdata = ffi.new('double[]', values)
+        keep.append(cdata)
+        return cdata
+
+    zsum = [0., 0.1, 0.4, 1.0, 2.0]
+    ws = ffi.new('fda_heat_eqn_workspace_struct *')
+    keep.append(ws)
+    ws.deltat = 3600.
+    ws.NOFLUX = 0
+    ws.EXP_TRANS = 0
+    ws.T0 = array([-6., -5., -4., -3., -2.])
+    ws.moist = array([0.38] * nnodes)
+    ws.ice = array([0.1] * nnodes)
+    ws.kappa = array([1.5] * nnodes)
+    ws.Cs = array([2.e6] * nnodes)
+    ws.max_moist = array([0.4] * nnodes)
+    ws.bubble = array([20.] * nnodes)
+    ws.expt = array([10.] * nnodes)
+    ws.alpha = array([zsum[i + 2] - zsum[i] for i in range(nnodes - 2)])
+    ws.beta = array([zsum[i + 1] - zsum[i] for i in range(nnodes - 2)])
+    ws.gamma = array([zsum[i + 2] - zsum[i + 1] for i in range(nnodes - 2)])
+    ws.Zsum = array(zsum)
+    ws.Dp = zsum[-1]
+    ws.bulk_dens_min = array([1500.] * nlayers)
+    ws.soil_dens_min = array([2650.] * nlayers)
+    ws.quartz = array([0.5] * nlayers)
+    ws.bulk_density = array([1500.] * nlayers)
+    ws.soil_density = array([2650.] * nlayers)
+    ws.organic = array([0.] * nlayers)
+    ws.depth = array([0.1, 0.5, 1.5])
+    ws.Nlayers = nlayers
+
+    return ws
+
+
+def test_fda_heat_eqn_jacobian_matches_fdjac3():
+    vic_lib.initialize_parameters()
+    keep = []
+    ws = make_fda_heat_eqn_workspace(keep)
+    n = 3
+
+    T = ffi.new('double[]', n)
+    res = ffi.new('double[]', n)
+    vic_lib.fda_heat_eqn(T, res, n, 1, ws)
+    for i, t in enumerate([-4.5, -3.7, -2.6]):
+        T[i] = t
+
+    # analytic Jacobian at the states of a full residual calculation
+    a = ffi.new('double[]', n)
+    b = ffi.new('double[]', n)
+    c = ffi.new('double[]', n)
+    vic_lib.fda_heat_eqn(T, res, n, 0, ws, ffi.cast('int', -1))
+    for i in range(1, n + 1):
+        assert ws.ice_new[i] > 0.
+    vic_lib.fda_heat_eqn(T, res, n, 2, ws, ffi.cast('double *', a),
+                         ffi.cast('double *', b), ffi.cast('double *', c))
+
+    # forward difference Jacobian
+    fa = ffi.new('double[]', n)
+    fb = ffi.new('double[]', n)
+    fc = ffi.new('double[]', n)
+    vic_lib.fda_heat_eqn(T, res, n, 0, ws, ffi.cast('int', -1))
+    vic_lib.fdjac3(T, res, fa, fb, fc, vic_lib.fda_heat_eqn, n, ws)
+
+    np.testing.assert_allclose(list(b), list(fb), rtol=1e-4)
+    np.testing.assert_allclose(list(a)[1:], list(fa)[1:], rtol=1e-4)
+    np.testing.assert_allclose(list(c)[:-1], list(fc)[:-1], rtol=1e-4)
@@ -26,48 +26,53 @@
 
 #include <vic_driver_cesm.h>
 
-size_t              NF, NR;
-size_t              current;
-size_t             *filter_active_cells = NULL;
-size_t             *mpi_map_mapping_array = NULL;
-all_vars_struct    *all_vars = NULL;
-force_data_struct  *force = NULL;
-x2l_data_struct    *x2l_vic = NULL;
-l2x_data_struct    *l2x_vic = NULL;
-dmy_struct          dmy_current;
-filenames_struct    filenames;
-filep_struct        filep;
-domain_struct       global_domain;
-domain_struct       local_domain;
-global_param_struct global_param;
-lake_con_struct     lake_con;
-MPI_Comm            MPI_COMM_VIC;
-MPI_Datatype        mpi_domain_struct_type;
-MPI_Datatype        mpi_global_struct_type;
-MPI_Datatype        mpi_filenames_struct_type;
-MPI_Datatype        mpi_location_struct_type;
-MPI_Datatype        mpi_alarm_struct_type;
-MPI_Datatype        mpi_option_struct_type;
-MPI_Datatype        mpi_param_struct_type;
-int                *mpi_map_local_array_sizes = NULL;
-int                *mpi_map_global_array_offsets = NULL;
-int                 mpi_rank;
-int                 mpi_size;
-option_struct       options;
-parameters_struct   param;
-param_set_struct    param_set;
-soil_con_struct    *soil_con = NULL;
-veg_con_map_struct *veg_con_map = NULL;
-veg_con_struct    **veg_con = NULL;
-veg_hist_struct   **veg_hist = NULL;
-veg_lib_struct    **veg_lib = NULL;
-metadata_struct     state_metadata[N_STATE_VARS];
-metadata_struct     out_metadata[N_OUTVAR_TYPES];
-save_data_struct   *save_data;  // [ncells]
-double           ***out_data = NULL;  // [ncells, nvars, nelem]
-stream_struct      *output_streams = NULL;  // [nstreams]
-nc_file_struct     *nc_hist_files = NULL;  // [nstreams]
-timer_struct        global_timers[N_TIMERS];
+size_t                NF, NR;
+size_t                current;
+size_t               *filter_active_cells = NULL;
+size_t               *mpi_map_mapping_array = NULL;
+all_vars_struct      *all_vars = NULL;
+force_data_struct    *force = NULL;
+x2l_data_struct      *x2l_vic = NULL;
+l2x_data_struct      *l2x_vic = NULL;
+dmy_struct            dmy_current;
+filenames_struct      filenames;
+filep_struct          filep;
+domain_struct         global_domain;
+domain_struct         local_domain;
+global_param_struct   global_param;
+lake_con_struct       lake_con;
+MPI_Comm              MPI_COMM_VIC;
+MPI_Comm              MPI_COMM_IO = MPI_COMM_NULL;
+MPI_Datatype          mpi_domain_struct_type;
+MPI_Datatype          mpi_global_struct_type;
+MPI_Datatype          mpi_filenames_struct_type;
+MPI_Datatype          mpi_location_struct_type;
+MPI_Datatype          mpi_alarm_struct_type;
+MPI_Datatype          mpi_option_struct_type;
+MPI_Datatype          mpi_param_struct_type;
+int                  *mpi_map_local_array_sizes = NULL;
+int                  *mpi_map_global_array_offsets = NULL;
+par_io_map_struct     par_io_map;
+int                   mpi_rank;
+int                   mpi_size;
+option_struct         options;
+parameters_struct     param;
+param_set_struct      param_set;
+soil_con_struct      *soil_con = NULL;
+state_store_struct    state_store;
+veg_con_map_struct   *veg_con_map = NULL;
+veg_con_struct      **veg_con = NULL;
+veg_hist_struct     **veg_hist = NULL;
+veg_lib_struct      **veg_lib = NULL;
+metadata_struct       state_metadata[N_STATE_VARS];
+metadata_struct       out_metadata[N_OUTVAR_TYPES];
+save_data_struct     *save_data;  // [ncells]
+scratch_arena_struct *scratch_arenas = NULL;  // [nthreads]
+double               *cell_cost = NULL;  // [ncells]
+double             ***out_data = NULL;  // [ncells, nvars, nelem]
+stream_struct        *output_streams = NULL;  // [nstreams]
+nc_file_struct       *nc_hist_files = NULL;  // [nstreams]
+timer_struct          global_timers[N_TIMERS];
 
 /******************************************************************************
  * @brief    Initialization function for CESM driver
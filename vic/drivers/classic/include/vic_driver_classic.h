@@ -28,12 +28,28 @@
 #define VIC_DRIVER_CLASSIC_H
 
 #include <vic_driver_shared_all.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 
 #define VIC_DRIVER "Classic"
 
 #define BINHEADERSIZE 256
 #define MAX_VEGPARAM_LINE_LENGTH 500
 #define ASCII_STATE_FLOAT_FMT "%.16g"
+#define PARAM_INDEX_MAGIC "VICPIDX1"
+#define PARAM_INDEX_SUFFIX ".idx"
+
+/******************************************************************************
+ * @brief   Parameter and state files that are indexed by grid cell
+ *****************************************************************************/
+enum
+{
+    PARAM_INDEX_VEGPARAM,      /**< vegetation parameter file */
+    PARAM_INDEX_SNOWBAND,      /**< snow band file */
+    PARAM_INDEX_LAKEPARAM,     /**< lake parameter file */
+    PARAM_INDEX_STATE_ASCII,   /**< ASCII initial state file */
+    PARAM_INDEX_STATE_BINARY   /**< BINARY initial state file */
+};
 
 /******************************************************************************
  * @brief   file structures
@@ -71,51 +87,134 @@ typedef struct {
     char log_path[MAXSTRING];      /**< Location to write log file to*/
 } filenames_struct;
 
+/******************************************************************************
+ * @brief   Parameters and initial state of a grid cell, as read from the
+ *          parameter files and handed to the thread that runs the cell.
+ *****************************************************************************/
+typedef struct {
+    int cellnum;                 /**< number of the cell in the run */
+    soil_con_struct soil_con;    /**< soil parameters */
+    veg_con_struct *veg_con;     /**< vegetation parameters */
+    lake_con_struct lake_con;    /**< lake parameters */
+    all_vars_struct all_vars;    /**< model state */
+} cell_task_struct;
+
+/******************************************************************************
+ * @brief   Model states of grid cells that are waiting to be copied to the
+ *          state file. Cells can finish in any order, but their states are
+ *          written in the order of the cells.
+ *****************************************************************************/
+typedef struct {
+    size_t next;      /**< number of the next cell to write */
+    size_t nalloc;    /**< allocated length of done and state */
+    bool *done;       /**< TRUE = the cell has finished */
+    FILE **state;     /**< temporary file with the state of the cell, or
+                           NULL if the cell did not save a state */
+} state_queue_struct;
+
+/******************************************************************************
+ * @brief   Position of the record of a grid cell in a parameter or state file.
+ *****************************************************************************/
+typedef struct {
+    int gridcel;    /**< grid cell number */
+    long offset;    /**< byte offset of the record in the file */
+} param_index_entry_struct;
+
+/******************************************************************************
+ * @brief   Index of the grid cell records in a parameter or state file, sorted
+ *          by grid cell number.
+ *****************************************************************************/
+typedef struct {
+    size_t n;                            /**< number of indexed cells */
+    param_index_entry_struct *entries;   /**< records of the cells */
+} param_index_struct;
+
+/******************************************************************************
+ * @brief   Header of the sidecar file in which the index of a parameter or
+ *          state file is cached. The index is only used if the indexed file
+ *          has not changed since the index was written.
+ *****************************************************************************/
+typedef struct {
+    char magic[8];          /**< PARAM_INDEX_MAGIC */
+    unsigned short type;    /**< type of indexed file */
+    int nlines;             /**< extra lines per record (see
+                                 param_index_nlines()) */
+    long long size;         /**< size of the indexed file in bytes */
+    long long mtime;        /**< modification time of the indexed file */
+    size_t n;               /**< number of indexed cells */
+} param_index_header_struct;
+
 void alloc_atmos(int, force_data_struct **);
 void alloc_veg_hist(int nrecs, int nveg, veg_hist_struct ***veg_hist);
 void calc_netlongwave(double *, double, double, double);
 double calc_netshort(double, int, double, double *);
 void check_files(filep_struct *, filenames_struct *);
+bool check_param_index(FILE *fp, unsigned short type,
+                       param_index_struct *index);
 bool check_save_state_flag(dmy_struct *, size_t);
 FILE  *check_state_file(char *, size_t, size_t, int *);
 void close_files(filep_struct *filep, stream_struct **streams);
+stream_struct *copy_streams(stream_struct *streams, dmy_struct *dmy);
 void compute_cell_area(soil_con_struct *);
 void free_atmos(int nrecs, force_data_struct **force);
+void free_cell_streams(stream_struct **streams);
+void free_param_index(param_index_struct *index);
+void free_state_queue(void);
 void free_veg_hist(int nrecs, int nveg, veg_hist_struct ***veg_hist);
 void free_veglib(veg_lib_struct **);
 double get_dist(double lat1, double long1, double lat2, double long2);
 void get_force_type(char *, int, int *);
 void get_global_param(FILE *);
+void get_param_index(char *filename, FILE *fp, unsigned short type,
+                     param_index_struct *index);
 void initialize_filenames(void);
 void initialize_fileps(void);
 void initialize_forcing_files(void);
 void make_in_and_outfiles(filep_struct *filep, filenames_struct *filenames,
                           soil_con_struct *soil, stream_struct **streams,
                           dmy_struct *dmy);
+void make_param_index(FILE *fp, unsigned short type, int nlines,
+                      param_index_struct *index);
 FILE *open_state_file(global_param_struct *, filenames_struct, size_t, size_t);
+int param_index_compare(const void *a, const void *b);
+int param_index_nlines(unsigned short type);
+void put_cell_state(int cellnum, FILE *state);
 void print_atmos_data(force_data_struct *force, size_t nr);
 void parse_output_info(FILE *gp, stream_struct **output_streams,
                        dmy_struct *dmy_current);
-void read_atmos_data(FILE *, global_param_struct, int, int, double **,
-                     double ***);
-double **read_forcing_data(FILE **, global_param_struct, double ****);
+size_t read_binary_forcing(FILE *infile, int file_num, size_t Nveg,
+                           size_t nrecs, bool swap, double **forcing_data,
+                           double ***veg_hist_data);
+void read_atmos_data(FILE *, global_param_struct, int, int, size_t, size_t,
+                     size_t, double **, double ***);
+double **read_forcing_data(FILE **, global_param_struct, size_t, size_t, size_t,
+                           double ****);
 void read_initial_model_state(FILE *, all_vars_struct *, int, int, int,
                               soil_con_struct *, lake_con_struct);
 lake_con_struct read_lakeparam(FILE *, soil_con_struct, veg_con_struct *);
+bool read_param_index_file(char *filename, unsigned short type, int nlines,
+                           struct stat *st, param_index_struct *index);
 void read_snowband(FILE *, soil_con_struct *);
 void read_soilparam(FILE *soilparam, soil_con_struct *temp, bool *RUN_MODEL,
                     bool *MODEL_DONE);
 veg_lib_struct *read_veglib(FILE *, size_t *);
 veg_con_struct *read_vegparam(FILE *, int, size_t);
+bool seek_param_index(param_index_struct *index, FILE *fp, int gridcel);
+void skip_param_lines(FILE *fp, size_t nlines);
+void vic_classic_run_cell(cell_task_struct *cell, dmy_struct *dmy,
+                          stream_struct *streams, int startrec);
 void vic_force(force_data_struct *, dmy_struct *, FILE **, veg_con_struct *,
-               veg_hist_struct **, soil_con_struct *);
+               veg_hist_struct **, soil_con_struct *, size_t, size_t);
 void vic_populate_model_state(all_vars_struct *, filep_struct, size_t,
                               soil_con_struct *, veg_con_struct *,
                               lake_con_struct, dmy_struct *);
-void write_data(stream_struct *streams);
+void write_data(stream_struct *streams, scratch_arena_struct *scratch);
 void write_header(stream_struct **streams, dmy_struct *dmy);
 void write_model_state(all_vars_struct *, int, int, filep_struct *,
                        soil_con_struct *);
-void write_output(stream_struct **streams, dmy_struct *dmy);
+void write_output(stream_struct **streams, dmy_struct *dmy,
+                  scratch_arena_struct *scratch);
+void write_param_index_file(char *filename, unsigned short type, int nlines,
+                            struct stat *st, param_index_struct *index);
 void write_vic_timing_table(timer_struct *timers);
 #endif
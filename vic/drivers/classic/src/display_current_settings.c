@@ -271,6 +271,7 @@ display_current_settings(int mode)
             }
         }
     }
+    fprintf(LOG_DEST, "FORCE_BLOCK_STEPS\t%zu\n", options.FORCE_BLOCK_STEPS);
     fprintf(LOG_DEST, "GRID_DECIMAL\t\t%d\n", options.GRID_DECIMAL);
 
     fprintf(LOG_DEST, "\n");
@@ -53,6 +53,10 @@ get_global_param(FILE *gp)
 
     file_num = 0;
 
+    // Unlike the image driver, read the forcing of the whole simulation
+    // period unless FORCE_BLOCK_STEPS is set in the global parameter file
+    options.FORCE_BLOCK_STEPS = 0;
+
     /** Read through global control file to find parameters **/
 
     fgets(cmdstr, MAXSTRING, gp);
@@ -398,6 +402,9 @@ get_global_param(FILE *gp)
                 sscanf(cmdstr, "%*s %zu",
                        &param_set.force_steps_per_day[file_num]);
             }
+            else if (strcasecmp("FORCE_BLOCK_STEPS", optstr) == 0) {
+                sscanf(cmdstr, "%*s %zu", &options.FORCE_BLOCK_STEPS);
+            }
             else if (strcasecmp("FORCEYEAR", optstr) == 0) {
                 sscanf(cmdstr, "%*s %hu",
                        &global_param.forceyear[file_num]);
@@ -0,0 +1,436 @@
+/******************************************************************************
+ * @section DESCRIPTION
+ *
+ * Index of the grid cell records in the parameter and initial state files.
+ *
+ * The vegetation parameter, snow band and lake parameter files and the
+ * initial state file hold one record per grid cell. Instead of scanning these
+ * files for the record of each cell, the byte offsets of all records are
+ * collected once at the start of the run and the readers seek directly to the
+ * record of a cell. The index is cached in a sidecar file next to the indexed
+ * file (its name with PARAM_INDEX_SUFFIX appended) and is rebuilt whenever
+ * the size or modification time of the indexed file changes, or the record
+ * of a cell no longer starts at its cached offset.
+ *
+ * @section LICENSE
+ *
+ * The Variable Infiltration Capacity (VIC) macroscale hydrological model
+ * Copyright (C) 2016 The Computational Hydrology Group, Department of Civil
+ * and Environmental Engineering, University of Washington.
+ *
+ * The VIC model is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *****************************************************************************/
+
+#include <vic_driver_classic.h>
+
+/******************************************************************************
+ * @brief    Get the index of a parameter or state file, from its sidecar file
+ *           if that is up to date, otherwise by scanning the file.
+ *****************************************************************************/
+void
+get_param_index(char               *filename,
+                FILE               *fp,
+                unsigned short      type,
+                param_index_struct *index)
+{
+    char        idxname[MAXSTRING + sizeof(PARAM_INDEX_SUFFIX)];
+    int         nlines;
+    struct stat st;
+
+    nlines = param_index_nlines(type);
+    sprintf(idxname, "%s%s", filename, PARAM_INDEX_SUFFIX);
+
+    if (stat(filename, &st) != 0) {
+        // without size and modification time the index cannot be cached
+        make_param_index(fp, type, nlines, index);
+        return;
+    }
+
+    if (read_param_index_file(idxname, type, nlines, &st, index)) {
+        if (check_param_index(fp, type, index)) {
+            log_info("Read index of %s from %s", filename, idxname);
+            return;
+        }
+        log_info("Index %s does not match %s, rebuilding it", idxname,
+                 filename);
+        free_param_index(index);
+    }
+
+    make_param_index(fp, type, nlines, index);
+    write_param_index_file(idxname, type, nlines, &st, index);
+}
+
+/******************************************************************************
+ * @brief    Check that the record of each cell of an index starts at its
+ *           offset in the file.
+ * @details  The size and modification time of a file do not change if it is
+ *           edited within the same second without changing its length, so a
+ *           cached index is also checked against the records themselves: the
+ *           first field of each record must be the grid cell number, and a
+ *           record of an ASCII file must start at the beginning of a line.
+ *           fp is returned to its position afterwards. Returns FALSE if any
+ *           record does not match.
+ *****************************************************************************/
+bool
+check_param_index(FILE               *fp,
+                  unsigned short      type,
+                  param_index_struct *index)
+{
+    bool   match;
+    int    gridcel;
+    long   start;
+    size_t i;
+
+    start = ftell(fp);
+
+    match = true;
+    for (i = 0; i < index->n && match; i++) {
+        if (type == PARAM_INDEX_STATE_BINARY) {
+            match = fseek(fp, index->entries[i].offset, SEEK_SET) == 0 &&
+                    fread(&gridcel, sizeof(int), 1, fp) == 1;
+        }
+        else if (index->entries[i].offset > 0) {
+            match = fseek(fp, index->entries[i].offset - 1, SEEK_SET) == 0 &&
+                    getc(fp) == '\n' &&
+                    fscanf(fp, "%d", &gridcel) == 1;
+        }
+        else {
+            match = fseek(fp, 0, SEEK_SET) == 0 &&
+                    fscanf(fp, "%d", &gridcel) == 1;
+        }
+        match = match && gridcel == index->entries[i].gridcel;
+    }
+
+    clearerr(fp);
+    fseek(fp, start, SEEK_SET);
+
+    return match;
+}
+
+/******************************************************************************
+ * @brief    Build the index of a parameter or state file by scanning all of
+ *           its records.
+ * @details  The scan starts at the current position of fp, which must be the
+ *           start of the first record, and fp is returned to that position
+ *           afterwards. nlines is given by param_index_nlines(). If a cell
+ *           occurs more than once, the first record is used, as the
+ *           sequential readers did.
+ *****************************************************************************/
+void
+make_param_index(FILE               *fp,
+                 unsigned short      type,
+                 int                 nlines,
+                 param_index_struct *index)
+{
+    int    gridcel;
+    int    nrec;
+    int    nband;
+    int    nbytes;
+    long   offset;
+    long   start;
+    size_t i;
+    size_t n;
+    size_t nalloc;
+
+    start = ftell(fp);
+
+    index->n = 0;
+    index->entries = NULL;
+    nalloc = 0;
+
+    while (true) {
+        offset = ftell(fp);
+        if (type == PARAM_INDEX_VEGPARAM) {
+            if (fscanf(fp, "%d %d", &gridcel, &nrec) != 2) {
+                break;
+            }
+            if (nrec < 0) {
+                log_err("number of vegetation tiles (%i) given for cell %i "
+                        "is < 0.", nrec, gridcel);
+            }
+            skip_param_lines(fp, 1 + nrec * nlines);
+        }
+        else if (type == PARAM_INDEX_SNOWBAND) {
+            if (fscanf(fp, "%d", &gridcel) != 1) {
+                break;
+            }
+            skip_param_lines(fp, 1);
+        }
+        else if (type == PARAM_INDEX_LAKEPARAM) {
+            if (fscanf(fp, "%d %d", &gridcel, &nrec) != 2) {
+                break;
+            }
+            // the depth-area relationship follows if the cell has a lake
+            skip_param_lines(fp, nrec >= 0 ? 2 : 1);
+        }
+        else if (type == PARAM_INDEX_STATE_ASCII) {
+            if (fscanf(fp, "%d %d %d", &gridcel, &nrec, &nband) != 3) {
+                break;
+            }
+            // cell line, one line per tile and band, and the lake line
+            skip_param_lines(fp, 1 + (nrec + 1) * nband + nlines);
+        }
+        else if (type == PARAM_INDEX_STATE_BINARY) {
+            if (fread(&gridcel, sizeof(int), 1, fp) != 1 ||
+                fread(&nrec, sizeof(int), 1, fp) != 1 ||
+                fread(&nband, sizeof(int), 1, fp) != 1 ||
+                fread(&nbytes, sizeof(int), 1, fp) != 1) {
+                break;
+            }
+            // the record carries the number of bytes that follow
+            if (fseek(fp, nbytes, SEEK_CUR) != 0) {
+                break;
+            }
+        }
+        else {
+            log_err("Unknown parameter file type %hu", type);
+        }
+
+        if (index->n == nalloc) {
+            nalloc = nalloc > 0 ? 2 * nalloc : MAXSTRING;
+            index->entries = realloc(index->entries,
+                                     nalloc * sizeof(*(index->entries)));
+            check_alloc_status(index->entries, "Memory allocation error.");
+        }
+        index->entries[index->n].gridcel = gridcel;
+        index->entries[index->n].offset = offset;
+        index->n++;
+    }
+
+    // sort by cell and keep the first record of each cell
+    qsort(index->entries, index->n, sizeof(*(index->entries)),
+          param_index_compare);
+    n = 0;
+    for (i = 0; i < index->n; i++) {
+        if (n == 0 || index->entries[i].gridcel !=
+            index->entries[n - 1].gridcel) {
+            index->entries[n++] = index->entries[i];
+        }
+    }
+    index->n = n;
+
+    fseek(fp, start, SEEK_SET);
+}
+
+/******************************************************************************
+ * @brief    Compare two index entries by grid cell and offset (for qsort).
+ *****************************************************************************/
+int
+param_index_compare(const void *a,
+                    const void *b)
+{
+    const param_index_entry_struct *ea = (const param_index_entry_struct *) a;
+    const param_index_entry_struct *eb = (const param_index_entry_struct *) b;
+
+    if (ea->gridcel != eb->gridcel) {
+        return (ea->gridcel < eb->gridcel) ? -1 : 1;
+    }
+    if (ea->offset != eb->offset) {
+        return (ea->offset < eb->offset) ? -1 : 1;
+    }
+    return 0;
+}
+
+/******************************************************************************
+ * @brief    Return the number of lines per record of an indexed file that
+ *           depend on the model options: the lines per vegetation tile in the
+ *           vegetation parameter file (VEGPARAM options) and the lake line of
+ *           each cell in an ASCII state file (LAKES). The cached index of a
+ *           file is only valid for the same number of lines.
+ *****************************************************************************/
+int
+param_index_nlines(unsigned short type)
+{
+    extern option_struct options;
+
+    int                  nlines;
+
+    nlines = 0;
+    if (type == PARAM_INDEX_VEGPARAM) {
+        nlines = 1;
+        if (options.VEGPARAM_LAI) {
+            nlines++;
+        }
+        if (options.VEGPARAM_FCAN) {
+            nlines++;
+        }
+        if (options.VEGPARAM_ALB) {
+            nlines++;
+        }
+    }
+    else if (type == PARAM_INDEX_STATE_ASCII && options.LAKES) {
+        nlines = 1;
+    }
+
+    return nlines;
+}
+
+/******************************************************************************
+ * @brief    Read the index of a parameter or state file from its sidecar file.
+ * @details  Returns FALSE if the sidecar file does not exist or does not
+ *           match the indexed file described by st.
+ *****************************************************************************/
+bool
+read_param_index_file(char               *filename,
+                      unsigned short      type,
+                      int                 nlines,
+                      struct stat        *st,
+                      param_index_struct *index)
+{
+    FILE                     *fp;
+    param_index_header_struct header;
+
+    fp = fopen(filename, "rb");
+    if (fp == NULL) {
+        return false;
+    }
+
+    if (fread(&header, sizeof(header), 1, fp) != 1 ||
+        strncmp(header.magic, PARAM_INDEX_MAGIC, sizeof(header.magic)) != 0 ||
+        header.type != type ||
+        header.nlines != nlines ||
+        header.size != (long long) st->st_size ||
+        header.mtime != (long long) st->st_mtime) {
+        fclose(fp);
+        return false;
+    }
+
+    index->n = header.n;
+    index->entries = NULL;
+    if (header.n == 0) {
+        fclose(fp);
+        return true;
+    }
+    index->entries = malloc(header.n * sizeof(*(index->entries)));
+    check_alloc_status(index->entries, "Memory allocation error.");
+    if (fread(index->entries, sizeof(*(index->entries)), header.n,
+              fp) != header.n) {
+        free_param_index(index);
+        fclose(fp);
+        return false;
+    }
+
+    fclose(fp);
+    return true;
+}
+
+/******************************************************************************
+ * @brief    Position a parameter or state file at the record of a grid cell.
+ * @details  Returns FALSE if the cell is not in the file.
+ *****************************************************************************/
+bool
+seek_param_index(param_index_struct *index,
+                 FILE               *fp,
+                 int                 gridcel)
+{
+    size_t lo;
+    size_t hi;
+    size_t mid;
+
+    lo = 0;
+    hi = index->n;
+    while (lo < hi) {
+        mid = lo + (hi - lo) / 2;
+        if (index->entries[mid].gridcel < gridcel) {
+            lo = mid + 1;
+        }
+        else {
+            hi = mid;
+        }
+    }
+
+    if (lo == index->n || index->entries[lo].gridcel != gridcel) {
+        return false;
+    }
+    if (fseek(fp, index->entries[lo].offset, SEEK_SET) != 0) {
+        log_err("Unable to seek to the record of cell %d", gridcel);
+    }
+
+    return true;
+}
+
+/******************************************************************************
+ * @brief    Skip the next nlines lines of a file, whatever their length.
+ *****************************************************************************/
+void
+skip_param_lines(FILE  *fp,
+                 size_t nlines)
+{
+    int c;
+
+    while (nlines > 0 && (c = getc(fp)) != EOF) {
+        if (c == '\n') {
+            nlines--;
+        }
+    }
+}
+
+/******************************************************************************
+ * @brief    Cache the index of a parameter or state file in its sidecar file.
+ * @details  The index is written to a temporary file that is renamed, so
+ *           that runs sharing the indexed file never read a partial index.
+ *           If the sidecar file cannot be written, for instance because the
+ *           parameter directory is read-only, the index is simply rebuilt in
+ *           the next run.
+ *****************************************************************************/
+void
+write_param_index_file(char               *filename,
+                       unsigned short      type,
+                       int                 nlines,
+                       struct stat        *st,
+                       param_index_struct *index)
+{
+    char                      tmpname[2 * MAXSTRING];
+    FILE                     *fp;
+    param_index_header_struct header;
+    size_t                    nwritten;
+
+    sprintf(tmpname, "%s.%ld", filename, (long) getpid());
+    fp = fopen(tmpname, "wb");
+    if (fp == NULL) {
+        log_info("Unable to write parameter file index %s", filename);
+        return;
+    }
+
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, PARAM_INDEX_MAGIC, sizeof(header.magic));
+    header.type = type;
+    header.nlines = nlines;
+    header.size = (long long) st->st_size;
+    header.mtime = (long long) st->st_mtime;
+    header.n = index->n;
+
+    nwritten = fwrite(&header, sizeof(header), 1, fp);
+    if (index->n > 0) {
+        nwritten += fwrite(index->entries, sizeof(*(index->entries)),
+                           index->n, fp);
+    }
+    if (fclose(fp) != 0 || nwritten != index->n + 1 ||
+        rename(tmpname, filename) != 0) {
+        log_info("Unable to write parameter file index %s", filename);
+        remove(tmpname);
+    }
+}
+
+/******************************************************************************
+ * @brief    Free the index of a parameter or state file.
+ *****************************************************************************/
+void
+free_param_index(param_index_struct *index)
+{
+    free(index->entries);
+    index->entries = NULL;
+    index->n = 0;
+}
@@ -28,25 +28,33 @@
 
 /******************************************************************************
  * @brief    Read in atmospheric data values from a binary/ascii file.
+ * @details  Reads the data of the nrecs model timesteps that start at model
+ *           timestep rec0. The file is positioned at the start of the
+ *           simulation when rec0 is 0; every later call continues where the
+ *           previous one stopped.
  *****************************************************************************/
 void
 read_atmos_data(FILE               *infile,
                 global_param_struct global_param,
                 int                 file_num,
                 int                 forceskip,
+                size_t              Nveg,
+                size_t              rec0,
+                size_t              nrecs,
                 double            **forcing_data,
                 double           ***veg_hist_data)
 {
     extern param_set_struct param_set;
 
     unsigned int            rec;
+    unsigned int            rec_start;
+    size_t                  nfile_recs;
     unsigned int            skip_recs;
     unsigned int            i, j;
     int                     endian;
     unsigned int            Nfields;
     int                    *field_index;
     unsigned short int      ustmp;
-    signed short            stmp;
     char                    str[MAXSTRING + 1];
     unsigned short int      Identifier[4];
     int                     Nbytes;
@@ -88,6 +96,10 @@ read_atmos_data(FILE               *infile,
         log_info("NULL file");
     }
 
+    // first record of the file that is read in this call
+    rec_start = (unsigned int) (rec0 * global_param.dt /
+                                param_set.FORCE_DT[file_num]);
+
     /***************************
        Read BINARY Forcing Data
     ***************************/
@@ -102,102 +114,53 @@ read_atmos_data(FILE               *infile,
             endian = BIG;
         }
 
-        // Check for presence of a header, & skip over it if appropriate.
-        // A VIC header will start with 4 instances of the identifier,
-        // followed by number of bytes in the header (Nbytes).
-        // Nbytes is assumed to be the byte offset at which the data records start.
-        fseek(infile, 0, SEEK_SET);
-        if (feof(infile)) {
-            log_err("No data in the forcing file.");
-        }
-        for (i = 0; i < 4; i++) {
-            fread(&ustmp, sizeof(unsigned short int), 1, infile);
-            if (endian != param_set.FORCE_ENDIAN[file_num]) {
-                ustmp = ((ustmp & 0xFF) << 8) | ((ustmp >> 8) & 0xFF);
+        // later calls continue where the previous call stopped
+        if (rec0 == 0) {
+            // Check for presence of a header, & skip over it if appropriate.
+            // A VIC header will start with 4 instances of the identifier,
+            // followed by number of bytes in the header (Nbytes).
+            // Nbytes is assumed to be the byte offset at which the data
+            // records start.
+            fseek(infile, 0, SEEK_SET);
+            if (feof(infile)) {
+                log_err("No data in the forcing file.");
             }
-            Identifier[i] = ustmp;
-        }
-        if (Identifier[0] != 0xFFFF || Identifier[1] != 0xFFFF ||
-            Identifier[2] != 0xFFFF || Identifier[3] != 0xFFFF) {
-            Nbytes = 0;
-        }
-        else {
-            fread(&ustmp, sizeof(unsigned short int), 1, infile);
-            if (endian != param_set.FORCE_ENDIAN[file_num]) {
-                ustmp = ((ustmp & 0xFF) << 8) | ((ustmp >> 8) & 0xFF);
+            for (i = 0; i < 4; i++) {
+                fread(&ustmp, sizeof(unsigned short int), 1, infile);
+                if (endian != param_set.FORCE_ENDIAN[file_num]) {
+                    ustmp = ((ustmp & 0xFF) << 8) | ((ustmp >> 8) & 0xFF);
+                }
+                Identifier[i] = ustmp;
             }
-            Nbytes = (int) ustmp;
-        }
-        fseek(infile, Nbytes, SEEK_SET);
+            if (Identifier[0] != 0xFFFF || Identifier[1] != 0xFFFF ||
+                Identifier[2] != 0xFFFF || Identifier[3] != 0xFFFF) {
+                Nbytes = 0;
+            }
+            else {
+                fread(&ustmp, sizeof(unsigned short int), 1, infile);
+                if (endian != param_set.FORCE_ENDIAN[file_num]) {
+                    ustmp = ((ustmp & 0xFF) << 8) | ((ustmp >> 8) & 0xFF);
+                }
+                Nbytes = (int) ustmp;
+            }
+            fseek(infile, Nbytes, SEEK_SET);
 
 
-        /** if forcing file starts before the model simulation,
-            skip over its starting records **/
-        fseek(infile, skip_recs * Nfields * sizeof(short int), SEEK_CUR);
-        if (feof(infile)) {
-            log_err("No data for the specified time period in the forcing "
-                    "file.");
+            /** if forcing file starts before the model simulation,
+                skip over its starting records **/
+            fseek(infile, skip_recs * Nfields * sizeof(short int), SEEK_CUR);
+            if (feof(infile)) {
+                log_err("No data for the specified time period in the forcing "
+                        "file.");
+            }
         }
 
         /** Read BINARY forcing data **/
-        rec = 0;
-
-        while (!feof(infile) && (rec * param_set.FORCE_DT[file_num] <
-                                 global_param.nrecs * global_param.dt)) {
-            for (i = 0; i < Nfields; i++) {
-                if (field_index[i] != ALBEDO && field_index[i] != LAI &&
-                    field_index[i] != FCANOPY) {
-                    if (param_set.TYPE[field_index[i]].SIGNED) {
-                        fread(&stmp, sizeof(short int), 1, infile);
-                        if (endian != param_set.FORCE_ENDIAN[file_num]) {
-                            stmp = ((stmp & 0xFF) << 8) | ((stmp >> 8) & 0xFF);
-                        }
-                        forcing_data[field_index[i]][rec] =
-                            (double) stmp /
-                            param_set.TYPE[field_index[i]].multiplier;
-                    }
-                    else {
-                        fread(&ustmp, sizeof(unsigned short int), 1, infile);
-                        if (endian != param_set.FORCE_ENDIAN[file_num]) {
-                            ustmp =
-                                ((ustmp & 0xFF) << 8) | ((ustmp >> 8) & 0xFF);
-                        }
-                        forcing_data[field_index[i]][rec] =
-                            (double) ustmp /
-                            param_set.TYPE[field_index[i]].multiplier;
-                    }
-                }
-                else {
-                    for (j = 0; j < param_set.TYPE[field_index[i]].N_ELEM;
-                         j++) {
-                        if (param_set.TYPE[field_index[i]].SIGNED) {
-                            fread(&stmp, sizeof(short int), 1, infile);
-                            if (endian != param_set.FORCE_ENDIAN[file_num]) {
-                                stmp =
-                                    ((stmp & 0xFF) << 8) | ((stmp >> 8) & 0xFF);
-                            }
-                            veg_hist_data[field_index[i]][j][rec] =
-                                (double) stmp /
-                                param_set.TYPE[field_index[i]].multiplier;
-                        }
-                        else {
-                            fread(&ustmp, sizeof(unsigned short int), 1,
-                                  infile);
-                            if (endian != param_set.FORCE_ENDIAN[file_num]) {
-                                ustmp =
-                                    ((ustmp &
-                                      0xFF) << 8) | ((ustmp >> 8) & 0xFF);
-                            }
-                            veg_hist_data[field_index[i]][j][rec] =
-                                (double) ustmp /
-                                param_set.TYPE[field_index[i]].multiplier;
-                        }
-                    }
-                }
-            }
-
-            rec++;
-        }
+        nfile_recs = (size_t) ceil(nrecs * global_param.dt /
+                                   param_set.FORCE_DT[file_num]);
+        rec = read_binary_forcing(infile, file_num, Nveg, nfile_recs,
+                                  endian != param_set.FORCE_ENDIAN[file_num],
+                                  forcing_data, veg_hist_data);
     }
 
     /**************************
@@ -213,10 +176,12 @@ read_atmos_data(FILE               *infile,
         // also read the headers if necessary).
 
         /* skip to the beginning of the required met data */
-        for (i = 0; i < skip_recs; i++) {
-            if (fgets(str, MAXSTRING, infile) == NULL) {
-                log_err("No data for the specified time period in the forcing "
-                        "file.");
+        if (rec0 == 0) {
+            for (i = 0; i < skip_recs; i++) {
+                if (fgets(str, MAXSTRING, infile) == NULL) {
+                    log_err("No data for the specified time period in the "
+                            "forcing file.");
+                }
             }
         }
 
@@ -224,15 +189,14 @@ read_atmos_data(FILE               *infile,
         rec = 0;
 
         while (!feof(infile) && (rec * param_set.FORCE_DT[file_num] <
-                                 global_param.nrecs * global_param.dt)) {
+                                 nrecs * global_param.dt)) {
             for (i = 0; i < Nfields; i++) {
                 if (field_index[i] != ALBEDO && field_index[i] != LAI &&
                     field_index[i] != FCANOPY) {
                     fscanf(infile, "%lf", &forcing_data[field_index[i]][rec]);
                 }
                 else {
-                    for (j = 0; j < param_set.TYPE[field_index[i]].N_ELEM;
-                         j++) {
+                    for (j = 0; j < Nveg; j++) {
                         fscanf(infile, "%lf",
                                &veg_hist_data[field_index[i]][j][rec]);
                     }
@@ -243,8 +207,8 @@ read_atmos_data(FILE               *infile,
         }
     }
 
-    if (rec * param_set.FORCE_DT[file_num] <
-        global_param.nrecs * global_param.dt) {
+    if (rec * param_set.FORCE_DT[file_num] < nrecs * global_param.dt) {
+        rec += rec_start;
         log_err("Not enough records in forcing file %i (%u * %f = %f) to run "
                 "the number of records defined in the global file "
                 "(%zu * %f = %f).  Check forcing file time step, and global "
@@ -0,0 +1,159 @@
+/******************************************************************************
+ * @section DESCRIPTION
+ *
+ * Read the records of a BINARY forcing file in one go.
+ *
+ * The bytes of the records read in one call (one forcing window) are mapped
+ * into memory, so the records are decoded straight from the page cache
+ * without being copied through the stdio buffer. Each column
+ * (forcing variable or vegetation tile) of the records is byte-swapped if
+ * needed, converted and scaled by one call to a tight loop that the compiler
+ * can vectorize. If the file is not a regular file or cannot be mapped, the
+ * records are read with a single fread() instead.
+ *
+ * @section LICENSE
+ *
+ * The Variable Infiltration Capacity (VIC) macroscale hydrological model
+ * Copyright (C) 2016 The Computational Hydrology Group, Department of Civil
+ * and Environmental Engineering, University of Washington.
+ *
+ * The VIC model is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *****************************************************************************/
+
+#include <vic_driver_classic.h>
+
+/******************************************************************************
+ * @brief    Read up to nrecs records of a BINARY forcing file, starting at
+ *           the current position of infile.
+ * @details  Only complete records are read. infile is left at the end of the
+ *           last record read, or of the last bytes read if it is a pipe.
+ *           Returns the number of records read.
+ *****************************************************************************/
+size_t
+read_binary_forcing(FILE     *infile,
+                    int       file_num,
+                    size_t    Nveg,
+                    size_t    nrecs,
+                    bool      swap,
+                    double  **forcing_data,
+                    double ***veg_hist_data)
+{
+    extern param_set_struct param_set;
+
+    size_t                  i;
+    size_t                  j;
+    size_t                  col;
+    size_t                  ncols;
+    size_t                  rec_bytes;
+    size_t                  n;
+    long                    offset;
+    long                    map_offset;
+    size_t                  map_size;
+    int                     type;
+    unsigned char          *map;
+    unsigned char          *buf;
+    unsigned char          *data;
+    struct stat             st;
+
+    // columns per record: 1 per variable, 1 per tile for veg timeseries
+    ncols = 0;
+    for (i = 0; i < param_set.N_TYPES[file_num]; i++) {
+        type = param_set.FORCE_INDEX[file_num][i];
+        if (type != ALBEDO && type != LAI && type != FCANOPY) {
+            ncols++;
+        }
+        else {
+            ncols += Nveg;
+        }
+    }
+    rec_bytes = ncols * sizeof(short int);
+    if (rec_bytes == 0) {
+        return nrecs;
+    }
+    if (nrecs == 0) {
+        return 0;
+    }
+
+    map = NULL;
+    buf = NULL;
+    n = nrecs;
+    offset = ftell(infile);
+    if (offset >= 0 && fstat(fileno(infile), &st) == 0 &&
+        S_ISREG(st.st_mode)) {
+        // only complete records
+        if (st.st_size <= offset) {
+            return 0;
+        }
+        if ((size_t) (st.st_size - offset) / rec_bytes < n) {
+            n = (size_t) (st.st_size - offset) / rec_bytes;
+        }
+        if (n == 0) {
+            return 0;
+        }
+        // map only the records read, mmap offsets must be multiples of the
+        // page size
+        map_offset = offset - offset % sysconf(_SC_PAGESIZE);
+        map_size = (size_t) (offset - map_offset) + n * rec_bytes;
+        map = mmap(NULL, map_size, PROT_READ, MAP_PRIVATE, fileno(infile),
+                   (off_t) map_offset);
+        if (map == MAP_FAILED) {
+            map = NULL;
+        }
+    }
+
+    if (map != NULL) {
+        data = map + (offset - map_offset);
+    }
+    else {
+        // the size of a pipe is unknown, fread reads complete records only
+        buf = malloc(n * rec_bytes);
+        check_alloc_status(buf, "Memory allocation error.");
+        n = fread(buf, rec_bytes, n, infile);
+        if (ferror(infile)) {
+            log_err("Unable to read forcing file %d", file_num + 1);
+        }
+        data = buf;
+    }
+
+    col = 0;
+    for (i = 0; i < param_set.N_TYPES[file_num]; i++) {
+        type = param_set.FORCE_INDEX[file_num][i];
+        if (type != ALBEDO && type != LAI && type != FCANOPY) {
+            decode_binary_forcing(data + col * sizeof(short int), rec_bytes,
+                                  n, swap, param_set.TYPE[type].SIGNED,
+                                  param_set.TYPE[type].multiplier,
+                                  forcing_data[type]);
+            col++;
+        }
+        else {
+            for (j = 0; j < Nveg; j++) {
+                decode_binary_forcing(data + col * sizeof(short int),
+                                      rec_bytes, n, swap,
+                                      param_set.TYPE[type].SIGNED,
+                                      param_set.TYPE[type].multiplier,
+                                      veg_hist_data[type][j]);
+                col++;
+            }
+        }
+    }
+
+    if (map != NULL) {
+        munmap(map, map_size);
+        fseek(infile, offset + (long) (n * rec_bytes), SEEK_SET);
+    }
+    free(buf);
+
+    return n;
+}
@@ -31,10 +31,16 @@
 /******************************************************************************
  * @brief    Control the order and number of forcing variables read from the
  *           forcing data files.
+ * @details  Reads the nrecs model timesteps that start at rec0, see
+ *           read_atmos_data(). Nveg is the number of vegetation tiles of the
+ *           grid cell, for which vegetation timeseries are read.
  *****************************************************************************/
 double **
 read_forcing_data(FILE              **infile,
                   global_param_struct global_param,
+                  size_t              Nveg,
+                  size_t              rec0,
+                  size_t              nrecs,
                   double          ****veg_hist_data)
 {
     extern param_set_struct param_set;
@@ -51,17 +57,17 @@ read_forcing_data(FILE              **infile,
     for (i = 0; i < N_FORCING_TYPES; i++) {
         if (param_set.TYPE[i].SUPPLIED) {
             if (i != ALBEDO && i != LAI && i != FCANOPY) {
-                forcing_data[i] = calloc(global_param.nrecs * NF,
+                forcing_data[i] = calloc(nrecs * NF,
                                          sizeof(*(forcing_data[i])));
                 check_alloc_status(forcing_data[i], "Memory allocation error.");
             }
             else {
-                (*veg_hist_data)[i] = calloc(param_set.TYPE[i].N_ELEM,
+                (*veg_hist_data)[i] = calloc(Nveg,
                                              sizeof(*((*veg_hist_data)[i])));
                 check_alloc_status((*veg_hist_data)[i],
                                    "Memory allocation error.");
-                for (j = 0; j < param_set.TYPE[i].N_ELEM; j++) {
-                    (*veg_hist_data)[i][j] = calloc(global_param.nrecs * NF,
+                for (j = 0; j < Nveg; j++) {
+                    (*veg_hist_data)[i][j] = calloc(nrecs * NF,
                                                     sizeof(*((*veg_hist_data)[i]
                                                              [j])));
                     check_alloc_status((*veg_hist_data)[i][j],
@@ -74,7 +80,7 @@ read_forcing_data(FILE              **infile,
     /** Read First Forcing Data File **/
     if (param_set.FORCE_DT[0] > 0) {
         read_atmos_data(infile[0], global_param, 0, global_param.forceskip[0],
-                        forcing_data, (*veg_hist_data));
+                        Nveg, rec0, nrecs, forcing_data, (*veg_hist_data));
     }
     else {
         log_err("File time step must be defined for at least the first "
@@ -84,7 +90,7 @@ read_forcing_data(FILE              **infile,
     /** Read Second Forcing Data File **/
     if (param_set.FORCE_DT[1] > 0) {
         read_atmos_data(infile[1], global_param, 1, global_param.forceskip[1],
-                        forcing_data, (*veg_hist_data));
+                        Nveg, rec0, nrecs, forcing_data, (*veg_hist_data));
     }
 
     return(forcing_data);
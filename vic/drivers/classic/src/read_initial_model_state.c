@@ -45,27 +45,27 @@ read_initial_model_state(FILE            *init_state,
                          soil_con_struct *soil_con,
                          lake_con_struct  lake_con)
 {
-    extern option_struct options;
-
-    char                 tmpstr[MAXSTRING];
-    char                 tmpchar;
-    int                  veg, iveg;
-    int                  band, iband;
-    size_t               lidx;
-    size_t               nidx;
-    int                  tmp_cellnum;
-    int                  tmp_Nveg;
-    int                  tmp_Nband;
-    int                  tmp_char;
-    int                  byte, Nbytes;
-    int                  node;
-    size_t               frost_area;
-
-    cell_data_struct   **cell;
-    snow_data_struct   **snow;
-    energy_bal_struct  **energy;
-    veg_var_struct     **veg_var;
-    lake_var_struct     *lake_var;
+    extern option_struct      options;
+    extern param_index_struct init_state_index;
+
+    char                      tmpstr[MAXSTRING];
+    int                       veg, iveg;
+    int                       band, iband;
+    size_t                    lidx;
+    size_t                    nidx;
+    int                       tmp_cellnum;
+    int                       tmp_Nveg;
+    int                       tmp_Nband;
+    int                       tmp_char;
+    int                       Nbytes;
+    int                       node;
+    size_t                    frost_area;
+
+    cell_data_struct        **cell;
+    snow_data_struct        **snow;
+    energy_bal_struct       **energy;
+    veg_var_struct          **veg_var;
+    lake_var_struct          *lake_var;
 
     cell = all_vars->cell;
     veg_var = all_vars->veg_var;
@@ -73,6 +73,13 @@ read_initial_model_state(FILE            *init_state,
     energy = all_vars->energy;
     lake_var = &all_vars->lake_var;
 
+    // go straight to the record of the cell if the file is indexed
+    if (init_state_index.n > 0 &&
+        !seek_param_index(&init_state_index, init_state, cellnum)) {
+        log_err("Requested grid cell (%d) is not in the model state file.",
+                cellnum);
+    }
+
     /* read cell information */
     if (options.STATE_FORMAT == BINARY) {
         fread(&tmp_cellnum, sizeof(int), 1, init_state);
@@ -87,9 +94,7 @@ read_initial_model_state(FILE            *init_state,
     while (tmp_cellnum != cellnum && !feof(init_state)) {
         if (options.STATE_FORMAT == BINARY) {
             // skip rest of current cells info
-            for (byte = 0; byte < Nbytes; byte++) {
-                fread(&tmpchar, 1, 1, init_state);
-            }
+            fseek(init_state, Nbytes, SEEK_CUR);
             // read info for next cell
             fread(&tmp_cellnum, sizeof(int), 1, init_state);
             fread(&tmp_Nveg, sizeof(int), 1, init_state);
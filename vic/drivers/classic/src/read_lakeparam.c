@@ -37,29 +37,41 @@ read_lakeparam(FILE           *lakeparam,
                soil_con_struct soil_con,
                veg_con_struct *veg_con)
 {
-    extern option_struct options;
+    extern option_struct      options;
+    extern param_index_struct lakeparam_index;
 
-    size_t               i;
-    unsigned int         lakecel;
-    char                 tmpstr[MAXSTRING + 1];
+    bool                      found;
+    size_t                    i;
+    unsigned int              lakecel;
+    char                      tmpstr[MAXSTRING + 1];
 
-    lake_con_struct      temp;
+    lake_con_struct           temp;
 
     /*******************************************************************/
     /* Read in general lake parameters.                           */
     /******************************************************************/
 
-    fscanf(lakeparam, "%u %d", &lakecel, &temp.lake_idx);
-    while (lakecel != soil_con.gridcel && !feof(lakeparam)) {
-        fgets(tmpstr, MAXSTRING, lakeparam); // grid cell number, etc.
-        if (temp.lake_idx >= 0) {
-            fgets(tmpstr, MAXSTRING, lakeparam); // lake depth-area relationship
+    if (lakeparam_index.n > 0) {
+        found = seek_param_index(&lakeparam_index, lakeparam,
+                                 soil_con.gridcel);
+        if (found) {
+            fscanf(lakeparam, "%u %d", &lakecel, &temp.lake_idx);
         }
+    }
+    else {
         fscanf(lakeparam, "%u %d", &lakecel, &temp.lake_idx);
+        while (lakecel != soil_con.gridcel && !feof(lakeparam)) {
+            fgets(tmpstr, MAXSTRING, lakeparam); // grid cell number, etc.
+            if (temp.lake_idx >= 0) {
+                fgets(tmpstr, MAXSTRING, lakeparam); // lake depth-area relationship
+            }
+            fscanf(lakeparam, "%u %d", &lakecel, &temp.lake_idx);
+        }
+        found = !feof(lakeparam);
     }
 
     // cell number not found
-    if (feof(lakeparam)) {
+    if (!found) {
         log_err("Unable to find cell %d in the lake parameter file",
                 soil_con.gridcel);
     }
@@ -35,30 +35,42 @@ void
 read_snowband(FILE            *snowband,
               soil_con_struct *soil_con)
 {
-    extern option_struct     options;
-    extern parameters_struct param;
+    extern option_struct      options;
+    extern parameters_struct  param;
+    extern param_index_struct snowband_index;
 
-    char                     ErrStr[MAXSTRING];
-    size_t                   band;
-    size_t                   Nbands;
-    unsigned int             cell;
-    double                   total;
-    double                   area_fract;
-    double                   prec_frac;
-    double                   band_elev;
-    double                   avg_elev;
+    char                      ErrStr[MAXSTRING];
+    bool                      found;
+    size_t                    band;
+    size_t                    Nbands;
+    unsigned int              cell;
+    double                    total;
+    double                    area_fract;
+    double                    prec_frac;
+    double                    band_elev;
+    double                    avg_elev;
 
     Nbands = options.SNOW_BAND;
 
     if (Nbands > 1) {
         /** Find Current Grid Cell in SnowBand File **/
-        fscanf(snowband, "%d", &cell);
-        while (cell != soil_con->gridcel && !feof(snowband)) {
-            fgets(ErrStr, MAXSTRING, snowband);
+        if (snowband_index.n > 0) {
+            found = seek_param_index(&snowband_index, snowband,
+                                     soil_con->gridcel);
+            if (found) {
+                fscanf(snowband, "%d", &cell);
+            }
+        }
+        else {
             fscanf(snowband, "%d", &cell);
+            while (cell != soil_con->gridcel && !feof(snowband)) {
+                fgets(ErrStr, MAXSTRING, snowband);
+                fscanf(snowband, "%d", &cell);
+            }
+            found = !feof(snowband);
         }
 
-        if (feof(snowband)) {
+        if (!found) {
             log_warn("Cannot find current gridcell (%i) in snow band file; "
                      "setting cell to have one elevation band.",
                      soil_con->gridcel);
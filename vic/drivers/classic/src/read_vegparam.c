@@ -38,29 +38,30 @@ read_vegparam(FILE  *vegparam,
               size_t Nveg_type)
 {
     void ttrim(char *string);
-    extern veg_lib_struct   *veg_lib;
-    extern option_struct     options;
-    extern parameters_struct param;
-
-    veg_con_struct          *temp;
-    size_t                   j;
-    int                      vegetat_type_num;
-    int                      vegcel, i, k, skip, veg_class;
-    int                      MaxVeg;
-    int                      Nfields, NfieldsMax;
-    int                      NoOverstory;
-    double                   depth_sum;
-    double                   sum;
-    double                   Cv_sum;
-    char                     str[MAX_VEGPARAM_LINE_LENGTH];
-    char                     line[MAXSTRING];
-    char                     tmpline[MAXSTRING];
-    const char               delimiters[] = " \t";
-    char                    *token;
-    char                    *vegarr[MAX_VEGPARAM_LINE_LENGTH];
-    size_t                   length;
-    size_t                   cidx;
-    double                   tmp;
+    extern veg_lib_struct    *veg_lib;
+    extern option_struct      options;
+    extern parameters_struct  param;
+    extern param_index_struct vegparam_index;
+
+    veg_con_struct           *temp;
+    size_t                    j;
+    int                       vegetat_type_num;
+    int                       vegcel, i, k, skip, veg_class;
+    int                       MaxVeg;
+    int                       Nfields, NfieldsMax;
+    int                       NoOverstory;
+    double                    depth_sum;
+    double                    sum;
+    double                    Cv_sum;
+    char                      str[MAX_VEGPARAM_LINE_LENGTH];
+    char                      line[MAXSTRING];
+    char                      tmpline[MAXSTRING];
+    const char                delimiters[] = " \t";
+    char                     *token;
+    char                     *vegarr[MAX_VEGPARAM_LINE_LENGTH];
+    size_t                    length;
+    size_t                    cidx;
+    double                    tmp;
 
     skip = 1;
     if (options.VEGPARAM_LAI) {
@@ -75,6 +76,12 @@ read_vegparam(FILE  *vegparam,
 
     NoOverstory = 0;
 
+    // go straight to the record of the cell if the file is indexed
+    if (vegparam_index.n > 0 &&
+        !seek_param_index(&vegparam_index, vegparam, gridcel)) {
+        log_err("Grid cell %d not found", gridcel);
+    }
+
     while ((fscanf(vegparam, "%d %d", &vegcel,
                    &vegetat_type_num) == 2) && vegcel != gridcel) {
         if (vegetat_type_num < 0) {
@@ -42,11 +42,18 @@ parameters_struct   param;
 filenames_struct    filenames;
 filep_struct        filep;
 metadata_struct     out_metadata[N_OUTVAR_TYPES];
+state_queue_struct  state_queue;
+param_index_struct  vegparam_index;
+param_index_struct  snowband_index;
+param_index_struct  lakeparam_index;
+param_index_struct  init_state_index;
 
 /******************************************************************************
  * @brief   Classic driver of the VIC model
  * @details The classic driver runs VIC for a single grid cell for all
- *          timesteps before moving on to the next grid cell.
+ *          timesteps before moving on to the next grid cell. When compiled
+ *          with OpenMP, the master thread reads the parameters of the cells
+ *          and the cells are run by all threads at the same time.
  *
  * @param argc Argument count
  * @param argv Argument vector
@@ -60,26 +67,13 @@ main(int   argc,
 
     bool               MODEL_DONE;
     bool               RUN_MODEL;
-    char               dmy_str[MAXSTRING];
-    size_t             rec;
     size_t             Nveg_type;
     int                cellnum;
     int                startrec;
-    int                ErrorFlag;
-    int                n;
-    size_t             streamnum;
     dmy_struct        *dmy;
-    force_data_struct *force;
-    veg_hist_struct  **veg_hist;
-    veg_con_struct    *veg_con;
-    soil_con_struct    soil_con;
-    all_vars_struct    all_vars;
-    lake_con_struct    lake_con;
+    cell_task_struct  *cell;
     stream_struct     *streams = NULL;
-    double          ***out_data;   // [1, nvars, nelem]
-    save_data_struct   save_data;
     timer_struct       global_timers[N_TIMERS];
-    timer_struct       cell_timer;
 
     // start vic all timer
     timer_start(&(global_timers[TIMER_VIC_ALL]));
@@ -121,14 +115,8 @@ main(int   argc,
     initialize_time();
     dmy = make_dmy(&global_param);
 
-    // Allocate memory for out_data
-    out_data = malloc(1 * sizeof(*out_data));
-    check_alloc_status(out_data, "Memory allocation error.");
-
     /** Set up output data structures **/
     set_output_met_data_info();
-    // out_data is shape [ngridcells (1), N_OUTVAR_TYPES]
-    alloc_out_data(1, out_data);
     filep.globalparam = open_file(filenames.global, "r");
     parse_output_info(filep.globalparam, &streams, &(dmy[0]));
     validate_streams(&streams);
@@ -136,21 +124,38 @@ main(int   argc,
     /** Check and Open Files **/
     check_files(&filep, &filenames);
 
+    /** Index the Grid Cells in the Parameter Files **/
+    get_param_index(filenames.veg, filep.vegparam, PARAM_INDEX_VEGPARAM,
+                    &vegparam_index);
+    if (options.SNOW_BAND > 1) {
+        get_param_index(filenames.snowband, filep.snowband,
+                        PARAM_INDEX_SNOWBAND, &snowband_index);
+    }
+    if (options.LAKES) {
+        get_param_index(filenames.lakeparam, filep.lakeparam,
+                        PARAM_INDEX_LAKEPARAM, &lakeparam_index);
+    }
+
     /** Read Vegetation Library File **/
     veg_lib = read_veglib(filep.veglib, &Nveg_type);
 
     /** Initialize Parameters **/
     cellnum = -1;
 
-    /** allocate memory for the force_data_struct **/
-    alloc_atmos(global_param.nrecs, &force);
-
     /** Initial state **/
     startrec = 0;
     if (options.INIT_STATE) {
         filep.init_state = check_state_file(filenames.init_state,
                                             options.Nlayer, options.Nnode,
                                             &startrec);
+        if (options.STATE_FORMAT == BINARY) {
+            get_param_index(filenames.init_state, filep.init_state,
+                            PARAM_INDEX_STATE_BINARY, &init_state_index);
+        }
+        else {
+            get_param_index(filenames.init_state, filep.init_state,
+                            PARAM_INDEX_STATE_ASCII, &init_state_index);
+        }
     }
 
     /** open state file if model state is to be saved **/
@@ -173,152 +178,64 @@ main(int   argc,
     // start vic run timer
     timer_start(&(global_timers[TIMER_VIC_RUN]));
 
-    while (!MODEL_DONE) {
-        read_soilparam(filep.soilparam, &soil_con, &RUN_MODEL, &MODEL_DONE);
-
-        if (RUN_MODEL) {
-            cellnum++;
-
-            /** Read Grid Cell Vegetation Parameters **/
-            veg_con = read_vegparam(filep.vegparam, soil_con.gridcel,
-                                    Nveg_type);
-            calc_root_fractions(veg_con, &soil_con);
-
-            if (options.LAKES) {
-                lake_con =
-                    read_lakeparam(filep.lakeparam, soil_con, veg_con);
-            }
-
-            /** Build Gridded Filenames, and Open **/
-            make_in_and_outfiles(&filep, &filenames, &soil_con,
-                                 &streams, dmy);
-
-            /** Reset agg_alarm for Each Stream **/
-            for (streamnum = 0;
-                 streamnum < (size_t) options.Noutstreams;
-                 streamnum++) {
-                n = streams[streamnum].agg_alarm.n;
-                set_alarm(&(dmy[0]), streams[streamnum].agg_alarm.freq,
-                          &n,
-                          &(streams[streamnum].agg_alarm));
-            }
-
-            /** Read Elevation Band Data if Used **/
-            read_snowband(filep.snowband, &soil_con);
-
-            /** Make Top-level Control Structure **/
-            all_vars = make_all_vars(veg_con[0].vegetat_type_num);
-
-            /** allocate memory for the veg_hist_struct **/
-            alloc_veg_hist(global_param.nrecs, veg_con[0].vegetat_type_num,
-                           &veg_hist);
-
-            /**************************************************
-               Initialize Meteological Forcing Values That
-               Have not Been Specifically Set
-            **************************************************/
-
-            vic_force(force, dmy, filep.forcing, veg_con, veg_hist, &soil_con);
-
-            /**************************************************
-               Initialize Energy Balance and Snow Variables
-            **************************************************/
-
-            vic_populate_model_state(&all_vars, filep, soil_con.gridcel,
-                                     &soil_con, veg_con, lake_con, &(dmy[0]));
-
-            /** Initialize the storage terms in the water and energy balances **/
-            initialize_save_data(&all_vars, &force[0], &soil_con, veg_con,
-                                 veg_lib, &lake_con, out_data[0], &save_data,
-                                 &cell_timer);
-
-            /******************************************
-               Run Model in Grid Cell for all Time Steps
-            ******************************************/
-
-            for (rec = startrec; rec < global_param.nrecs; rec++) {
-                // Set global reference string (for debugging inside vic_run)
-                sprint_dmy(dmy_str, &(dmy[rec]));
-                sprintf(vic_run_ref_str,
-                        "Gridcell cellnum: %i, timestep info: %s",
-                        cellnum, dmy_str);
-
-                /**************************************************
-                   Update data structures for current time step
-                **************************************************/
-                ErrorFlag = update_step_vars(&all_vars, veg_con,
-                                             veg_hist[rec]);
-
-                /**************************************************
-                   Compute cell physics for 1 timestep
-                **************************************************/
-                timer_start(&cell_timer);
-                ErrorFlag = vic_run(&force[rec], &all_vars,
-                                    &(dmy[rec]), &global_param, &lake_con,
-                                    &soil_con, veg_con, veg_lib);
-                timer_stop(&cell_timer);
-
-                /**************************************************
-                   Calculate cell average values for current time step
-                **************************************************/
-                put_data(&all_vars, &force[rec], &soil_con, veg_con, veg_lib,
-                         &lake_con, out_data[0], &save_data, &cell_timer);
-
-                for (streamnum = 0;
-                     streamnum < options.Noutstreams;
-                     streamnum++) {
-                    agg_stream_data(&(streams[streamnum]), &(dmy[rec]),
-                                    out_data);
-                }
-
-                // Write cell average values for current time step
-                write_output(&streams, &dmy[rec]);
-
-                /************************************
-                   Save model state at assigned date
-                   (after the final time step of the assigned date)
-                ************************************/
-                if (filep.statefile != NULL &&
-                    check_save_state_flag(dmy, rec)) {
-                    write_model_state(&all_vars, veg_con->vegetat_type_num,
-                                      soil_con.gridcel, &filep, &soil_con);
-                }
-
-
-                if (ErrorFlag == ERROR) {
-                    if (options.CONTINUEONERROR) {
-                        // Handle grid cell solution error
-                        log_warn("ERROR: Grid cell %i failed in record %zu "
-                                 "so the simulation has not finished.  An "
-                                 "incomplete output file has been "
-                                 "generated, check your inputs before "
-                                 "rerunning the simulation.",
-                                 soil_con.gridcel, rec);
-                        break;
+    #pragma omp parallel default(shared)
+    {
+        #pragma omp single
+        {
+            while (!MODEL_DONE) {
+                cell = malloc(sizeof(*cell));
+                check_alloc_status(cell, "Memory allocation error.");
+
+                read_soilparam(filep.soilparam, &(cell->soil_con), &RUN_MODEL,
+                               &MODEL_DONE);
+
+                if (RUN_MODEL) {
+                    cellnum++;
+                    cell->cellnum = cellnum;
+
+                    /** Read Grid Cell Vegetation Parameters **/
+                    cell->veg_con = read_vegparam(filep.vegparam,
+                                                  cell->soil_con.gridcel,
+                                                  Nveg_type);
+                    calc_root_fractions(cell->veg_con, &(cell->soil_con));
+
+                    if (options.LAKES) {
+                        cell->lake_con = read_lakeparam(filep.lakeparam,
+                                                        cell->soil_con,
+                                                        cell->veg_con);
                     }
-                    else {
-                        // Else exit program on cell solution error as in previous versions
-                        log_err("ERROR: Grid cell %i failed in record %zu "
-                                "so the simulation has ended. Check your "
-                                "inputs before rerunning the simulation.",
-                                soil_con.gridcel, rec);
+
+                    /** Read Elevation Band Data if Used **/
+                    read_snowband(filep.snowband, &(cell->soil_con));
+
+                    /** Make Top-level Control Structure **/
+                    cell->all_vars =
+                        make_all_vars(cell->veg_con[0].vegetat_type_num);
+
+                    /**************************************************
+                       Initialize Energy Balance and Snow Variables
+                       (the initial state file is read in cell order)
+                    **************************************************/
+
+                    vic_populate_model_state(&(cell->all_vars), filep,
+                                             cell->soil_con.gridcel,
+                                             &(cell->soil_con),
+                                             cell->veg_con, cell->lake_con,
+                                             &(dmy[0]));
+
+                    /** Run the cell on the next free thread **/
+                    #pragma omp task firstprivate(cell)
+                    {
+                        vic_classic_run_cell(cell, dmy, streams, startrec);
+                        free(cell);
                     }
+                } /* End Run Model Condition */
+                else {
+                    free(cell);
                 }
-            } /* End Rec Loop */
-
-            close_files(&filep, &streams);
-
-            free_veg_hist(global_param.nrecs, veg_con[0].vegetat_type_num,
-                          &veg_hist);
-            free_all_vars(&all_vars, veg_con[0].vegetat_type_num);
-            free_vegcon(&veg_con);
-            free((char *) soil_con.AreaFract);
-            free((char *) soil_con.BandElev);
-            free((char *) soil_con.Tfactor);
-            free((char *) soil_con.Pfactor);
-            free((char *) soil_con.AboveTreeLine);
-        } /* End Run Model Condition */
-    }   /* End Grid Loop */
+            }   /* End Grid Loop */
+        }
+    }
 
     // stop vic run timer
     timer_stop(&(global_timers[TIMER_VIC_RUN]));
@@ -326,22 +243,25 @@ main(int   argc,
     timer_start(&(global_timers[TIMER_VIC_FINAL]));
 
     /** cleanup **/
-    free_atmos(global_param.nrecs, &force);
     free_dmy(&dmy);
     free_streams(&streams);
-    free_out_data(1, out_data);  // 1 is for the number of gridcells, 1 in classic driver
+    free_state_queue();
     fclose(filep.soilparam);
     free_veglib(&veg_lib);
     fclose(filep.vegparam);
+    free_param_index(&vegparam_index);
     fclose(filep.veglib);
     if (options.SNOW_BAND > 1) {
         fclose(filep.snowband);
+        free_param_index(&snowband_index);
     }
     if (options.LAKES) {
         fclose(filep.lakeparam);
+        free_param_index(&lakeparam_index);
     }
     if (options.INIT_STATE) {
         fclose(filep.init_state);
+        free_param_index(&init_state_index);
     }
     if (options.SAVE_STATE && strcmp(filenames.statefile, "NONE") != 0) {
         fclose(filep.statefile);
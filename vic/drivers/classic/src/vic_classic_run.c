@@ -0,0 +1,391 @@
+/******************************************************************************
+ * @section DESCRIPTION
+ *
+ * Run the classic driver for a single grid cell.
+ *
+ * The cells of the classic driver are independent of each other. The main
+ * program reads the parameters of one cell after the other and hands each
+ * cell to a thread, which reads its forcing, runs it for all timesteps and
+ * writes its output files. The model states that are saved for the cells are
+ * collected here and written to the state file in the order of the cells.
+ *
+ * With FORCE_BLOCK_STEPS > 0 the forcing of a cell is read in windows of
+ * FORCE_BLOCK_STEPS timesteps instead of for the whole simulation period at
+ * once. Two windows are kept in memory: the one that is being run and the next
+ * one, which is read by a separate task in the meantime.
+ *
+ * @section LICENSE
+ *
+ * The Variable Infiltration Capacity (VIC) macroscale hydrological model
+ * Copyright (C) 2016 The Computational Hydrology Group, Department of Civil
+ * and Environmental Engineering, University of Washington.
+ *
+ * The VIC model is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *****************************************************************************/
+
+#include <vic_driver_classic.h>
+
+/******************************************************************************
+ * @brief    Run a grid cell for all timesteps and free it.
+ * @details  All files, output streams, work arrays and the scratch arena of
+ *           the cell are private to the calling thread, so several cells can
+ *           be run at the same time.
+ *****************************************************************************/
+void
+vic_classic_run_cell(cell_task_struct *cell,
+                     dmy_struct       *dmy,
+                     stream_struct    *streams,
+                     int               startrec)
+{
+    extern filenames_struct    filenames;
+    extern filep_struct        filep;
+    extern global_param_struct global_param;
+    extern option_struct       options;
+    extern veg_lib_struct     *veg_lib;
+
+    char                       dmy_str[MAXSTRING];
+    int                        ErrorFlag;
+    size_t                     rec;
+    size_t                     streamnum;
+    size_t                     Nveg;
+    size_t                     b;
+    size_t                     nbuf;
+    size_t                     nwindow;
+    size_t                     win;
+    size_t                     win_start[2];
+    size_t                     win_nrecs[2];
+    size_t                     rstart;
+    size_t                     rnrecs;
+    filep_struct               cell_filep;
+    filenames_struct          *cell_filenames;
+    force_data_struct         *force[2];
+    veg_hist_struct          **veg_hist[2];
+    stream_struct             *cell_streams;
+    double                  ***out_data; // [1, nvars, nelem]
+    save_data_struct           save_data;
+    timer_struct               cell_timer;
+    scratch_arena_struct       scratch;
+
+    Nveg = cell->veg_con[0].vegetat_type_num;
+
+    // the forcing, output and state files of the cell are opened here
+    cell_filep = filep;
+    cell_filep.statefile = NULL;
+    cell_filenames = malloc(sizeof(*cell_filenames));
+    check_alloc_status(cell_filenames, "Memory allocation error.");
+    *cell_filenames = filenames;
+
+    /** Output streams and data of the cell **/
+    cell_streams = copy_streams(streams, dmy);
+    out_data = malloc(1 * sizeof(*out_data));
+    check_alloc_status(out_data, "Memory allocation error.");
+    alloc_out_data(1, out_data);
+    initialize_scratch_arena(&scratch);
+
+    /** allocate memory for the force_data_struct and veg_hist_struct **/
+    if (options.FORCE_BLOCK_STEPS > 0 &&
+        options.FORCE_BLOCK_STEPS < global_param.nrecs) {
+        nwindow = options.FORCE_BLOCK_STEPS;
+        nbuf = 2;
+    }
+    else {
+        nwindow = global_param.nrecs;
+        nbuf = 1;
+    }
+    for (b = 0; b < nbuf; b++) {
+        alloc_atmos(nwindow, &force[b]);
+        alloc_veg_hist(nwindow, Nveg, &veg_hist[b]);
+    }
+
+    /** Build Gridded Filenames, and Open **/
+    make_in_and_outfiles(&cell_filep, cell_filenames, &(cell->soil_con),
+                         &cell_streams, dmy);
+
+    /**************************************************
+       Initialize Meteological Forcing Values That
+       Have not Been Specifically Set
+    **************************************************/
+
+    win = 0;
+    win_start[win] = 0;
+    win_nrecs[win] = nwindow;
+    vic_force(force[win], dmy, cell_filep.forcing, cell->veg_con,
+              veg_hist[win], &(cell->soil_con), win_start[win],
+              win_nrecs[win]);
+
+    // read the second window while the first one is run
+    if (nbuf > 1) {
+        b = 1 - win;
+        rstart = win_start[win] + win_nrecs[win];
+        rnrecs = min(nwindow, global_param.nrecs - rstart);
+        win_start[b] = rstart;
+        win_nrecs[b] = rnrecs;
+        #pragma omp task firstprivate(b, rstart, rnrecs)
+        vic_force(force[b], dmy, cell_filep.forcing, cell->veg_con,
+                  veg_hist[b], &(cell->soil_con), rstart, rnrecs);
+    }
+
+    /** Initialize the storage terms in the water and energy balances **/
+    initialize_save_data(&(cell->all_vars), &force[win][0], &(cell->soil_con),
+                         cell->veg_con, veg_lib, &(cell->lake_con),
+                         out_data[0], &save_data, &cell_timer);
+
+    /******************************************
+       Run Model in Grid Cell for all Time Steps
+    ******************************************/
+
+    for (rec = startrec; rec < global_param.nrecs; rec++) {
+        /**************************************************
+           Switch to the next window of forcing, and start
+           reading the one after it
+        **************************************************/
+        while (rec >= win_start[win] + win_nrecs[win]) {
+            #pragma omp taskwait
+            b = win;
+            win = 1 - win;
+            rstart = win_start[win] + win_nrecs[win];
+            if (rstart < global_param.nrecs) {
+                rnrecs = min(nwindow, global_param.nrecs - rstart);
+                win_start[b] = rstart;
+                win_nrecs[b] = rnrecs;
+                #pragma omp task firstprivate(b, rstart, rnrecs)
+                vic_force(force[b], dmy, cell_filep.forcing, cell->veg_con,
+                          veg_hist[b], &(cell->soil_con), rstart, rnrecs);
+            }
+        }
+
+        // Set the thread's reference string (for debugging inside vic_run)
+        sprint_dmy(dmy_str, &(dmy[rec]));
+        sprintf(vic_run_ref_str, "Gridcell cellnum: %i, timestep info: %s",
+                cell->cellnum, dmy_str);
+
+        /**************************************************
+           Update data structures for current time step
+        **************************************************/
+        ErrorFlag = update_step_vars(&(cell->all_vars), cell->veg_con,
+                                     veg_hist[win][rec - win_start[win]]);
+
+        /**************************************************
+           Compute cell physics for 1 timestep
+        **************************************************/
+        timer_start(&cell_timer);
+        ErrorFlag = vic_run(&force[win][rec - win_start[win]],
+                            &(cell->all_vars), &(dmy[rec]),
+                            &global_param, &(cell->lake_con),
+                            &(cell->soil_con), cell->veg_con, veg_lib,
+                            &scratch);
+        timer_stop(&cell_timer);
+
+        /**************************************************
+           Calculate cell average values for current time step
+        **************************************************/
+        put_data(&(cell->all_vars), &force[win][rec - win_start[win]],
+                 &(cell->soil_con), cell->veg_con, veg_lib, &(cell->lake_con),
+                 out_data[0], &save_data, &cell_timer);
+
+        for (streamnum = 0; streamnum < options.Noutstreams; streamnum++) {
+            agg_stream_data(&(cell_streams[streamnum]), &(dmy[rec]),
+                            out_data);
+        }
+
+        // Write cell average values for current time step
+        write_output(&cell_streams, &dmy[rec], &scratch);
+
+        /************************************
+           Save model state at assigned date
+           (after the final time step of the assigned date)
+        ************************************/
+        if (filep.statefile != NULL && check_save_state_flag(dmy, rec)) {
+            if (cell_filep.statefile == NULL) {
+                cell_filep.statefile = tmpfile();
+                if (cell_filep.statefile == NULL) {
+                    log_err("Unable to open a temporary state file for "
+                            "grid cell %i", cell->soil_con.gridcel);
+                }
+            }
+            write_model_state(&(cell->all_vars), Nveg,
+                              cell->soil_con.gridcel, &cell_filep,
+                              &(cell->soil_con));
+        }
+
+        if (ErrorFlag == ERROR) {
+            if (options.CONTINUEONERROR) {
+                // Handle grid cell solution error
+                log_warn("ERROR: Grid cell %i failed in record %zu "
+                         "so the simulation has not finished.  An "
+                         "incomplete output file has been "
+                         "generated, check your inputs before "
+                         "rerunning the simulation.",
+                         cell->soil_con.gridcel, rec);
+                break;
+            }
+            else {
+                // Else exit program on cell solution error as in previous versions
+                log_err("ERROR: Grid cell %i failed in record %zu "
+                        "so the simulation has ended. Check your "
+                        "inputs before rerunning the simulation.",
+                        cell->soil_con.gridcel, rec);
+            }
+        }
+    } /* End Rec Loop */
+
+    // a window may still be read if the cell stopped early
+    #pragma omp taskwait
+
+    close_files(&cell_filep, &cell_streams);
+    if (filep.statefile != NULL) {
+        put_cell_state(cell->cellnum, cell_filep.statefile);
+    }
+
+    free_cell_streams(&cell_streams);
+    free_out_data(1, out_data);
+    scratch_free(&scratch);
+    for (b = 0; b < nbuf; b++) {
+        free_atmos(nwindow, &force[b]);
+        free_veg_hist(nwindow, Nveg, &veg_hist[b]);
+    }
+    free(cell_filenames);
+    free_all_vars(&(cell->all_vars), Nveg);
+    free_vegcon(&(cell->veg_con));
+    free((char *) cell->soil_con.AreaFract);
+    free((char *) cell->soil_con.BandElev);
+    free((char *) cell->soil_con.Tfactor);
+    free((char *) cell->soil_con.Pfactor);
+    free((char *) cell->soil_con.AboveTreeLine);
+}
+
+/******************************************************************************
+ * @brief    Make a copy of the output streams for a single grid cell.
+ * @details  The copies share the variable lists of streams, but have their
+ *           own aggregation data, alarms and output file.
+ *****************************************************************************/
+stream_struct *
+copy_streams(stream_struct *streams,
+             dmy_struct    *dmy)
+{
+    extern option_struct options;
+
+    size_t               streamnum;
+    int                  n;
+    stream_struct       *cell_streams;
+
+    cell_streams = malloc(options.Noutstreams * sizeof(*cell_streams));
+    check_alloc_status(cell_streams, "Memory allocation error.");
+
+    for (streamnum = 0; streamnum < options.Noutstreams; streamnum++) {
+        cell_streams[streamnum] = streams[streamnum];
+        alloc_aggdata(&(cell_streams[streamnum]));
+
+        /** Reset agg_alarm for Each Stream **/
+        n = cell_streams[streamnum].agg_alarm.n;
+        set_alarm(&(dmy[0]), cell_streams[streamnum].agg_alarm.freq, &n,
+                  &(cell_streams[streamnum].agg_alarm));
+    }
+
+    return cell_streams;
+}
+
+/******************************************************************************
+ * @brief    Free the output streams of a single grid cell.
+ *****************************************************************************/
+void
+free_cell_streams(stream_struct **streams)
+{
+    extern option_struct options;
+
+    size_t               streamnum;
+
+    for (streamnum = 0; streamnum < options.Noutstreams; streamnum++) {
+        free_aggdata(&((*streams)[streamnum]));
+    }
+    free(*streams);
+    *streams = NULL;
+}
+
+/******************************************************************************
+ * @brief    Hand the saved model state of a finished grid cell to the state
+ *           file.
+ * @details  state is a temporary file that holds the state of the cell, or
+ *           NULL if the cell did not save a state. The states are copied to
+ *           the state file, and the temporary files closed, as soon as all
+ *           cells before them have finished.
+ *****************************************************************************/
+void
+put_cell_state(int   cellnum,
+               FILE *state)
+{
+    extern filep_struct       filep;
+    extern state_queue_struct state_queue;
+
+    char                      buf[MAXSTRING];
+    size_t                    i;
+    size_t                    nalloc;
+    size_t                    nbytes;
+
+    #pragma omp critical(state_queue)
+    {
+        if ((size_t) cellnum >= state_queue.nalloc) {
+            nalloc = 2 * state_queue.nalloc;
+            if (nalloc <= (size_t) cellnum) {
+                nalloc = cellnum + 1;
+            }
+            state_queue.done = realloc(state_queue.done,
+                                       nalloc * sizeof(*(state_queue.done)));
+            check_alloc_status(state_queue.done, "Memory allocation error.");
+            state_queue.state = realloc(state_queue.state,
+                                        nalloc *
+                                        sizeof(*(state_queue.state)));
+            check_alloc_status(state_queue.state, "Memory allocation error.");
+            for (i = state_queue.nalloc; i < nalloc; i++) {
+                state_queue.done[i] = false;
+                state_queue.state[i] = NULL;
+            }
+            state_queue.nalloc = nalloc;
+        }
+        state_queue.done[cellnum] = true;
+        state_queue.state[cellnum] = state;
+
+        // write the states of all cells that are next in line
+        while (state_queue.next < state_queue.nalloc &&
+               state_queue.done[state_queue.next]) {
+            state = state_queue.state[state_queue.next];
+            if (state != NULL) {
+                rewind(state);
+                while ((nbytes = fread(buf, 1, sizeof(buf), state)) > 0) {
+                    fwrite(buf, 1, nbytes, filep.statefile);
+                }
+                fclose(state);
+                state_queue.state[state_queue.next] = NULL;
+            }
+            state_queue.next++;
+        }
+    }
+}
+
+/******************************************************************************
+ * @brief    Free the state queue.
+ *****************************************************************************/
+void
+free_state_queue(void)
+{
+    extern state_queue_struct state_queue;
+
+    free(state_queue.done);
+    free(state_queue.state);
+    state_queue.done = NULL;
+    state_queue.state = NULL;
+    state_queue.nalloc = 0;
+    state_queue.next = 0;
+}
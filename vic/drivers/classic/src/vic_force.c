@@ -29,6 +29,9 @@
 
 /******************************************************************************
  * @brief    Initialize atmospheric variables for the model and snow time steps.
+ * @details  Fills force and veg_hist with the nrecs model timesteps that start
+ *           at rec0. Successive calls for a grid cell must read consecutive
+ *           timesteps, starting at rec0 = 0.
  *****************************************************************************/
 void
 vic_force(force_data_struct *force,
@@ -36,7 +39,9 @@ vic_force(force_data_struct *force,
           FILE             **infile,
           veg_con_struct    *veg_con,
           veg_hist_struct  **veg_hist,
-          soil_con_struct   *soil_con)
+          soil_con_struct   *soil_con,
+          size_t             rec0,
+          size_t             nrecs)
 {
     extern option_struct       options;
     extern param_set_struct    param_set;
@@ -49,6 +54,7 @@ vic_force(force_data_struct *force,
     size_t                     v;
     size_t                     rec;
     size_t                     uidx;
+    size_t                     Nveg;
     double                     t_offset;
     double                   **forcing_data;
     double                  ***veg_hist_data;
@@ -91,24 +97,19 @@ vic_force(force_data_struct *force,
     Tfactor = soil_con->Tfactor;
     AboveTreeLine = soil_con->AboveTreeLine;
 
-    /* Assign N_ELEM for veg-dependent forcings */
-    if (param_set.TYPE[ALBEDO].SUPPLIED) {
-        param_set.TYPE[ALBEDO].N_ELEM = veg_con[0].vegetat_type_num;
-    }
-    if (param_set.TYPE[LAI].SUPPLIED) {
-        param_set.TYPE[LAI].N_ELEM = veg_con[0].vegetat_type_num;
-    }
-    if (param_set.TYPE[FCANOPY].SUPPLIED) {
-        param_set.TYPE[FCANOPY].N_ELEM = veg_con[0].vegetat_type_num;
-    }
+    /* Number of elements of veg-dependent forcings */
+    Nveg = veg_con[0].vegetat_type_num;
 
     /*******************************
        read in meteorological data
     *******************************/
 
-    forcing_data = read_forcing_data(infile, global_param, &veg_hist_data);
+    forcing_data = read_forcing_data(infile, global_param, Nveg, rec0, nrecs,
+                                     &veg_hist_data);
 
-    log_info("Read meteorological forcing file");
+    if (rec0 == 0) {
+        log_info("Read meteorological forcing file");
+    }
 
     /****************************************************
        Variables in the atmos_data structure
@@ -121,7 +122,7 @@ vic_force(force_data_struct *force,
         }
     }
 
-    for (rec = 0; rec < global_param.nrecs; rec++) {
+    for (rec = 0; rec < nrecs; rec++) {
         for (i = 0; i < NF; i++) {
             uidx = rec * NF + i;
             // temperature in Celsius
@@ -170,11 +171,11 @@ vic_force(force_data_struct *force,
                 // photosynthetically active radiation
                 force[rec].par[i] = forcing_data[PAR][uidx];
                 // Cosine of solar zenith angle
-                force[rec].coszen[i] = compute_coszen(soil_con->lat,
-                                                      soil_con->lng,
-                                                      soil_con->time_zone_lng,
-                                                      dmy[rec].day_in_year,
-                                                      dmy[rec].dayseconds);
+                force[rec].coszen[i] =
+                    compute_coszen(soil_con->lat, soil_con->lng,
+                                   soil_con->time_zone_lng,
+                                   dmy[rec0 + rec].day_in_year,
+                                   dmy[rec0 + rec].dayseconds);
             }
         }
         if (NF > 1) {
@@ -203,11 +204,11 @@ vic_force(force_data_struct *force,
                 force[rec].fdir[NR] = average(force[rec].fdir, NF);
                 force[rec].par[NR] = average(force[rec].par, NF);
                 // for coszen, use value at noon
-                force[rec].coszen[NR] = compute_coszen(soil_con->lat,
-                                                       soil_con->lng,
-                                                       soil_con->time_zone_lng,
-                                                       dmy[rec].day_in_year,
-                                                       SEC_PER_DAY / 2);
+                force[rec].coszen[NR] =
+                    compute_coszen(soil_con->lat, soil_con->lng,
+                                   soil_con->time_zone_lng,
+                                   dmy[rec0 + rec].day_in_year,
+                                   SEC_PER_DAY / 2);
             }
         }
     }
@@ -217,25 +218,25 @@ vic_force(force_data_struct *force,
     ****************************************************/
 
     /* First, assign default climatology */
-    for (rec = 0; rec < global_param.nrecs; rec++) {
+    for (rec = 0; rec < nrecs; rec++) {
         for (v = 0; v <= veg_con[0].vegetat_type_num; v++) {
             for (i = 0; i < NF; i++) {
                 veg_hist[rec][v].albedo[i] =
-                    veg_con[v].albedo[dmy[rec].month - 1];
+                    veg_con[v].albedo[dmy[rec0 + rec].month - 1];
                 veg_hist[rec][v].displacement[i] =
-                    veg_con[v].displacement[dmy[rec].month - 1];
+                    veg_con[v].displacement[dmy[rec0 + rec].month - 1];
                 veg_hist[rec][v].fcanopy[i] =
-                    veg_con[v].fcanopy[dmy[rec].month - 1];
+                    veg_con[v].fcanopy[dmy[rec0 + rec].month - 1];
                 veg_hist[rec][v].LAI[i] =
-                    veg_con[v].LAI[dmy[rec].month - 1];
+                    veg_con[v].LAI[dmy[rec0 + rec].month - 1];
                 veg_hist[rec][v].roughness[i] =
-                    veg_con[v].roughness[dmy[rec].month - 1];
+                    veg_con[v].roughness[dmy[rec0 + rec].month - 1];
             }
         }
     }
 
     /* Next, overwrite with veg_hist values, validate, and average */
-    for (rec = 0; rec < global_param.nrecs; rec++) {
+    for (rec = 0; rec < nrecs; rec++) {
         for (v = 0; v <= veg_con[0].vegetat_type_num; v++) {
             for (i = 0; i < NF; i++) {
                 uidx = rec * NF + i;
@@ -263,7 +264,7 @@ vic_force(force_data_struct *force,
                 // Check on fcanopy
                 if (veg_hist[rec][v].fcanopy[i] < MIN_FCANOPY) {
                     log_warn(
-                        "rec %zu, veg %zu substep %zu fcanopy %f < minimum of %f; setting = %f", rec, v, i,
+                        "rec %zu, veg %zu substep %zu fcanopy %f < minimum of %f; setting = %f", rec0 + rec, v, i,
                         veg_hist[rec][v].fcanopy[i], MIN_FCANOPY,
                         MIN_FCANOPY);
                     veg_hist[rec][v].fcanopy[i] = MIN_FCANOPY;
@@ -293,7 +294,7 @@ vic_force(force_data_struct *force,
                 free(forcing_data[i]);
             }
             else {
-                for (j = 0; j < param_set.TYPE[i].N_ELEM; j++) {
+                for (j = 0; j < Nveg; j++) {
                     free(veg_hist_data[i][j]);
                 }
                 free(veg_hist_data[i]);
@@ -307,7 +308,7 @@ vic_force(force_data_struct *force,
        Compute treeline based on July average temperature
     ****************************************************/
 
-    if (options.COMPUTE_TREELINE) {
+    if (options.COMPUTE_TREELINE && rec0 == 0) {
         if (!(options.JULY_TAVG_SUPPLIED && avgJulyAirTemp == -999)) {
             compute_treeline(force, dmy, avgJulyAirTemp, Tfactor,
                              AboveTreeLine);
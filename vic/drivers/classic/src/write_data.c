@@ -30,7 +30,8 @@
  * @brief    write all variables to output files.
  *****************************************************************************/
 void
-write_data(stream_struct *stream)
+write_data(stream_struct        *stream,
+           scratch_arena_struct *scratch)
 {
     extern option_struct   options;
     extern metadata_struct out_metadata[N_OUTVAR_TYPES];
@@ -46,16 +47,18 @@ write_data(stream_struct *stream)
     int                   *tmp_iptr;
     float                 *tmp_fptr;
     double                *tmp_dptr;
+    size_t                 scratch_top;
 
     if (stream->file_format == BINARY) {
         n = N_OUTVAR_TYPES * options.Nlayer * options.SNOW_BAND;
         // Initialize pointers
-        tmp_cptr = calloc(n, sizeof(*tmp_cptr));
-        tmp_siptr = calloc(n, sizeof(*tmp_siptr));
-        tmp_usiptr = calloc(n, sizeof(*tmp_usiptr));
-        tmp_iptr = calloc(n, sizeof(*tmp_iptr));
-        tmp_fptr = calloc(n, sizeof(*tmp_fptr));
-        tmp_dptr = calloc(n, sizeof(*tmp_dptr));
+        scratch_top = scratch_mark(scratch);
+        tmp_cptr = scratch_alloc(scratch, n * sizeof(*tmp_cptr));
+        tmp_siptr = scratch_alloc(scratch, n * sizeof(*tmp_siptr));
+        tmp_usiptr = scratch_alloc(scratch, n * sizeof(*tmp_usiptr));
+        tmp_iptr = scratch_alloc(scratch, n * sizeof(*tmp_iptr));
+        tmp_fptr = scratch_alloc(scratch, n * sizeof(*tmp_fptr));
+        tmp_dptr = scratch_alloc(scratch, n * sizeof(*tmp_dptr));
 
         // Time
         tmp_iptr[0] = stream->time_bounds[0].year;
@@ -143,12 +146,7 @@ write_data(stream_struct *stream)
         }
 
         // Free the arrays
-        free((char *) tmp_cptr);
-        free((char *) tmp_siptr);
-        free((char *) tmp_usiptr);
-        free((char *) tmp_iptr);
-        free((char *) tmp_fptr);
-        free((char *) tmp_dptr);
+        scratch_release(scratch, scratch_top);
     }
     else if (stream->file_format == ASCII) {
         // Write the date
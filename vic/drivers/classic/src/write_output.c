@@ -30,8 +30,9 @@
  * @brief    Write output data and convert units if necessary.
  *****************************************************************************/
 void
-write_output(stream_struct **streams,
-             dmy_struct     *dmy)
+write_output(stream_struct       **streams,
+             dmy_struct           *dmy,
+             scratch_arena_struct *scratch)
 {
     extern option_struct options;
 
@@ -40,7 +41,7 @@ write_output(stream_struct **streams,
     // Write data
     for (stream_idx = 0; stream_idx < options.Noutstreams; stream_idx++) {
         if (raise_alarm(&(*streams)[stream_idx].agg_alarm, dmy)) {
-            write_data(&((*streams)[stream_idx]));
+            write_data(&((*streams)[stream_idx]), scratch);
             reset_stream((&(*streams)[stream_idx]), dmy);
         }
     }
@@ -31,13 +31,40 @@
 
 #define VIC_DRIVER "Image"
 
+/******************************************************************************
+ * @brief    Block of forcing time steps of one variable held in memory on
+ *           each process (FORCE_BLOCK_STEPS).
+ *****************************************************************************/
+typedef struct {
+    char filename[MAXSTRING]; /**< file the block was read from */
+    char varname[MAXSTRING];  /**< name of the variable */
+    size_t lead;              /**< vegetation class of 4-D variables */
+    size_t start;             /**< first record in the block */
+    size_t nrecs;             /**< number of records in the block */
+    double *data;             /**< values [nrecs][ncells_active] */
+} force_cache_struct;
+
+void alloc_pipeline_buffers(void);
 bool check_save_state_flag(size_t, dmy_struct *dmy_offset);
+void close_forcing_file(size_t file_num);
 void display_current_settings(int);
+void free_force_cache(void);
+void free_pipeline_buffers(void);
+void get_forcing(size_t rec, force_data_struct *force,
+                 veg_hist_struct **veg_hist);
 void get_forcing_file_info(param_set_struct *param_set, size_t file_num);
+size_t get_force_nc_nrecs(nameid_struct *nc_nameid, char *var_name);
+void get_force_nc_field_double(nameid_struct *nc_nameid, char *var_name,
+                               size_t *start, size_t *count, double *var);
 void get_global_param(FILE *);
+void open_forcing_file(size_t file_num, unsigned short int year);
+void read_force_nc_block_double(nameid_struct *nc_nameid, char *var_name,
+                                size_t *start, size_t *count, double *var);
 void vic_force(void);
 void vic_image_init(void);
 void vic_image_finalize();
+void vic_image_run_pipelined(dmy_struct *dmy_current,
+                             timer_struct *global_timers);
 void vic_image_start(void);
 void vic_populate_model_state(dmy_struct *dmy_current);
 
@@ -266,6 +266,65 @@ display_current_settings(int mode)
             fprintf(LOG_DEST, "FORCE_DT\t\t%f\n", param_set.FORCE_DT[file_num]);
         }
     }
+    if (options.FORCE_IO_MODE == IO_MODE_PARALLEL) {
+        fprintf(LOG_DEST, "FORCE_IO_MODE\t\tPARALLEL\n");
+    }
+    else {
+        fprintf(LOG_DEST, "FORCE_IO_MODE\t\tROOT\n");
+    }
+    fprintf(LOG_DEST, "FORCE_BLOCK_STEPS\t%zu\n", options.FORCE_BLOCK_STEPS);
+    if (options.CONTIGUOUS_STATE) {
+        fprintf(LOG_DEST, "CONTIGUOUS_STATE\tTRUE\n");
+    }
+    else {
+        fprintf(LOG_DEST, "CONTIGUOUS_STATE\tFALSE\n");
+    }
+    if (options.ROUT_SPARSE_UH) {
+        fprintf(LOG_DEST, "ROUT_SPARSE_UH\t\tTRUE\n");
+    }
+    else {
+        fprintf(LOG_DEST, "ROUT_SPARSE_UH\t\tFALSE\n");
+    }
+    if (options.DECOMP_METHOD == DECOMP_ROW_BLOCKS) {
+        fprintf(LOG_DEST, "DECOMP_METHOD\t\tROW_BLOCKS\n");
+    }
+    else if (options.DECOMP_METHOD == DECOMP_MORTON) {
+        fprintf(LOG_DEST, "DECOMP_METHOD\t\tMORTON\n");
+    }
+    else if (options.DECOMP_METHOD == DECOMP_HILBERT) {
+        fprintf(LOG_DEST, "DECOMP_METHOD\t\tHILBERT\n");
+    }
+    else if (options.DECOMP_METHOD == DECOMP_BASIN) {
+        fprintf(LOG_DEST, "DECOMP_METHOD\t\tBASIN\n");
+    }
+    else {
+        fprintf(LOG_DEST, "DECOMP_METHOD\t\tROUND_ROBIN\n");
+    }
+    if (options.CELL_SCHEDULE == CELL_SCHEDULE_DYNAMIC) {
+        fprintf(LOG_DEST, "CELL_SCHEDULE\t\tDYNAMIC\n");
+    }
+    else if (options.CELL_SCHEDULE == CELL_SCHEDULE_GUIDED) {
+        fprintf(LOG_DEST, "CELL_SCHEDULE\t\tGUIDED\n");
+    }
+    else {
+        fprintf(LOG_DEST, "CELL_SCHEDULE\t\tSTATIC\n");
+    }
+    fprintf(LOG_DEST, "CELL_CHUNK_SIZE\t\t%d\n", options.CELL_CHUNK_SIZE);
+    if (options.CELL_COST_ORDER) {
+        fprintf(LOG_DEST, "CELL_COST_ORDER\t\tTRUE\n");
+    }
+    else {
+        fprintf(LOG_DEST, "CELL_COST_ORDER\t\tFALSE\n");
+    }
+    if (options.PIPELINE_IO) {
+        fprintf(LOG_DEST, "PIPELINE_IO\t\tTRUE\n");
+    }
+    else {
+        fprintf(LOG_DEST, "PIPELINE_IO\t\tFALSE\n");
+    }
+    fprintf(LOG_DEST, "IO_SERVER_RANKS\t\t%zu\n", options.IO_SERVER_RANKS);
+    fprintf(LOG_DEST, "COST_MAP\t\t%s\n", filenames.cost_map);
+    fprintf(LOG_DEST, "COST_MAP_OUT\t\t%s\n", filenames.cost_map_out);
 
     fprintf(LOG_DEST, "\n");
     fprintf(LOG_DEST, "Input Domain Data:\n");
@@ -430,5 +489,11 @@ display_current_settings(int mode)
     fprintf(LOG_DEST, "\n");
     fprintf(LOG_DEST, "Output Data:\n");
     fprintf(LOG_DEST, "Result dir:\t\t%s\n", filenames.result_dir);
+    if (options.HIST_IO_MODE == IO_MODE_PARALLEL) {
+        fprintf(LOG_DEST, "HIST_IO_MODE\t\tPARALLEL\n");
+    }
+    else {
+        fprintf(LOG_DEST, "HIST_IO_MODE\t\tROOT\n");
+    }
     fprintf(LOG_DEST, "\n");
 }
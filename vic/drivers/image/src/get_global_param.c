@@ -39,6 +39,7 @@ get_global_param(FILE *gp)
     extern param_set_struct    param_set;
     extern filenames_struct    filenames;
     extern size_t              NF, NR;
+    extern int                 mpi_size;
 
     char                       cmdstr[MAXSTRING];
     char                       optstr[MAXSTRING];
@@ -287,6 +288,99 @@ get_global_param(FILE *gp)
                 sscanf(cmdstr, "%*s %s", filenames.log_path);
             }
 
+            /*************************************
+               Define parallel execution settings
+            *************************************/
+            else if (strcasecmp("FORCE_IO_MODE", optstr) == 0) {
+                sscanf(cmdstr, "%*s %s", flgstr);
+                if (strcasecmp("ROOT", flgstr) == 0) {
+                    options.FORCE_IO_MODE = IO_MODE_ROOT;
+                }
+                else if (strcasecmp("PARALLEL", flgstr) == 0) {
+                    options.FORCE_IO_MODE = IO_MODE_PARALLEL;
+                }
+                else {
+                    log_err("FORCE_IO_MODE must be either ROOT or PARALLEL.");
+                }
+            }
+            else if (strcasecmp("FORCE_BLOCK_STEPS", optstr) == 0) {
+                sscanf(cmdstr, "%*s %zu", &options.FORCE_BLOCK_STEPS);
+            }
+            else if (strcasecmp("CONTIGUOUS_STATE", optstr) == 0) {
+                sscanf(cmdstr, "%*s %s", flgstr);
+                options.CONTIGUOUS_STATE = str_to_bool(flgstr);
+            }
+            else if (strcasecmp("HIST_IO_MODE", optstr) == 0) {
+                sscanf(cmdstr, "%*s %s", flgstr);
+                if (strcasecmp("ROOT", flgstr) == 0) {
+                    options.HIST_IO_MODE = IO_MODE_ROOT;
+                }
+                else if (strcasecmp("PARALLEL", flgstr) == 0) {
+                    options.HIST_IO_MODE = IO_MODE_PARALLEL;
+                }
+                else {
+                    log_err("HIST_IO_MODE must be either ROOT or PARALLEL.");
+                }
+            }
+            else if (strcasecmp("DECOMP_METHOD", optstr) == 0) {
+                sscanf(cmdstr, "%*s %s", flgstr);
+                if (strcasecmp("ROUND_ROBIN", flgstr) == 0) {
+                    options.DECOMP_METHOD = DECOMP_ROUND_ROBIN;
+                }
+                else if (strcasecmp("ROW_BLOCKS", flgstr) == 0) {
+                    options.DECOMP_METHOD = DECOMP_ROW_BLOCKS;
+                }
+                else if (strcasecmp("MORTON", flgstr) == 0) {
+                    options.DECOMP_METHOD = DECOMP_MORTON;
+                }
+                else if (strcasecmp("HILBERT", flgstr) == 0) {
+                    options.DECOMP_METHOD = DECOMP_HILBERT;
+                }
+                else if (strcasecmp("BASIN", flgstr) == 0) {
+                    options.DECOMP_METHOD = DECOMP_BASIN;
+                }
+                else {
+                    log_err("DECOMP_METHOD must be one of ROUND_ROBIN, "
+                            "ROW_BLOCKS, MORTON, HILBERT or BASIN.");
+                }
+            }
+            else if (strcasecmp("CELL_SCHEDULE", optstr) == 0) {
+                sscanf(cmdstr, "%*s %s", flgstr);
+                if (strcasecmp("STATIC", flgstr) == 0) {
+                    options.CELL_SCHEDULE = CELL_SCHEDULE_STATIC;
+                }
+                else if (strcasecmp("DYNAMIC", flgstr) == 0) {
+                    options.CELL_SCHEDULE = CELL_SCHEDULE_DYNAMIC;
+                }
+                else if (strcasecmp("GUIDED", flgstr) == 0) {
+                    options.CELL_SCHEDULE = CELL_SCHEDULE_GUIDED;
+                }
+                else {
+                    log_err("CELL_SCHEDULE must be one of STATIC, DYNAMIC "
+                            "or GUIDED.");
+                }
+            }
+            else if (strcasecmp("CELL_CHUNK_SIZE", optstr) == 0) {
+                sscanf(cmdstr, "%*s %d", &options.CELL_CHUNK_SIZE);
+            }
+            else if (strcasecmp("CELL_COST_ORDER", optstr) == 0) {
+                sscanf(cmdstr, "%*s %s", flgstr);
+                options.CELL_COST_ORDER = str_to_bool(flgstr);
+            }
+            else if (strcasecmp("PIPELINE_IO", optstr) == 0) {
+                sscanf(cmdstr, "%*s %s", flgstr);
+                options.PIPELINE_IO = str_to_bool(flgstr);
+            }
+            else if (strcasecmp("IO_SERVER_RANKS", optstr) == 0) {
+                sscanf(cmdstr, "%*s %zu", &options.IO_SERVER_RANKS);
+            }
+            else if (strcasecmp("COST_MAP", optstr) == 0) {
+                sscanf(cmdstr, "%*s %s", filenames.cost_map);
+            }
+            else if (strcasecmp("COST_MAP_OUT", optstr) == 0) {
+                sscanf(cmdstr, "%*s %s", filenames.cost_map_out);
+            }
+
             /*************************************
                Define state files
             *************************************/
@@ -386,6 +480,10 @@ get_global_param(FILE *gp)
             else if (strcasecmp("ROUT_PARAM", optstr) == 0) {
                 sscanf(cmdstr, "%*s %s", filenames.rout_params.nc_filename);
             }
+            else if (strcasecmp("ROUT_SPARSE_UH", optstr) == 0) {
+                sscanf(cmdstr, "%*s %s", flgstr);
+                options.ROUT_SPARSE_UH = str_to_bool(flgstr);
+            }
             else if (strcasecmp("ARNO_PARAMS", optstr) == 0) {
                 sscanf(cmdstr, "%*s %s", flgstr);
                 if (strcasecmp("TRUE", flgstr) == 0) {
@@ -832,6 +930,42 @@ get_global_param(FILE *gp)
                 "begins with \"RESULT_DIR\".");
     }
 
+    // Validate parallel history output
+    if (options.HIST_IO_MODE == IO_MODE_PARALLEL && !VIC_NC_PARALLEL) {
+        log_err("HIST_IO_MODE = PARALLEL requires a netCDF library built with "
+                "parallel I/O support.");
+    }
+
+    // Validate domain decomposition
+    if (options.CELL_CHUNK_SIZE < 0) {
+        log_err("CELL_CHUNK_SIZE must be >= 0 (0 = OpenMP default), "
+                "CELL_CHUNK_SIZE = %d", options.CELL_CHUNK_SIZE);
+    }
+    if (options.PIPELINE_IO && options.CELL_SCHEDULE == CELL_SCHEDULE_STATIC) {
+        log_warn("PIPELINE_IO = TRUE with CELL_SCHEDULE = STATIC: the cells "
+                 "of the master thread are only run after its I/O is done. "
+                 "Use CELL_SCHEDULE = DYNAMIC or GUIDED to overlap I/O and "
+                 "computation.");
+    }
+    if (options.FORCE_BLOCK_STEPS < 1) {
+        log_err("FORCE_BLOCK_STEPS must be >= 1, FORCE_BLOCK_STEPS = %zu",
+                options.FORCE_BLOCK_STEPS);
+    }
+    if (options.IO_SERVER_RANKS >= (size_t) mpi_size) {
+        log_err("IO_SERVER_RANKS (%zu) must be smaller than the number of "
+                "MPI processes (%d).", options.IO_SERVER_RANKS, mpi_size);
+    }
+    if (options.IO_SERVER_RANKS > 0 &&
+        options.HIST_IO_MODE == IO_MODE_PARALLEL) {
+        log_err("IO_SERVER_RANKS can not be combined with HIST_IO_MODE = "
+                "PARALLEL.");
+    }
+    if (options.DECOMP_METHOD == DECOMP_BASIN &&
+        strcmp(filenames.rout_params.nc_filename, "MISSING") == 0) {
+        log_err("DECOMP_METHOD = BASIN requires a routing parameter file "
+                "(ROUT_PARAM).");
+    }
+
     // Validate parameter file information
     if (strcmp(filenames.params.nc_filename, "MISSING") == 0) {
         log_err("A parameters file has not been defined.  Make sure that the "
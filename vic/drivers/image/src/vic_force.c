@@ -27,186 +27,187 @@
 #include <vic_driver_image.h>
 
 /******************************************************************************
- * @brief    Read atmospheric forcing data.
+ * @brief    Read atmospheric forcing data for the current timestep.
  *****************************************************************************/
 void
 vic_force(void)
 {
-    extern size_t              NF;
-    extern size_t              NR;
-    extern size_t              current;
-    extern int                 mpi_rank;
-    extern force_data_struct  *force;
-    extern dmy_struct         *dmy;
-    extern domain_struct       global_domain;
-    extern domain_struct       local_domain;
-    extern filenames_struct    filenames;
-    extern global_param_struct global_param;
-    extern option_struct       options;
-    extern soil_con_struct    *soil_con;
-    extern veg_con_map_struct *veg_con_map;
-    extern veg_con_struct    **veg_con;
-    extern veg_hist_struct   **veg_hist;
-    extern parameters_struct   param;
-    extern param_set_struct    param_set;
-
-    double                    *t_offset = NULL;
-    double                    *dvar = NULL;
-    size_t                     i;
-    size_t                     j;
-    size_t                     v;
-    size_t                     band;
-    int                        vidx;
-    int                        status;
-    size_t                     d3count[3];
-    size_t                     d3start[3];
-    size_t                     d4count[4];
-    size_t                     d4start[4];
-    double                    *Tfactor;
+    extern size_t             current;
+    extern force_data_struct *force;
+    extern veg_hist_struct  **veg_hist;
 
-    // allocate memory for variables to be read
-    dvar = malloc(local_domain.ncells_active * sizeof(*dvar));
-    check_alloc_status(dvar, "Memory allocation error.");
+    get_forcing(current, force, veg_hist);
+}
+
+/******************************************************************************
+ * @brief    Read atmospheric forcing data for timestep rec into force and
+ *           veg_hist.
+ * @details  Timesteps must be read in order, because the offsets into the
+ *           forcing files are advanced with every call.
+ *****************************************************************************/
+void
+get_forcing(size_t              rec,
+            force_data_struct  *force,
+            veg_hist_struct   **veg_hist)
+{
+    extern size_t                NF;
+    extern size_t                NR;
+    extern dmy_struct           *dmy;
+    extern domain_struct         global_domain;
+    extern domain_struct         local_domain;
+    extern filenames_struct      filenames;
+    extern global_param_struct   global_param;
+    extern option_struct         options;
+    extern soil_con_struct      *soil_con;
+    extern veg_con_map_struct   *veg_con_map;
+    extern veg_con_struct      **veg_con;
+    extern parameters_struct     param;
+    extern param_set_struct      param_set;
+    extern scratch_arena_struct *scratch_arenas;
+
+    double                      *t_offset = NULL;
+    double                      *dvar = NULL;
+    size_t                       i;
+    size_t                       j;
+    size_t                       v;
+    size_t                       band;
+    int                          vidx;
+    size_t                       d3count[3];
+    size_t                       d3start[3];
+    size_t                       d4count[4];
+    size_t                       d4start[4];
+    double                      *Tfactor;
+    scratch_arena_struct        *scratch;
+    size_t                       scratch_top;
+
+    // allocate memory for variables to be read (all substeps of a timestep);
+    // the forcing may be read by any thread (see PIPELINE_IO)
+    scratch = &(scratch_arenas[omp_get_thread_num()]);
+    scratch_top = scratch_mark(scratch);
+    dvar = scratch_alloc(scratch, (NF * local_domain.ncells_active + 1) *
+                         sizeof(*dvar));
 
     // global_param.forceoffset[0] resets every year since the met file restarts
     // every year
     // global_param.forceskip[0] should also reset to 0 after the first year
-    if (current > 0 && (dmy[current].year != dmy[current - 1].year)) {
+    if (rec > 0 && (dmy[rec].year != dmy[rec - 1].year)) {
         global_param.forceoffset[0] = 0;
         global_param.forceskip[0] = 0;
         // close the forcing file for the previous year and open the forcing
         // file for the current new year
         // (forcing file for the first year should already be open in
-        // get_global_param)
-        if (mpi_rank == VIC_MPI_ROOT) {
-            // close previous forcing file
-            status = nc_close(filenames.forcing[0].nc_id);
-            check_nc_status(status, "Error closing %s",
-                            filenames.forcing[0].nc_filename);
-            // open new forcing file
-            sprintf(filenames.forcing[0].nc_filename, "%s%4d.nc",
-                    filenames.f_path_pfx[0], dmy[current].year);
-            status = nc_open(filenames.forcing[0].nc_filename, NC_NOWRITE,
-                             &(filenames.forcing[0].nc_id));
-            check_nc_status(status, "Error opening %s",
-                            filenames.forcing[0].nc_filename);
-        }
+        // get_global_param or vic_image_start)
+        close_forcing_file(0);
+        open_forcing_file(0, dmy[rec].year);
     }
 
-    // only the time slice changes for the met file reads. The rest is constant
+    // all NF substeps of a variable are read in one go. Only the time slice
+    // changes for the met file reads. The rest is constant
+    d3start[0] = global_param.forceskip[0] + global_param.forceoffset[0];
     d3start[1] = 0;
     d3start[2] = 0;
-    d3count[0] = 1;
+    d3count[0] = NF;
     d3count[1] = global_domain.n_ny;
     d3count[2] = global_domain.n_nx;
 
     // Air temperature: tas
+    get_force_nc_field_double(&(filenames.forcing[0]),
+                              param_set.TYPE[AIR_TEMP].varname,
+                              d3start, d3count, dvar);
     for (j = 0; j < NF; j++) {
-        d3start[0] = global_param.forceskip[0] + global_param.forceoffset[0] +
-                     j;
-        get_scatter_nc_field_double(&(filenames.forcing[0]),
-                                    param_set.TYPE[AIR_TEMP].varname,
-                                    d3start, d3count, dvar);
         for (i = 0; i < local_domain.ncells_active; i++) {
-            force[i].air_temp[j] = (double) dvar[i];
+            force[i].air_temp[j] =
+                (double) dvar[j * local_domain.ncells_active + i];
         }
     }
 
     // Precipitation: prcp
+    get_force_nc_field_double(&(filenames.forcing[0]),
+                              param_set.TYPE[PREC].varname,
+                              d3start, d3count, dvar);
     for (j = 0; j < NF; j++) {
-        d3start[0] = global_param.forceskip[0] + global_param.forceoffset[0] +
-                     j;
-        get_scatter_nc_field_double(&(filenames.forcing[0]),
-                                    param_set.TYPE[PREC].varname,
-                                    d3start, d3count, dvar);
         for (i = 0; i < local_domain.ncells_active; i++) {
-            force[i].prec[j] = (double) dvar[i];
+            force[i].prec[j] =
+                (double) dvar[j * local_domain.ncells_active + i];
         }
     }
 
     // Downward solar radiation: dswrf
+    get_force_nc_field_double(&(filenames.forcing[0]),
+                              param_set.TYPE[SWDOWN].varname,
+                              d3start, d3count, dvar);
     for (j = 0; j < NF; j++) {
-        d3start[0] = global_param.forceskip[0] + global_param.forceoffset[0] +
-                     j;
-        get_scatter_nc_field_double(&(filenames.forcing[0]),
-                                    param_set.TYPE[SWDOWN].varname,
-                                    d3start, d3count, dvar);
         for (i = 0; i < local_domain.ncells_active; i++) {
-            force[i].shortwave[j] = (double) dvar[i];
+            force[i].shortwave[j] =
+                (double) dvar[j * local_domain.ncells_active + i];
         }
     }
 
     // Downward longwave radiation: dlwrf
+    get_force_nc_field_double(&(filenames.forcing[0]),
+                              param_set.TYPE[LWDOWN].varname,
+                              d3start, d3count, dvar);
     for (j = 0; j < NF; j++) {
-        d3start[0] = global_param.forceskip[0] + global_param.forceoffset[0] +
-                     j;
-        get_scatter_nc_field_double(&(filenames.forcing[0]),
-                                    param_set.TYPE[LWDOWN].varname,
-                                    d3start, d3count, dvar);
         for (i = 0; i < local_domain.ncells_active; i++) {
-            force[i].longwave[j] = (double) dvar[i];
+            force[i].longwave[j] =
+                (double) dvar[j * local_domain.ncells_active + i];
         }
     }
 
     // Wind speed: wind
+    get_force_nc_field_double(&(filenames.forcing[0]),
+                              param_set.TYPE[WIND].varname,
+                              d3start, d3count, dvar);
     for (j = 0; j < NF; j++) {
-        d3start[0] = global_param.forceskip[0] + global_param.forceoffset[0] +
-                     j;
-        get_scatter_nc_field_double(&(filenames.forcing[0]),
-                                    param_set.TYPE[WIND].varname,
-                                    d3start, d3count, dvar);
         for (i = 0; i < local_domain.ncells_active; i++) {
-            force[i].wind[j] = (double) dvar[i];
+            force[i].wind[j] =
+                (double) dvar[j * local_domain.ncells_active + i];
         }
     }
 
     // vapor pressure: vp
+    get_force_nc_field_double(&(filenames.forcing[0]),
+                              param_set.TYPE[VP].varname,
+                              d3start, d3count, dvar);
     for (j = 0; j < NF; j++) {
-        d3start[0] = global_param.forceskip[0] + global_param.forceoffset[0] +
-                     j;
-        get_scatter_nc_field_double(&(filenames.forcing[0]),
-                                    param_set.TYPE[VP].varname,
-                                    d3start, d3count, dvar);
         for (i = 0; i < local_domain.ncells_active; i++) {
-            force[i].vp[j] = (double) dvar[i];
+            force[i].vp[j] =
+                (double) dvar[j * local_domain.ncells_active + i];
         }
     }
 
     // Pressure: pressure
+    get_force_nc_field_double(&(filenames.forcing[0]),
+                              param_set.TYPE[PRESSURE].varname,
+                              d3start, d3count, dvar);
     for (j = 0; j < NF; j++) {
-        d3start[0] = global_param.forceskip[0] + global_param.forceoffset[0] +
-                     j;
-        get_scatter_nc_field_double(&(filenames.forcing[0]),
-                                    param_set.TYPE[PRESSURE].varname,
-                                    d3start, d3count, dvar);
         for (i = 0; i < local_domain.ncells_active; i++) {
-            force[i].pressure[j] = (double) dvar[i];
+            force[i].pressure[j] =
+                (double) dvar[j * local_domain.ncells_active + i];
         }
     }
     // Optional inputs
     if (options.LAKES) {
         // Channel inflow to lake
-        d3start[0] = global_param.forceskip[0] + global_param.forceoffset[0] +
-                     j;
-        get_scatter_nc_field_double(&(filenames.forcing[0]),
-                                    param_set.TYPE[CHANNEL_IN].varname,
-                                    d3start, d3count, dvar);
+        get_force_nc_field_double(&(filenames.forcing[0]),
+                                  param_set.TYPE[CHANNEL_IN].varname,
+                                  d3start, d3count, dvar);
         for (j = 0; j < NF; j++) {
             for (i = 0; i < local_domain.ncells_active; i++) {
-                force[i].channel_in[j] = (double) dvar[i];
+                force[i].channel_in[j] =
+                    (double) dvar[j * local_domain.ncells_active + i];
             }
         }
     }
     if (options.CARBON) {
         // Atmospheric CO2 mixing ratio
+        get_force_nc_field_double(&(filenames.forcing[0]),
+                                  param_set.TYPE[CATM].varname,
+                                  d3start, d3count, dvar);
         for (j = 0; j < NF; j++) {
-            d3start[0] = global_param.forceskip[0] +
-                         global_param.forceoffset[0] + j;
-            get_scatter_nc_field_double(&(filenames.forcing[0]),
-                                        param_set.TYPE[CATM].varname,
-                                        d3start, d3count, dvar);
             for (i = 0; i < local_domain.ncells_active; i++) {
-                force[i].Catm[j] = (double) dvar[i];
+                force[i].Catm[j] =
+                    (double) dvar[j * local_domain.ncells_active + i];
             }
         }
         // Cosine of solar zenith angle
@@ -215,41 +216,35 @@ vic_force(void)
                 force[i].coszen[j] = compute_coszen(
                     local_domain.locations[i].latitude,
                     local_domain.locations[i].longitude,
-                    soil_con[i].time_zone_lng, dmy[current].day_in_year,
-                    dmy[current].dayseconds);
+                    soil_con[i].time_zone_lng, dmy[rec].day_in_year,
+                    dmy[rec].dayseconds);
             }
         }
         // Fraction of shortwave that is direct
+        get_force_nc_field_double(&(filenames.forcing[0]),
+                                  param_set.TYPE[FDIR].varname,
+                                  d3start, d3count, dvar);
         for (j = 0; j < NF; j++) {
-            d3start[0] = global_param.forceskip[0] +
-                         global_param.forceoffset[0] + j;
-            get_scatter_nc_field_double(&(filenames.forcing[0]),
-                                        param_set.TYPE[FDIR].varname,
-                                        d3start, d3count, dvar);
             for (i = 0; i < local_domain.ncells_active; i++) {
-                force[i].fdir[j] = (double) dvar[i];
+                force[i].fdir[j] =
+                    (double) dvar[j * local_domain.ncells_active + i];
             }
         }
         // Photosynthetically active radiation
+        get_force_nc_field_double(&(filenames.forcing[0]),
+                                  param_set.TYPE[PAR].varname,
+                                  d3start, d3count, dvar);
         for (j = 0; j < NF; j++) {
-            d3start[0] = global_param.forceskip[0] +
-                         global_param.forceoffset[0] + j;
-            get_scatter_nc_field_double(&(filenames.forcing[0]),
-                                        param_set.TYPE[PAR].varname,
-                                        d3start, d3count, dvar);
             for (i = 0; i < local_domain.ncells_active; i++) {
-                force[i].par[j] = (double) dvar[i];
+                force[i].par[j] =
+                    (double) dvar[j * local_domain.ncells_active + i];
             }
         }
     }
 
-    if (mpi_rank == VIC_MPI_ROOT) {
-        // Close forcing file if it is the last time step
-        if (current == global_param.nrecs - 1) {
-            status = nc_close(filenames.forcing[0].nc_id);
-            check_nc_status(status, "Error closing %s",
-                            filenames.forcing[0].nc_filename);
-        }
+    // Close forcing file if it is the last time step
+    if (rec == global_param.nrecs - 1) {
+        close_forcing_file(0);
     }
 
     // Update the offset counter
@@ -264,15 +259,15 @@ vic_force(void)
             if (vidx != NODATA_VEG) {
                 for (j = 0; j < NF; j++) {
                     veg_hist[i][vidx].albedo[j] =
-                        veg_con[i][vidx].albedo[dmy[current].month - 1];
+                        veg_con[i][vidx].albedo[dmy[rec].month - 1];
                     veg_hist[i][vidx].displacement[j] =
-                        veg_con[i][vidx].displacement[dmy[current].month - 1];
+                        veg_con[i][vidx].displacement[dmy[rec].month - 1];
                     veg_hist[i][vidx].fcanopy[j] =
-                        veg_con[i][vidx].fcanopy[dmy[current].month - 1];
+                        veg_con[i][vidx].fcanopy[dmy[rec].month - 1];
                     veg_hist[i][vidx].LAI[j] =
-                        veg_con[i][vidx].LAI[dmy[current].month - 1];
+                        veg_con[i][vidx].LAI[dmy[rec].month - 1];
                     veg_hist[i][vidx].roughness[j] =
-                        veg_con[i][vidx].roughness[dmy[current].month - 1];
+                        veg_con[i][vidx].roughness[dmy[rec].month - 1];
                 }
             }
         }
@@ -285,50 +280,41 @@ vic_force(void)
         // global_param.forceoffset[1] resets every year since the met file restarts
         // every year
         // global_param.forceskip[1] should also reset to 0 after the first year
-        if (current > 0 && (dmy[current].year != dmy[current - 1].year)) {
+        if (rec > 0 && (dmy[rec].year != dmy[rec - 1].year)) {
             global_param.forceoffset[1] = 0;
             global_param.forceskip[1] = 0;
             // close the forcing file for the previous year and open the forcing
             // file for the current new year
             // (forcing file for the first year should already be open in
-            // get_global_param)
-            if (mpi_rank == VIC_MPI_ROOT) {
-                // close previous forcing file
-                status = nc_close(filenames.forcing[1].nc_id);
-                check_nc_status(status, "Error closing %s",
-                                filenames.forcing[1].nc_filename);
-                // open new forcing file
-                sprintf(filenames.forcing[1].nc_filename, "%s%4d.nc",
-                        filenames.f_path_pfx[1],
-                        dmy[current].year);
-                status = nc_open(filenames.forcing[1].nc_filename, NC_NOWRITE,
-                                 &(filenames.forcing[1].nc_id));
-                check_nc_status(status, "Error opening %s",
-                                filenames.forcing[1].nc_filename);
-            }
+            // get_global_param or vic_image_start)
+            close_forcing_file(1);
+            open_forcing_file(1, dmy[rec].year);
         }
 
-        // only the time slice changes for the met file reads. The rest is constant
+        // all NF substeps of a variable are read in one go. Only the time
+        // slice and the vegetation class change for the veg_hist file reads.
+        // The rest is constant
+        d4start[0] = global_param.forceskip[1] + global_param.forceoffset[1];
         d4start[2] = 0;
         d4start[3] = 0;
-        d4count[0] = 1;
+        d4count[0] = NF;
         d4count[1] = 1;
         d4count[2] = global_domain.n_ny;
         d4count[3] = global_domain.n_nx;
 
         // Leaf Area Index: LAI
         if (options.LAI_SRC == FROM_VEGHIST) {
-            for (j = 0; j < NF; j++) {
-                d4start[0] = global_param.forceskip[1] +
-                             global_param.forceoffset[1] + j;
-                for (v = 0; v < options.NVEGTYPES; v++) {
-                    d4start[1] = v;
-                    get_scatter_nc_field_double(&(filenames.forcing[1]), "LAI",
-                                                d4start, d4count, dvar);
+            for (v = 0; v < options.NVEGTYPES; v++) {
+                d4start[1] = v;
+                get_force_nc_field_double(&(filenames.forcing[1]), "LAI",
+                                          d4start, d4count, dvar);
+                for (j = 0; j < NF; j++) {
                     for (i = 0; i < local_domain.ncells_active; i++) {
                         vidx = veg_con_map[i].vidx[v];
                         if (vidx != NODATA_VEG) {
-                            veg_hist[i][vidx].LAI[j] = (double) dvar[i];
+                            veg_hist[i][vidx].LAI[j] =
+                                (double) dvar[j * local_domain.ncells_active +
+                                              i];
                         }
                     }
                 }
@@ -337,18 +323,18 @@ vic_force(void)
 
         // Partial veg cover fraction: fcanopy
         if (options.FCAN_SRC == FROM_VEGHIST) {
-            for (j = 0; j < NF; j++) {
-                d4start[0] = global_param.forceskip[1] +
-                             global_param.forceoffset[1] + j;
-                for (v = 0; v < options.NVEGTYPES; v++) {
-                    d4start[1] = v;
-                    get_scatter_nc_field_double(&(filenames.forcing[1]),
-                                                "fcanopy", d4start, d4count,
-                                                dvar);
+            for (v = 0; v < options.NVEGTYPES; v++) {
+                d4start[1] = v;
+                get_force_nc_field_double(&(filenames.forcing[1]),
+                                          "fcanopy", d4start, d4count,
+                                          dvar);
+                for (j = 0; j < NF; j++) {
                     for (i = 0; i < local_domain.ncells_active; i++) {
                         vidx = veg_con_map[i].vidx[v];
                         if (vidx != NODATA_VEG) {
-                            veg_hist[i][vidx].fcanopy[j] = (double) dvar[i];
+                            veg_hist[i][vidx].fcanopy[j] =
+                                (double) dvar[j * local_domain.ncells_active +
+                                              i];
                         }
                     }
                 }
@@ -357,31 +343,27 @@ vic_force(void)
 
         // Albedo: albedo
         if (options.ALB_SRC == FROM_VEGHIST) {
-            for (j = 0; j < NF; j++) {
-                d4start[0] = global_param.forceskip[1] +
-                             global_param.forceoffset[1] + j;
-                for (v = 0; v < options.NVEGTYPES; v++) {
-                    d4start[1] = v;
-                    get_scatter_nc_field_double(&(filenames.forcing[1]),
-                                                "albedo", d4start, d4count,
-                                                dvar);
+            for (v = 0; v < options.NVEGTYPES; v++) {
+                d4start[1] = v;
+                get_force_nc_field_double(&(filenames.forcing[1]),
+                                          "albedo", d4start, d4count,
+                                          dvar);
+                for (j = 0; j < NF; j++) {
                     for (i = 0; i < local_domain.ncells_active; i++) {
                         vidx = veg_con_map[i].vidx[v];
                         if (vidx != NODATA_VEG) {
-                            veg_hist[i][vidx].albedo[j] = (double) dvar[i];
+                            veg_hist[i][vidx].albedo[j] =
+                                (double) dvar[j * local_domain.ncells_active +
+                                              i];
                         }
                     }
                 }
             }
         }
 
-        if (mpi_rank == VIC_MPI_ROOT) {
-            // Close forcing file if it is the last time step
-            if (current == global_param.nrecs - 1) {
-                status = nc_close(filenames.forcing[1].nc_id);
-                check_nc_status(status, "Error closing %s",
-                                filenames.forcing[1].nc_filename);
-            }
+        // Close forcing file if it is the last time step
+        if (rec == global_param.nrecs - 1) {
+            close_forcing_file(1);
         }
 
         // Update the offset counter
@@ -390,8 +372,8 @@ vic_force(void)
 
 
     // allocate memory for t_offset
-    t_offset = malloc(local_domain.ncells_active * sizeof(*t_offset));
-    check_alloc_status(t_offset, "Memory allocation error.");
+    t_offset = scratch_alloc(scratch, local_domain.ncells_active *
+                             sizeof(*t_offset));
 
     for (i = 0; i < local_domain.ncells_active; i++) {
         if (options.SNOW_BAND > 1) {
@@ -435,7 +417,7 @@ vic_force(void)
             if (vidx != NODATA_VEG) {
                 for (j = 0; j < NF; j++) {
                     if ((veg_hist[i][vidx].fcanopy[j] < MIN_FCANOPY) &&
-                        ((current == 0) ||
+                        ((rec == 0) ||
                          (options.FCAN_SRC == FROM_VEGHIST))) {
                         // Only issue this warning once if not using veg hist fractions
                         log_warn(
@@ -497,14 +479,13 @@ vic_force(void)
             force[i].coszen[NR] = compute_coszen(
                 local_domain.locations[i].latitude,
                 local_domain.locations[i].longitude, soil_con[i].time_zone_lng,
-                dmy[current].day_in_year, SEC_PER_DAY / 2);
+                dmy[rec].day_in_year, SEC_PER_DAY / 2);
         }
     }
 
 
     // cleanup
-    free(dvar);
-    free(t_offset);
+    scratch_release(scratch, scratch_top);
 }
 
 /******************************************************************************
@@ -590,3 +571,264 @@ get_forcing_file_info(param_set_struct *param_set,
     free(nc_unit_chars);
     free(calendar_char);
 }
+
+/******************************************************************************
+ * @brief    Open the forcing file of a given year.
+ * @details  In parallel forcing I/O mode the file is opened by all processes,
+ *           otherwise only by the master process.
+ *****************************************************************************/
+void
+open_forcing_file(size_t             file_num,
+                  unsigned short int year)
+{
+    extern filenames_struct filenames;
+    extern int              mpi_rank;
+    extern option_struct    options;
+#if VIC_NC_PARALLEL
+    extern MPI_Comm         MPI_COMM_VIC;
+#endif
+
+    int                     status;
+    char                    nc_filename[MAXSTRING];
+
+    // format into a local buffer: the prefix and the target both live in
+    // filenames
+    snprintf(nc_filename, MAXSTRING, "%s%4d.nc",
+             filenames.f_path_pfx[file_num], year);
+    strcpy(filenames.forcing[file_num].nc_filename, nc_filename);
+
+    if (options.FORCE_IO_MODE == IO_MODE_PARALLEL) {
+#if VIC_NC_PARALLEL
+        status = nc_open_par(filenames.forcing[file_num].nc_filename,
+                             NC_NOWRITE, MPI_COMM_VIC, MPI_INFO_NULL,
+                             &(filenames.forcing[file_num].nc_id));
+#else
+        status = nc_open(filenames.forcing[file_num].nc_filename, NC_NOWRITE,
+                         &(filenames.forcing[file_num].nc_id));
+#endif
+        check_nc_status(status, "Error opening %s",
+                        filenames.forcing[file_num].nc_filename);
+    }
+    else if (mpi_rank == VIC_MPI_ROOT) {
+        status = nc_open(filenames.forcing[file_num].nc_filename, NC_NOWRITE,
+                         &(filenames.forcing[file_num].nc_id));
+        check_nc_status(status, "Error opening %s",
+                        filenames.forcing[file_num].nc_filename);
+    }
+}
+
+/******************************************************************************
+ * @brief    Close a forcing file.
+ *****************************************************************************/
+void
+close_forcing_file(size_t file_num)
+{
+    extern filenames_struct    filenames;
+    extern force_cache_struct *force_cache;
+    extern size_t              force_cache_n;
+    extern int                 mpi_rank;
+    extern option_struct       options;
+
+    int                        status;
+    size_t                     i;
+
+    // cached blocks of this file can not be used anymore
+    for (i = 0; i < force_cache_n; i++) {
+        if (strcmp(force_cache[i].filename,
+                   filenames.forcing[file_num].nc_filename) == 0) {
+            strcpy(force_cache[i].filename, "");
+            force_cache[i].nrecs = 0;
+        }
+    }
+
+    if (options.FORCE_IO_MODE == IO_MODE_PARALLEL ||
+        mpi_rank == VIC_MPI_ROOT) {
+        status = nc_close(filenames.forcing[file_num].nc_id);
+        check_nc_status(status, "Error closing %s",
+                        filenames.forcing[file_num].nc_filename);
+    }
+}
+
+/******************************************************************************
+ * @brief    Read a double precision forcing field for the local cells.
+ * @details  count[0] time steps are returned in var as
+ *           [count[0]][local_domain.ncells_active]; the counts of the other
+ *           leading dimensions must be 1. With FORCE_BLOCK_STEPS > 1 the
+ *           steps are served from a per-process cache that is refilled with
+ *           FORCE_BLOCK_STEPS model timesteps at a time. Must be called by
+ *           all processes.
+ *****************************************************************************/
+void
+get_force_nc_field_double(nameid_struct *nc_nameid,
+                          char          *var_name,
+                          size_t        *start,
+                          size_t        *count,
+                          double        *var)
+{
+    extern force_cache_struct *force_cache;
+    extern size_t              force_cache_n;
+    extern domain_struct       local_domain;
+    extern option_struct       options;
+
+    force_cache_struct        *cache = NULL;
+    size_t                     lead;
+    size_t                     nrecs_file;
+    size_t                     nsteps;
+    size_t                     i;
+
+    if (options.FORCE_BLOCK_STEPS <= 1) {
+        read_force_nc_block_double(nc_nameid, var_name, start, count, var);
+        return;
+    }
+
+    // 4-D fields (veg_hist) are cached per vegetation class; start[1] is 0
+    // for the 3-D fields
+    lead = start[1];
+
+    // find the cache entry of this variable
+    for (i = 0; i < force_cache_n; i++) {
+        if (strcmp(force_cache[i].varname, var_name) == 0 &&
+            force_cache[i].lead == lead) {
+            cache = &(force_cache[i]);
+            break;
+        }
+    }
+    if (cache == NULL) {
+        force_cache = realloc(force_cache,
+                              (force_cache_n + 1) * sizeof(*force_cache));
+        check_alloc_status(force_cache, "Memory allocation error.");
+        cache = &(force_cache[force_cache_n]);
+        force_cache_n++;
+        strcpy(cache->filename, "");
+        strcpy(cache->varname, var_name);
+        cache->lead = lead;
+        cache->start = 0;
+        cache->nrecs = 0;
+        cache->data = NULL;
+    }
+
+    // refill the cache if the requested steps are not in it
+    if (strcmp(cache->filename, nc_nameid->nc_filename) != 0 ||
+        start[0] < cache->start ||
+        start[0] + count[0] > cache->start + cache->nrecs) {
+        nrecs_file = get_force_nc_nrecs(nc_nameid, var_name);
+        if (start[0] + count[0] > nrecs_file) {
+            log_err("Trying to read records %zu to %zu of %s in %s, which "
+                    "has %zu records", start[0], start[0] + count[0],
+                    var_name, nc_nameid->nc_filename, nrecs_file);
+        }
+        // read FORCE_BLOCK_STEPS timesteps, but not past the end of the file
+        nsteps = count[0];
+        count[0] = options.FORCE_BLOCK_STEPS * nsteps;
+        if (start[0] + count[0] > nrecs_file) {
+            count[0] = nrecs_file - start[0];
+        }
+
+        cache->data = realloc(cache->data,
+                              (count[0] * local_domain.ncells_active + 1) *
+                              sizeof(*(cache->data)));
+        check_alloc_status(cache->data, "Memory allocation error.");
+        read_force_nc_block_double(nc_nameid, var_name, start, count,
+                                   cache->data);
+        strcpy(cache->filename, nc_nameid->nc_filename);
+        cache->start = start[0];
+        cache->nrecs = count[0];
+        count[0] = nsteps;
+    }
+
+    memcpy(var, &(cache->data[(start[0] - cache->start) *
+                              local_domain.ncells_active]),
+           count[0] * local_domain.ncells_active * sizeof(*var));
+}
+
+/******************************************************************************
+ * @brief    Number of records (length of the first dimension) of a forcing
+ *           variable. Must be called by all processes.
+ *****************************************************************************/
+size_t
+get_force_nc_nrecs(nameid_struct *nc_nameid,
+                   char          *var_name)
+{
+    extern MPI_Comm      MPI_COMM_VIC;
+    extern int           mpi_rank;
+    extern option_struct options;
+
+    int                  status;
+    int                  var_id;
+    int                  dimids[MAXDIMS];
+    size_t               nrecs = 0;
+
+    if (options.FORCE_IO_MODE == IO_MODE_PARALLEL ||
+        mpi_rank == VIC_MPI_ROOT) {
+        status = nc_inq_varid(nc_nameid->nc_id, var_name, &var_id);
+        check_nc_status(status, "Error getting variable id for %s in %s",
+                        var_name, nc_nameid->nc_filename);
+        status = nc_inq_vardimid(nc_nameid->nc_id, var_id, dimids);
+        check_nc_status(status, "Error getting dimensions of %s in %s",
+                        var_name, nc_nameid->nc_filename);
+        status = nc_inq_dimlen(nc_nameid->nc_id, dimids[0], &nrecs);
+        check_nc_status(status, "Error getting time dimension of %s in %s",
+                        var_name, nc_nameid->nc_filename);
+    }
+    if (options.FORCE_IO_MODE != IO_MODE_PARALLEL) {
+        status = MPI_Bcast(&nrecs, 1, MPI_UNSIGNED_LONG, VIC_MPI_ROOT,
+                           MPI_COMM_VIC);
+        check_mpi_status(status, "MPI error.");
+    }
+
+    return nrecs;
+}
+
+/******************************************************************************
+ * @brief    Free the forcing cache.
+ *****************************************************************************/
+void
+free_force_cache(void)
+{
+    extern force_cache_struct *force_cache;
+    extern size_t              force_cache_n;
+
+    size_t                     i;
+
+    for (i = 0; i < force_cache_n; i++) {
+        free(force_cache[i].data);
+    }
+    free(force_cache);
+    force_cache = NULL;
+    force_cache_n = 0;
+}
+
+/******************************************************************************
+ * @brief    Read count[0] time steps of a double precision forcing field for
+ *           the local cells from the file.
+ * @details  Dispatches to the parallel or the master-process read depending
+ *           on the FORCE_IO_MODE option. Must be called by all processes.
+ *****************************************************************************/
+void
+read_force_nc_block_double(nameid_struct *nc_nameid,
+                           char          *var_name,
+                           size_t        *start,
+                           size_t        *count,
+                           double        *var)
+{
+    extern domain_struct global_domain;
+    extern int           mpi_rank;
+    extern option_struct options;
+
+    double              *dvar = NULL;
+
+    if (options.FORCE_IO_MODE == IO_MODE_PARALLEL) {
+        get_par_nc_field_double(nc_nameid, var_name, start, count, var);
+    }
+    else {
+        if (mpi_rank == VIC_MPI_ROOT) {
+            dvar = malloc(count[0] * global_domain.ncells_total *
+                          sizeof(*dvar));
+            check_alloc_status(dvar, "Memory allocation error.");
+
+            get_nc_field_double(nc_nameid, var_name, start, count, dvar);
+        }
+        // scatter all steps at once; frees dvar
+        scatter_field_steps_double(count[0], dvar, var);
+    }
+}
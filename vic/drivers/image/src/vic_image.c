@@ -27,48 +27,57 @@
 #include <vic_driver_image.h>
 #include <rout.h>   // Routing routine (extension)
 
-size_t              NF, NR;
-size_t              current;
-size_t             *filter_active_cells = NULL;
-size_t             *mpi_map_mapping_array = NULL;
-all_vars_struct    *all_vars = NULL;
-force_data_struct  *force = NULL;
-dmy_struct         *dmy = NULL;
-dmy_struct          dmy_state;
-filenames_struct    filenames;
-filep_struct        filep;
-domain_struct       global_domain;
-global_param_struct global_param;
-lake_con_struct    *lake_con = NULL;
-domain_struct       local_domain;
-MPI_Comm            MPI_COMM_VIC = MPI_COMM_WORLD;
-MPI_Datatype        mpi_global_struct_type;
-MPI_Datatype        mpi_filenames_struct_type;
-MPI_Datatype        mpi_location_struct_type;
-MPI_Datatype        mpi_alarm_struct_type;
-MPI_Datatype        mpi_option_struct_type;
-MPI_Datatype        mpi_param_struct_type;
-int                *mpi_map_local_array_sizes = NULL;
-int                *mpi_map_global_array_offsets = NULL;
-int                 mpi_rank;
-int                 mpi_size;
-option_struct       options;
-parameters_struct   param;
-param_set_struct    param_set;
-soil_con_struct    *soil_con = NULL;
-veg_con_map_struct *veg_con_map = NULL;
-veg_con_struct    **veg_con = NULL;
-veg_hist_struct   **veg_hist = NULL;
-veg_lib_struct    **veg_lib = NULL;
-metadata_struct     state_metadata[N_STATE_VARS + N_STATE_VARS_EXT];
-metadata_struct     out_metadata[N_OUTVAR_TYPES];
-save_data_struct   *save_data;  // [ncells]
-double           ***out_data = NULL;  // [ncells, nvars, nelem]
-stream_struct      *output_streams = NULL;  // [nstreams]
-nc_file_struct     *nc_hist_files = NULL;  // [nstreams]
+size_t                NF, NR;
+size_t                current;
+size_t               *filter_active_cells = NULL;
+size_t               *mpi_map_mapping_array = NULL;
+all_vars_struct      *all_vars = NULL;
+force_data_struct    *force = NULL;
+force_data_struct    *force_next = NULL;  // read-ahead buffer for PIPELINE_IO
+force_cache_struct   *force_cache = NULL;  // [force_cache_n]
+size_t                force_cache_n = 0;
+dmy_struct           *dmy = NULL;
+dmy_struct            dmy_state;
+filenames_struct      filenames;
+filep_struct          filep;
+domain_struct         global_domain;
+global_param_struct   global_param;
+lake_con_struct      *lake_con = NULL;
+domain_struct         local_domain;
+MPI_Comm              MPI_COMM_VIC = MPI_COMM_WORLD;
+MPI_Comm              MPI_COMM_IO = MPI_COMM_NULL;
+MPI_Datatype          mpi_global_struct_type;
+MPI_Datatype          mpi_filenames_struct_type;
+MPI_Datatype          mpi_location_struct_type;
+MPI_Datatype          mpi_alarm_struct_type;
+MPI_Datatype          mpi_option_struct_type;
+MPI_Datatype          mpi_param_struct_type;
+int                  *mpi_map_local_array_sizes = NULL;
+int                  *mpi_map_global_array_offsets = NULL;
+par_io_map_struct     par_io_map;
+int                   mpi_rank;
+int                   mpi_size;
+option_struct         options;
+parameters_struct     param;
+param_set_struct      param_set;
+soil_con_struct      *soil_con = NULL;
+state_store_struct    state_store;
+veg_con_map_struct   *veg_con_map = NULL;
+veg_con_struct      **veg_con = NULL;
+veg_hist_struct     **veg_hist = NULL;
+veg_hist_struct     **veg_hist_next = NULL;  // read-ahead buffer for PIPELINE_IO
+veg_lib_struct      **veg_lib = NULL;
+metadata_struct       state_metadata[N_STATE_VARS + N_STATE_VARS_EXT];
+metadata_struct       out_metadata[N_OUTVAR_TYPES];
+save_data_struct     *save_data;  // [ncells]
+scratch_arena_struct *scratch_arenas = NULL;  // [nthreads]
+double               *cell_cost = NULL;  // [ncells]
+double             ***out_data = NULL;  // [ncells, nvars, nelem]
+stream_struct        *output_streams = NULL;  // [nstreams]
+nc_file_struct       *nc_hist_files = NULL;  // [nstreams]
 
 // Extensions
-rout_struct         rout; // Routing routine (extension)
+rout_struct           rout; // Routing routine (extension)
 
 /******************************************************************************
  * @brief   Stand-alone image mode driver of the VIC model
@@ -83,6 +92,7 @@ main(int    argc,
      char **argv)
 {
     int          status;
+    int          provided;
     timer_struct global_timers[N_TIMERS];
     char         state_filename[MAXSTRING];
 
@@ -92,7 +102,8 @@ main(int    argc,
     timer_start(&(global_timers[TIMER_VIC_INIT]));
 
     // Initialize MPI - note: logging not yet initialized
-    status = MPI_Init(&argc, &argv);
+    // MPI is only called from the master thread of each process
+    status = MPI_Init_thread(&argc, &argv, MPI_THREAD_FUNNELED, &provided);
     if (status != MPI_SUCCESS) {
         fprintf(stderr, "MPI error in main(): %d\n", status);
         exit(EXIT_FAILURE);
@@ -101,6 +112,11 @@ main(int    argc,
     // Initialize Log Destination
     initialize_log();
 
+    if (provided < MPI_THREAD_FUNNELED) {
+        log_warn("The MPI library does not support MPI_THREAD_FUNNELED; "
+                 "running with multiple OpenMP threads may not be safe.");
+    }
+
     // initialize mpi
     initialize_mpi();
 
@@ -144,18 +160,25 @@ main(int    argc,
 
     // loop over all timesteps
     for (current = 0; current < global_param.nrecs; current++) {
-        // read forcing data
-        timer_continue(&(global_timers[TIMER_VIC_FORCE]));
-        vic_force();
-        timer_stop(&(global_timers[TIMER_VIC_FORCE]));
-
-        // run vic over the domain
-        vic_image_run(&(dmy[current]));
-
-        // Write history files
-        timer_continue(&(global_timers[TIMER_VIC_WRITE]));
-        vic_write_output(&(dmy[current]));
-        timer_stop(&(global_timers[TIMER_VIC_WRITE]));
+        if (options.PIPELINE_IO) {
+            // run vic over the domain while reading the next forcing and
+            // writing the previous history
+            vic_image_run_pipelined(&(dmy[current]), global_timers);
+        }
+        else {
+            // read forcing data
+            timer_continue(&(global_timers[TIMER_VIC_FORCE]));
+            vic_force();
+            timer_stop(&(global_timers[TIMER_VIC_FORCE]));
+
+            // run vic over the domain
+            vic_image_run(&(dmy[current]));
+
+            // Write history files
+            timer_continue(&(global_timers[TIMER_VIC_WRITE]));
+            vic_write_output(&(dmy[current]));
+            timer_stop(&(global_timers[TIMER_VIC_WRITE]));
+        }
 
         // Write state file
         if (check_save_state_flag(current, &dmy_state)) {
@@ -32,10 +32,15 @@
 void
 vic_image_finalize(void)
 {
-    extern dmy_struct *dmy;
+    extern dmy_struct    *dmy;
+    extern option_struct  options;
 
     // free data structures specific to to image driver
     free(dmy);
+    if (options.PIPELINE_IO) {
+        free_pipeline_buffers();
+    }
+    free_force_cache();
 
     vic_finalize();
 }
@@ -34,10 +34,16 @@ vic_image_init(void)
 {
     extern dmy_struct         *dmy;
     extern global_param_struct global_param;
+    extern option_struct       options;
 
     // make_dmy()
     initialize_time();
     dmy = make_dmy(&global_param);
 
     vic_init();
+
+    // second set of forcing buffers to read ahead into
+    if (options.PIPELINE_IO) {
+        alloc_pipeline_buffers();
+    }
 }
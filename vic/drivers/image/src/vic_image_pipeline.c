@@ -0,0 +1,180 @@
+/******************************************************************************
+ * @section DESCRIPTION
+ *
+ * Pipelined timestep of the image driver: the forcing of the next timestep is
+ * read and the history of the previous timestep is written while the current
+ * timestep is run.
+ *
+ * @section LICENSE
+ *
+ * The Variable Infiltration Capacity (VIC) macroscale hydrological model
+ * Copyright (C) 2016 The Computational Hydrology Group, Department of Civil
+ * and Environmental Engineering, University of Washington.
+ *
+ * The VIC model is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *****************************************************************************/
+
+
+#include <vic_driver_image.h>
+#include <rout.h>   // Routing routine (extension)
+
+/******************************************************************************
+ * @brief    Allocate the second set of forcing buffers used by PIPELINE_IO.
+ *****************************************************************************/
+void
+alloc_pipeline_buffers(void)
+{
+    extern force_data_struct  *force_next;
+    extern domain_struct       local_domain;
+    extern veg_con_map_struct *veg_con_map;
+    extern veg_hist_struct   **veg_hist_next;
+
+    size_t                     i;
+    size_t                     j;
+
+    force_next = malloc(local_domain.ncells_active * sizeof(*force_next));
+    check_alloc_status(force_next, "Memory allocation error.");
+
+    veg_hist_next = malloc(local_domain.ncells_active *
+                           sizeof(*veg_hist_next));
+    check_alloc_status(veg_hist_next, "Memory allocation error.");
+
+    for (i = 0; i < local_domain.ncells_active; i++) {
+        alloc_force(&(force_next[i]));
+
+        veg_hist_next[i] = calloc(veg_con_map[i].nv_active,
+                                  sizeof(*(veg_hist_next[i])));
+        check_alloc_status(veg_hist_next[i], "Memory allocation error.");
+        for (j = 0; j < veg_con_map[i].nv_active; j++) {
+            alloc_veg_hist(&(veg_hist_next[i][j]));
+        }
+    }
+}
+
+/******************************************************************************
+ * @brief    Free the second set of forcing buffers used by PIPELINE_IO.
+ *****************************************************************************/
+void
+free_pipeline_buffers(void)
+{
+    extern force_data_struct  *force_next;
+    extern domain_struct       local_domain;
+    extern veg_con_map_struct *veg_con_map;
+    extern veg_hist_struct   **veg_hist_next;
+
+    size_t                     i;
+    size_t                     j;
+
+    for (i = 0; i < local_domain.ncells_active; i++) {
+        free_force(&(force_next[i]));
+        for (j = 0; j < veg_con_map[i].nv_active; j++) {
+            free_veg_hist(&(veg_hist_next[i][j]));
+        }
+        free(veg_hist_next[i]);
+    }
+    free(force_next);
+    free(veg_hist_next);
+}
+
+/******************************************************************************
+ * @brief    Run VIC for one timestep while reading the forcing of the next
+ *           timestep and writing the history of the previous one.
+ * @details  The I/O is done by the master thread of each process, which is
+ *           the only thread that makes MPI and netCDF calls; the other
+ *           threads start on the grid cells right away and the master thread
+ *           joins them when the I/O is done. The forcing is read into
+ *           force_next/veg_hist_next, which are swapped with force/veg_hist
+ *           at the end of the timestep. The aggregated history of the
+ *           previous timestep is not touched by the cell loop (aggregation
+ *           happens after it), so it can be written from the stream buffers
+ *           directly. State files are written between timesteps by the
+ *           caller as before.
+ *****************************************************************************/
+void
+vic_image_run_pipelined(dmy_struct   *dmy_current,
+                        timer_struct *global_timers)
+{
+    extern size_t              current;
+    extern dmy_struct         *dmy;
+    extern force_data_struct  *force;
+    extern force_data_struct  *force_next;
+    extern global_param_struct global_param;
+    extern option_struct       options;
+    extern double           ***out_data;
+    extern stream_struct      *output_streams;
+    extern veg_hist_struct   **veg_hist;
+    extern veg_hist_struct   **veg_hist_next;
+
+    char                       dmy_str[MAXSTRING];
+    size_t                     i;
+    size_t                    *cell_order = NULL;
+    force_data_struct         *force_tmp = NULL;
+    veg_hist_struct          **veg_hist_tmp = NULL;
+
+    // the forcing of the first timestep has not been read ahead
+    if (current == 0) {
+        timer_continue(&(global_timers[TIMER_VIC_FORCE]));
+        get_forcing(current, force, veg_hist);
+        timer_stop(&(global_timers[TIMER_VIC_FORCE]));
+    }
+
+    sprint_dmy(dmy_str, dmy_current);
+    debug("Running timestep %zu: %s", current, dmy_str);
+
+    cell_order = init_cell_loop();
+
+    #pragma omp parallel default(shared)
+    {
+        #pragma omp master
+        {
+            if (current > 0) {
+                timer_continue(&(global_timers[TIMER_VIC_WRITE]));
+                vic_write_output(&(dmy[current - 1]));
+                timer_stop(&(global_timers[TIMER_VIC_WRITE]));
+            }
+            if (current + 1 < global_param.nrecs) {
+                timer_continue(&(global_timers[TIMER_VIC_FORCE]));
+                get_forcing(current + 1, force_next, veg_hist_next);
+                timer_stop(&(global_timers[TIMER_VIC_FORCE]));
+            }
+        }
+
+        vic_run_cells(dmy_current, cell_order);
+    }
+
+    free(cell_order);
+
+    // run routing over the domain
+    rout_run();     // Routing routine (extension)
+
+    for (i = 0; i < options.Noutstreams; i++) {
+        agg_stream_data(&(output_streams[i]), dmy_current, out_data);
+    }
+
+    // the forcing read ahead becomes the forcing of the next timestep
+    force_tmp = force;
+    force = force_next;
+    force_next = force_tmp;
+    veg_hist_tmp = veg_hist;
+    veg_hist = veg_hist_next;
+    veg_hist_next = veg_hist_tmp;
+
+    // there is no later timestep to hide the last history write behind
+    if (current == global_param.nrecs - 1) {
+        timer_continue(&(global_timers[TIMER_VIC_WRITE]));
+        vic_write_output(dmy_current);
+        timer_stop(&(global_timers[TIMER_VIC_WRITE]));
+    }
+}
@@ -32,9 +32,16 @@
 void
 vic_image_start(void)
 {
-    extern filep_struct     filep;
-    extern filenames_struct filenames;
-    extern int              mpi_rank;
+    extern filep_struct        filep;
+    extern filenames_struct    filenames;
+    extern global_param_struct global_param;
+    extern MPI_Comm            MPI_COMM_VIC;
+    extern int                 mpi_rank;
+    extern option_struct       options;
+    extern param_set_struct    param_set;
+
+    int                        status;
+    size_t                     file_num;
 
     // Initialize structures
     initialize_global_structures();
@@ -47,4 +54,24 @@ vic_image_start(void)
 
     // initialize image mode structures and settings
     vic_start();
+
+    if (options.FORCE_IO_MODE == IO_MODE_PARALLEL) {
+        // the forcing variable names are needed on all nodes
+        status = MPI_Bcast(&param_set, sizeof(param_set_struct), MPI_BYTE,
+                           VIC_MPI_ROOT, MPI_COMM_VIC);
+        check_mpi_status(status, "MPI error.");
+
+        // reopen the forcing files of the first year on all nodes
+        for (file_num = 0; file_num < 2; file_num++) {
+            if (param_set.N_TYPES[file_num] == 0) {
+                continue;
+            }
+            if (mpi_rank == VIC_MPI_ROOT) {
+                status = nc_close(filenames.forcing[file_num].nc_id);
+                check_nc_status(status, "Error closing %s",
+                                filenames.forcing[file_num].nc_filename);
+            }
+            open_forcing_file(file_num, global_param.startyear);
+        }
+    }
 }
@@ -123,6 +123,8 @@ def make_cffi_headers():
                  'soil_thermal_eqn',
                  'zwtvmoist_zwt',
                  'zwtvmoist_moist']
+    # match whole names only, so that e.g. soil_thermal_eqn_args_struct is kept
+    omit_regex = re.compile(r'\b(%s)\b' % '|'.join(omissions))
 
     args = ['gcc', '-std=c99', '-E',
             '-P', os.path.join(vic_root_abs_path, 'vic', 'drivers',
@@ -155,6 +157,7 @@ def make_cffi_headers():
         # now we write the preprocessed headers, skipping the system headers
         f.write("headers = '''\n")
         skip_headers = True
+        statement = []
         for line in stdout.split('\n'):
             # Note: This check for LOG_DEST is here because the subprocess call
             # above includes system headers which we don't want in headers.py.
@@ -163,20 +166,23 @@ def make_cffi_headers():
             # the standard out stream.
             if 'LOG_DEST' in line:
                 skip_headers = False
-
-            # Skip some lines if they contain functions cffi cannot use
-            for omit in omissions:
-                if omit in line:
-                    skip_omit = True
-                    break
-                else:
-                    skip_omit = False
-            if not skip_headers and not skip_omit:
-                # Evaluate strings that are not completely evaluated by the
-                # preprocessor.
-                line = maybe_eval_between_brackets(line)
-                f.write(line)
-                f.write('\n')
+            if skip_headers:
+                continue
+
+            # Collect the lines of a declaration, which may span several lines
+            statement.append(line)
+            if line.rstrip() and line.rstrip()[-1] not in ';{}':
+                continue
+
+            # Skip whole declarations that name functions cffi cannot use
+            if not omit_regex.search('\n'.join(statement)):
+                for line in statement:
+                    # Evaluate strings that are not completely evaluated by the
+                    # preprocessor.
+                    line = maybe_eval_between_brackets(line)
+                    f.write(line)
+                    f.write('\n')
+            statement = []
         f.write("'''\n")
 
 # -------------------------------------------------------------------- #
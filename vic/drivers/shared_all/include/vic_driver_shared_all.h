@@ -62,6 +62,38 @@ enum
     NETCDF4
 };
 
+/******************************************************************************
+ * @brief   Parallel netCDF I/O modes
+ *****************************************************************************/
+enum
+{
+    IO_MODE_ROOT,     /**< read/write on the master process only */
+    IO_MODE_PARALLEL  /**< every process reads/writes its own cells */
+};
+
+/******************************************************************************
+ * @brief   Domain decomposition methods
+ *****************************************************************************/
+enum
+{
+    DECOMP_ROUND_ROBIN,  /**< cells are dealt to the processes in turn */
+    DECOMP_ROW_BLOCKS,   /**< contiguous blocks of cells in row-major order */
+    DECOMP_MORTON,       /**< contiguous blocks along a Morton (Z-order)
+                              curve */
+    DECOMP_HILBERT,      /**< contiguous blocks along a Hilbert curve */
+    DECOMP_BASIN         /**< whole routing basins per process */
+};
+
+/******************************************************************************
+ * @brief   OpenMP loop schedules for the grid cell loop
+ *****************************************************************************/
+enum
+{
+    CELL_SCHEDULE_STATIC,   /**< equal blocks of cells per thread */
+    CELL_SCHEDULE_DYNAMIC,  /**< chunks are handed out as threads finish */
+    CELL_SCHEDULE_GUIDED    /**< dynamic with decreasing chunk sizes */
+};
+
 /******************************************************************************
  * @brief   endian flags
  *****************************************************************************/
@@ -584,8 +616,15 @@ typedef struct {
 } timer_struct;
 
 double air_density(double t, double p);
+void agg_copy(size_t ncells, size_t nelem, double *src, double *agg);
+void agg_divide(size_t n, double count, double *agg);
+void agg_max(size_t ncells, size_t nelem, double *src, double *agg);
+void agg_min(size_t ncells, size_t nelem, double *src, double *agg);
 void agg_stream_data(stream_struct *stream, dmy_struct *dmy_current,
                      double ***out_data);
+void agg_stream_var(stream_struct *stream, size_t j, bool alarm_now,
+                    double ***out_data);
+void agg_sum(size_t ncells, size_t nelem, double *src, double *agg);
 double all_30_day_from_dmy(dmy_struct *dmy);
 double all_leap_from_dmy(dmy_struct *dmy);
 void alloc_aggdata(stream_struct *stream);
@@ -617,6 +656,9 @@ void get_current_datetime(char *cdt);
 double get_wall_time();
 double date2num(double origin, dmy_struct *date, double tzoffset,
                 unsigned short int calendar, unsigned short int time_units);
+void decode_binary_forcing(const unsigned char *restrict src, size_t stride,
+                           size_t n, bool swap, bool is_signed,
+                           double multiplier, double *restrict dst);
 void dmy_all_30_day(double julian, dmy_struct *dmy);
 void dmy_all_leap(double julian, dmy_struct *dmy);
 bool dmy_equal(dmy_struct *a, dmy_struct *b);
@@ -627,6 +669,7 @@ void dt_seconds_to_time_units(unsigned short int time_units, double dt_seconds,
                               double *dt_time_units);
 void display_current_settings(int);
 double fractional_day_from_dmy(dmy_struct *dmy);
+void free_aggdata(stream_struct *stream);
 void free_all_vars(all_vars_struct *all_vars, int Nveg);
 void free_dmy(dmy_struct **dmy);
 void free_out_data(size_t ngridcells, double ***out_data);
@@ -638,6 +681,7 @@ void generate_default_lake_state(all_vars_struct *, soil_con_struct *,
                                  lake_con_struct);
 void get_default_nstreams_nvars(size_t *nstreams, size_t nvars[]);
 void get_parameters(FILE *paramfile);
+size_t get_stream_nelem(stream_struct *stream);
 void init_output_list(double **out_data, int write, char *format, int type,
                       double mult);
 void initialize_energy(energy_bal_struct **energy, size_t nveg);
@@ -28,21 +28,19 @@
 
 /******************************************************************************
  * @brief    Perform temporal aggregation on stream data
+ * @details  The aggregation runs variable by variable over the contiguous
+ *           cell arrays of out_data and aggdata (see alloc_out_data and
+ *           alloc_aggdata), with one kernel per aggregation type. The cells
+ *           are shared out among the OpenMP threads.
  *****************************************************************************/
 void
 agg_stream_data(stream_struct *stream,
                 dmy_struct    *dmy_current,
                 double      ***out_data)
 {
-    extern metadata_struct out_metadata[N_OUTVAR_TYPES];
-
-    alarm_struct          *alarm;
-    size_t                 i;
-    size_t                 j;
-    size_t                 k;
-    size_t                 nelem;
-    unsigned int           varid;
-    bool                   alarm_now;
+    alarm_struct *alarm;
+    size_t        j;
+    bool          alarm_now;
 
     alarm = &(stream->agg_alarm);
     alarm->count++;
@@ -56,51 +54,171 @@ agg_stream_data(stream_struct *stream,
         stream->time_bounds[1] = *dmy_current;
     }
 
-    for (i = 0; i < stream->ngridcells; i++) {
+    if (stream->ngridcells == 0) {
+        return;
+    }
+
+    #pragma omp parallel default(shared) private(j) if (stream->ngridcells > 1)
+    {
         for (j = 0; j < stream->nvars; j++) {
-            varid = stream->varid[j];
-            nelem = out_metadata[varid].nelem;
-
-            // Instantaneous at the beginning of the period
-            if ((stream->aggtype[j] == AGG_TYPE_END) && (alarm_now)) {
-                for (k = 0; k < nelem; k++) {
-                    stream->aggdata[i][j][k][0] = out_data[i][varid][k];
-                }
-            }
-            // Instantaneous at the end of the period
-            else if ((stream->aggtype[j] == AGG_TYPE_BEG) &&
-                     (alarm->count == 1)) {
-                for (k = 0; k < nelem; k++) {
-                    stream->aggdata[i][j][k][0] = out_data[i][varid][k];
-                }
-            }
-            // Sum over the period
-            else if ((stream->aggtype[j] == AGG_TYPE_SUM) ||
-                     (stream->aggtype[j] == AGG_TYPE_AVG)) {
-                for (k = 0; k < nelem; k++) {
-                    stream->aggdata[i][j][k][0] += out_data[i][varid][k];
-                }
-            }
-            // Maximum over the period
-            else if (stream->aggtype[j] == AGG_TYPE_MAX) {
-                for (k = 0; k < nelem; k++) {
-                    stream->aggdata[i][j][k][0] =
-                        max(stream->aggdata[i][j][k][0], out_data[i][varid][k]);
-                }
-            }
-            // Minimum over the period
-            else if (stream->aggtype[j] == AGG_TYPE_MIN) {
-                for (k = 0; k < nelem; k++) {
-                    stream->aggdata[i][j][k][0] =
-                        min(stream->aggdata[i][j][k][0], out_data[i][varid][k]);
-                }
-            }
-            // Average over the period if counter is full
-            if ((stream->aggtype[j] == AGG_TYPE_AVG) && (alarm_now)) {
-                for (k = 0; k < nelem; k++) {
-                    stream->aggdata[i][j][k][0] /= (double) alarm->count;
-                }
-            }
+            agg_stream_var(stream, j, alarm_now, out_data);
+        }
+    }
+}
+
+/******************************************************************************
+ * @brief    Aggregate one variable of a stream for all grid cells.
+ * @details  Must be called by all threads of the enclosing parallel region.
+ *****************************************************************************/
+void
+agg_stream_var(stream_struct *stream,
+               size_t         j,
+               bool           alarm_now,
+               double      ***out_data)
+{
+    extern metadata_struct out_metadata[N_OUTVAR_TYPES];
+
+    alarm_struct          *alarm;
+    size_t                 ncells;
+    size_t                 nelem;
+    unsigned int           varid;
+    double                *agg;
+    double                *src;
+
+    alarm = &(stream->agg_alarm);
+    ncells = stream->ngridcells;
+    varid = stream->varid[j];
+    nelem = out_metadata[varid].nelem;
+
+    // [nelem, ncells] values of the variable in the stream
+    agg = stream->aggdata[0][j][0];
+    // [ncells, nelem] values of the variable in out_data
+    src = out_data[0][varid];
+
+    // Instantaneous at the beginning of the period
+    if ((stream->aggtype[j] == AGG_TYPE_END) && (alarm_now)) {
+        agg_copy(ncells, nelem, src, agg);
+    }
+    // Instantaneous at the end of the period
+    else if ((stream->aggtype[j] == AGG_TYPE_BEG) &&
+             (alarm->count == 1)) {
+        agg_copy(ncells, nelem, src, agg);
+    }
+    // Sum over the period
+    else if ((stream->aggtype[j] == AGG_TYPE_SUM) ||
+             (stream->aggtype[j] == AGG_TYPE_AVG)) {
+        agg_sum(ncells, nelem, src, agg);
+    }
+    // Maximum over the period
+    else if (stream->aggtype[j] == AGG_TYPE_MAX) {
+        agg_max(ncells, nelem, src, agg);
+    }
+    // Minimum over the period
+    else if (stream->aggtype[j] == AGG_TYPE_MIN) {
+        agg_min(ncells, nelem, src, agg);
+    }
+    // Average over the period if counter is full
+    if ((stream->aggtype[j] == AGG_TYPE_AVG) && (alarm_now)) {
+        agg_divide(ncells * nelem, (double) alarm->count, agg);
+    }
+}
+
+/******************************************************************************
+ * @brief    Copy the [ncells, nelem] values of src to the [nelem, ncells]
+ *           values of agg.
+ *****************************************************************************/
+void
+agg_copy(size_t  ncells,
+         size_t  nelem,
+         double *src,
+         double *agg)
+{
+    size_t i;
+    size_t k;
+
+    for (k = 0; k < nelem; k++) {
+        #pragma omp for schedule(static)
+        for (i = 0; i < ncells; i++) {
+            agg[k * ncells + i] = src[i * nelem + k];
+        }
+    }
+}
+
+/******************************************************************************
+ * @brief    Add the [ncells, nelem] values of src to the [nelem, ncells]
+ *           values of agg.
+ *****************************************************************************/
+void
+agg_sum(size_t  ncells,
+        size_t  nelem,
+        double *src,
+        double *agg)
+{
+    size_t i;
+    size_t k;
+
+    for (k = 0; k < nelem; k++) {
+        #pragma omp for schedule(static)
+        for (i = 0; i < ncells; i++) {
+            agg[k * ncells + i] += src[i * nelem + k];
+        }
+    }
+}
+
+/******************************************************************************
+ * @brief    Keep the maximum of the [ncells, nelem] values of src and the
+ *           [nelem, ncells] values of agg in agg.
+ *****************************************************************************/
+void
+agg_max(size_t  ncells,
+        size_t  nelem,
+        double *src,
+        double *agg)
+{
+    size_t i;
+    size_t k;
+
+    for (k = 0; k < nelem; k++) {
+        #pragma omp for schedule(static)
+        for (i = 0; i < ncells; i++) {
+            agg[k * ncells + i] = max(agg[k * ncells + i], src[i * nelem + k]);
+        }
+    }
+}
+
+/******************************************************************************
+ * @brief    Keep the minimum of the [ncells, nelem] values of src and the
+ *           [nelem, ncells] values of agg in agg.
+ *****************************************************************************/
+void
+agg_min(size_t  ncells,
+        size_t  nelem,
+        double *src,
+        double *agg)
+{
+    size_t i;
+    size_t k;
+
+    for (k = 0; k < nelem; k++) {
+        #pragma omp for schedule(static)
+        for (i = 0; i < ncells; i++) {
+            agg[k * ncells + i] = min(agg[k * ncells + i], src[i * nelem + k]);
         }
     }
 }
+
+/******************************************************************************
+ * @brief    Divide the n values of agg by count.
+ *****************************************************************************/
+void
+agg_divide(size_t  n,
+           double  count,
+           double *agg)
+{
+    size_t i;
+
+    #pragma omp for schedule(static)
+    for (i = 0; i < n; i++) {
+        agg[i] /= count;
+    }
+}
@@ -166,3 +166,57 @@ count_force_vars(FILE *gp)
 
     return nvars;
 }
+
+/******************************************************************************
+ * @brief    Decode one column of n BINARY forcing records.
+ * @details  src points to the first value of the column, and successive
+ *           values are stride bytes apart. The values are byte-swapped if
+ *           swap is TRUE, read as signed or unsigned short int, and divided
+ *           by multiplier. dst may be NULL for columns that are not used.
+ *****************************************************************************/
+void
+decode_binary_forcing(const unsigned char *restrict src,
+                      size_t                        stride,
+                      size_t                        n,
+                      bool                          swap,
+                      bool                          is_signed,
+                      double                        multiplier,
+                      double *restrict              dst)
+{
+    size_t             k;
+    unsigned short int u;
+    signed short int   s;
+
+    if (dst == NULL) {
+        return;
+    }
+
+    // keep the branches out of the loops
+    if (swap && is_signed) {
+        for (k = 0; k < n; k++) {
+            memcpy(&u, src + k * stride, sizeof(u));
+            u = (unsigned short int) ((u << 8) | (u >> 8));
+            memcpy(&s, &u, sizeof(s));
+            dst[k] = (double) s / multiplier;
+        }
+    }
+    else if (swap) {
+        for (k = 0; k < n; k++) {
+            memcpy(&u, src + k * stride, sizeof(u));
+            u = (unsigned short int) ((u << 8) | (u >> 8));
+            dst[k] = (double) u / multiplier;
+        }
+    }
+    else if (is_signed) {
+        for (k = 0; k < n; k++) {
+            memcpy(&s, src + k * stride, sizeof(s));
+            dst[k] = (double) s / multiplier;
+        }
+    }
+    else {
+        for (k = 0; k < n; k++) {
+            memcpy(&u, src + k * stride, sizeof(u));
+            dst[k] = (double) u / multiplier;
+        }
+    }
+}
@@ -93,6 +93,18 @@ initialize_options()
     options.STATE_FORMAT = UNSET_FILE_FORMAT;
     options.INIT_STATE = false;
     options.SAVE_STATE = false;
+    // parallel execution options
+    options.FORCE_IO_MODE = IO_MODE_ROOT;
+    options.HIST_IO_MODE = IO_MODE_ROOT;
+    options.DECOMP_METHOD = DECOMP_ROUND_ROBIN;
+    options.CELL_SCHEDULE = CELL_SCHEDULE_STATIC;
+    options.CELL_CHUNK_SIZE = 0;
+    options.CELL_COST_ORDER = false;
+    options.PIPELINE_IO = false;
+    options.IO_SERVER_RANKS = 0;
+    options.FORCE_BLOCK_STEPS = 1;
+    options.CONTIGUOUS_STATE = false;
+    options.ROUT_SPARSE_UH = true;
     // output options
     options.Noutstreams = 2;
 }
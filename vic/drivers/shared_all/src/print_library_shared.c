@@ -521,6 +521,24 @@ print_option(option_struct *option)
             option->INIT_STATE ? "true" : "false");
     fprintf(LOG_DEST, "\tSAVE_STATE           : %s\n",
             option->SAVE_STATE ? "true" : "false");
+    fprintf(LOG_DEST, "\tFORCE_IO_MODE        : %d\n", option->FORCE_IO_MODE);
+    fprintf(LOG_DEST, "\tHIST_IO_MODE         : %d\n", option->HIST_IO_MODE);
+    fprintf(LOG_DEST, "\tDECOMP_METHOD        : %d\n", option->DECOMP_METHOD);
+    fprintf(LOG_DEST, "\tCELL_SCHEDULE        : %d\n", option->CELL_SCHEDULE);
+    fprintf(LOG_DEST, "\tCELL_CHUNK_SIZE      : %d\n",
+            option->CELL_CHUNK_SIZE);
+    fprintf(LOG_DEST, "\tCELL_COST_ORDER      : %s\n",
+            option->CELL_COST_ORDER ? "true" : "false");
+    fprintf(LOG_DEST, "\tPIPELINE_IO          : %s\n",
+            option->PIPELINE_IO ? "true" : "false");
+    fprintf(LOG_DEST, "\tIO_SERVER_RANKS      : %zu\n",
+            option->IO_SERVER_RANKS);
+    fprintf(LOG_DEST, "\tFORCE_BLOCK_STEPS    : %zu\n",
+            option->FORCE_BLOCK_STEPS);
+    fprintf(LOG_DEST, "\tCONTIGUOUS_STATE     : %s\n",
+            option->CONTIGUOUS_STATE ? "true" : "false");
+    fprintf(LOG_DEST, "\tROUT_SPARSE_UH       : %s\n",
+            option->ROUT_SPARSE_UH ? "true" : "false");
     fprintf(LOG_DEST, "\tNoutstreams          : %zu\n", option->Noutstreams);
 }
 
@@ -28,6 +28,12 @@
 
 /******************************************************************************
  * @brief    This routine creates the list of output data.
+ * @details  The data of all grid cells and variables are stored in a single
+ *           block, ordered [N_OUTVAR_TYPES, ngridcells, nelem], so that the
+ *           values of a variable for all cells are contiguous, and so are the
+ *           pointers to the variables of each cell. out_data[0] points to the
+ *           start of the pointer block and out_data[0][0] to the start of the
+ *           data block.
  *****************************************************************************/
 void
 alloc_out_data(size_t    ngridcells,
@@ -37,16 +43,34 @@ alloc_out_data(size_t    ngridcells,
 
     size_t                 i;
     size_t                 j;
+    size_t                 nelem;
+    size_t                 offset;
+    double               **ptrs;
+    double                *data;
+
+    if (ngridcells == 0) {
+        return;
+    }
+
+    nelem = 0;
+    for (j = 0; j < N_OUTVAR_TYPES; j++) {
+        nelem += out_metadata[j].nelem;
+    }
+
+    ptrs = calloc(ngridcells * N_OUTVAR_TYPES, sizeof(*ptrs));
+    check_alloc_status(ptrs, "Memory allocation error.");
+    data = calloc(ngridcells * nelem, sizeof(*data));
+    check_alloc_status(data, "Memory allocation error.");
 
     for (i = 0; i < ngridcells; i++) {
-        out_data[i] = calloc(N_OUTVAR_TYPES, sizeof(*(out_data[i])));
-        check_alloc_status(out_data[i], "Memory allocation error.");
-        // Allocate space for data
-        for (j = 0; j < N_OUTVAR_TYPES; j++) {
-            out_data[i][j] =
-                calloc(out_metadata[j].nelem, sizeof(*(out_data[i][j])));
-            check_alloc_status(out_data[i][j], "Memory allocation error.");
+        out_data[i] = &(ptrs[i * N_OUTVAR_TYPES]);
+    }
+    offset = 0;
+    for (j = 0; j < N_OUTVAR_TYPES; j++) {
+        for (i = 0; i < ngridcells; i++) {
+            out_data[i][j] = &(data[offset + i * out_metadata[j].nelem]);
         }
+        offset += ngridcells * out_metadata[j].nelem;
     }
 }
 
@@ -155,9 +179,35 @@ validate_streams(stream_struct **streams)
     }
 }
 
+/******************************************************************************
+ * @brief   This routine returns the number of values per grid cell in the
+            stream aggdata array.
+ *****************************************************************************/
+size_t
+get_stream_nelem(stream_struct *stream)
+{
+    extern metadata_struct out_metadata[N_OUTVAR_TYPES];
+
+    size_t                 j;
+    size_t                 nelem;
+
+    nelem = 0;
+    for (j = 0; j < stream->nvars; j++) {
+        nelem += out_metadata[stream->varid[j]].nelem;
+    }
+
+    return nelem;
+}
+
 /******************************************************************************
  * @brief   This routine allocates memory for the stream aggdata array.  The
             shape of this array is [ngridcells, nvars, nelems, nbins].
+ * @details Each level of the array is allocated as a single block, so
+            aggdata[0], aggdata[0][0] and aggdata[0][0][0] are the start of
+            the blocks. The data are ordered [nvars, nelems, ngridcells], so
+            that the values of a variable element for all cells are
+            contiguous. The blocks are only allocated if the stream has both
+            grid cells and variables.
  *****************************************************************************/
 void
 alloc_aggdata(stream_struct *stream)
@@ -168,27 +218,35 @@ alloc_aggdata(stream_struct *stream)
     size_t                 j;
     size_t                 k;
     size_t                 nelem;
+    size_t                 offset;
+    double              ***var_ptrs;
+    double               **elem_ptrs;
+    double                *data;
 
     stream->aggdata = calloc(stream->ngridcells, sizeof(*(stream->aggdata)));
     check_alloc_status(stream->aggdata, "Memory allocation error.");
 
+    // TODO: Also allocate for nbins, for now just setting to size 1
+    nelem = get_stream_nelem(stream);
+    if (stream->ngridcells == 0 || nelem == 0) {
+        return;
+    }
+
+    var_ptrs = calloc(stream->ngridcells * stream->nvars, sizeof(*var_ptrs));
+    check_alloc_status(var_ptrs, "Memory allocation error.");
+    elem_ptrs = calloc(stream->ngridcells * nelem, sizeof(*elem_ptrs));
+    check_alloc_status(elem_ptrs, "Memory allocation error.");
+    data = calloc(stream->ngridcells * nelem, sizeof(*data));
+    check_alloc_status(data, "Memory allocation error.");
+
     for (i = 0; i < stream->ngridcells; i++) {
-        stream->aggdata[i] =
-            calloc(stream->nvars, sizeof(*(stream->aggdata[i])));
-        check_alloc_status(stream->aggdata[i], "Memory allocation error.");
+        stream->aggdata[i] = &(var_ptrs[i * stream->nvars]);
+        offset = 0;
         for (j = 0; j < stream->nvars; j++) {
-            nelem = out_metadata[stream->varid[j]].nelem;
-            stream->aggdata[i][j] =
-                calloc(nelem, sizeof(*(stream->aggdata[i][j])));
-            check_alloc_status(stream->aggdata[i][j],
-                               "Memory allocation error.");
-
-            for (k = 0; k < nelem; k++) {
-                // TODO: Also allocate for nbins, for now just setting to size 1
-                stream->aggdata[i][j][k] =
-                    calloc(1, sizeof(*(stream->aggdata[i][j][k])));
-                check_alloc_status(stream->aggdata[i][j][k],
-                                   "Memory allocation error.");
+            stream->aggdata[i][j] = elem_ptrs;
+            for (k = 0; k < out_metadata[stream->varid[j]].nelem; k++) {
+                *(elem_ptrs++) = &(data[offset + i]);
+                offset += stream->ngridcells;
             }
         }
     }
@@ -203,22 +261,13 @@ reset_stream(stream_struct *stream,
 {
     extern metadata_struct out_metadata[N_OUTVAR_TYPES];
 
-    size_t                 i;
-    size_t                 j;
-    size_t                 k;
-    size_t                 varid;
-
     // Reset alarm to next agg period
     reset_alarm(&(stream->agg_alarm), dmy_current);
 
     // Set aggdata to zero
-    for (i = 0; i < stream->ngridcells; i++) {
-        for (j = 0; j < stream->nvars; j++) {
-            varid = stream->varid[j];
-            for (k = 0; k < out_metadata[varid].nelem; k++) {
-                stream->aggdata[i][j][k][0] = 0.;
-            }
-        }
+    if (stream->ngridcells > 0 && get_stream_nelem(stream) > 0) {
+        memset(stream->aggdata[0][0][0], 0, stream->ngridcells *
+               get_stream_nelem(stream) * sizeof(*(stream->aggdata[0][0][0])));
     }
 }
 
@@ -389,38 +438,38 @@ set_output_var(stream_struct     *stream,
     }
 }
 
+/******************************************************************************
+ * @brief    This routine frees the memory of the stream aggdata array.
+ *****************************************************************************/
+void
+free_aggdata(stream_struct *stream)
+{
+    if (stream->ngridcells > 0 && get_stream_nelem(stream) > 0) {
+        free(stream->aggdata[0][0][0]);
+        free(stream->aggdata[0][0]);
+        free(stream->aggdata[0]);
+    }
+    free(stream->aggdata);
+}
+
 /******************************************************************************
  * @brief    This routine frees the memory in the streams array.
  *****************************************************************************/
 void
 free_streams(stream_struct **streams)
 {
-    extern option_struct   options;
-    extern metadata_struct out_metadata[N_OUTVAR_TYPES];
+    extern option_struct options;
 
-    size_t                 streamnum;
-    size_t                 i;
-    size_t                 j;
-    size_t                 k;
-    size_t                 varid;
+    size_t               streamnum;
+    size_t               j;
 
     // free output streams
     for (streamnum = 0; streamnum < options.Noutstreams; streamnum++) {
         // Free aggdata first
-        for (i = 0; i < (*streams)[streamnum].ngridcells; i++) {
-            for (j = 0; j < (*streams)[streamnum].nvars; j++) {
-                varid = (*streams)[streamnum].varid[j];
-                for (k = 0; k < out_metadata[varid].nelem; k++) {
-                    free((*streams)[streamnum].aggdata[i][j][k]);
-                }
-                free((*streams)[streamnum].aggdata[i][j]);
-            }
-            free((*streams)[streamnum].aggdata[i]);
-        }
+        free_aggdata(&((*streams)[streamnum]));
         for (j = 0; j < (*streams)[streamnum].nvars; j++) {
             free((*streams)[streamnum].format[j]);
         }
-        free((*streams)[streamnum].aggdata);
         // free remaining arrays
         free((*streams)[streamnum].type);
         free((*streams)[streamnum].mult);
@@ -438,19 +487,13 @@ void
 free_out_data(size_t    ngridcells,
               double ***out_data)
 {
-    size_t i;
-    size_t j;
-
-
     if (out_data == NULL) {
         return;
     }
 
-    for (i = 0; i < ngridcells; i++) {
-        for (j = 0; j < N_OUTVAR_TYPES; j++) {
-            free(out_data[i][j]);
-        }
-        free(out_data[i]);
+    if (ngridcells > 0) {
+        free(out_data[0][0]);
+        free(out_data[0]);
     }
 
     free(out_data);
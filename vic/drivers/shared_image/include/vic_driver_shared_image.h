@@ -33,6 +33,16 @@
 #include <vic_mpi.h>
 
 #include <netcdf.h>
+#include <netcdf_meta.h>
+
+// Parallel netCDF I/O requires a netCDF library built with parallel support
+// (MPI-IO through HDF5 and/or PnetCDF)
+#if defined(NC_HAS_PARALLEL) && NC_HAS_PARALLEL
+#include <netcdf_par.h>
+#define VIC_NC_PARALLEL 1
+#else
+#define VIC_NC_PARALLEL 0
+#endif
 
 #define MAXDIMS 10
 #define AREA_SUM_ERROR_THRESH 1e-20
@@ -92,6 +102,34 @@ typedef struct {
     domain_info_struct info; /**< structure storing domain file info */
 } domain_struct;
 
+/******************************************************************************
+ * @brief    Sort key used to order grid cells for the domain decomposition
+ *****************************************************************************/
+typedef struct {
+    size_t key;   /**< sort key */
+    double cost;  /**< computational cost */
+    size_t idx;   /**< index of the grid cell */
+} decomp_key_struct;
+
+/******************************************************************************
+ * @brief    Structure to store the exchange pattern used to write netCDF
+ *           fields from all processes. Each process writes a contiguous block
+ *           of rows of the global domain.
+ *****************************************************************************/
+typedef struct {
+    size_t row_start;     /**< first row of the global domain written here */
+    size_t nrows;         /**< number of rows written by this process */
+    size_t nrecv;         /**< number of active cells received for writing */
+    size_t *send_order;   /**< local cell index of each element sent */
+    size_t *recv_idx;     /**< index in the row block of each element
+                               received */
+    int *send_counts;     /**< number of cells sent to each process */
+    int *send_displs;     /**< offsets of the cells sent to each process */
+    int *recv_counts;     /**< number of cells received from each process */
+    int *recv_displs;     /**< offsets of the cells received from each
+                               process */
+} par_io_map_struct;
+
 /******************************************************************************
  * @brief    Structure for netcdf variable information
  *****************************************************************************/
@@ -145,6 +183,9 @@ typedef struct {
     size_t veg_size;
     bool open;
     nc_var_struct *nc_vars;
+    int io_rank;            /**< process that writes the file */
+    double *io_buf;         /**< data sent to the I/O server */
+    MPI_Request io_request; /**< pending send to the I/O server */
 } nc_file_struct;
 
 /******************************************************************************
@@ -162,6 +203,34 @@ typedef struct {
     double *Cv;    /**< array of fractional coverage for nc_types */
 } veg_con_map_struct;
 
+/******************************************************************************
+ * @brief    Structure to store the model state of all local grid cells in
+ *           contiguous arrays (CONTIGUOUS_STATE = TRUE).
+ * @details  Every state array is ordered [cell][veg][band], where veg runs
+ *           over the nv_active tiles of each cell. The pointer tables are
+ *           handed to all_vars, so that code that uses
+ *           all_vars[cell].snow[veg][band] works on the same memory.
+ *****************************************************************************/
+typedef struct {
+    size_t ntiles;                   /**< total number of vegetation tiles */
+    size_t *offset;                  /**< index of the first tile of each
+                                          cell [ncells] */
+    cell_data_struct *cell;          /**< soil states [ntiles * SNOW_BAND] */
+    energy_bal_struct *energy;       /**< energy states [ntiles * SNOW_BAND] */
+    snow_data_struct *snow;          /**< snow states [ntiles * SNOW_BAND] */
+    veg_var_struct *veg_var;         /**< vegetation states
+                                          [ntiles * SNOW_BAND] */
+    double *NscaleFactor;            /**< canopy layer arrays of veg_var
+                                          [ntiles * SNOW_BAND * Ncanopy] */
+    double *aPARLayer;               /**< see NscaleFactor */
+    double *CiLayer;                 /**< see NscaleFactor */
+    double *rsLayer;                 /**< see NscaleFactor */
+    cell_data_struct **cell_ptr;     /**< first band of each tile [ntiles] */
+    energy_bal_struct **energy_ptr;  /**< first band of each tile [ntiles] */
+    snow_data_struct **snow_ptr;     /**< first band of each tile [ntiles] */
+    veg_var_struct **veg_var_ptr;    /**< first band of each tile [ntiles] */
+} state_store_struct;
+
 /******************************************************************************
  * @brief   file structures
  *****************************************************************************/
@@ -187,6 +256,8 @@ typedef struct {
     char result_dir[MAXSTRING]; /**< result directory */
     char statefile[MAXSTRING];  /**< name of model state file */
     char log_path[MAXSTRING];   /**< Location to write log file to */
+    char cost_map[MAXSTRING];   /**< cost map used for load balancing */
+    char cost_map_out[MAXSTRING]; /**< cost map written at the end of the run */
 } filenames_struct;
 
 void add_nveg_to_global_domain(nameid_struct *nc_nameid,
@@ -195,10 +266,26 @@ void alloc_force(force_data_struct *force);
 void alloc_veg_hist(veg_hist_struct *veg_hist);
 double air_density(double t, double p);
 double average(double *ar, size_t n);
+void assign_ranks_by_cost(size_t ncells, size_t mpi_size, size_t *cell_order,
+                          double *cost, int *cell_rank);
 void check_init_state_file(void);
 void compare_ncdomain_with_global_domain(nameid_struct *nc_nameid);
+int decomp_cost_compare(const void *a, const void *b);
+int decomp_key_compare(const void *a, const void *b);
+void decompose_domain(domain_struct *domain, size_t mpi_size,
+                      int **mpi_map_local_array_sizes,
+                      int **mpi_map_global_array_offsets,
+                      size_t **mpi_map_mapping_array);
+void finalize_io_servers(void);
+void finalize_par_io_map(void);
 void free_force(force_data_struct *force);
+void free_state_store(void);
+void get_cost_cell_order(size_t ncells, double *cost, size_t *cell_order);
 void free_veg_hist(veg_hist_struct *veg_hist);
+void get_basin_decomp(domain_struct *domain, size_t mpi_size, double *cost,
+                      size_t *cell_order, int *cell_rank);
+void get_curve_decomp_order(domain_struct *domain, unsigned short int method,
+                            size_t *cell_order);
 void get_domain_type(char *cmdstr);
 size_t get_global_domain(nameid_struct *domain_nc_nameid,
                          nameid_struct *param_nc_nameid,
@@ -206,6 +293,8 @@ size_t get_global_domain(nameid_struct *domain_nc_nameid,
 void copy_domain_info(domain_struct *domain_from, domain_struct *domain_to);
 void get_nc_latlon(nameid_struct *nc_nameid, domain_struct *nc_domain);
 size_t get_nc_dimension(nameid_struct *nc_nameid, char *dim_name);
+int get_stream_io_rank(size_t stream_idx);
+size_t get_stream_io_nvals(stream_struct *stream);
 void get_nc_var_attr(nameid_struct *nc_nameid, char *var_name, char *attr_name,
                      char **attr);
 int get_nc_var_type(nameid_struct *nc_nameid, char *var_name);
@@ -217,13 +306,17 @@ int get_nc_field_float(nameid_struct *nc_nameid, char *var_name, size_t *start,
 int get_nc_field_int(nameid_struct *nc_nameid, char *var_name, size_t *start,
                      size_t *count, int *var);
 int get_nc_dtype(unsigned short int dtype);
+void get_par_nc_field_double(nameid_struct *nc_nameid, char *var_name,
+                             size_t *start, size_t *count, double *var);
 int get_nc_mode(unsigned short int format);
+size_t *init_cell_loop(void);
 void initialize_domain(domain_struct *domain);
 void initialize_domain_info(domain_info_struct *info);
 void initialize_filenames(void);
 void initialize_fileps(void);
 void initialize_global_structures(void);
 void initialize_history_file(nc_file_struct *nc, stream_struct *stream);
+void initialize_io_servers(void);
 void initialize_state_file(char *filename, nc_file_struct *nc_state_file,
                            dmy_struct *dmy_state);
 void initialize_location(location_struct *location);
@@ -232,8 +325,18 @@ int initialize_model_state(all_vars_struct *all_vars, size_t Nveg,
                            soil_con_struct *soil_con, veg_con_struct *veg_con);
 void initialize_nc_file(nc_file_struct *nc_file, size_t nvars,
                         unsigned int *varids, unsigned short int *dtypes);
+void initialize_par_history_file(nc_file_struct *nc, stream_struct *stream);
+void initialize_par_io_map(void);
 void initialize_soil_con(soil_con_struct *soil_con);
 void initialize_veg_con(veg_con_struct *veg_con);
+size_t hilbert_curve_index(size_t n, size_t x, size_t y);
+void make_state_store(void);
+size_t morton_curve_index(size_t x, size_t y);
+size_t par_io_row_start(int rank);
+void read_cost_map(domain_struct *domain, double *cost);
+void recv_put_stream_data(stream_struct *stream, nc_file_struct *nc_hist_file);
+void reserve_io_server_ranks(int **mpi_map_local_array_sizes,
+                             int **mpi_map_global_array_offsets);
 void parse_output_info(FILE *gp, stream_struct **output_streams,
                        dmy_struct *dmy_current);
 void print_force_data(force_data_struct *force);
@@ -243,6 +346,19 @@ void print_nc_file(nc_file_struct *nc);
 void print_nc_var(nc_var_struct *nc_var);
 void print_veg_con_map(veg_con_map_struct *veg_con_map);
 void put_nc_attr(int nc_id, int var_id, const char *name, const char *value);
+void put_par_nc_field_double(int nc_id, int var_id, double fillval,
+                             size_t ndims, size_t *start, size_t *count,
+                             double *var);
+void put_par_nc_field_float(int nc_id, int var_id, float fillval, size_t ndims,
+                            size_t *start, size_t *count, float *var);
+void put_par_nc_field_int(int nc_id, int var_id, int fillval, size_t ndims,
+                          size_t *start, size_t *count, int *var);
+void put_par_nc_field_short(int nc_id, int var_id, short int fillval,
+                            size_t ndims, size_t *start, size_t *count,
+                            short int *var);
+void put_par_nc_field_schar(int nc_id, int var_id, char fillval, size_t ndims,
+                            size_t *start, size_t *count, char *var);
+void send_stream_data(stream_struct *stream, nc_file_struct *nc_hist_file);
 void set_force_type(char *cmdstr, int file_num, int *field);
 void set_global_nc_attributes(int ncid, unsigned short int file_type);
 void set_state_meta_data_info();
@@ -252,17 +368,24 @@ void set_nc_var_info(unsigned int varid, unsigned short int dtype,
                      nc_file_struct *nc_hist_file, nc_var_struct *nc_var);
 void set_nc_state_file_info(nc_file_struct *nc_state_file);
 void set_nc_state_var_info(nc_file_struct *nc_state_file);
+void set_par_io_slab(size_t ndims, size_t *start, size_t *count,
+                     size_t *dstart, size_t *dcount);
 void sprint_location(char *str, location_struct *loc);
+size_t state_store_index(size_t cell, size_t veg, size_t band);
+void update_store_step_vars(size_t cell, veg_con_struct *veg_con,
+                            veg_hist_struct *veg_hist);
 void vic_alloc(void);
 void vic_finalize(void);
 void vic_image_run(dmy_struct *dmy_current);
 void vic_init(void);
 void vic_init_output(dmy_struct *dmy_current);
 void vic_restore(void);
+void vic_run_cells(dmy_struct *dmy_current, size_t *cell_order);
 void vic_start(void);
 void vic_store(dmy_struct *dmy_state, char *state_filename);
 void vic_write(stream_struct *stream, nc_file_struct *nc_hist_file,
                dmy_struct *dmy_current);
 void vic_write_output(dmy_struct *dmy);
+void write_cost_map(void);
 void write_vic_timing_table(timer_struct *timers, char *driver);
 #endif
@@ -28,11 +28,13 @@
 #define VIC_MPI_H
 
 #include <vic_def.h>
+#include <limits.h>
 #include <mpi.h>
 #ifdef _OPENMP
     #include <omp.h>
 #else
     #define omp_get_max_threads() 1
+    #define omp_get_thread_num() 0
 #endif
 
 #define VIC_MPI_ROOT 0
@@ -63,6 +65,7 @@ void gather_put_nc_field_short(int nc_id, int var_id, short int fillval,
 void gather_put_nc_field_schar(int nc_id, int var_id, char fillval,
                                size_t *start, size_t *count, char *var);
 void scatter_field_double(double *dvar, double *var);
+void scatter_field_steps_double(size_t nsteps, double *dvar, double *var);
 void get_scatter_nc_field_double(nameid_struct *nc_nameid, char *var_name,
                                  size_t *start, size_t *count, double *var);
 void get_scatter_nc_field_float(nameid_struct *nc_nameid, char *var_name,
@@ -76,6 +79,11 @@ void mpi_map_decomp_domain(size_t ncells, size_t mpi_size,
                            int **mpi_map_local_array_sizes,
                            int **mpi_map_global_array_offsets,
                            size_t **mpi_map_mapping_array);
+void mpi_map_decomp_domain_ranks(size_t ncells, size_t mpi_size,
+                                 size_t *cell_order, int *cell_rank,
+                                 int **mpi_map_local_array_sizes,
+                                 int **mpi_map_global_array_offsets,
+                                 size_t **mpi_map_mapping_array);
 void print_mpi_error_str(int error_code);
 
 #endif
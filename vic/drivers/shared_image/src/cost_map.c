@@ -0,0 +1,223 @@
+/******************************************************************************
+ * @section DESCRIPTION
+ *
+ * Read and write maps of the computational cost of each grid cell. These are
+ * used to balance the load over the MPI processes.
+ *
+ * @section LICENSE
+ *
+ * The Variable Infiltration Capacity (VIC) macroscale hydrological model
+ * Copyright (C) 2016 The Computational Hydrology Group, Department of Civil
+ * and Environmental Engineering, University of Washington.
+ *
+ * The VIC model is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *****************************************************************************/
+
+#include <vic_driver_shared_image.h>
+
+/******************************************************************************
+ * @brief    Read the cost of each active cell from the cost map.
+ * @details  Only called on the master process. Cells without a valid
+ *           (positive) cost get the mean cost of the other cells.
+ *****************************************************************************/
+void
+read_cost_map(domain_struct *domain,
+              double        *cost)
+{
+    extern filenames_struct filenames;
+
+    int                     status;
+    size_t                  d2start[2];
+    size_t                  d2count[2];
+    size_t                  i;
+    size_t                  j;
+    size_t                  nvalid;
+    double                  mean;
+    double                 *dvar = NULL;
+    nameid_struct           cost_map;
+
+    strcpy(cost_map.nc_filename, filenames.cost_map);
+    status = nc_open(cost_map.nc_filename, NC_NOWRITE, &(cost_map.nc_id));
+    check_nc_status(status, "Error opening %s", cost_map.nc_filename);
+
+    // make sure the cost map has the same shape as the domain
+    if (get_nc_dimension(&cost_map, domain->info.y_dim) != domain->n_ny ||
+        get_nc_dimension(&cost_map, domain->info.x_dim) != domain->n_nx) {
+        log_err("The dimensions of %s do not match the domain",
+                cost_map.nc_filename);
+    }
+
+    dvar = malloc(domain->n_ny * domain->n_nx * sizeof(*dvar));
+    check_alloc_status(dvar, "Memory allocation error.");
+
+    d2start[0] = 0;
+    d2start[1] = 0;
+    d2count[0] = domain->n_ny;
+    d2count[1] = domain->n_nx;
+    get_nc_field_double(&cost_map, "cost", d2start, d2count, dvar);
+
+    status = nc_close(cost_map.nc_id);
+    check_nc_status(status, "Error closing %s", cost_map.nc_filename);
+
+    mean = 0.;
+    nvalid = 0;
+    for (i = 0, j = 0; i < domain->ncells_total; i++) {
+        if (!domain->locations[i].run) {
+            continue;
+        }
+        cost[j] = dvar[domain->locations[i].io_idx];
+        if (isfinite(cost[j]) && cost[j] > 0. && cost[j] < NC_FILL_DOUBLE) {
+            mean += cost[j];
+            nvalid++;
+        }
+        else {
+            cost[j] = -1.;
+        }
+        j++;
+    }
+    if (nvalid == 0) {
+        log_err("No valid cost values in %s", cost_map.nc_filename);
+    }
+    mean /= nvalid;
+    if (nvalid < domain->ncells_active) {
+        log_warn("%zu active cells without a valid cost in %s, using the "
+                 "mean cost for them", domain->ncells_active - nvalid,
+                 cost_map.nc_filename);
+        for (j = 0; j < domain->ncells_active; j++) {
+            if (cost[j] < 0.) {
+                cost[j] = mean;
+            }
+        }
+    }
+
+    free(dvar);
+}
+
+/******************************************************************************
+ * @brief    Write the mean cost of vic_run per time step of each cell.
+ * @details  Must be called by all processes. The file can be used as cost
+ *           map (COST_MAP) for later runs.
+ *****************************************************************************/
+void
+write_cost_map(void)
+{
+    extern double             *cell_cost;
+    extern filenames_struct    filenames;
+    extern domain_struct       global_domain;
+    extern domain_struct       local_domain;
+    extern global_param_struct global_param;
+    extern int                 mpi_rank;
+
+    int                        status;
+    int                        nc_id;
+    int                        dimids[2];
+    int                        var_id;
+    double                     fillval;
+    size_t                     d2start[2];
+    size_t                     d2count[2];
+    size_t                     grid_size;
+    size_t                     i;
+    double                    *dvar = NULL;
+    double                    *cost = NULL;
+
+    fillval = NC_FILL_DOUBLE;
+
+    // mean wall time per time step
+    cost = malloc((local_domain.ncells_active + 1) * sizeof(*cost));
+    check_alloc_status(cost, "Memory allocation error.");
+    for (i = 0; i < local_domain.ncells_active; i++) {
+        cost[i] = cell_cost[i] / global_param.nrecs;
+    }
+
+    if (mpi_rank == VIC_MPI_ROOT) {
+        grid_size = global_domain.n_nx * global_domain.n_ny;
+        dvar = malloc(grid_size * sizeof(*dvar));
+        check_alloc_status(dvar, "Memory allocation error.");
+    }
+    gather_field_double(fillval, dvar, cost);
+
+    if (mpi_rank == VIC_MPI_ROOT) {
+        status = nc_create(filenames.cost_map_out,
+                           get_nc_mode(NETCDF4_CLASSIC), &nc_id);
+        check_nc_status(status, "Error creating %s", filenames.cost_map_out);
+
+        status = nc_def_dim(nc_id, global_domain.info.y_dim,
+                            global_domain.n_ny, &(dimids[0]));
+        check_nc_status(status, "Error defining y dimension in %s",
+                        filenames.cost_map_out);
+        status = nc_def_dim(nc_id, global_domain.info.x_dim,
+                            global_domain.n_nx, &(dimids[1]));
+        check_nc_status(status, "Error defining x dimension in %s",
+                        filenames.cost_map_out);
+
+        status = nc_def_var(nc_id, "cost", NC_DOUBLE, 2, dimids, &var_id);
+        check_nc_status(status, "Error defining cost variable in %s",
+                        filenames.cost_map_out);
+        status = nc_put_att_double(nc_id, var_id, "_FillValue", NC_DOUBLE, 1,
+                                   &fillval);
+        check_nc_status(status, "Error adding fill value in %s",
+                        filenames.cost_map_out);
+        put_nc_attr(nc_id, var_id, "long_name",
+                    "mean wall time of vic_run per time step");
+        put_nc_attr(nc_id, var_id, "units", "s");
+
+        status = nc_enddef(nc_id);
+        check_nc_status(status, "Error leaving define mode for %s",
+                        filenames.cost_map_out);
+
+        d2start[0] = 0;
+        d2start[1] = 0;
+        d2count[0] = global_domain.n_ny;
+        d2count[1] = global_domain.n_nx;
+        status = nc_put_vara_double(nc_id, var_id, d2start, d2count, dvar);
+        check_nc_status(status, "Error writing cost to %s",
+                        filenames.cost_map_out);
+
+        status = nc_close(nc_id);
+        check_nc_status(status, "Error closing %s", filenames.cost_map_out);
+
+        free(dvar);
+    }
+
+    free(cost);
+}
+
+/******************************************************************************
+ * @brief    Order the local cells by descending cost.
+ * @details  Cells with equal cost keep their original order.
+ *****************************************************************************/
+void
+get_cost_cell_order(size_t  ncells,
+                    double *cost,
+                    size_t *cell_order)
+{
+    size_t             i;
+    decomp_key_struct *keys = NULL;
+
+    keys = malloc((ncells + 1) * sizeof(*keys));
+    check_alloc_status(keys, "Memory allocation error.");
+
+    for (i = 0; i < ncells; i++) {
+        keys[i].key = 0;
+        keys[i].cost = cost[i];
+        keys[i].idx = i;
+    }
+    qsort(keys, ncells, sizeof(*keys), decomp_cost_compare);
+    for (i = 0; i < ncells; i++) {
+        cell_order[i] = keys[i].idx;
+    }
+
+    free(keys);
+}
@@ -0,0 +1,469 @@
+/******************************************************************************
+ * @section DESCRIPTION
+ *
+ * Decompose the active cells of the global domain over the MPI processes.
+ *
+ * @section LICENSE
+ *
+ * The Variable Infiltration Capacity (VIC) macroscale hydrological model
+ * Copyright (C) 2016 The Computational Hydrology Group, Department of Civil
+ * and Environmental Engineering, University of Washington.
+ *
+ * The VIC model is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *****************************************************************************/
+
+#include <vic_driver_shared_image.h>
+
+/******************************************************************************
+ * @brief    Decompose the domain for MPI operations using the method set in
+ *           options.DECOMP_METHOD.
+ * @details  Only called on the master process. See mpi_map_decomp_domain for
+ *           a description of the output arrays. If a cost map is given, the
+ *           cells are distributed so that every process gets about the same
+ *           total cost instead of the same number of cells.
+ *****************************************************************************/
+void
+decompose_domain(domain_struct *domain,
+                 size_t         mpi_size,
+                 int          **mpi_map_local_array_sizes,
+                 int          **mpi_map_global_array_offsets,
+                 size_t       **mpi_map_mapping_array)
+{
+    extern filenames_struct filenames;
+    extern option_struct    options;
+
+    size_t                  ncells;
+    size_t                  i;
+    size_t                 *cell_order = NULL;
+    int                    *cell_rank = NULL;
+    double                 *cost = NULL;
+
+    ncells = domain->ncells_active;
+
+    if (options.DECOMP_METHOD == DECOMP_ROUND_ROBIN) {
+        if (strcasecmp(filenames.cost_map, "MISSING") != 0) {
+            log_warn("The cost map %s is not used with DECOMP_METHOD = "
+                     "ROUND_ROBIN", filenames.cost_map);
+        }
+        mpi_map_decomp_domain(ncells, mpi_size, mpi_map_local_array_sizes,
+                              mpi_map_global_array_offsets,
+                              mpi_map_mapping_array);
+        return;
+    }
+
+    cell_order = malloc((ncells + 1) * sizeof(*cell_order));
+    check_alloc_status(cell_order, "Memory allocation error.");
+    cell_rank = malloc((ncells + 1) * sizeof(*cell_rank));
+    check_alloc_status(cell_rank, "Memory allocation error.");
+    cost = malloc((ncells + 1) * sizeof(*cost));
+    check_alloc_status(cost, "Memory allocation error.");
+
+    // cost of each active cell (all cells cost the same without a cost map)
+    if (strcasecmp(filenames.cost_map, "MISSING") != 0) {
+        read_cost_map(domain, cost);
+    }
+    else {
+        for (i = 0; i < ncells; i++) {
+            cost[i] = 1.;
+        }
+    }
+
+    if (options.DECOMP_METHOD == DECOMP_BASIN) {
+        get_basin_decomp(domain, mpi_size, cost, cell_order, cell_rank);
+    }
+    else {
+        // order the cells along a curve and cut it in pieces of equal cost
+        get_curve_decomp_order(domain, options.DECOMP_METHOD, cell_order);
+        assign_ranks_by_cost(ncells, mpi_size, cell_order, cost, cell_rank);
+    }
+
+    mpi_map_decomp_domain_ranks(ncells, mpi_size, cell_order, cell_rank,
+                                mpi_map_local_array_sizes,
+                                mpi_map_global_array_offsets,
+                                mpi_map_mapping_array);
+
+    free(cell_order);
+    free(cell_rank);
+    free(cost);
+}
+
+/******************************************************************************
+ * @brief    Cut an ordered list of cells into mpi_size contiguous pieces of
+ *           about equal total cost.
+ * @details  Every process gets at least one cell if there are enough cells.
+ *****************************************************************************/
+void
+assign_ranks_by_cost(size_t  ncells,
+                     size_t  mpi_size,
+                     size_t *cell_order,
+                     double *cost,
+                     int    *cell_rank)
+{
+    size_t i;
+    size_t k;
+    size_t rank;
+    size_t nassigned;
+    double total;
+    double cum;
+
+    total = 0.;
+    for (i = 0; i < ncells; i++) {
+        total += cost[i];
+    }
+
+    rank = 0;
+    nassigned = 0;
+    cum = 0.;
+    for (k = 0; k < ncells; k++) {
+        i = cell_order[k];
+        // move on to the next process once this one has its share of the
+        // cost, or when the remaining cells are needed to give every
+        // remaining process a cell
+        if (rank < mpi_size - 1 && nassigned > 0 &&
+            (cum + 0.5 * cost[i] > (rank + 1) * total / mpi_size ||
+             ncells - k <= mpi_size - 1 - rank)) {
+            rank++;
+            nassigned = 0;
+        }
+        cell_rank[i] = (int) rank;
+        cum += cost[i];
+        nassigned++;
+    }
+}
+
+/******************************************************************************
+ * @brief    Compare two decomposition keys (for qsort).
+ * @details  Ties are broken by index so that the sort is deterministic.
+ *****************************************************************************/
+int
+decomp_key_compare(const void *a,
+                   const void *b)
+{
+    const decomp_key_struct *ka = (const decomp_key_struct *) a;
+    const decomp_key_struct *kb = (const decomp_key_struct *) b;
+
+    if (ka->key != kb->key) {
+        return (ka->key < kb->key) ? -1 : 1;
+    }
+    if (ka->idx != kb->idx) {
+        return (ka->idx < kb->idx) ? -1 : 1;
+    }
+    return 0;
+}
+
+/******************************************************************************
+ * @brief    Compare two decomposition keys by decreasing cost (for qsort).
+ *****************************************************************************/
+int
+decomp_cost_compare(const void *a,
+                    const void *b)
+{
+    const decomp_key_struct *ka = (const decomp_key_struct *) a;
+    const decomp_key_struct *kb = (const decomp_key_struct *) b;
+
+    if (ka->cost != kb->cost) {
+        return (ka->cost > kb->cost) ? -1 : 1;
+    }
+    if (ka->idx != kb->idx) {
+        return (ka->idx < kb->idx) ? -1 : 1;
+    }
+    return 0;
+}
+
+/******************************************************************************
+ * @brief    Position of grid cell (x, y) along a Morton (Z-order) curve.
+ *****************************************************************************/
+size_t
+morton_curve_index(size_t x,
+                   size_t y)
+{
+    size_t d = 0;
+    size_t bit;
+
+    // grids are far smaller than 2^32 cells in either direction
+    for (bit = 0; bit < 32; bit++) {
+        d |= ((x >> bit) & 1) << (2 * bit);
+        d |= ((y >> bit) & 1) << (2 * bit + 1);
+    }
+
+    return d;
+}
+
+/******************************************************************************
+ * @brief    Position of grid cell (x, y) along a Hilbert curve that fills an
+ *           n by n grid (n must be a power of 2).
+ *****************************************************************************/
+size_t
+hilbert_curve_index(size_t n,
+                    size_t x,
+                    size_t y)
+{
+    size_t d = 0;
+    size_t rx;
+    size_t ry;
+    size_t s;
+    size_t tmp;
+
+    for (s = n / 2; s > 0; s /= 2) {
+        rx = (x & s) > 0;
+        ry = (y & s) > 0;
+        d += s * s * ((3 * rx) ^ ry);
+        // rotate the quadrant
+        if (ry == 0) {
+            if (rx == 1) {
+                x = n - 1 - x;
+                y = n - 1 - y;
+            }
+            tmp = x;
+            x = y;
+            y = tmp;
+        }
+    }
+
+    return d;
+}
+
+/******************************************************************************
+ * @brief    Order the active cells along a row-major, Morton or Hilbert
+ *           curve.
+ *****************************************************************************/
+void
+get_curve_decomp_order(domain_struct     *domain,
+                       unsigned short int method,
+                       size_t            *cell_order)
+{
+    size_t             i;
+    size_t             j;
+    size_t             n;
+    size_t             x;
+    size_t             y;
+    decomp_key_struct *keys = NULL;
+
+    keys = malloc((domain->ncells_active + 1) * sizeof(*keys));
+    check_alloc_status(keys, "Memory allocation error.");
+
+    // side of the smallest power of 2 square that covers the domain
+    n = 1;
+    while (n < domain->n_nx || n < domain->n_ny) {
+        n *= 2;
+    }
+
+    for (i = 0, j = 0; i < domain->ncells_total; i++) {
+        if (!domain->locations[i].run) {
+            continue;
+        }
+        y = domain->locations[i].io_idx / domain->n_nx;
+        x = domain->locations[i].io_idx % domain->n_nx;
+        if (method == DECOMP_MORTON) {
+            keys[j].key = morton_curve_index(x, y);
+        }
+        else if (method == DECOMP_HILBERT) {
+            keys[j].key = hilbert_curve_index(n, x, y);
+        }
+        else {
+            keys[j].key = domain->locations[i].io_idx;
+        }
+        keys[j].idx = j;
+        j++;
+    }
+
+    qsort(keys, domain->ncells_active, sizeof(*keys), decomp_key_compare);
+
+    for (j = 0; j < domain->ncells_active; j++) {
+        cell_order[j] = keys[j].idx;
+    }
+
+    free(keys);
+}
+
+/******************************************************************************
+ * @brief    Assign the active cells to processes so that routing basins are
+ *           kept on one process where possible.
+ * @details  The basin of each cell is read from source2outlet_ind in the
+ *           routing parameter file. Cells that are not a routing source are
+ *           grouped together. Basins that cost more than the average cost per
+ *           process are cut into row-major pieces of at most that cost. The
+ *           pieces are then assigned, most expensive first, to the process
+ *           with the lowest total cost.
+ *****************************************************************************/
+void
+get_basin_decomp(domain_struct *domain,
+                 size_t         mpi_size,
+                 double        *cost,
+                 size_t        *cell_order,
+                 int           *cell_rank)
+{
+    extern filenames_struct filenames;
+
+    int                     status;
+    size_t                  ncells;
+    size_t                  n_outlets;
+    size_t                  n_sources;
+    size_t                  nunits;
+    size_t                  start;
+    size_t                  i;
+    size_t                  j;
+    size_t                  k;
+    size_t                  u;
+    size_t                  i1start;
+    size_t                 *active_idx = NULL;
+    size_t                 *unit_start = NULL;
+    size_t                 *unit_size = NULL;
+    int                     rank;
+    double                  max_cost;
+    double                  total;
+    double                  unit_cost;
+    double                 *unit_costs = NULL;
+    double                 *rank_load = NULL;
+    int                    *ivar = NULL;
+    double                 *source_lat = NULL;
+    double                 *source_lon = NULL;
+    decomp_key_struct      *keys = NULL;
+    decomp_key_struct      *units = NULL;
+
+    ncells = domain->ncells_active;
+    i1start = 0;
+
+    status = nc_open(filenames.rout_params.nc_filename, NC_NOWRITE,
+                     &(filenames.rout_params.nc_id));
+    check_nc_status(status, "Error opening %s",
+                    filenames.rout_params.nc_filename);
+
+    n_outlets = get_nc_dimension(&(filenames.rout_params), "outlets");
+    n_sources = get_nc_dimension(&(filenames.rout_params), "sources");
+
+    ivar = malloc(n_sources * sizeof(*ivar));
+    check_alloc_status(ivar, "Memory allocation error.");
+    source_lat = malloc(n_sources * sizeof(*source_lat));
+    check_alloc_status(source_lat, "Memory allocation error.");
+    source_lon = malloc(n_sources * sizeof(*source_lon));
+    check_alloc_status(source_lon, "Memory allocation error.");
+
+    get_nc_field_int(&(filenames.rout_params), "source2outlet_ind",
+                     &i1start, &n_sources, ivar);
+    get_nc_field_double(&(filenames.rout_params), "source_lat",
+                        &i1start, &n_sources, source_lat);
+    get_nc_field_double(&(filenames.rout_params), "source_lon",
+                        &i1start, &n_sources, source_lon);
+
+    status = nc_close(filenames.rout_params.nc_id);
+    check_nc_status(status, "Error closing %s",
+                    filenames.rout_params.nc_filename);
+
+    // index of each cell in the list of active cells
+    active_idx = malloc(domain->ncells_total * sizeof(*active_idx));
+    check_alloc_status(active_idx, "Memory allocation error.");
+    for (i = 0, j = 0; i < domain->ncells_total; i++) {
+        if (domain->locations[i].run) {
+            active_idx[i] = j++;
+        }
+        else {
+            active_idx[i] = ncells;
+        }
+    }
+
+    // cells that are not a routing source are put in basin n_outlets
+    keys = malloc((ncells + 1) * sizeof(*keys));
+    check_alloc_status(keys, "Memory allocation error.");
+    for (j = 0; j < ncells; j++) {
+        keys[j].key = n_outlets;
+        keys[j].idx = j;
+    }
+    // match the routing sources to the VIC grid cells (as in rout_init)
+    for (k = 0; k < n_sources; k++) {
+        if (ivar[k] < 0 || (size_t) ivar[k] >= n_outlets) {
+            log_err("invalid source2outlet_ind %d for source %zu", ivar[k],
+                    k);
+        }
+        for (i = 0; i < domain->ncells_total; i++) {
+            if (active_idx[i] < ncells &&
+                source_lat[k] == domain->locations[i].latitude &&
+                source_lon[k] == domain->locations[i].longitude) {
+                keys[active_idx[i]].key = (size_t) ivar[k];
+                break;
+            }
+        }
+    }
+
+    // cells of a basin are now contiguous and in row-major order
+    qsort(keys, ncells, sizeof(*keys), decomp_key_compare);
+    for (j = 0; j < ncells; j++) {
+        cell_order[j] = keys[j].idx;
+    }
+
+    // cut the basins into units that cost at most max_cost
+    total = 0.;
+    for (j = 0; j < ncells; j++) {
+        total += cost[j];
+    }
+    max_cost = total / mpi_size;
+    unit_start = malloc((ncells + 1) * sizeof(*unit_start));
+    check_alloc_status(unit_start, "Memory allocation error.");
+    unit_size = malloc((ncells + 1) * sizeof(*unit_size));
+    check_alloc_status(unit_size, "Memory allocation error.");
+    unit_costs = malloc((ncells + 1) * sizeof(*unit_costs));
+    check_alloc_status(unit_costs, "Memory allocation error.");
+    nunits = 0;
+    for (start = 0; start < ncells; start = j) {
+        unit_cost = cost[cell_order[start]];
+        j = start + 1;
+        while (j < ncells && keys[j].key == keys[start].key &&
+               unit_cost + cost[cell_order[j]] <= max_cost) {
+            unit_cost += cost[cell_order[j]];
+            j++;
+        }
+        unit_start[nunits] = start;
+        unit_size[nunits] = j - start;
+        unit_costs[nunits] = unit_cost;
+        nunits++;
+    }
+
+    // assign the most expensive units first to the least loaded process
+    units = malloc((nunits + 1) * sizeof(*units));
+    check_alloc_status(units, "Memory allocation error.");
+    for (u = 0; u < nunits; u++) {
+        units[u].key = 0;
+        units[u].cost = unit_costs[u];
+        units[u].idx = u;
+    }
+    qsort(units, nunits, sizeof(*units), decomp_cost_compare);
+
+    rank_load = calloc(mpi_size, sizeof(*rank_load));
+    check_alloc_status(rank_load, "Memory allocation error.");
+    for (k = 0; k < nunits; k++) {
+        u = units[k].idx;
+        rank = 0;
+        for (i = 1; i < mpi_size; i++) {
+            if (rank_load[i] < rank_load[rank]) {
+                rank = (int) i;
+            }
+        }
+        rank_load[rank] += unit_costs[u];
+        for (j = unit_start[u]; j < unit_start[u] + unit_size[u]; j++) {
+            cell_rank[cell_order[j]] = rank;
+        }
+    }
+
+    free(ivar);
+    free(source_lat);
+    free(source_lon);
+    free(active_idx);
+    free(keys);
+    free(unit_start);
+    free(unit_size);
+    free(unit_costs);
+    free(units);
+    free(rank_load);
+}
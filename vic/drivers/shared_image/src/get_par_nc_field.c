@@ -0,0 +1,155 @@
+/******************************************************************************
+ * @section DESCRIPTION
+ *
+ * Functions to support reading the local part of a netCDF field on every
+ * process.
+ *
+ * @section LICENSE
+ *
+ * The Variable Infiltration Capacity (VIC) macroscale hydrological model
+ * Copyright (C) 2016 The Computational Hydrology Group, Department of Civil
+ * and Environmental Engineering, University of Washington.
+ *
+ * The VIC model is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *****************************************************************************/
+
+#include <vic_driver_shared_image.h>
+
+/******************************************************************************
+ * @brief    Read the local part of a double precision netCDF field on every
+ *           process.
+ * @details  Each process reads the smallest y-x hyperslab that contains all
+ *           of its active cells and extracts its own cells from it, so no
+ *           process holds the full grid. The last two dimensions in start and
+ *           count are the y and x dimensions of the global domain; they are
+ *           replaced by the local hyperslab. Any leading dimension may have a
+ *           count larger than 1, in which case var is filled as
+ *           [leading elements][local_domain.ncells_active].
+ *
+ *           This function must be called by all processes. If the file was
+ *           opened with nc_open_par the read is collective, otherwise every
+ *           process reads independently from its own file handle.
+ *****************************************************************************/
+void
+get_par_nc_field_double(nameid_struct *nc_nameid,
+                        char          *var_name,
+                        size_t        *start,
+                        size_t        *count,
+                        double        *var)
+{
+    extern domain_struct global_domain;
+    extern domain_struct local_domain;
+
+    int                  status;
+    int                  var_id;
+    int                  ndims;
+    size_t               dstart[MAXDIMS];
+    size_t               dcount[MAXDIMS];
+    size_t               nlead;
+    size_t               nslab;
+    size_t               xmin;
+    size_t               xmax;
+    size_t               ymin;
+    size_t               ymax;
+    size_t               x;
+    size_t               y;
+    size_t               i;
+    size_t               j;
+    double              *dvar = NULL;
+
+    status = nc_inq_varid(nc_nameid->nc_id, var_name, &var_id);
+    check_nc_status(status, "Error getting variable id for %s in %s", var_name,
+                    nc_nameid->nc_filename);
+
+    status = nc_inq_varndims(nc_nameid->nc_id, var_id, &ndims);
+    check_nc_status(status, "Error getting number of dimensions for %s in %s",
+                    var_name, nc_nameid->nc_filename);
+    if (ndims < 2 || ndims > MAXDIMS) {
+        log_err("Variable %s in %s has %d dimensions, expected between 2 "
+                "and %d", var_name, nc_nameid->nc_filename, ndims, MAXDIMS);
+    }
+
+#if VIC_NC_PARALLEL
+    status = nc_var_par_access(nc_nameid->nc_id, var_id, NC_COLLECTIVE);
+    check_nc_status(status, "Error setting parallel access for %s in %s",
+                    var_name, nc_nameid->nc_filename);
+#endif
+
+    // find the bounding box of the local active cells
+    ymin = global_domain.n_ny;
+    ymax = 0;
+    xmin = global_domain.n_nx;
+    xmax = 0;
+    for (i = 0; i < local_domain.ncells_active; i++) {
+        y = local_domain.locations[i].io_idx / global_domain.n_nx;
+        x = local_domain.locations[i].io_idx % global_domain.n_nx;
+        if (y < ymin) {
+            ymin = y;
+        }
+        if (y > ymax) {
+            ymax = y;
+        }
+        if (x < xmin) {
+            xmin = x;
+        }
+        if (x > xmax) {
+            xmax = x;
+        }
+    }
+
+    nlead = 1;
+    for (i = 0; i < (size_t) ndims - 2; i++) {
+        dstart[i] = start[i];
+        dcount[i] = count[i];
+        nlead *= count[i];
+    }
+    if (local_domain.ncells_active > 0) {
+        dstart[ndims - 2] = ymin;
+        dcount[ndims - 2] = ymax - ymin + 1;
+        dstart[ndims - 1] = xmin;
+        dcount[ndims - 1] = xmax - xmin + 1;
+    }
+    else {
+        // processes without cells still take part in the collective read
+        for (i = 0; i < (size_t) ndims; i++) {
+            dstart[i] = 0;
+            dcount[i] = 0;
+        }
+    }
+    nslab = dcount[ndims - 2] * dcount[ndims - 1];
+
+    dvar = malloc((nlead * nslab + 1) * sizeof(*dvar));
+    check_alloc_status(dvar, "Memory allocation error.");
+
+    status = nc_get_vara_double(nc_nameid->nc_id, var_id, dstart, dcount,
+                                dvar);
+    check_nc_status(status, "Error getting values for %s in %s", var_name,
+                    nc_nameid->nc_filename);
+
+    // extract the local cells from the hyperslab
+    if (local_domain.ncells_active > 0) {
+        for (j = 0; j < nlead; j++) {
+            for (i = 0; i < local_domain.ncells_active; i++) {
+                y = local_domain.locations[i].io_idx / global_domain.n_nx;
+                x = local_domain.locations[i].io_idx % global_domain.n_nx;
+                var[j * local_domain.ncells_active + i] =
+                    dvar[j * nslab + (y - ymin) * dcount[ndims - 1] +
+                         (x - xmin)];
+            }
+        }
+    }
+
+    free(dvar);
+}
@@ -46,6 +46,8 @@ initialize_filenames()
     strcpy(filenames.domain.nc_filename, "MISSING");
     strcpy(filenames.result_dir, "MISSING");
     strcpy(filenames.log_path, "MISSING");
+    strcpy(filenames.cost_map, "MISSING");
+    strcpy(filenames.cost_map_out, "MISSING");
     for (i = 0; i < 2; i++) {
         strcpy(filenames.f_path_pfx[i], "MISSING");
     }
@@ -0,0 +1,490 @@
+/******************************************************************************
+ * @section DESCRIPTION
+ *
+ * Functions to support dedicated I/O server processes for the history files.
+ *
+ * With IO_SERVER_RANKS = N, the first N processes get no grid cells. Only the
+ * history output is offloaded: the master process keeps reading the forcing
+ * and writing the state files, and the history streams are spread over the
+ * I/O servers. The compute processes
+ * send the aggregated data of a history stream to its server with a
+ * non-blocking send and carry on with the next timestep while the server
+ * writes it.
+ *
+ * @section LICENSE
+ *
+ * The Variable Infiltration Capacity (VIC) macroscale hydrological model
+ * Copyright (C) 2016 The Computational Hydrology Group, Department of Civil
+ * and Environmental Engineering, University of Washington.
+ *
+ * The VIC model is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *****************************************************************************/
+
+#include <vic_driver_shared_image.h>
+
+/******************************************************************************
+ * @brief    Process that writes history stream stream_idx.
+ * @details  With a single I/O server everything goes to the master process.
+ *           With more servers the master process is left to the forcing and
+ *           the state files and the streams are dealt to the other servers.
+ *****************************************************************************/
+int
+get_stream_io_rank(size_t stream_idx)
+{
+    extern option_struct options;
+
+    if (options.IO_SERVER_RANKS <= 1) {
+        return VIC_MPI_ROOT;
+    }
+    return (int) (1 + stream_idx % (options.IO_SERVER_RANKS - 1));
+}
+
+/******************************************************************************
+ * @brief    Give the I/O server processes an empty part of the domain.
+ * @details  Only called on the master process. The domain has been
+ *           decomposed over the mpi_size - IO_SERVER_RANKS compute processes;
+ *           the arrays are extended to mpi_size processes with no cells on
+ *           the first IO_SERVER_RANKS ones. The mapping array does not change
+ *           because it is in the order of the processes.
+ *****************************************************************************/
+void
+reserve_io_server_ranks(int **mpi_map_local_array_sizes,
+                        int **mpi_map_global_array_offsets)
+{
+    extern option_struct options;
+    extern int           mpi_size;
+
+    size_t               nservers;
+    size_t               i;
+    int                 *sizes = NULL;
+    int                 *offsets = NULL;
+
+    nservers = options.IO_SERVER_RANKS;
+
+    sizes = malloc(mpi_size * sizeof(*sizes));
+    check_alloc_status(sizes, "Memory allocation error.");
+    offsets = malloc(mpi_size * sizeof(*offsets));
+    check_alloc_status(offsets, "Memory allocation error.");
+
+    for (i = 0; i < nservers; i++) {
+        sizes[i] = 0;
+        offsets[i] = 0;
+    }
+    for (i = nservers; i < (size_t) mpi_size; i++) {
+        sizes[i] = (*mpi_map_local_array_sizes)[i - nservers];
+        offsets[i] = (*mpi_map_global_array_offsets)[i - nservers];
+    }
+
+    free(*mpi_map_local_array_sizes);
+    free(*mpi_map_global_array_offsets);
+    *mpi_map_local_array_sizes = sizes;
+    *mpi_map_global_array_offsets = offsets;
+}
+
+/******************************************************************************
+ * @brief    Set up the I/O server processes.
+ * @details  Must be called by all processes after the domain has been
+ *           scattered. The I/O servers other than the master process get a
+ *           copy of the global domain and the decomposition, which they need
+ *           to create and write the history files.
+ *****************************************************************************/
+void
+initialize_io_servers(void)
+{
+    extern size_t       *filter_active_cells;
+    extern size_t       *mpi_map_mapping_array;
+    extern int          *mpi_map_local_array_sizes;
+    extern int          *mpi_map_global_array_offsets;
+    extern domain_struct global_domain;
+    extern MPI_Comm      MPI_COMM_IO;
+    extern MPI_Comm      MPI_COMM_VIC;
+    extern MPI_Datatype  mpi_location_struct_type;
+    extern int           mpi_rank;
+    extern int           mpi_size;
+    extern option_struct options;
+
+    int                  status;
+    int                  color;
+
+    if (options.IO_SERVER_RANKS <= 1) {
+        return;
+    }
+
+    // communicator of the I/O servers, with the master process as rank 0
+    if ((size_t) mpi_rank < options.IO_SERVER_RANKS) {
+        color = 0;
+    }
+    else {
+        color = MPI_UNDEFINED;
+    }
+    status = MPI_Comm_split(MPI_COMM_VIC, color, mpi_rank, &MPI_COMM_IO);
+    check_mpi_status(status, "MPI error.");
+
+    if (MPI_COMM_IO == MPI_COMM_NULL) {
+        return;
+    }
+
+    status = MPI_Bcast(&(global_domain.ncells_total), 1, MPI_AINT,
+                       VIC_MPI_ROOT, MPI_COMM_IO);
+    check_mpi_status(status, "MPI error.");
+    status = MPI_Bcast(&(global_domain.ncells_active), 1, MPI_AINT,
+                       VIC_MPI_ROOT, MPI_COMM_IO);
+    check_mpi_status(status, "MPI error.");
+    status = MPI_Bcast(&(global_domain.info), sizeof(global_domain.info),
+                       MPI_BYTE, VIC_MPI_ROOT, MPI_COMM_IO);
+    check_mpi_status(status, "MPI error.");
+
+    if (mpi_rank != VIC_MPI_ROOT) {
+        global_domain.locations = malloc(global_domain.ncells_total *
+                                         sizeof(*global_domain.locations));
+        check_alloc_status(global_domain.locations,
+                           "Memory allocation error.");
+        filter_active_cells = malloc(global_domain.ncells_active *
+                                     sizeof(*filter_active_cells));
+        check_alloc_status(filter_active_cells, "Memory allocation error.");
+        mpi_map_mapping_array = malloc(global_domain.ncells_active *
+                                       sizeof(*mpi_map_mapping_array));
+        check_alloc_status(mpi_map_mapping_array, "Memory allocation error.");
+        mpi_map_local_array_sizes = malloc(mpi_size *
+                                           sizeof(*mpi_map_local_array_sizes));
+        check_alloc_status(mpi_map_local_array_sizes,
+                           "Memory allocation error.");
+        mpi_map_global_array_offsets =
+            malloc(mpi_size * sizeof(*mpi_map_global_array_offsets));
+        check_alloc_status(mpi_map_global_array_offsets,
+                           "Memory allocation error.");
+    }
+
+    status = MPI_Bcast(global_domain.locations, global_domain.ncells_total,
+                       mpi_location_struct_type, VIC_MPI_ROOT, MPI_COMM_IO);
+    check_mpi_status(status, "MPI error.");
+    status = MPI_Bcast(filter_active_cells, global_domain.ncells_active,
+                       MPI_AINT, VIC_MPI_ROOT, MPI_COMM_IO);
+    check_mpi_status(status, "MPI error.");
+    status = MPI_Bcast(mpi_map_mapping_array, global_domain.ncells_active,
+                       MPI_AINT, VIC_MPI_ROOT, MPI_COMM_IO);
+    check_mpi_status(status, "MPI error.");
+    status = MPI_Bcast(mpi_map_local_array_sizes, mpi_size, MPI_INT,
+                       VIC_MPI_ROOT, MPI_COMM_IO);
+    check_mpi_status(status, "MPI error.");
+    status = MPI_Bcast(mpi_map_global_array_offsets, mpi_size, MPI_INT,
+                       VIC_MPI_ROOT, MPI_COMM_IO);
+    check_mpi_status(status, "MPI error.");
+}
+
+/******************************************************************************
+ * @brief    Wait for the outstanding history sends and free the I/O server
+ *           resources.
+ *****************************************************************************/
+void
+finalize_io_servers(void)
+{
+    extern size_t         *filter_active_cells;
+    extern size_t         *mpi_map_mapping_array;
+    extern int            *mpi_map_local_array_sizes;
+    extern int            *mpi_map_global_array_offsets;
+    extern domain_struct   global_domain;
+    extern MPI_Comm        MPI_COMM_IO;
+    extern MPI_Comm        MPI_COMM_VIC;
+    extern int             mpi_rank;
+    extern nc_file_struct *nc_hist_files;
+    extern option_struct   options;
+
+    int                    status;
+    size_t                 i;
+
+    if (options.IO_SERVER_RANKS == 0) {
+        return;
+    }
+
+    for (i = 0; i < options.Noutstreams; i++) {
+        status = MPI_Wait(&(nc_hist_files[i].io_request), MPI_STATUS_IGNORE);
+        check_mpi_status(status, "MPI error.");
+        free(nc_hist_files[i].io_buf);
+        nc_hist_files[i].io_buf = NULL;
+    }
+
+    if (MPI_COMM_IO != MPI_COMM_NULL) {
+        if (mpi_rank != VIC_MPI_ROOT) {
+            free(global_domain.locations);
+            free(filter_active_cells);
+            free(mpi_map_mapping_array);
+            free(mpi_map_local_array_sizes);
+            free(mpi_map_global_array_offsets);
+        }
+        MPI_Comm_free(&MPI_COMM_IO);
+    }
+}
+
+/******************************************************************************
+ * @brief    Number of values per grid cell in the message of a history
+ *           stream: the sum of the number of elements of its variables.
+ *****************************************************************************/
+size_t
+get_stream_io_nvals(stream_struct *stream)
+{
+    extern metadata_struct out_metadata[N_OUTVAR_TYPES];
+
+    size_t                 k;
+    size_t                 nvals;
+
+    nvals = 0;
+    for (k = 0; k < stream->nvars; k++) {
+        nvals += out_metadata[stream->varid[k]].nelem;
+    }
+    return nvals;
+}
+
+/******************************************************************************
+ * @brief    Send the aggregated data of a history stream to its I/O server.
+ * @details  The send is non-blocking; the buffer is only reused once the
+ *           previous send of the same stream has completed. The message holds
+ *           the local cells of each variable and element in turn.
+ *****************************************************************************/
+void
+send_stream_data(stream_struct  *stream,
+                 nc_file_struct *nc_hist_file)
+{
+    extern domain_struct   local_domain;
+    extern MPI_Comm        MPI_COMM_VIC;
+    extern metadata_struct out_metadata[N_OUTVAR_TYPES];
+
+    int                    status;
+    size_t                 nvals;
+    size_t                 i;
+    size_t                 j;
+    size_t                 k;
+    size_t                 n;
+
+    if (local_domain.ncells_active == 0) {
+        return;
+    }
+
+    nvals = get_stream_io_nvals(stream);
+    if (nvals * local_domain.ncells_active > INT_MAX) {
+        log_err("History stream %s has %zu values per process, more than "
+                "can be sent to an I/O server in one message (%d).",
+                stream->prefix, nvals * local_domain.ncells_active, INT_MAX);
+    }
+
+    // the previous message of this stream must be out before the buffer is
+    // filled again
+    status = MPI_Wait(&(nc_hist_file->io_request), MPI_STATUS_IGNORE);
+    check_mpi_status(status, "MPI error.");
+
+    if (nc_hist_file->io_buf == NULL) {
+        nc_hist_file->io_buf = malloc(nvals * local_domain.ncells_active *
+                                      sizeof(*(nc_hist_file->io_buf)));
+        check_alloc_status(nc_hist_file->io_buf, "Memory allocation error.");
+    }
+
+    n = 0;
+    for (k = 0; k < stream->nvars; k++) {
+        for (j = 0; j < out_metadata[stream->varid[k]].nelem; j++) {
+            for (i = 0; i < local_domain.ncells_active; i++) {
+                nc_hist_file->io_buf[n++] = stream->aggdata[i][k][j][0];
+            }
+        }
+    }
+
+    status = MPI_Isend(nc_hist_file->io_buf,
+                       (int) (nvals * local_domain.ncells_active), MPI_DOUBLE,
+                       nc_hist_file->io_rank, 0, MPI_COMM_VIC,
+                       &(nc_hist_file->io_request));
+    check_mpi_status(status, "MPI error.");
+}
+
+/******************************************************************************
+ * @brief    Receive the aggregated data of a history stream from the compute
+ *           processes and write it to the history file.
+ * @details  Only called on the I/O server of the stream. The messages of the
+ *           compute processes arrive in the order in which the streams are
+ *           written, so a single tag is sufficient.
+ *****************************************************************************/
+void
+recv_put_stream_data(stream_struct  *stream,
+                     nc_file_struct *nc_hist_file)
+{
+    extern size_t         *filter_active_cells;
+    extern size_t         *mpi_map_mapping_array;
+    extern int            *mpi_map_local_array_sizes;
+    extern int            *mpi_map_global_array_offsets;
+    extern domain_struct   global_domain;
+    extern MPI_Comm        MPI_COMM_VIC;
+    extern int             mpi_size;
+    extern metadata_struct out_metadata[N_OUTVAR_TYPES];
+
+    int                    status;
+    int                    rank;
+    size_t                 nvals;
+    size_t                 ncells;
+    size_t                 grid_size;
+    size_t                 ndims;
+    size_t                 dstart[MAXDIMS];
+    size_t                 dcount[MAXDIMS];
+    size_t                 i;
+    size_t                 j;
+    size_t                 k;
+    size_t                 m;
+    size_t                 offset;
+    size_t                 size;
+    double                *recv = NULL;
+    double                *dvar_gathered = NULL;
+    double                *dvar_remapped = NULL;
+    double                *dvar = NULL;
+    float                 *fvar = NULL;
+    int                   *ivar = NULL;
+    short int             *svar = NULL;
+    signed char           *cvar = NULL;
+
+    nvals = get_stream_io_nvals(stream);
+    ncells = global_domain.ncells_active;
+    grid_size = global_domain.n_nx * global_domain.n_ny;
+
+    recv = malloc(nvals * ncells * sizeof(*recv));
+    check_alloc_status(recv, "Memory allocation error.");
+    dvar_gathered = malloc(ncells * sizeof(*dvar_gathered));
+    check_alloc_status(dvar_gathered, "Memory allocation error.");
+    dvar_remapped = malloc(ncells * sizeof(*dvar_remapped));
+    check_alloc_status(dvar_remapped, "Memory allocation error.");
+    dvar = malloc(grid_size * sizeof(*dvar));
+    check_alloc_status(dvar, "Memory allocation error.");
+    fvar = malloc(grid_size * sizeof(*fvar));
+    check_alloc_status(fvar, "Memory allocation error.");
+    ivar = malloc(grid_size * sizeof(*ivar));
+    check_alloc_status(ivar, "Memory allocation error.");
+    svar = malloc(grid_size * sizeof(*svar));
+    check_alloc_status(svar, "Memory allocation error.");
+    cvar = malloc(grid_size * sizeof(*cvar));
+    check_alloc_status(cvar, "Memory allocation error.");
+
+    // the block of each process starts at nvals times its offset
+    for (rank = 0; rank < mpi_size; rank++) {
+        size = (size_t) mpi_map_local_array_sizes[rank];
+        if (size == 0) {
+            continue;
+        }
+        offset = (size_t) mpi_map_global_array_offsets[rank];
+        if (nvals * size > INT_MAX) {
+            log_err("History stream %s has %zu values on process %d, more "
+                    "than can be received in one message (%d).",
+                    stream->prefix, nvals * size, rank, INT_MAX);
+        }
+        status = MPI_Recv(&(recv[nvals * offset]), (int) (nvals * size),
+                          MPI_DOUBLE, rank, 0, MPI_COMM_VIC,
+                          MPI_STATUS_IGNORE);
+        check_mpi_status(status, "MPI error.");
+    }
+
+    m = 0;
+    for (k = 0; k < stream->nvars; k++) {
+        ndims = nc_hist_file->nc_vars[k].nc_dims;
+        for (j = 0; j < ndims; j++) {
+            dstart[j] = 0;
+            dcount[j] = 1;
+        }
+        for (j = ndims - 2; j < ndims; j++) {
+            dcount[j] = nc_hist_file->nc_vars[k].nc_counts[j];
+        }
+        dstart[0] = stream->write_alarm.count;
+
+        for (j = 0; j < out_metadata[stream->varid[k]].nelem; j++, m++) {
+            dstart[1] = j;
+
+            // field m of every process, in the order of the processes
+            for (rank = 0; rank < mpi_size; rank++) {
+                size = (size_t) mpi_map_local_array_sizes[rank];
+                offset = (size_t) mpi_map_global_array_offsets[rank];
+                for (i = 0; i < size; i++) {
+                    dvar_gathered[offset + i] =
+                        recv[nvals * offset + m * size + i];
+                }
+            }
+            map(sizeof(double), ncells, NULL, mpi_map_mapping_array,
+                dvar_gathered, dvar_remapped);
+
+            if (nc_hist_file->nc_vars[k].nc_type == NC_DOUBLE) {
+                for (i = 0; i < grid_size; i++) {
+                    dvar[i] = nc_hist_file->d_fillvalue;
+                }
+                for (i = 0; i < ncells; i++) {
+                    dvar[filter_active_cells[i]] = dvar_remapped[i];
+                }
+                status = nc_put_vara_double(nc_hist_file->nc_id,
+                                            nc_hist_file->nc_vars[k].nc_varid,
+                                            dstart, dcount, dvar);
+            }
+            else if (nc_hist_file->nc_vars[k].nc_type == NC_FLOAT) {
+                for (i = 0; i < grid_size; i++) {
+                    fvar[i] = nc_hist_file->f_fillvalue;
+                }
+                for (i = 0; i < ncells; i++) {
+                    fvar[filter_active_cells[i]] = (float) dvar_remapped[i];
+                }
+                status = nc_put_vara_float(nc_hist_file->nc_id,
+                                           nc_hist_file->nc_vars[k].nc_varid,
+                                           dstart, dcount, fvar);
+            }
+            else if (nc_hist_file->nc_vars[k].nc_type == NC_INT) {
+                for (i = 0; i < grid_size; i++) {
+                    ivar[i] = nc_hist_file->i_fillvalue;
+                }
+                for (i = 0; i < ncells; i++) {
+                    ivar[filter_active_cells[i]] = (int) dvar_remapped[i];
+                }
+                status = nc_put_vara_int(nc_hist_file->nc_id,
+                                         nc_hist_file->nc_vars[k].nc_varid,
+                                         dstart, dcount, ivar);
+            }
+            else if (nc_hist_file->nc_vars[k].nc_type == NC_SHORT) {
+                for (i = 0; i < grid_size; i++) {
+                    svar[i] = nc_hist_file->s_fillvalue;
+                }
+                for (i = 0; i < ncells; i++) {
+                    svar[filter_active_cells[i]] =
+                        (short int) dvar_remapped[i];
+                }
+                status = nc_put_vara_short(nc_hist_file->nc_id,
+                                           nc_hist_file->nc_vars[k].nc_varid,
+                                           dstart, dcount, svar);
+            }
+            else if (nc_hist_file->nc_vars[k].nc_type == NC_CHAR) {
+                for (i = 0; i < grid_size; i++) {
+                    cvar[i] = nc_hist_file->c_fillvalue;
+                }
+                for (i = 0; i < ncells; i++) {
+                    cvar[filter_active_cells[i]] =
+                        (signed char) dvar_remapped[i];
+                }
+                status = nc_put_vara_schar(nc_hist_file->nc_id,
+                                           nc_hist_file->nc_vars[k].nc_varid,
+                                           dstart, dcount, cvar);
+            }
+            else {
+                log_err("Unsupported nc_type encountered");
+            }
+            check_nc_status(status, "Error writing values.");
+        }
+    }
+
+    free(recv);
+    free(dvar_gathered);
+    free(dvar_remapped);
+    free(dvar);
+    free(fvar);
+    free(ivar);
+    free(svar);
+    free(cvar);
+}
@@ -0,0 +1,510 @@
+/******************************************************************************
+ * @section DESCRIPTION
+ *
+ * Functions to support writing netCDF fields from every process without
+ * gathering them on the master process.
+ *
+ * The global grid is split into contiguous blocks of rows, one per process.
+ * Before each write the active cells are exchanged (MPI_Alltoallv) so that
+ * every process holds the complete rows of its block, which it then writes
+ * with a single collective nc_put_vara call.
+ *
+ * @section LICENSE
+ *
+ * The Variable Infiltration Capacity (VIC) macroscale hydrological model
+ * Copyright (C) 2016 The Computational Hydrology Group, Department of Civil
+ * and Environmental Engineering, University of Washington.
+ *
+ * The VIC model is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *****************************************************************************/
+
+#include <vic_driver_shared_image.h>
+
+/******************************************************************************
+ * @brief    Return the first row of the global grid written by a process.
+ *****************************************************************************/
+size_t
+par_io_row_start(int rank)
+{
+    extern domain_struct global_domain;
+    extern int           mpi_size;
+
+    return ((size_t) rank * global_domain.n_ny) / (size_t) mpi_size;
+}
+
+/******************************************************************************
+ * @brief    Set up the exchange pattern used by the put_par_nc_field_*
+ *           functions.
+ * @details  Must be called by all processes after vic_start.
+ *****************************************************************************/
+void
+initialize_par_io_map(void)
+{
+    extern domain_struct     global_domain;
+    extern domain_struct     local_domain;
+    extern MPI_Comm          MPI_COMM_VIC;
+    extern int               mpi_rank;
+    extern int               mpi_size;
+    extern par_io_map_struct par_io_map;
+
+    int                      status;
+    int                      rank;
+    int                     *owner = NULL;
+    int                     *offsets = NULL;
+    size_t                   y;
+    size_t                   i;
+    size_t                  *send_io_idx = NULL;
+    size_t                  *recv_io_idx = NULL;
+
+    par_io_map.row_start = par_io_row_start(mpi_rank);
+    par_io_map.nrows = par_io_row_start(mpi_rank + 1) - par_io_map.row_start;
+
+    par_io_map.send_counts = calloc(mpi_size,
+                                    sizeof(*(par_io_map.send_counts)));
+    check_alloc_status(par_io_map.send_counts, "Memory allocation error.");
+    par_io_map.send_displs = calloc(mpi_size,
+                                    sizeof(*(par_io_map.send_displs)));
+    check_alloc_status(par_io_map.send_displs, "Memory allocation error.");
+    par_io_map.recv_counts = calloc(mpi_size,
+                                    sizeof(*(par_io_map.recv_counts)));
+    check_alloc_status(par_io_map.recv_counts, "Memory allocation error.");
+    par_io_map.recv_displs = calloc(mpi_size,
+                                    sizeof(*(par_io_map.recv_displs)));
+    check_alloc_status(par_io_map.recv_displs, "Memory allocation error.");
+
+    // find the process that writes the row of each local cell
+    owner = malloc(local_domain.ncells_active * sizeof(*owner));
+    check_alloc_status(owner, "Memory allocation error.");
+    for (i = 0; i < local_domain.ncells_active; i++) {
+        y = local_domain.locations[i].io_idx / global_domain.n_nx;
+        rank = (int) ((y * mpi_size) / global_domain.n_ny);
+        while (rank > 0 && par_io_row_start(rank) > y) {
+            rank--;
+        }
+        while (rank < mpi_size - 1 && par_io_row_start(rank + 1) <= y) {
+            rank++;
+        }
+        owner[i] = rank;
+        par_io_map.send_counts[rank]++;
+    }
+
+    status = MPI_Alltoall(par_io_map.send_counts, 1, MPI_INT,
+                          par_io_map.recv_counts, 1, MPI_INT, MPI_COMM_VIC);
+    check_mpi_status(status, "MPI error.");
+
+    par_io_map.nrecv = 0;
+    for (rank = 0; rank < mpi_size; rank++) {
+        if (rank > 0) {
+            par_io_map.send_displs[rank] = par_io_map.send_displs[rank - 1] +
+                                           par_io_map.send_counts[rank - 1];
+            par_io_map.recv_displs[rank] = par_io_map.recv_displs[rank - 1] +
+                                           par_io_map.recv_counts[rank - 1];
+        }
+        par_io_map.nrecv += par_io_map.recv_counts[rank];
+    }
+
+    // order the local cells by destination process
+    offsets = malloc(mpi_size * sizeof(*offsets));
+    check_alloc_status(offsets, "Memory allocation error.");
+    for (rank = 0; rank < mpi_size; rank++) {
+        offsets[rank] = par_io_map.send_displs[rank];
+    }
+    par_io_map.send_order = malloc((local_domain.ncells_active + 1) *
+                                   sizeof(*(par_io_map.send_order)));
+    check_alloc_status(par_io_map.send_order, "Memory allocation error.");
+    send_io_idx = malloc((local_domain.ncells_active + 1) *
+                         sizeof(*send_io_idx));
+    check_alloc_status(send_io_idx, "Memory allocation error.");
+    for (i = 0; i < local_domain.ncells_active; i++) {
+        par_io_map.send_order[offsets[owner[i]]] = i;
+        send_io_idx[offsets[owner[i]]] = local_domain.locations[i].io_idx;
+        offsets[owner[i]]++;
+    }
+
+    // tell the writing processes where the cells they receive go
+    recv_io_idx = malloc((par_io_map.nrecv + 1) * sizeof(*recv_io_idx));
+    check_alloc_status(recv_io_idx, "Memory allocation error.");
+    status = MPI_Alltoallv(send_io_idx, par_io_map.send_counts,
+                           par_io_map.send_displs, MPI_UNSIGNED_LONG,
+                           recv_io_idx, par_io_map.recv_counts,
+                           par_io_map.recv_displs, MPI_UNSIGNED_LONG,
+                           MPI_COMM_VIC);
+    check_mpi_status(status, "MPI error.");
+
+    par_io_map.recv_idx = malloc((par_io_map.nrecv + 1) *
+                                 sizeof(*(par_io_map.recv_idx)));
+    check_alloc_status(par_io_map.recv_idx, "Memory allocation error.");
+    for (i = 0; i < par_io_map.nrecv; i++) {
+        par_io_map.recv_idx[i] = recv_io_idx[i] - par_io_map.row_start *
+                                 global_domain.n_nx;
+    }
+
+    free(owner);
+    free(offsets);
+    free(send_io_idx);
+    free(recv_io_idx);
+}
+
+/******************************************************************************
+ * @brief    Free the exchange pattern used by the put_par_nc_field_*
+ *           functions.
+ *****************************************************************************/
+void
+finalize_par_io_map(void)
+{
+    extern par_io_map_struct par_io_map;
+
+    free(par_io_map.send_counts);
+    free(par_io_map.send_displs);
+    free(par_io_map.recv_counts);
+    free(par_io_map.recv_displs);
+    free(par_io_map.send_order);
+    free(par_io_map.recv_idx);
+}
+
+/******************************************************************************
+ * @brief    Set the start and count of the row block written by this process.
+ * @details  The last two dimensions in start and count are the y and x
+ *           dimensions of the global domain; all other dimensions are copied
+ *           from the arguments.
+ *****************************************************************************/
+void
+set_par_io_slab(size_t  ndims,
+                size_t *start,
+                size_t *count,
+                size_t *dstart,
+                size_t *dcount)
+{
+    extern domain_struct     global_domain;
+    extern par_io_map_struct par_io_map;
+
+    size_t                   i;
+
+    for (i = 0; i < ndims - 2; i++) {
+        dstart[i] = start[i];
+        dcount[i] = count[i];
+    }
+    dstart[ndims - 2] = par_io_map.row_start;
+    dcount[ndims - 2] = par_io_map.nrows;
+    dstart[ndims - 1] = 0;
+    dcount[ndims - 1] = global_domain.n_nx;
+}
+
+/******************************************************************************
+ * @brief    Write double precision field from all processes.
+ * @details  This function must be called by all processes. The file must be
+ *           opened with nc_open_par or nc_create_par and var_id set to
+ *           collective access.
+ *****************************************************************************/
+void
+put_par_nc_field_double(int     nc_id,
+                        int     var_id,
+                        double  fillval,
+                        size_t  ndims,
+                        size_t *start,
+                        size_t *count,
+                        double *var)
+{
+    extern MPI_Comm          MPI_COMM_VIC;
+    extern domain_struct     global_domain;
+    extern domain_struct     local_domain;
+    extern par_io_map_struct par_io_map;
+
+    int                      status;
+    size_t                   dstart[MAXDIMS];
+    size_t                   dcount[MAXDIMS];
+    size_t                   slab_size;
+    size_t                   i;
+    double                  *dvar_send = NULL;
+    double                  *dvar_recv = NULL;
+    double                  *dvar = NULL;
+
+    slab_size = par_io_map.nrows * global_domain.n_nx;
+
+    dvar_send = malloc((local_domain.ncells_active + 1) * sizeof(*dvar_send));
+    check_alloc_status(dvar_send, "Memory allocation error.");
+    dvar_recv = malloc((par_io_map.nrecv + 1) * sizeof(*dvar_recv));
+    check_alloc_status(dvar_recv, "Memory allocation error.");
+    dvar = malloc((slab_size + 1) * sizeof(*dvar));
+    check_alloc_status(dvar, "Memory allocation error.");
+
+    for (i = 0; i < local_domain.ncells_active; i++) {
+        dvar_send[i] = var[par_io_map.send_order[i]];
+    }
+    status = MPI_Alltoallv(dvar_send, par_io_map.send_counts,
+                           par_io_map.send_displs, MPI_DOUBLE,
+                           dvar_recv, par_io_map.recv_counts,
+                           par_io_map.recv_displs, MPI_DOUBLE, MPI_COMM_VIC);
+    check_mpi_status(status, "MPI error.");
+
+    for (i = 0; i < slab_size; i++) {
+        dvar[i] = fillval;
+    }
+    for (i = 0; i < par_io_map.nrecv; i++) {
+        dvar[par_io_map.recv_idx[i]] = dvar_recv[i];
+    }
+
+    set_par_io_slab(ndims, start, count, dstart, dcount);
+    status = nc_put_vara_double(nc_id, var_id, dstart, dcount, dvar);
+    check_nc_status(status, "Error writing values");
+
+    free(dvar_send);
+    free(dvar_recv);
+    free(dvar);
+}
+
+/******************************************************************************
+ * @brief    Write single precision field from all processes.
+ * @details  This function must be called by all processes.
+ *****************************************************************************/
+void
+put_par_nc_field_float(int     nc_id,
+                       int     var_id,
+                       float   fillval,
+                       size_t  ndims,
+                       size_t *start,
+                       size_t *count,
+                       float  *var)
+{
+    extern MPI_Comm          MPI_COMM_VIC;
+    extern domain_struct     global_domain;
+    extern domain_struct     local_domain;
+    extern par_io_map_struct par_io_map;
+
+    int                      status;
+    size_t                   dstart[MAXDIMS];
+    size_t                   dcount[MAXDIMS];
+    size_t                   slab_size;
+    size_t                   i;
+    float                   *fvar_send = NULL;
+    float                   *fvar_recv = NULL;
+    float                   *fvar = NULL;
+
+    slab_size = par_io_map.nrows * global_domain.n_nx;
+
+    fvar_send = malloc((local_domain.ncells_active + 1) * sizeof(*fvar_send));
+    check_alloc_status(fvar_send, "Memory allocation error.");
+    fvar_recv = malloc((par_io_map.nrecv + 1) * sizeof(*fvar_recv));
+    check_alloc_status(fvar_recv, "Memory allocation error.");
+    fvar = malloc((slab_size + 1) * sizeof(*fvar));
+    check_alloc_status(fvar, "Memory allocation error.");
+
+    for (i = 0; i < local_domain.ncells_active; i++) {
+        fvar_send[i] = var[par_io_map.send_order[i]];
+    }
+    status = MPI_Alltoallv(fvar_send, par_io_map.send_counts,
+                           par_io_map.send_displs, MPI_FLOAT,
+                           fvar_recv, par_io_map.recv_counts,
+                           par_io_map.recv_displs, MPI_FLOAT, MPI_COMM_VIC);
+    check_mpi_status(status, "MPI error.");
+
+    for (i = 0; i < slab_size; i++) {
+        fvar[i] = fillval;
+    }
+    for (i = 0; i < par_io_map.nrecv; i++) {
+        fvar[par_io_map.recv_idx[i]] = fvar_recv[i];
+    }
+
+    set_par_io_slab(ndims, start, count, dstart, dcount);
+    status = nc_put_vara_float(nc_id, var_id, dstart, dcount, fvar);
+    check_nc_status(status, "Error writing values");
+
+    free(fvar_send);
+    free(fvar_recv);
+    free(fvar);
+}
+
+/******************************************************************************
+ * @brief    Write integer field from all processes.
+ * @details  This function must be called by all processes.
+ *****************************************************************************/
+void
+put_par_nc_field_int(int     nc_id,
+                     int     var_id,
+                     int     fillval,
+                     size_t  ndims,
+                     size_t *start,
+                     size_t *count,
+                     int    *var)
+{
+    extern MPI_Comm          MPI_COMM_VIC;
+    extern domain_struct     global_domain;
+    extern domain_struct     local_domain;
+    extern par_io_map_struct par_io_map;
+
+    int                      status;
+    size_t                   dstart[MAXDIMS];
+    size_t                   dcount[MAXDIMS];
+    size_t                   slab_size;
+    size_t                   i;
+    int                     *ivar_send = NULL;
+    int                     *ivar_recv = NULL;
+    int                     *ivar = NULL;
+
+    slab_size = par_io_map.nrows * global_domain.n_nx;
+
+    ivar_send = malloc((local_domain.ncells_active + 1) * sizeof(*ivar_send));
+    check_alloc_status(ivar_send, "Memory allocation error.");
+    ivar_recv = malloc((par_io_map.nrecv + 1) * sizeof(*ivar_recv));
+    check_alloc_status(ivar_recv, "Memory allocation error.");
+    ivar = malloc((slab_size + 1) * sizeof(*ivar));
+    check_alloc_status(ivar, "Memory allocation error.");
+
+    for (i = 0; i < local_domain.ncells_active; i++) {
+        ivar_send[i] = var[par_io_map.send_order[i]];
+    }
+    status = MPI_Alltoallv(ivar_send, par_io_map.send_counts,
+                           par_io_map.send_displs, MPI_INT,
+                           ivar_recv, par_io_map.recv_counts,
+                           par_io_map.recv_displs, MPI_INT, MPI_COMM_VIC);
+    check_mpi_status(status, "MPI error.");
+
+    for (i = 0; i < slab_size; i++) {
+        ivar[i] = fillval;
+    }
+    for (i = 0; i < par_io_map.nrecv; i++) {
+        ivar[par_io_map.recv_idx[i]] = ivar_recv[i];
+    }
+
+    set_par_io_slab(ndims, start, count, dstart, dcount);
+    status = nc_put_vara_int(nc_id, var_id, dstart, dcount, ivar);
+    check_nc_status(status, "Error writing values");
+
+    free(ivar_send);
+    free(ivar_recv);
+    free(ivar);
+}
+
+/******************************************************************************
+ * @brief    Write short integer field from all processes.
+ * @details  This function must be called by all processes.
+ *****************************************************************************/
+void
+put_par_nc_field_short(int        nc_id,
+                       int        var_id,
+                       short int  fillval,
+                       size_t     ndims,
+                       size_t    *start,
+                       size_t    *count,
+                       short int *var)
+{
+    extern MPI_Comm          MPI_COMM_VIC;
+    extern domain_struct     global_domain;
+    extern domain_struct     local_domain;
+    extern par_io_map_struct par_io_map;
+
+    int                      status;
+    size_t                   dstart[MAXDIMS];
+    size_t                   dcount[MAXDIMS];
+    size_t                   slab_size;
+    size_t                   i;
+    short int               *svar_send = NULL;
+    short int               *svar_recv = NULL;
+    short int               *svar = NULL;
+
+    slab_size = par_io_map.nrows * global_domain.n_nx;
+
+    svar_send = malloc((local_domain.ncells_active + 1) * sizeof(*svar_send));
+    check_alloc_status(svar_send, "Memory allocation error.");
+    svar_recv = malloc((par_io_map.nrecv + 1) * sizeof(*svar_recv));
+    check_alloc_status(svar_recv, "Memory allocation error.");
+    svar = malloc((slab_size + 1) * sizeof(*svar));
+    check_alloc_status(svar, "Memory allocation error.");
+
+    for (i = 0; i < local_domain.ncells_active; i++) {
+        svar_send[i] = var[par_io_map.send_order[i]];
+    }
+    status = MPI_Alltoallv(svar_send, par_io_map.send_counts,
+                           par_io_map.send_displs, MPI_SHORT,
+                           svar_recv, par_io_map.recv_counts,
+                           par_io_map.recv_displs, MPI_SHORT, MPI_COMM_VIC);
+    check_mpi_status(status, "MPI error.");
+
+    for (i = 0; i < slab_size; i++) {
+        svar[i] = fillval;
+    }
+    for (i = 0; i < par_io_map.nrecv; i++) {
+        svar[par_io_map.recv_idx[i]] = svar_recv[i];
+    }
+
+    set_par_io_slab(ndims, start, count, dstart, dcount);
+    status = nc_put_vara_short(nc_id, var_id, dstart, dcount, svar);
+    check_nc_status(status, "Error writing values");
+
+    free(svar_send);
+    free(svar_recv);
+    free(svar);
+}
+
+/******************************************************************************
+ * @brief    Write char field from all processes.
+ * @details  This function must be called by all processes.
+ *****************************************************************************/
+void
+put_par_nc_field_schar(int     nc_id,
+                       int     var_id,
+                       char    fillval,
+                       size_t  ndims,
+                       size_t *start,
+                       size_t *count,
+                       char   *var)
+{
+    extern MPI_Comm          MPI_COMM_VIC;
+    extern domain_struct     global_domain;
+    extern domain_struct     local_domain;
+    extern par_io_map_struct par_io_map;
+
+    int                      status;
+    size_t                   dstart[MAXDIMS];
+    size_t                   dcount[MAXDIMS];
+    size_t                   slab_size;
+    size_t                   i;
+    signed char             *cvar_send = NULL;
+    signed char             *cvar_recv = NULL;
+    signed char             *cvar = NULL;
+
+    slab_size = par_io_map.nrows * global_domain.n_nx;
+
+    cvar_send = malloc((local_domain.ncells_active + 1) * sizeof(*cvar_send));
+    check_alloc_status(cvar_send, "Memory allocation error.");
+    cvar_recv = malloc((par_io_map.nrecv + 1) * sizeof(*cvar_recv));
+    check_alloc_status(cvar_recv, "Memory allocation error.");
+    cvar = malloc((slab_size + 1) * sizeof(*cvar));
+    check_alloc_status(cvar, "Memory allocation error.");
+
+    for (i = 0; i < local_domain.ncells_active; i++) {
+        cvar_send[i] = var[par_io_map.send_order[i]];
+    }
+    status = MPI_Alltoallv(cvar_send, par_io_map.send_counts,
+                           par_io_map.send_displs, MPI_CHAR,
+                           cvar_recv, par_io_map.recv_counts,
+                           par_io_map.recv_displs, MPI_CHAR, MPI_COMM_VIC);
+    check_mpi_status(status, "MPI error.");
+
+    for (i = 0; i < slab_size; i++) {
+        cvar[i] = fillval;
+    }
+    for (i = 0; i < par_io_map.nrecv; i++) {
+        cvar[par_io_map.recv_idx[i]] = cvar_recv[i];
+    }
+
+    set_par_io_slab(ndims, start, count, dstart, dcount);
+    status = nc_put_vara_schar(nc_id, var_id, dstart, dcount, cvar);
+    check_nc_status(status, "Error writing values");
+
+    free(cvar_send);
+    free(cvar_recv);
+    free(cvar);
+}
@@ -0,0 +1,210 @@
+/******************************************************************************
+ * @section DESCRIPTION
+ *
+ * Contiguous storage of the model state of all local grid cells.
+ *
+ * With CONTIGUOUS_STATE = TRUE the cell, energy, snow and veg_var states of
+ * all cells of a process are allocated as one array each, ordered
+ * [cell][veg][band], instead of with separate allocations for every cell and
+ * vegetation tile. all_vars[cell] points into these arrays, so vic_run() and
+ * the output routines do not need to know which layout is used, while loops
+ * that are ported to the store reach the state of a tile through
+ * state_store_index().
+ *
+ * @section LICENSE
+ *
+ * The Variable Infiltration Capacity (VIC) macroscale hydrological model
+ * Copyright (C) 2016 The Computational Hydrology Group, Department of Civil
+ * and Environmental Engineering, University of Washington.
+ *
+ * The VIC model is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *****************************************************************************/
+
+#include <vic_driver_shared_image.h>
+
+/******************************************************************************
+ * @brief    Allocate the contiguous state store for all local grid cells and
+ *           point the state tables of all_vars into it.
+ * @details  Replaces the calls to make_all_vars() in vic_alloc(). The memory
+ *           is initialized like make_all_vars() does.
+ *****************************************************************************/
+void
+make_state_store(void)
+{
+    extern all_vars_struct    *all_vars;
+    extern domain_struct       local_domain;
+    extern option_struct       options;
+    extern state_store_struct  state_store;
+    extern veg_con_map_struct *veg_con_map;
+
+    size_t                     i;
+    size_t                     j;
+    size_t                     k;
+    size_t                     n;
+    size_t                     nelem;
+    size_t                     tile;
+
+    state_store.offset = malloc(local_domain.ncells_active *
+                                sizeof(*(state_store.offset)));
+    check_alloc_status(state_store.offset, "Memory allocation error.");
+
+    state_store.ntiles = 0;
+    for (i = 0; i < local_domain.ncells_active; i++) {
+        state_store.offset[i] = state_store.ntiles;
+        state_store.ntiles += veg_con_map[i].nv_active;
+    }
+    nelem = state_store.ntiles * options.SNOW_BAND;
+
+    state_store.cell = calloc(nelem, sizeof(*(state_store.cell)));
+    check_alloc_status(state_store.cell, "Memory allocation error.");
+    state_store.energy = calloc(nelem, sizeof(*(state_store.energy)));
+    check_alloc_status(state_store.energy, "Memory allocation error.");
+    state_store.snow = calloc(nelem, sizeof(*(state_store.snow)));
+    check_alloc_status(state_store.snow, "Memory allocation error.");
+    state_store.veg_var = calloc(nelem, sizeof(*(state_store.veg_var)));
+    check_alloc_status(state_store.veg_var, "Memory allocation error.");
+
+    state_store.cell_ptr = malloc(state_store.ntiles *
+                                  sizeof(*(state_store.cell_ptr)));
+    check_alloc_status(state_store.cell_ptr, "Memory allocation error.");
+    state_store.energy_ptr = malloc(state_store.ntiles *
+                                    sizeof(*(state_store.energy_ptr)));
+    check_alloc_status(state_store.energy_ptr, "Memory allocation error.");
+    state_store.snow_ptr = malloc(state_store.ntiles *
+                                  sizeof(*(state_store.snow_ptr)));
+    check_alloc_status(state_store.snow_ptr, "Memory allocation error.");
+    state_store.veg_var_ptr = malloc(state_store.ntiles *
+                                     sizeof(*(state_store.veg_var_ptr)));
+    check_alloc_status(state_store.veg_var_ptr, "Memory allocation error.");
+
+    state_store.NscaleFactor = NULL;
+    state_store.aPARLayer = NULL;
+    state_store.CiLayer = NULL;
+    state_store.rsLayer = NULL;
+    if (options.CARBON) {
+        n = nelem * options.Ncanopy;
+        state_store.NscaleFactor = calloc(n,
+                                          sizeof(*(state_store.NscaleFactor)));
+        check_alloc_status(state_store.NscaleFactor,
+                           "Memory allocation error.");
+        state_store.aPARLayer = calloc(n, sizeof(*(state_store.aPARLayer)));
+        check_alloc_status(state_store.aPARLayer, "Memory allocation error.");
+        state_store.CiLayer = calloc(n, sizeof(*(state_store.CiLayer)));
+        check_alloc_status(state_store.CiLayer, "Memory allocation error.");
+        state_store.rsLayer = calloc(n, sizeof(*(state_store.rsLayer)));
+        check_alloc_status(state_store.rsLayer, "Memory allocation error.");
+    }
+
+    for (tile = 0; tile < state_store.ntiles; tile++) {
+        n = tile * options.SNOW_BAND;
+        state_store.cell_ptr[tile] = &(state_store.cell[n]);
+        state_store.energy_ptr[tile] = &(state_store.energy[n]);
+        state_store.snow_ptr[tile] = &(state_store.snow[n]);
+        state_store.veg_var_ptr[tile] = &(state_store.veg_var[n]);
+        for (k = 0; k < options.SNOW_BAND; k++) {
+            state_store.energy[n + k].frozen = false;
+            if (options.CARBON) {
+                j = (n + k) * options.Ncanopy;
+                state_store.veg_var[n + k].NscaleFactor =
+                    &(state_store.NscaleFactor[j]);
+                state_store.veg_var[n + k].aPARLayer =
+                    &(state_store.aPARLayer[j]);
+                state_store.veg_var[n + k].CiLayer =
+                    &(state_store.CiLayer[j]);
+                state_store.veg_var[n + k].rsLayer =
+                    &(state_store.rsLayer[j]);
+            }
+        }
+    }
+
+    for (i = 0; i < local_domain.ncells_active; i++) {
+        tile = state_store.offset[i];
+        all_vars[i].cell = &(state_store.cell_ptr[tile]);
+        all_vars[i].energy = &(state_store.energy_ptr[tile]);
+        all_vars[i].snow = &(state_store.snow_ptr[tile]);
+        all_vars[i].veg_var = &(state_store.veg_var_ptr[tile]);
+    }
+}
+
+/******************************************************************************
+ * @brief    Free the contiguous state store.
+ *****************************************************************************/
+void
+free_state_store(void)
+{
+    extern state_store_struct state_store;
+
+    free(state_store.offset);
+    free(state_store.cell);
+    free(state_store.energy);
+    free(state_store.snow);
+    free(state_store.veg_var);
+    free(state_store.NscaleFactor);
+    free(state_store.aPARLayer);
+    free(state_store.CiLayer);
+    free(state_store.rsLayer);
+    free(state_store.cell_ptr);
+    free(state_store.energy_ptr);
+    free(state_store.snow_ptr);
+    free(state_store.veg_var_ptr);
+}
+
+/******************************************************************************
+ * @brief    Return the index of a band of a vegetation tile of a local grid
+ *           cell in the arrays of the state store.
+ *****************************************************************************/
+size_t
+state_store_index(size_t cell,
+                  size_t veg,
+                  size_t band)
+{
+    extern option_struct      options;
+    extern state_store_struct state_store;
+
+    return (state_store.offset[cell] + veg) * options.SNOW_BAND + band;
+}
+
+/******************************************************************************
+ * @brief    Update the vegetation of a grid cell for the current timestep in
+ *           the state store.
+ * @details  Same as update_step_vars(), but runs over the tiles of the cell
+ *           in the order in which they are stored.
+ *****************************************************************************/
+void
+update_store_step_vars(size_t           cell,
+                       veg_con_struct  *veg_con,
+                       veg_hist_struct *veg_hist)
+{
+    extern option_struct      options;
+    extern state_store_struct state_store;
+
+    size_t                    iveg;
+    size_t                    Nveg;
+    size_t                    band;
+    veg_var_struct           *veg_var;
+
+    Nveg = veg_con[0].vegetat_type_num;
+
+    for (iveg = 0; iveg <= Nveg; iveg++) {
+        veg_var = &(state_store.veg_var[state_store_index(cell, iveg, 0)]);
+        for (band = 0; band < options.SNOW_BAND; band++) {
+            veg_var[band].albedo = veg_hist[iveg].albedo[NR];
+            veg_var[band].displacement = veg_hist[iveg].displacement[NR];
+            veg_var[band].fcanopy = veg_hist[iveg].fcanopy[NR];
+            veg_var[band].LAI = veg_hist[iveg].LAI[NR];
+            veg_var[band].roughness = veg_hist[iveg].roughness[NR];
+        }
+    }
+}
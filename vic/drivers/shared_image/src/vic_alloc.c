@@ -32,20 +32,22 @@
 void
 vic_alloc(void)
 {
-    extern all_vars_struct    *all_vars;
-    extern force_data_struct  *force;
-    extern domain_struct       local_domain;
-    extern option_struct       options;
-    extern double           ***out_data;
-    extern save_data_struct   *save_data;
-    extern soil_con_struct    *soil_con;
-    extern veg_con_map_struct *veg_con_map;
-    extern veg_con_struct    **veg_con;
-    extern veg_hist_struct   **veg_hist;
-    extern veg_lib_struct    **veg_lib;
-    extern lake_con_struct    *lake_con;
-    size_t                     i;
-    size_t                     j;
+    extern all_vars_struct      *all_vars;
+    extern double               *cell_cost;
+    extern force_data_struct    *force;
+    extern domain_struct         local_domain;
+    extern option_struct         options;
+    extern double             ***out_data;
+    extern save_data_struct     *save_data;
+    extern scratch_arena_struct *scratch_arenas;
+    extern soil_con_struct      *soil_con;
+    extern veg_con_map_struct   *veg_con_map;
+    extern veg_con_struct      **veg_con;
+    extern veg_hist_struct     **veg_hist;
+    extern veg_lib_struct      **veg_lib;
+    extern lake_con_struct      *lake_con;
+    size_t                       i;
+    size_t                       j;
 
     // allocate memory for force structure
     force = malloc(local_domain.ncells_active * sizeof(*force));
@@ -89,6 +91,17 @@ vic_alloc(void)
     save_data = calloc(local_domain.ncells_active, sizeof(*save_data));
     check_alloc_status(save_data, "Memory allocation error.");
 
+    // computational cost of each cell
+    cell_cost = calloc(local_domain.ncells_active, sizeof(*cell_cost));
+    check_alloc_status(cell_cost, "Memory allocation error.");
+
+    // scratch arena of each thread
+    scratch_arenas = malloc(omp_get_max_threads() * sizeof(*scratch_arenas));
+    check_alloc_status(scratch_arenas, "Memory allocation error.");
+    for (i = 0; i < (size_t) omp_get_max_threads(); i++) {
+        initialize_scratch_arena(&(scratch_arenas[i]));
+    }
+
     // allocate memory for individual grid cells
     for (i = 0; i < local_domain.ncells_active; i++) {
         // force allocation - allocate enough memory for NR+1 steps
@@ -158,7 +171,9 @@ vic_alloc(void)
         veg_lib[i] = calloc(options.NVEGTYPES, sizeof(*(veg_lib[i])));
         check_alloc_status(veg_lib[i], "Memory allocation error.");
 
-        all_vars[i] = make_all_vars(veg_con_map[i].nv_active - 1);
+        if (!options.CONTIGUOUS_STATE) {
+            all_vars[i] = make_all_vars(veg_con_map[i].nv_active - 1);
+        }
 
         // allocate memory for veg_hist
         veg_hist[i] = calloc(veg_con_map[i].nv_active, sizeof(*(veg_hist[i])));
@@ -166,4 +181,9 @@ vic_alloc(void)
             alloc_veg_hist(&(veg_hist[i][j]));
         }
     }
+
+    // state of all cells in contiguous arrays
+    if (options.CONTIGUOUS_STATE) {
+        make_state_store();
+    }
 }
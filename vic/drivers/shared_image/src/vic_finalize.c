@@ -32,52 +32,64 @@
 void
 vic_finalize(void)
 {
-    extern size_t             *filter_active_cells;
-    extern size_t             *mpi_map_mapping_array;
-    extern all_vars_struct    *all_vars;
-    extern force_data_struct  *force;
-    extern domain_struct       global_domain;
-    extern domain_struct       local_domain;
-    extern filep_struct        filep;
-    extern int                *mpi_map_local_array_sizes;
-    extern int                *mpi_map_global_array_offsets;
-    extern int                 mpi_rank;
-    extern nc_file_struct     *nc_hist_files;
-    extern option_struct       options;
-    extern double           ***out_data;
-    extern stream_struct      *output_streams;
-    extern save_data_struct   *save_data;
-    extern soil_con_struct    *soil_con;
-    extern veg_con_map_struct *veg_con_map;
-    extern veg_con_struct    **veg_con;
-    extern veg_hist_struct   **veg_hist;
-    extern veg_lib_struct    **veg_lib;
-    extern MPI_Datatype        mpi_global_struct_type;
-    extern MPI_Datatype        mpi_filenames_struct_type;
-    extern MPI_Datatype        mpi_location_struct_type;
-    extern MPI_Datatype        mpi_alarm_struct_type;
-    extern MPI_Datatype        mpi_option_struct_type;
-    extern MPI_Datatype        mpi_param_struct_type;
+    extern size_t               *filter_active_cells;
+    extern double               *cell_cost;
+    extern filenames_struct      filenames;
+    extern size_t               *mpi_map_mapping_array;
+    extern all_vars_struct      *all_vars;
+    extern force_data_struct    *force;
+    extern domain_struct         global_domain;
+    extern domain_struct         local_domain;
+    extern filep_struct          filep;
+    extern int                  *mpi_map_local_array_sizes;
+    extern int                  *mpi_map_global_array_offsets;
+    extern int                   mpi_rank;
+    extern nc_file_struct       *nc_hist_files;
+    extern option_struct         options;
+    extern double             ***out_data;
+    extern stream_struct        *output_streams;
+    extern save_data_struct     *save_data;
+    extern scratch_arena_struct *scratch_arenas;
+    extern soil_con_struct      *soil_con;
+    extern veg_con_map_struct   *veg_con_map;
+    extern veg_con_struct      **veg_con;
+    extern veg_hist_struct     **veg_hist;
+    extern veg_lib_struct      **veg_lib;
+    extern MPI_Datatype          mpi_global_struct_type;
+    extern MPI_Datatype          mpi_filenames_struct_type;
+    extern MPI_Datatype          mpi_location_struct_type;
+    extern MPI_Datatype          mpi_alarm_struct_type;
+    extern MPI_Datatype          mpi_option_struct_type;
+    extern MPI_Datatype          mpi_param_struct_type;
 
-    size_t                     i;
-    size_t                     j;
-    int                        status;
+    size_t                       i;
+    size_t                       j;
+    int                          status;
 
 
+    // write the measured cost of each cell for load balancing of later runs
+    if (strcasecmp(filenames.cost_map_out, "MISSING") != 0) {
+        write_cost_map();
+    }
+
     if (mpi_rank == VIC_MPI_ROOT) {
         // close the global parameter file
         fclose(filep.globalparam);
+    }
 
-        // close the netcdf history file if it is still open
-        for (i = 0; i < options.Noutstreams; i++) {
-            if (nc_hist_files[i].open == true) {
-                status = nc_close(nc_hist_files[i].nc_id);
-                check_nc_status(status, "Error closing history file");
-            }
-            free(nc_hist_files[i].nc_vars);
+    // complete the outstanding sends to the I/O servers
+    finalize_io_servers();
+
+    // history files may be open on any process (parallel output or I/O
+    // servers); close the netcdf history files that are still open
+    for (i = 0; i < options.Noutstreams; i++) {
+        if (nc_hist_files[i].open == true) {
+            status = nc_close(nc_hist_files[i].nc_id);
+            check_nc_status(status, "Error closing history file");
         }
-        free(nc_hist_files);
+        free(nc_hist_files[i].nc_vars);
     }
+    free(nc_hist_files);
 
     for (i = 0; i < local_domain.ncells_active; i++) {
         free_force(&(force[i]));
@@ -94,7 +106,9 @@ vic_finalize(void)
             }
             free_veg_hist(&(veg_hist[i][j]));
         }
-        free_all_vars(&(all_vars[i]), veg_con_map[i].nv_active - 1);
+        if (!options.CONTIGUOUS_STATE) {
+            free_all_vars(&(all_vars[i]), veg_con_map[i].nv_active - 1);
+        }
         free(veg_con_map[i].vidx);
         free(veg_con_map[i].Cv);
         free(veg_con[i]);
@@ -102,6 +116,9 @@ vic_finalize(void)
         free(veg_lib[i]);
     }
 
+    if (options.CONTIGUOUS_STATE) {
+        free_state_store();
+    }
     free_streams(&output_streams);
     free_out_data(local_domain.ncells_active, out_data);
     free(force);
@@ -112,7 +129,11 @@ vic_finalize(void)
     free(veg_lib);
     free(all_vars);
     free(save_data);
+    free(cell_cost);
     free(local_domain.locations);
+    if (options.HIST_IO_MODE == IO_MODE_PARALLEL) {
+        finalize_par_io_map();
+    }
     if (mpi_rank == VIC_MPI_ROOT) {
         free(filter_active_cells);
         free(global_domain.locations);
@@ -121,6 +142,12 @@ vic_finalize(void)
         free(mpi_map_mapping_array);
     }
 
+    // free the scratch arena of every thread
+    for (i = 0; i < (size_t) omp_get_max_threads(); i++) {
+        scratch_free(&(scratch_arenas[i]));
+    }
+    free(scratch_arenas);
+
     MPI_Type_free(&mpi_global_struct_type);
     MPI_Type_free(&mpi_filenames_struct_type);
     MPI_Type_free(&mpi_location_struct_type);
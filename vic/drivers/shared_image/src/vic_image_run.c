@@ -27,58 +27,150 @@
 #include <vic_driver_shared_image.h>
 #include <rout.h>
 
+
 /******************************************************************************
  * @brief    Run VIC for one timestep and store output data
  *****************************************************************************/
 void
 vic_image_run(dmy_struct *dmy_current)
 {
-    extern size_t              current;
-    extern all_vars_struct    *all_vars;
-    extern force_data_struct  *force;
-    extern domain_struct       local_domain;
-    extern option_struct       options;
-    extern global_param_struct global_param;
-    extern lake_con_struct     lake_con;
-    extern double           ***out_data;
-    extern stream_struct      *output_streams;
-    extern save_data_struct   *save_data;
-    extern soil_con_struct    *soil_con;
-    extern veg_con_struct    **veg_con;
-    extern veg_hist_struct   **veg_hist;
-    extern veg_lib_struct    **veg_lib;
-
-    char                       dmy_str[MAXSTRING];
-    size_t                     i;
-    timer_struct               timer;
+    extern size_t           current;
+    extern option_struct    options;
+    extern double        ***out_data;
+    extern stream_struct   *output_streams;
+
+    char                    dmy_str[MAXSTRING];
+    size_t                  i;
+    size_t                 *cell_order = NULL;
 
     // Print the current timestep info before running vic_run
     sprint_dmy(dmy_str, dmy_current);
     debug("Running timestep %zu: %s", current, dmy_str);
 
-    // If running with OpenMP, run this for loop using multiple threads
-    #pragma omp parallel for default(shared) private(i, timer, vic_run_ref_str)
-    for (i = 0; i < local_domain.ncells_active; i++) {
-        // Set global reference string (for debugging inside vic_run)
-        sprintf(vic_run_ref_str, "Gridcell io_idx: %zu, timestep info: %s",
-                local_domain.locations[i].io_idx, dmy_str);
+    cell_order = init_cell_loop();
+
+    // If running with OpenMP, run the cells using multiple threads
+    #pragma omp parallel default(shared)
+    {
+        vic_run_cells(dmy_current, cell_order);
+    }
+
+    free(cell_order);
+
+    // run routing over the domain
+    rout_run();     // Routing routine (extension)
+
+    for (i = 0; i < options.Noutstreams; i++) {
+        agg_stream_data(&(output_streams[i]), dmy_current, out_data);
+    }
+}
+
+/******************************************************************************
+ * @brief    Set up the OpenMP loop over the grid cells of this process.
+ * @details  Sets the OpenMP schedule and returns the order in which the
+ *           cells are run, or NULL if they are run in their natural order.
+ *           The returned array must be freed by the caller.
+ *****************************************************************************/
+size_t *
+init_cell_loop(void)
+{
+    extern double       *cell_cost;
+    extern domain_struct local_domain;
+    extern option_struct options;
 
-        update_step_vars(&(all_vars[i]), veg_con[i], veg_hist[i]);
+    size_t              *cell_order = NULL;
+
+    // run the most expensive cells first so that the cheap ones fill the
+    // gaps at the end of the loop (the cost is measured in earlier steps)
+    if (options.CELL_COST_ORDER) {
+        cell_order = malloc((local_domain.ncells_active + 1) *
+                            sizeof(*cell_order));
+        check_alloc_status(cell_order, "Memory allocation error.");
+        get_cost_cell_order(local_domain.ncells_active, cell_cost,
+                            cell_order);
+    }
+
+#ifdef _OPENMP
+    if (options.CELL_SCHEDULE == CELL_SCHEDULE_DYNAMIC) {
+        omp_set_schedule(omp_sched_dynamic, options.CELL_CHUNK_SIZE);
+    }
+    else if (options.CELL_SCHEDULE == CELL_SCHEDULE_GUIDED) {
+        omp_set_schedule(omp_sched_guided, options.CELL_CHUNK_SIZE);
+    }
+    else {
+        omp_set_schedule(omp_sched_static, options.CELL_CHUNK_SIZE);
+    }
+#endif
+
+    return cell_order;
+}
+
+/******************************************************************************
+ * @brief    Run vic_run for all grid cells of this process.
+ * @details  Must be called by all threads of the enclosing parallel region;
+ *           the cells are shared out among the threads according to the
+ *           schedule set in init_cell_loop. Threads that arrive late (e.g.
+ *           because they were doing I/O) pick up the remaining cells if the
+ *           schedule is dynamic or guided.
+ *****************************************************************************/
+void
+vic_run_cells(dmy_struct *dmy_current,
+              size_t     *cell_order)
+{
+    extern all_vars_struct      *all_vars;
+    extern double               *cell_cost;
+    extern force_data_struct    *force;
+    extern domain_struct         local_domain;
+    extern global_param_struct   global_param;
+    extern lake_con_struct       lake_con;
+    extern option_struct         options;
+    extern double             ***out_data;
+    extern save_data_struct     *save_data;
+    extern scratch_arena_struct *scratch_arenas;
+    extern soil_con_struct      *soil_con;
+    extern veg_con_struct      **veg_con;
+    extern veg_hist_struct     **veg_hist;
+    extern veg_lib_struct      **veg_lib;
+
+    char                         dmy_str[MAXSTRING];
+    size_t                       i;
+    size_t                       k;
+    timer_struct                 timer;
+    scratch_arena_struct        *scratch;
+
+    sprint_dmy(dmy_str, dmy_current);
+    scratch = &(scratch_arenas[omp_get_thread_num()]);
+
+    #pragma omp for schedule(runtime)
+    for (k = 0; k < local_domain.ncells_active; k++) {
+        if (cell_order != NULL) {
+            i = cell_order[k];
+        }
+        else {
+            i = k;
+        }
+
+        // Set the thread's reference string (for debugging inside vic_run);
+        // dmy_str is bounded so the result always fits
+        sprintf(vic_run_ref_str, "Gridcell io_idx: %zu, timestep info: %.*s",
+                local_domain.locations[i].io_idx, MAXSTRING / 2, dmy_str);
+
+        if (options.CONTIGUOUS_STATE) {
+            update_store_step_vars(i, veg_con[i], veg_hist[i]);
+        }
+        else {
+            update_step_vars(&(all_vars[i]), veg_con[i], veg_hist[i]);
+        }
 
         timer_start(&timer);
         vic_run(&(force[i]), &(all_vars[i]), dmy_current, &global_param,
-                &lake_con, &(soil_con[i]), veg_con[i], veg_lib[i]);
+                &lake_con, &(soil_con[i]), veg_con[i], veg_lib[i], scratch);
         timer_stop(&timer);
+        // accumulate the cost of the cell for load balancing
+        cell_cost[i] += timer.delta_wall;
 
         put_data(&(all_vars[i]), &(force[i]), &(soil_con[i]), veg_con[i],
                  veg_lib[i], &lake_con, out_data[i], &(save_data[i]),
                  &timer);
     }
-
-    // run routing over the domain
-    rout_run();     // Routing routine (extension)
-
-    for (i = 0; i < options.Noutstreams; i++) {
-        agg_stream_data(&(output_streams[i]), dmy_current, out_data);
-    }
 }
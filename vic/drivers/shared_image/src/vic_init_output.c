@@ -185,9 +185,17 @@ vic_init_output(dmy_struct *dmy_current)
                            output_streams[streamnum].nvars,
                            output_streams[streamnum].varid,
                            output_streams[streamnum].type);
+        if (options.IO_SERVER_RANKS > 0) {
+            nc_hist_files[streamnum].io_rank = get_stream_io_rank(streamnum);
+        }
     }
     // validate streams
     validate_streams(&output_streams);
+
+    // setup the exchange pattern for parallel history output
+    if (options.HIST_IO_MODE == IO_MODE_PARALLEL) {
+        initialize_par_io_map();
+    }
 }
 
 /******************************************************************************
@@ -573,6 +581,78 @@ initialize_history_file(nc_file_struct *nc,
     }
 }
 
+/******************************************************************************
+ * @brief    Initialize history file for parallel output
+ * @details  The file is created and defined on the master process and then
+ *           reopened on all processes for collective writes. Must be called
+ *           by all processes.
+ *****************************************************************************/
+void
+initialize_par_history_file(nc_file_struct *nc,
+                            stream_struct  *stream)
+{
+    extern MPI_Comm        MPI_COMM_VIC;
+    extern int             mpi_rank;
+    extern metadata_struct out_metadata[N_OUTVAR_TYPES];
+
+    int                    status;
+    size_t                 j;
+
+    if (mpi_rank == VIC_MPI_ROOT) {
+        initialize_history_file(nc, stream);
+        status = nc_close(nc->nc_id);
+        check_nc_status(status, "Error closing %s", stream->filename);
+    }
+
+    // the file name is set in initialize_history_file
+    status = MPI_Bcast(stream->filename, MAXSTRING, MPI_CHAR, VIC_MPI_ROOT,
+                       MPI_COMM_VIC);
+    check_mpi_status(status, "MPI error.");
+
+#if VIC_NC_PARALLEL
+    status = nc_open_par(stream->filename, NC_WRITE, MPI_COMM_VIC,
+                         MPI_INFO_NULL, &(nc->nc_id));
+    check_nc_status(status, "Error opening %s", stream->filename);
+#else
+    log_err("Parallel history output requires a netCDF library built with "
+            "parallel I/O support.");
+#endif
+    nc->open = true;
+
+    // get the variable ids and switch all variables to collective access
+    status = nc_inq_varid(nc->nc_id, "time", &(nc->time_varid));
+    check_nc_status(status, "Error getting time variable id in %s",
+                    stream->filename);
+    status = nc_inq_varid(nc->nc_id, "time_bnds", &(nc->time_bounds_varid));
+    check_nc_status(status, "Error getting time_bnds variable id in %s",
+                    stream->filename);
+#if VIC_NC_PARALLEL
+    status = nc_var_par_access(nc->nc_id, nc->time_varid, NC_COLLECTIVE);
+    check_nc_status(status, "Error setting parallel access in %s",
+                    stream->filename);
+    status = nc_var_par_access(nc->nc_id, nc->time_bounds_varid,
+                               NC_COLLECTIVE);
+    check_nc_status(status, "Error setting parallel access in %s",
+                    stream->filename);
+#endif
+
+    for (j = 0; j < stream->nvars; j++) {
+        status = nc_inq_varid(nc->nc_id,
+                              out_metadata[stream->varid[j]].varname,
+                              &(nc->nc_vars[j].nc_varid));
+        check_nc_status(status, "Error getting variable id for %s in %s",
+                        out_metadata[stream->varid[j]].varname,
+                        stream->filename);
+#if VIC_NC_PARALLEL
+        status = nc_var_par_access(nc->nc_id, nc->nc_vars[j].nc_varid,
+                                   NC_COLLECTIVE);
+        check_nc_status(status, "Error setting parallel access for %s in %s",
+                        out_metadata[stream->varid[j]].varname,
+                        stream->filename);
+#endif
+    }
+}
+
 /******************************************************************************
  * @brief    Set global netcdf attributes (either history or state file)
  *****************************************************************************/
@@ -669,6 +749,11 @@ initialize_nc_file(nc_file_struct     *nc_file,
 
     nc_file->open = false;
 
+    // written by the master process unless an I/O server takes it over
+    nc_file->io_rank = VIC_MPI_ROOT;
+    nc_file->io_buf = NULL;
+    nc_file->io_request = MPI_REQUEST_NULL;
+
     // Set fill values
     nc_file->c_fillvalue = NC_FILL_CHAR;
     nc_file->s_fillvalue = NC_FILL_SHORT;
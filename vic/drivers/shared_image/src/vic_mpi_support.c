@@ -293,7 +293,7 @@ create_MPI_filenames_struct_type(MPI_Datatype *mpi_type)
     MPI_Datatype   *mpi_types;
 
     // nitems has to equal the number of elements in filenames_struct
-    nitems = 10;
+    nitems = 12;
     blocklengths = malloc(nitems * sizeof(*blocklengths));
     check_alloc_status(blocklengths, "Memory allocation error.");
 
@@ -354,6 +354,14 @@ create_MPI_filenames_struct_type(MPI_Datatype *mpi_type)
     offsets[i] = offsetof(filenames_struct, log_path);
     mpi_types[i++] = MPI_CHAR;
 
+    // char cost_map[MAXSTRING];
+    offsets[i] = offsetof(filenames_struct, cost_map);
+    mpi_types[i++] = MPI_CHAR;
+
+    // char cost_map_out[MAXSTRING];
+    offsets[i] = offsetof(filenames_struct, cost_map_out);
+    mpi_types[i++] = MPI_CHAR;
+
 
     // make sure that the we have the right number of elements
     if (i != (size_t) nitems) {
@@ -488,7 +496,7 @@ create_MPI_option_struct_type(MPI_Datatype *mpi_type)
     MPI_Datatype   *mpi_types;
 
     // nitems has to equal the number of elements in option_struct
-    nitems = 53;
+    nitems = 64;
     blocklengths = malloc(nitems * sizeof(*blocklengths));
     check_alloc_status(blocklengths, "Memory allocation error.");
 
@@ -718,6 +726,50 @@ create_MPI_option_struct_type(MPI_Datatype *mpi_type)
     offsets[i] = offsetof(option_struct, SAVE_STATE);
     mpi_types[i++] = MPI_C_BOOL;
 
+    // unsigned short FORCE_IO_MODE;
+    offsets[i] = offsetof(option_struct, FORCE_IO_MODE);
+    mpi_types[i++] = MPI_UNSIGNED_SHORT;
+
+    // unsigned short HIST_IO_MODE;
+    offsets[i] = offsetof(option_struct, HIST_IO_MODE);
+    mpi_types[i++] = MPI_UNSIGNED_SHORT;
+
+    // unsigned short DECOMP_METHOD;
+    offsets[i] = offsetof(option_struct, DECOMP_METHOD);
+    mpi_types[i++] = MPI_UNSIGNED_SHORT;
+
+    // unsigned short CELL_SCHEDULE;
+    offsets[i] = offsetof(option_struct, CELL_SCHEDULE);
+    mpi_types[i++] = MPI_UNSIGNED_SHORT;
+
+    // int CELL_CHUNK_SIZE;
+    offsets[i] = offsetof(option_struct, CELL_CHUNK_SIZE);
+    mpi_types[i++] = MPI_INT;
+
+    // bool CELL_COST_ORDER;
+    offsets[i] = offsetof(option_struct, CELL_COST_ORDER);
+    mpi_types[i++] = MPI_C_BOOL;
+
+    // bool PIPELINE_IO;
+    offsets[i] = offsetof(option_struct, PIPELINE_IO);
+    mpi_types[i++] = MPI_C_BOOL;
+
+    // size_t IO_SERVER_RANKS;
+    offsets[i] = offsetof(option_struct, IO_SERVER_RANKS);
+    mpi_types[i++] = MPI_AINT; // note there is no MPI_SIZE_T equivalent
+
+    // size_t FORCE_BLOCK_STEPS;
+    offsets[i] = offsetof(option_struct, FORCE_BLOCK_STEPS);
+    mpi_types[i++] = MPI_AINT; // note there is no MPI_SIZE_T equivalent
+
+    // bool CONTIGUOUS_STATE;
+    offsets[i] = offsetof(option_struct, CONTIGUOUS_STATE);
+    mpi_types[i++] = MPI_C_BOOL;
+
+    // bool ROUT_SPARSE_UH;
+    offsets[i] = offsetof(option_struct, ROUT_SPARSE_UH);
+    mpi_types[i++] = MPI_C_BOOL;
+
     // make sure that the we have the right number of elements
     if (i != (size_t) nitems) {
         log_err("Miscount: %zd not equal to %d.", i, nitems);
@@ -1691,6 +1743,81 @@ mpi_map_decomp_domain(size_t   ncells,
     }
 }
 
+/******************************************************************************
+ * @brief   Decompose the domain for MPI operations from a given assignment of
+ *          cells to processes
+ * @details Same as mpi_map_decomp_domain, but the process of each cell is
+ *          given in cell_rank. The cells of each process are ordered as they
+ *          appear in cell_order.
+ *
+ * @param ncells total number of cells
+ * @param mpi_size number of mpi processes
+ * @param cell_order array with a permutation of the cell indices
+ * @param cell_rank array with the mpi process of each cell
+ * @param mpi_map_local_array_sizes address of integer array with number of
+ *        cells assigned to each node (MPI_Scatterv:sendcounts and
+ *        MPI_Gatherv:recvcounts)
+ * @param mpi_map_global_array_offsets address of integer array with offsets
+ *        for sending and receiving data (MPI_Scatterv:displs and
+ *        MPI_Gatherv:displs)
+ * @param mpi_map_mapping_array address of size_t array with indices to prepare
+ *        an array on the master process for MPI_Scatterv or map back after
+ *        MPI_Gatherv
+ *****************************************************************************/
+void
+mpi_map_decomp_domain_ranks(size_t   ncells,
+                            size_t   mpi_size,
+                            size_t  *cell_order,
+                            int     *cell_rank,
+                            int    **mpi_map_local_array_sizes,
+                            int    **mpi_map_global_array_offsets,
+                            size_t **mpi_map_mapping_array)
+{
+    size_t i;
+    size_t k;
+    int   *position = NULL;
+
+    *mpi_map_local_array_sizes = calloc(mpi_size,
+                                        sizeof(*(*mpi_map_local_array_sizes)));
+    check_alloc_status(*mpi_map_local_array_sizes, "Memory allocation error.");
+    *mpi_map_global_array_offsets = calloc(mpi_size,
+                                           sizeof(*(*
+                                                    mpi_map_global_array_offsets)));
+    check_alloc_status(*mpi_map_global_array_offsets,
+                       "Memory allocation error.");
+    *mpi_map_mapping_array = calloc(ncells, sizeof(*(*mpi_map_mapping_array)));
+    check_alloc_status(*mpi_map_mapping_array, "Memory allocation error.");
+    position = calloc(mpi_size, sizeof(*position));
+    check_alloc_status(position, "Memory allocation error.");
+
+    // determine number of cells per node
+    for (i = 0; i < ncells; i++) {
+        if (cell_rank[i] < 0 || (size_t) cell_rank[i] >= mpi_size) {
+            log_err("Cell %zu assigned to invalid process %d", i,
+                    cell_rank[i]);
+        }
+        (*mpi_map_local_array_sizes)[cell_rank[i]] += 1;
+    }
+
+    // determine offsets to use for MPI_Scatterv and MPI_Gatherv
+    for (i = 1; i < mpi_size; i++) {
+        (*mpi_map_global_array_offsets)[i] =
+            (*mpi_map_global_array_offsets)[i - 1] +
+            (*mpi_map_local_array_sizes)[i - 1];
+    }
+
+    // set mapping array
+    for (i = 0; i < mpi_size; i++) {
+        position[i] = (*mpi_map_global_array_offsets)[i];
+    }
+    for (k = 0; k < ncells; k++) {
+        i = cell_order[k];
+        (*mpi_map_mapping_array)[position[cell_rank[i]]++] = i;
+    }
+
+    free(position);
+}
+
 /******************************************************************************
  * @brief   Gather double precision variable
  * @details Values are gathered to the master node
@@ -2126,6 +2253,99 @@ scatter_field_double(double *dvar,
     }
 }
 
+/******************************************************************************
+ * @brief   Scatter several time steps of a double precision variable
+ * @details Same as scatter_field_double, but dvar holds nsteps consecutive
+ *          grids and all of them are sent in a single MPI_Scatterv. The
+ *          local result in var is [nsteps][local_domain.ncells_active].
+ *****************************************************************************/
+void
+scatter_field_steps_double(size_t  nsteps,
+                           double *dvar,
+                           double *var)
+{
+    extern MPI_Comm      MPI_COMM_VIC;
+    extern domain_struct global_domain;
+    extern domain_struct local_domain;
+    extern int           mpi_rank;
+    extern int           mpi_size;
+    extern int          *mpi_map_global_array_offsets;
+    extern int          *mpi_map_local_array_sizes;
+    extern size_t       *filter_active_cells;
+    extern size_t       *mpi_map_mapping_array;
+    int                  status;
+    int                 *send_counts = NULL;
+    int                 *send_displs = NULL;
+    int                  rank;
+    size_t               offset;
+    size_t               size;
+    size_t               i;
+    size_t               s;
+    double              *dvar_filtered = NULL;
+    double              *dvar_mapped = NULL;
+    double              *dvar_send = NULL;
+
+    if (mpi_rank == VIC_MPI_ROOT) {
+        dvar_filtered =
+            malloc(global_domain.ncells_active * sizeof(*dvar_filtered));
+        check_alloc_status(dvar_filtered, "Memory allocation error.");
+
+        dvar_mapped =
+            malloc(global_domain.ncells_active * sizeof(*dvar_mapped));
+        check_alloc_status(dvar_mapped, "Memory allocation error.");
+
+        dvar_send = malloc(nsteps * global_domain.ncells_active *
+                           sizeof(*dvar_send));
+        check_alloc_status(dvar_send, "Memory allocation error.");
+
+        send_counts = malloc(mpi_size * sizeof(*send_counts));
+        check_alloc_status(send_counts, "Memory allocation error.");
+
+        send_displs = malloc(mpi_size * sizeof(*send_displs));
+        check_alloc_status(send_displs, "Memory allocation error.");
+
+        for (rank = 0; rank < mpi_size; rank++) {
+            send_counts[rank] = (int) nsteps *
+                                mpi_map_local_array_sizes[rank];
+            send_displs[rank] = (int) nsteps *
+                                mpi_map_global_array_offsets[rank];
+        }
+
+        for (s = 0; s < nsteps; s++) {
+            // filter the active cells only
+            map(sizeof(double), global_domain.ncells_active,
+                filter_active_cells, NULL,
+                &(dvar[s * global_domain.ncells_total]), dvar_filtered);
+            // map to prepare for MPI_Scatterv
+            map(sizeof(double), global_domain.ncells_active,
+                mpi_map_mapping_array, NULL, dvar_filtered, dvar_mapped);
+            // the block of each process holds all its steps in turn
+            for (rank = 0; rank < mpi_size; rank++) {
+                size = (size_t) mpi_map_local_array_sizes[rank];
+                offset = (size_t) mpi_map_global_array_offsets[rank];
+                for (i = 0; i < size; i++) {
+                    dvar_send[nsteps * offset + s * size + i] =
+                        dvar_mapped[offset + i];
+                }
+            }
+        }
+        free(dvar);
+        free(dvar_filtered);
+        free(dvar_mapped);
+    }
+
+    status = MPI_Scatterv(dvar_send, send_counts, send_displs, MPI_DOUBLE,
+                          var, (int) (nsteps * local_domain.ncells_active),
+                          MPI_DOUBLE, VIC_MPI_ROOT, MPI_COMM_VIC);
+    check_mpi_status(status, "MPI error.");
+
+    if (mpi_rank == VIC_MPI_ROOT) {
+        free(dvar_send);
+        free(send_counts);
+        free(send_displs);
+    }
+}
+
 /******************************************************************************
  * @brief   Read double precision NetCDF field from file and scatter
  * @details Read happens on the master node and is then scattered to the local
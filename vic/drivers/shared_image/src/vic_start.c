@@ -95,11 +95,15 @@ vic_start(void)
         // global domain struct. This just makes life easier
         add_nveg_to_global_domain(&(filenames.params), &global_domain);
 
-        // decompose the mask
-        mpi_map_decomp_domain(global_domain.ncells_active, mpi_size,
-                              &mpi_map_local_array_sizes,
-                              &mpi_map_global_array_offsets,
-                              &mpi_map_mapping_array);
+        // decompose the mask over the processes that are not I/O servers
+        decompose_domain(&global_domain, mpi_size - options.IO_SERVER_RANKS,
+                         &mpi_map_local_array_sizes,
+                         &mpi_map_global_array_offsets,
+                         &mpi_map_mapping_array);
+        if (options.IO_SERVER_RANKS > 0) {
+            reserve_io_server_ranks(&mpi_map_local_array_sizes,
+                                    &mpi_map_global_array_offsets);
+        }
 
         // get the indices for the active cells (used in reading and writing)
         filter_active_cells = malloc(global_domain.ncells_active *
@@ -150,6 +154,16 @@ vic_start(void)
                        VIC_MPI_ROOT, MPI_COMM_VIC);
     check_mpi_status(status, "MPI error.");
 
+    // broadcast the size of the global domain, which is needed on all nodes
+    // to locate their cells for parallel netCDF I/O
+    status = MPI_Bcast(&(global_domain.n_nx), 1, MPI_UNSIGNED_LONG,
+                       VIC_MPI_ROOT, MPI_COMM_VIC);
+    check_mpi_status(status, "MPI error.");
+
+    status = MPI_Bcast(&(global_domain.n_ny), 1, MPI_UNSIGNED_LONG,
+                       VIC_MPI_ROOT, MPI_COMM_VIC);
+    check_mpi_status(status, "MPI error.");
+
     // setup the local domain_structs
 
     // First scatter the array sizes
@@ -219,4 +233,7 @@ vic_start(void)
         free(mapped_locations);
         free(active_locations);
     }
+
+    // give the I/O servers what they need to write history files
+    initialize_io_servers();
 }
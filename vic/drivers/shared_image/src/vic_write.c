@@ -58,33 +58,54 @@ vic_write(stream_struct  *stream,
           nc_file_struct *nc_hist_file,
           dmy_struct     *dmy_current)
 {
-    extern global_param_struct global_param;
-    extern domain_struct       local_domain;
-    extern int                 mpi_rank;
-    extern metadata_struct     out_metadata[N_OUTVAR_TYPES];
+    extern global_param_struct   global_param;
+    extern domain_struct         local_domain;
+    extern int                   mpi_rank;
+    extern option_struct         options;
+    extern metadata_struct       out_metadata[N_OUTVAR_TYPES];
+    extern scratch_arena_struct *scratch_arenas;
 
-    size_t                     i;
-    size_t                     j;
-    size_t                     k;
-    size_t                     ndims;
-    double                     dtime;
-    double                    *dvar = NULL;
-    float                     *fvar = NULL;
-    int                       *ivar = NULL;
-    short int                 *svar = NULL;
-    char                      *cvar = NULL;
-    size_t                     dcount[MAXDIMS];
-    size_t                     dstart[MAXDIMS];
-    unsigned int               varid;
-    int                        status;
-    double                     offset;
-    double                     bounds[2];
+    size_t                       i;
+    size_t                       j;
+    size_t                       k;
+    size_t                       ndims;
+    size_t                       nvars;
+    double                       dtime;
+    double                      *dvar = NULL;
+    float                       *fvar = NULL;
+    int                         *ivar = NULL;
+    short int                   *svar = NULL;
+    char                        *cvar = NULL;
+    size_t                       dcount[MAXDIMS];
+    size_t                       dstart[MAXDIMS];
+    unsigned int                 varid;
+    int                          status;
+    double                       offset;
+    double                       bounds[2];
+    bool                         par_io;
+    bool                         writer;
+    scratch_arena_struct        *scratch;
+    size_t                       scratch_top;
 
-    if (mpi_rank == VIC_MPI_ROOT) {
+    // the history may be written by any thread (see PIPELINE_IO)
+    scratch = &(scratch_arenas[omp_get_thread_num()]);
+    scratch_top = scratch_mark(scratch);
+
+    // in parallel mode the history files are written by all processes,
+    // otherwise by the master process or the I/O server of the stream
+    par_io = (options.HIST_IO_MODE == IO_MODE_PARALLEL);
+    writer = (par_io || mpi_rank == nc_hist_file->io_rank);
+
+    if (writer) {
         // If the output file is not open, initialize the history file now.
         if (nc_hist_file->open == false) {
             // open the netcdf history file
-            initialize_history_file(nc_hist_file, stream);
+            if (par_io) {
+                initialize_par_history_file(nc_hist_file, stream);
+            }
+            else {
+                initialize_history_file(nc_hist_file, stream);
+            }
         }
     }
 
@@ -94,42 +115,55 @@ vic_write(stream_struct  *stream,
         dcount[i] = 0;
     }
 
-    for (k = 0; k < stream->nvars; k++) {
+    // with I/O servers the whole stream is sent to its server in one
+    // message instead of being gathered one variable at a time
+    nvars = stream->nvars;
+    if (options.IO_SERVER_RANKS > 0) {
+        if (writer) {
+            recv_put_stream_data(stream, nc_hist_file);
+        }
+        else {
+            send_stream_data(stream, nc_hist_file);
+        }
+        nvars = 0;
+    }
+
+    for (k = 0; k < nvars; k++) {
         varid = stream->varid[k];
 
         if (nc_hist_file->nc_vars[k].nc_type == NC_DOUBLE) {
             if (dvar == NULL) {
                 // allocate memory for variables to be stored
-                dvar = malloc(local_domain.ncells_active * sizeof(*dvar));
-                check_alloc_status(dvar, "Memory allocation error");
+                dvar = scratch_alloc(scratch, local_domain.ncells_active *
+                                   sizeof(*dvar));
             }
         }
         else if (nc_hist_file->nc_vars[k].nc_type == NC_FLOAT) {
             if (fvar == NULL) {
                 // allocate memory for variables to be stored
-                fvar = malloc(local_domain.ncells_active * sizeof(*fvar));
-                check_alloc_status(fvar, "Memory allocation error");
+                fvar = scratch_alloc(scratch, local_domain.ncells_active *
+                                   sizeof(*fvar));
             }
         }
         else if (nc_hist_file->nc_vars[k].nc_type == NC_INT) {
             if (ivar == NULL) {
                 // allocate memory for variables to be stored
-                ivar = malloc(local_domain.ncells_active * sizeof(*ivar));
-                check_alloc_status(ivar, "Memory allocation error");
+                ivar = scratch_alloc(scratch, local_domain.ncells_active *
+                                   sizeof(*ivar));
             }
         }
         else if (nc_hist_file->nc_vars[k].nc_type == NC_SHORT) {
             if (svar == NULL) {
                 // allocate memory for variables to be stored
-                svar = malloc(local_domain.ncells_active * sizeof(*svar));
-                check_alloc_status(svar, "Memory allocation error");
+                svar = scratch_alloc(scratch, local_domain.ncells_active *
+                                   sizeof(*svar));
             }
         }
         else if (nc_hist_file->nc_vars[k].nc_type == NC_CHAR) {
             if (cvar == NULL) {
                 // allocate memory for variables to be stored
-                cvar = malloc(local_domain.ncells_active * sizeof(*cvar));
-                check_alloc_status(cvar, "Memory allocation error");
+                cvar = scratch_alloc(scratch, local_domain.ncells_active *
+                                   sizeof(*cvar));
             }
         }
         else {
@@ -156,46 +190,86 @@ vic_write(stream_struct  *stream,
                 for (i = 0; i < local_domain.ncells_active; i++) {
                     dvar[i] = (double) stream->aggdata[i][k][j][0];
                 }
-                gather_put_nc_field_double(nc_hist_file->nc_id,
-                                           nc_hist_file->nc_vars[k].nc_varid,
-                                           nc_hist_file->d_fillvalue,
-                                           dstart, dcount, dvar);
+                if (par_io) {
+                    put_par_nc_field_double(nc_hist_file->nc_id,
+                                            nc_hist_file->nc_vars[k].nc_varid,
+                                            nc_hist_file->d_fillvalue,
+                                            ndims, dstart, dcount, dvar);
+                }
+                else {
+                    gather_put_nc_field_double(nc_hist_file->nc_id,
+                                               nc_hist_file->nc_vars[k].nc_varid,
+                                               nc_hist_file->d_fillvalue,
+                                               dstart, dcount, dvar);
+                }
             }
             else if (nc_hist_file->nc_vars[k].nc_type == NC_FLOAT) {
                 for (i = 0; i < local_domain.ncells_active; i++) {
                     fvar[i] = (float) stream->aggdata[i][k][j][0];
                 }
-                gather_put_nc_field_float(nc_hist_file->nc_id,
-                                          nc_hist_file->nc_vars[k].nc_varid,
-                                          nc_hist_file->f_fillvalue,
-                                          dstart, dcount, fvar);
+                if (par_io) {
+                    put_par_nc_field_float(nc_hist_file->nc_id,
+                                           nc_hist_file->nc_vars[k].nc_varid,
+                                           nc_hist_file->f_fillvalue,
+                                           ndims, dstart, dcount, fvar);
+                }
+                else {
+                    gather_put_nc_field_float(nc_hist_file->nc_id,
+                                              nc_hist_file->nc_vars[k].nc_varid,
+                                              nc_hist_file->f_fillvalue,
+                                              dstart, dcount, fvar);
+                }
             }
             else if (nc_hist_file->nc_vars[k].nc_type == NC_INT) {
                 for (i = 0; i < local_domain.ncells_active; i++) {
                     ivar[i] = (int) stream->aggdata[i][k][j][0];
                 }
-                gather_put_nc_field_int(nc_hist_file->nc_id,
-                                        nc_hist_file->nc_vars[k].nc_varid,
-                                        nc_hist_file->i_fillvalue,
-                                        dstart, dcount, ivar);
+                if (par_io) {
+                    put_par_nc_field_int(nc_hist_file->nc_id,
+                                         nc_hist_file->nc_vars[k].nc_varid,
+                                         nc_hist_file->i_fillvalue,
+                                         ndims, dstart, dcount, ivar);
+                }
+                else {
+                    gather_put_nc_field_int(nc_hist_file->nc_id,
+                                            nc_hist_file->nc_vars[k].nc_varid,
+                                            nc_hist_file->i_fillvalue,
+                                            dstart, dcount, ivar);
+                }
             }
             else if (nc_hist_file->nc_vars[k].nc_type == NC_SHORT) {
                 for (i = 0; i < local_domain.ncells_active; i++) {
                     svar[i] = (short int) stream->aggdata[i][k][j][0];
                 }
-                gather_put_nc_field_short(nc_hist_file->nc_id,
-                                          nc_hist_file->nc_vars[k].nc_varid,
-                                          nc_hist_file->s_fillvalue,
-                                          dstart, dcount, svar);
+                if (par_io) {
+                    put_par_nc_field_short(nc_hist_file->nc_id,
+                                           nc_hist_file->nc_vars[k].nc_varid,
+                                           nc_hist_file->s_fillvalue,
+                                           ndims, dstart, dcount, svar);
+                }
+                else {
+                    gather_put_nc_field_short(nc_hist_file->nc_id,
+                                              nc_hist_file->nc_vars[k].nc_varid,
+                                              nc_hist_file->s_fillvalue,
+                                              dstart, dcount, svar);
+                }
             }
             else if (nc_hist_file->nc_vars[k].nc_type == NC_CHAR) {
                 for (i = 0; i < local_domain.ncells_active; i++) {
                     cvar[i] = (char) stream->aggdata[i][k][j][0];
                 }
-                gather_put_nc_field_schar(nc_hist_file->nc_id,
-                                          nc_hist_file->nc_vars[k].nc_varid,
-                                          nc_hist_file->c_fillvalue,
-                                          dstart, dcount, cvar);
+                if (par_io) {
+                    put_par_nc_field_schar(nc_hist_file->nc_id,
+                                           nc_hist_file->nc_vars[k].nc_varid,
+                                           nc_hist_file->c_fillvalue,
+                                           ndims, dstart, dcount, cvar);
+                }
+                else {
+                    gather_put_nc_field_schar(nc_hist_file->nc_id,
+                                              nc_hist_file->nc_vars[k].nc_varid,
+                                              nc_hist_file->c_fillvalue,
+                                              dstart, dcount, cvar);
+                }
             }
             else {
                 log_err("Unsupported nc_type encountered");
@@ -210,23 +284,30 @@ vic_write(stream_struct  *stream,
     }
 
     // write to file
-    if (mpi_rank == VIC_MPI_ROOT) {
+    if (writer) {
         // Add time variable
         dstart[0] = stream->write_alarm.count;
+        // in parallel mode only the master process writes the time
+        // variables, but all processes take part in the collective call
+        if (!par_io || mpi_rank == VIC_MPI_ROOT) {
+            dcount[0] = 1;
+        }
+        else {
+            dcount[0] = 0;
+        }
 
         // timestamp is the beginning of the aggregation window
         dtime = date2num(global_param.time_origin_num,
                          &(stream->time_bounds[0]), 0.,
                          global_param.calendar, global_param.time_units);
 
-        status = nc_put_var1_double(nc_hist_file->nc_id,
+        status = nc_put_vara_double(nc_hist_file->nc_id,
                                     nc_hist_file->time_varid,
-                                    dstart, &dtime);
+                                    dstart, dcount, &dtime);
         check_nc_status(status, "Error writing time variable");
 
         // Add time bounds variable
         dstart[1] = 0;
-        dcount[0] = 1;
         dcount[1] = 2;
         bounds[0] = dtime;
         dt_seconds_to_time_units(global_param.time_units, global_param.dt,
@@ -246,7 +327,7 @@ vic_write(stream_struct  *stream,
     stream->write_alarm.count++;
     if (raise_alarm(&(stream->write_alarm), dmy_current)) {
         // close this history file
-        if (mpi_rank == VIC_MPI_ROOT) {
+        if (writer) {
             status = nc_close(nc_hist_file->nc_id);
             check_nc_status(status, "Error closing history file");
             nc_hist_file->open = false;
@@ -255,7 +336,7 @@ vic_write(stream_struct  *stream,
     }
     else {
         // Force sync with disk (GH:#596)
-        if (mpi_rank == VIC_MPI_ROOT) {
+        if (writer) {
             status = nc_sync(nc_hist_file->nc_id);
             check_nc_status(status, "Error syncing netCDF file %s",
                             stream->filename);
@@ -263,19 +344,5 @@ vic_write(stream_struct  *stream,
     }
 
     // free memory
-    if (dvar != NULL) {
-        free(dvar);
-    }
-    if (fvar != NULL) {
-        free(fvar);
-    }
-    if (ivar != NULL) {
-        free(ivar);
-    }
-    if (svar != NULL) {
-        free(svar);
-    }
-    if (cvar != NULL) {
-        free(cvar);
-    }
+    scratch_release(scratch, scratch_top);
 }
@@ -37,7 +37,7 @@
 typedef struct {
     size_t full_time_length;                  /*scalar - total number of timesteps*/
     size_t n_timesteps;                        /*scalar - number of timesteps*/
-    size_t n_sources;                          /*scalar - number of sources*/
+    size_t n_sources;                          /*scalar - number of sources on this process*/
     size_t n_outlets;                          /*scalar - length of subset*/
     size_t *source2outlet_ind;                /*1d array - source to outlet mapping*/
     int *source_y_ind;                        /*1d array - source y location*/
@@ -48,9 +48,15 @@ typedef struct {
     double *outlet_lon;                       /*1d array - Longitude coordinate of outlet grid cell*/
     int *source_VIC_index;                    /*1d array - mapping of routing-source index to VIC index*/
     int *outlet_VIC_index;                    /*1d array - mapping of routing-outlet index to VIC index*/
+    size_t *source_local_ind;                 /*1d array - local index of the VIC grid cell of the source*/
+    size_t *outlet_local_ind;                 /*1d array - local index of the VIC grid cell of the outlet, local_domain.ncells_active if not on this process*/
     int *source_time_offset;                  /*1d array - source time offset*/
-    double *unit_hydrograph;                  /*2d array[times][sources] - unit hydrographs*/
-    double *aggrunin;                         /*2d array[ysize][xsize] - vic runoff flux*/
+    double *unit_hydrograph;                  /*2d array[times][sources] - unit hydrographs, freed once compressed*/
+    size_t *outlet_source_start;              /*1d array[outlets + 1] - first source of each outlet, sources are sorted by outlet*/
+    size_t *uh_lag;                           /*1d array - time offset plus leading zero steps of the unit hydrograph*/
+    size_t *uh_start;                         /*1d array[sources + 1] - start of the nonzero unit hydrograph of each source in uh_data*/
+    double *uh_data;                          /*1d array - nonzero window of the unit hydrographs, source after source*/
+    double *aggrunin;                         /*1d array[sources] - vic runoff flux*/
 } rout_param_struct;
 
 /******************************************************************************
@@ -58,8 +64,9 @@ typedef struct {
  *****************************************************************************/
 typedef struct {
     rout_param_struct rout_param;
-    double *ring;
-    double *discharge;
+    double *ring;                             /*2d array[outlets][times] - contribution of the sources on this process*/
+    size_t ring_head;                         /*scalar - position in ring that holds the current timestep*/
+    double *discharge;                        /*1d array[outlets] - outlet flux summed over all processes*/
 } rout_struct;
 
 /******************************************************************************
@@ -69,6 +76,8 @@ void rout_alloc(void);                 // allocate memory
 void rout_init(void);                  // initialize model parameters from parameter files
 void rout_run(void);                   // run routing over the domain
 void rout_finalize(void);              // clean up routine for routing
+void rout_decompose(void);             // distribute sources and outlets
+void compress_unit_hydrograph(void);   // sparse, outlet-major unit hydrographs
 void convolution(double *, double *);  // convolution over the domain
 
 /******************************************************************************
@@ -81,7 +90,6 @@ void gather_var_double(double *, double *);
  * @brief   Convolution function adapted from the RVIC scheme
  *****************************************************************************/
 void get_global_param_rout(FILE *gp);
-void cshift(double *, int, int, int, int);
 void vic_store_rout_extension(nc_file_struct *);
 void vic_restore_rout_extension(nameid_struct *, metadata_struct *);
 void state_metadata_rout_extension();
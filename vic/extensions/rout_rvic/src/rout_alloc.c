@@ -32,15 +32,16 @@
 void
 rout_alloc(void)
 {
-    extern int mpi_rank;
+    extern int         mpi_rank;
+    extern MPI_Comm    MPI_COMM_VIC;
+    extern rout_struct rout;
+    int                status;
+
     if (mpi_rank == VIC_MPI_ROOT) {
-        extern domain_struct    global_domain;
-        extern rout_struct      rout;
         int                     ivar;
         size_t                  d1count[1];
         size_t                  d1start[1];
         extern filenames_struct filenames;
-        int                     status;
 
         // open parameter file
         status = nc_open(filenames.rout_params.nc_filename, NC_NOWRITE,
@@ -66,7 +67,8 @@ rout_alloc(void)
         rout.rout_param.n_sources = get_nc_dimension(&(filenames.rout_params),
                                                      "sources");
 
-        // Allocate memory in rout param_struct
+        // Allocate memory in rout param_struct for the full set of sources;
+        // rout_init keeps only the sources of each process
         rout.rout_param.source2outlet_ind = malloc(
             rout.rout_param.n_sources *
             sizeof(*rout.rout_param.source2outlet_ind));
@@ -117,7 +119,7 @@ rout_alloc(void)
 
         rout.rout_param.outlet_VIC_index = malloc(
             rout.rout_param.n_outlets *
-            sizeof(rout.rout_param.outlet_VIC_index));
+            sizeof(*rout.rout_param.outlet_VIC_index));
         check_alloc_status(rout.rout_param.outlet_VIC_index,
                            "Memory allocation error.");
 
@@ -126,21 +128,33 @@ rout_alloc(void)
             sizeof(*rout.rout_param.unit_hydrograph));
         check_alloc_status(rout.rout_param.unit_hydrograph,
                            "Memory allocation error.");
-
-        rout.rout_param.aggrunin =
-            malloc(
-                global_domain.ncells_total * sizeof(*rout.rout_param.aggrunin));
-        check_alloc_status(rout.rout_param.aggrunin,
-                           "Memory allocation error.");
-
-        rout.discharge =
-            malloc(global_domain.ncells_total * sizeof(*rout.discharge));
-        check_alloc_status(rout.discharge, "Memory allocation error.");
-
-        // Allocate memory for the ring
-        rout.ring = malloc(
-            rout.rout_param.full_time_length * rout.rout_param.n_outlets *
-            sizeof(*rout.ring));
-        check_alloc_status(rout.ring, "Memory allocation error.");
     }
+
+    // every process convolves its own sources into its own ring
+    status = MPI_Bcast(&(rout.rout_param.full_time_length), 1,
+                       MPI_UNSIGNED_LONG, VIC_MPI_ROOT, MPI_COMM_VIC);
+    check_mpi_status(status, "MPI error.");
+
+    status = MPI_Bcast(&(rout.rout_param.n_timesteps), 1, MPI_UNSIGNED_LONG,
+                       VIC_MPI_ROOT, MPI_COMM_VIC);
+    check_mpi_status(status, "MPI error.");
+
+    status = MPI_Bcast(&(rout.rout_param.n_outlets), 1, MPI_UNSIGNED_LONG,
+                       VIC_MPI_ROOT, MPI_COMM_VIC);
+    check_mpi_status(status, "MPI error.");
+
+    rout.rout_param.outlet_local_ind = malloc(
+        rout.rout_param.n_outlets * sizeof(*rout.rout_param.outlet_local_ind));
+    check_alloc_status(rout.rout_param.outlet_local_ind,
+                       "Memory allocation error.");
+
+    rout.discharge = malloc(rout.rout_param.n_outlets *
+                            sizeof(*rout.discharge));
+    check_alloc_status(rout.discharge, "Memory allocation error.");
+
+    // Allocate memory for the ring
+    rout.ring = malloc(
+        rout.rout_param.full_time_length * rout.rout_param.n_outlets *
+        sizeof(*rout.ring));
+    check_alloc_status(rout.ring, "Memory allocation error.");
 }
@@ -30,55 +30,66 @@ void
 convolution(double *runoff,
             double *discharge)
 {
-    extern rout_struct         rout;
-    extern global_param_struct global_param;
-    extern domain_struct       global_domain;
+    extern rout_struct rout;
 
-    size_t                     i_source;
-    size_t                     i_outlet;
-    size_t                     i_timestep;
-    size_t                     j_timestep;
-    int                        offset; /*2d indicies*/
-    size_t                     i_ring;
-    size_t                     i_uh; /*1d indicies*/
+    size_t             i_source;
+    size_t             i_outlet;
+    size_t             i_row;
+    size_t             n_uh;
+    size_t             n_first;
+    size_t             k;
+    size_t             n_ring; /*ring length*/
+    double            *ring; /*ring of one outlet*/
+    double            *uh; /*unit hydrograph of one source*/
+    double             q;
+
+    n_ring = rout.rout_param.full_time_length;
 
     // Zero out current ring
     // in python: (from variables.py) self.ring[tracer][0, :] = 0.
     for (i_outlet = 0; i_outlet < rout.rout_param.n_outlets; i_outlet++) {
-        rout.ring[i_outlet] = 0.0;
+        rout.ring[i_outlet * n_ring + rout.ring_head] = 0.0;
     }
 
-    // Equivalent to Fortran 90 cshift function, in python: (from variables.py)
+    // Advance the head of the ring buffer, the zeroed row becomes the last
+    // row. In python: (from variables.py)
     // self.ring[tracer] = np.roll(self.ring[tracer], -1, axis=0)
-    cshift(rout.ring, rout.rout_param.n_timesteps, rout.rout_param.n_outlets, 0,
-           1);
-
-    /*Loop through all sources*/
-    for (i_source = 0; i_source < rout.rout_param.n_sources; i_source++) {
-        i_outlet = rout.rout_param.source2outlet_ind[i_source];
-        offset = rout.rout_param.source_time_offset[i_source];
+    rout.ring_head = (rout.ring_head + 1) % n_ring;
 
-        /* Do the convolution */
-        // iTimestep is the position in the unit hydrograph
-        // jTimestep is the position in the ring
-        for (i_timestep = 0; i_timestep < rout.rout_param.n_timesteps;
-             i_timestep++) {
-            j_timestep = i_timestep + offset;
+    /* Do the convolution */
+    // each thread owns the rings of whole outlets, the nonzero part of the
+    // unit hydrograph of a source is added to it as one or (where the ring
+    // wraps around) two contiguous axpy operations
+    #pragma omp parallel for default(shared) schedule(dynamic) \
+    private(i_source, i_row, n_uh, n_first, k, ring, uh, q)
+    for (i_outlet = 0; i_outlet < rout.rout_param.n_outlets; i_outlet++) {
+        ring = &(rout.ring[i_outlet * n_ring]);
+        /*Loop through the sources of this outlet*/
+        for (i_source = rout.rout_param.outlet_source_start[i_outlet];
+             i_source < rout.rout_param.outlet_source_start[i_outlet + 1];
+             i_source++) {
+            uh = &(rout.rout_param.uh_data[rout.rout_param.uh_start[i_source]]);
+            n_uh = rout.rout_param.uh_start[i_source + 1] -
+                   rout.rout_param.uh_start[i_source];
+            q = runoff[i_source];
 
-            // index locations
-            i_ring = (j_timestep * rout.rout_param.n_outlets) + i_outlet;
-            i_uh = (i_timestep * rout.rout_param.n_sources) + i_source;
-            rout.ring[i_ring] += rout.rout_param.unit_hydrograph[i_uh] *
-                                 runoff[rout.rout_param.source_VIC_index[
-                                            i_source]];
+            i_row = (rout.ring_head + rout.rout_param.uh_lag[i_source]) %
+                    n_ring;
+            n_first = n_ring - i_row;
+            if (n_first > n_uh) {
+                n_first = n_uh;
+            }
+            for (k = 0; k < n_first; k++) {
+                ring[i_row + k] += uh[k] * q;
+            }
+            for (k = n_first; k < n_uh; k++) {
+                ring[k - n_first] += uh[k] * q;
+            }
         }
     }
-    // Write to discharge prior to scattering over local domains...
+
+    // Contribution of the local sources to the current outlet flux
     for (i_outlet = 0; i_outlet < rout.rout_param.n_outlets; i_outlet++) {
-        discharge[rout.rout_param.outlet_VIC_index[i_outlet]] =
-            rout.ring[i_outlet] *
-            global_domain.locations[rout.rout_param.outlet_VIC_index[i_outlet]]
-            .area /
-            (MM_PER_M * global_param.dt);
+        discharge[i_outlet] = rout.ring[i_outlet * n_ring + rout.ring_head];
     }
 }
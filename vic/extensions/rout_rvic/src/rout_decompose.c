@@ -0,0 +1,284 @@
+/******************************************************************************
+ * @section DESCRIPTION
+ *
+ * Distribute the routing sources and outlets over the processes.
+ *
+ * @section LICENSE
+ *
+ * The Variable Infiltration Capacity (VIC) macroscale hydrological model
+ * Copyright (C) 2016 The Computational Hydrology Group, Department of Civil
+ * and Environmental Engineering, University of Washington.
+ *
+ * The VIC model is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *****************************************************************************/
+
+#include <rout.h>
+
+/******************************************************************************
+ * @brief    Distribute the routing sources and outlets over the processes.
+ * @details  Each source is sent to the process that runs its VIC grid cell,
+ *           together with its unit hydrograph, so the convolution can be done
+ *           without gathering the runoff. Afterwards rout.rout_param only
+ *           describes the sources of this process and source_local_ind holds
+ *           their local cell index. Sources on inactive cells never receive
+ *           runoff and are dropped. Every process learns the local cell index
+ *           of the outlets it owns; outlet_local_ind is
+ *           local_domain.ncells_active for the others.
+ *****************************************************************************/
+void
+rout_decompose(void)
+{
+    extern domain_struct global_domain;
+    extern domain_struct local_domain;
+    extern MPI_Comm      MPI_COMM_VIC;
+    extern int           mpi_rank;
+    extern int           mpi_size;
+    extern int          *mpi_map_global_array_offsets;
+    extern int          *mpi_map_local_array_sizes;
+    extern size_t       *mpi_map_mapping_array;
+    extern rout_struct   rout;
+
+    int                  status;
+    int                  n_local;
+    int                  rank;
+    int                 *cell_rank = NULL;
+    int                 *source_rank = NULL;
+    int                 *outlet_rank = NULL;
+    int                 *source_counts = NULL;
+    int                 *source_displs = NULL;
+    int                 *uh_counts = NULL;
+    int                 *uh_displs = NULL;
+    int                 *send_offset = NULL;
+    int                 *recv_offset = NULL;
+    size_t              *cell_local_ind = NULL;
+    size_t              *outlet_ind = NULL;
+    size_t              *send_outlet = NULL;
+    size_t              *send_local = NULL;
+    size_t              *recv_outlet = NULL;
+    size_t              *recv_local = NULL;
+    size_t              *pos = NULL;
+    size_t               n_timesteps;
+    size_t               i_source;
+    size_t               i_outlet;
+    size_t               i_timestep;
+    size_t               i;
+    size_t               j;
+    double              *send_uh = NULL;
+    double              *recv_uh = NULL;
+
+    n_timesteps = rout.rout_param.n_timesteps;
+
+    outlet_rank = malloc(rout.rout_param.n_outlets * sizeof(*outlet_rank));
+    check_alloc_status(outlet_rank, "Memory allocation error.");
+    outlet_ind = malloc(rout.rout_param.n_outlets * sizeof(*outlet_ind));
+    check_alloc_status(outlet_ind, "Memory allocation error.");
+
+    if (mpi_rank == VIC_MPI_ROOT) {
+        // process and local index of each active cell
+        cell_rank = malloc(global_domain.ncells_active * sizeof(*cell_rank));
+        check_alloc_status(cell_rank, "Memory allocation error.");
+        cell_local_ind = malloc(global_domain.ncells_active *
+                                sizeof(*cell_local_ind));
+        check_alloc_status(cell_local_ind, "Memory allocation error.");
+        for (rank = 0; rank < mpi_size; rank++) {
+            for (i = 0; i < (size_t) mpi_map_local_array_sizes[rank]; i++) {
+                j = mpi_map_mapping_array[mpi_map_global_array_offsets[rank] +
+                                          i];
+                cell_rank[j] = rank;
+                cell_local_ind[j] = i;
+            }
+        }
+
+        // count the sources of each process
+        source_rank = malloc(rout.rout_param.n_sources * sizeof(*source_rank));
+        check_alloc_status(source_rank, "Memory allocation error.");
+        source_counts = calloc(mpi_size, sizeof(*source_counts));
+        check_alloc_status(source_counts, "Memory allocation error.");
+        source_displs = malloc(mpi_size * sizeof(*source_displs));
+        check_alloc_status(source_displs, "Memory allocation error.");
+        uh_counts = malloc(mpi_size * sizeof(*uh_counts));
+        check_alloc_status(uh_counts, "Memory allocation error.");
+        uh_displs = malloc(mpi_size * sizeof(*uh_displs));
+        check_alloc_status(uh_displs, "Memory allocation error.");
+        for (i_source = 0; i_source < rout.rout_param.n_sources; i_source++) {
+            j = rout.rout_param.source_VIC_index[i_source];
+            if (global_domain.locations[j].run) {
+                source_rank[i_source] =
+                    cell_rank[global_domain.locations[j].global_idx];
+                source_counts[source_rank[i_source]]++;
+            }
+            else {
+                source_rank[i_source] = MISSING;
+            }
+        }
+        source_displs[0] = 0;
+        for (rank = 1; rank < mpi_size; rank++) {
+            source_displs[rank] = source_displs[rank - 1] +
+                                  source_counts[rank - 1];
+        }
+        for (rank = 0; rank < mpi_size; rank++) {
+            uh_counts[rank] = source_counts[rank] * n_timesteps;
+            uh_displs[rank] = source_displs[rank] * n_timesteps;
+        }
+
+        // order the sources by process; the unit hydrograph of each process
+        // is a contiguous [n_timesteps][sources of the process] block
+        send_outlet = malloc((rout.rout_param.n_sources + 1) *
+                             sizeof(*send_outlet));
+        check_alloc_status(send_outlet, "Memory allocation error.");
+        send_offset = malloc((rout.rout_param.n_sources + 1) *
+                             sizeof(*send_offset));
+        check_alloc_status(send_offset, "Memory allocation error.");
+        send_local = malloc((rout.rout_param.n_sources + 1) *
+                            sizeof(*send_local));
+        check_alloc_status(send_local, "Memory allocation error.");
+        send_uh = malloc((rout.rout_param.n_sources * n_timesteps + 1) *
+                         sizeof(*send_uh));
+        check_alloc_status(send_uh, "Memory allocation error.");
+        pos = calloc(mpi_size, sizeof(*pos));
+        check_alloc_status(pos, "Memory allocation error.");
+        for (i_source = 0; i_source < rout.rout_param.n_sources; i_source++) {
+            rank = source_rank[i_source];
+            if (rank == MISSING) {
+                continue;
+            }
+            i = source_displs[rank] + pos[rank];
+            j = rout.rout_param.source_VIC_index[i_source];
+            send_outlet[i] = rout.rout_param.source2outlet_ind[i_source];
+            send_offset[i] = rout.rout_param.source_time_offset[i_source];
+            send_local[i] =
+                cell_local_ind[global_domain.locations[j].global_idx];
+            for (i_timestep = 0; i_timestep < n_timesteps; i_timestep++) {
+                send_uh[uh_displs[rank] + i_timestep * source_counts[rank] +
+                        pos[rank]] =
+                    rout.rout_param.unit_hydrograph[i_timestep *
+                                                    rout.rout_param.n_sources +
+                                                    i_source];
+            }
+            pos[rank]++;
+        }
+
+        // owner of each outlet
+        for (i_outlet = 0; i_outlet < rout.rout_param.n_outlets; i_outlet++) {
+            j = rout.rout_param.outlet_VIC_index[i_outlet];
+            if (global_domain.locations[j].run) {
+                outlet_rank[i_outlet] =
+                    cell_rank[global_domain.locations[j].global_idx];
+                outlet_ind[i_outlet] =
+                    cell_local_ind[global_domain.locations[j].global_idx];
+            }
+            else {
+                outlet_rank[i_outlet] = MISSING;
+                outlet_ind[i_outlet] = 0;
+            }
+        }
+
+        // the full set of sources is not needed anymore
+        free(rout.rout_param.source2outlet_ind);
+        free(rout.rout_param.source_time_offset);
+        free(rout.rout_param.source_x_ind);
+        free(rout.rout_param.source_y_ind);
+        free(rout.rout_param.source_lat);
+        free(rout.rout_param.source_lon);
+        free(rout.rout_param.source_VIC_index);
+        free(rout.rout_param.unit_hydrograph);
+        rout.rout_param.source_x_ind = NULL;
+        rout.rout_param.source_y_ind = NULL;
+        rout.rout_param.source_lat = NULL;
+        rout.rout_param.source_lon = NULL;
+        rout.rout_param.source_VIC_index = NULL;
+
+        free(cell_rank);
+        free(cell_local_ind);
+        free(source_rank);
+        free(pos);
+    }
+
+    // scatter the sources
+    status = MPI_Scatter(source_counts, 1, MPI_INT, &n_local, 1, MPI_INT,
+                         VIC_MPI_ROOT, MPI_COMM_VIC);
+    check_mpi_status(status, "MPI error.");
+    rout.rout_param.n_sources = (size_t) n_local;
+
+    recv_outlet = malloc((rout.rout_param.n_sources + 1) *
+                         sizeof(*recv_outlet));
+    check_alloc_status(recv_outlet, "Memory allocation error.");
+    recv_offset = malloc((rout.rout_param.n_sources + 1) *
+                         sizeof(*recv_offset));
+    check_alloc_status(recv_offset, "Memory allocation error.");
+    recv_local = malloc((rout.rout_param.n_sources + 1) *
+                        sizeof(*recv_local));
+    check_alloc_status(recv_local, "Memory allocation error.");
+    recv_uh = malloc((rout.rout_param.n_sources * n_timesteps + 1) *
+                     sizeof(*recv_uh));
+    check_alloc_status(recv_uh, "Memory allocation error.");
+
+    status = MPI_Scatterv(send_outlet, source_counts, source_displs,
+                          MPI_UNSIGNED_LONG, recv_outlet, n_local,
+                          MPI_UNSIGNED_LONG, VIC_MPI_ROOT, MPI_COMM_VIC);
+    check_mpi_status(status, "MPI error.");
+    status = MPI_Scatterv(send_offset, source_counts, source_displs,
+                          MPI_INT, recv_offset, n_local,
+                          MPI_INT, VIC_MPI_ROOT, MPI_COMM_VIC);
+    check_mpi_status(status, "MPI error.");
+    status = MPI_Scatterv(send_local, source_counts, source_displs,
+                          MPI_UNSIGNED_LONG, recv_local, n_local,
+                          MPI_UNSIGNED_LONG, VIC_MPI_ROOT, MPI_COMM_VIC);
+    check_mpi_status(status, "MPI error.");
+    status = MPI_Scatterv(send_uh, uh_counts, uh_displs,
+                          MPI_DOUBLE, recv_uh, n_local * n_timesteps,
+                          MPI_DOUBLE, VIC_MPI_ROOT, MPI_COMM_VIC);
+    check_mpi_status(status, "MPI error.");
+
+    rout.rout_param.source2outlet_ind = recv_outlet;
+    rout.rout_param.source_time_offset = recv_offset;
+    rout.rout_param.source_local_ind = recv_local;
+    rout.rout_param.unit_hydrograph = recv_uh;
+
+    rout.rout_param.aggrunin = malloc((rout.rout_param.n_sources + 1) *
+                                      sizeof(*rout.rout_param.aggrunin));
+    check_alloc_status(rout.rout_param.aggrunin, "Memory allocation error.");
+
+    // tell every process which outlets it owns
+    status = MPI_Bcast(outlet_rank, rout.rout_param.n_outlets, MPI_INT,
+                       VIC_MPI_ROOT, MPI_COMM_VIC);
+    check_mpi_status(status, "MPI error.");
+    status = MPI_Bcast(outlet_ind, rout.rout_param.n_outlets,
+                       MPI_UNSIGNED_LONG, VIC_MPI_ROOT, MPI_COMM_VIC);
+    check_mpi_status(status, "MPI error.");
+    for (i_outlet = 0; i_outlet < rout.rout_param.n_outlets; i_outlet++) {
+        if (outlet_rank[i_outlet] == mpi_rank) {
+            rout.rout_param.outlet_local_ind[i_outlet] = outlet_ind[i_outlet];
+        }
+        else {
+            rout.rout_param.outlet_local_ind[i_outlet] =
+                local_domain.ncells_active;
+        }
+    }
+
+    // cleanup
+    if (mpi_rank == VIC_MPI_ROOT) {
+        free(source_counts);
+        free(source_displs);
+        free(uh_counts);
+        free(uh_displs);
+        free(send_outlet);
+        free(send_offset);
+        free(send_local);
+        free(send_uh);
+    }
+    free(outlet_rank);
+    free(outlet_ind);
+}
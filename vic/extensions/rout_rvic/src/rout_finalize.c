@@ -44,7 +44,13 @@ rout_finalize(void)
     free(rout.rout_param.outlet_lat);
     free(rout.rout_param.outlet_lon);
     free(rout.rout_param.outlet_VIC_index);
+    free(rout.rout_param.source_local_ind);
+    free(rout.rout_param.outlet_local_ind);
     free(rout.rout_param.unit_hydrograph);
+    free(rout.rout_param.outlet_source_start);
+    free(rout.rout_param.uh_lag);
+    free(rout.rout_param.uh_start);
+    free(rout.rout_param.uh_data);
     free(rout.rout_param.aggrunin);
     free(rout.discharge);
     free(rout.ring);
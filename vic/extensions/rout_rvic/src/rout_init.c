@@ -37,13 +37,26 @@ rout_init(void)
     extern domain_struct    global_domain;
     extern filenames_struct filenames;
     int                     status;
+    size_t                  i_ring;
+
+    // The Ring; each process holds the part of the ring from its own sources
+    for (i_ring = 0;
+         i_ring < rout.rout_param.full_time_length * rout.rout_param.n_outlets;
+         i_ring++) {
+        rout.ring[i_ring] = 0.0;
+    }
+    rout.ring_head = 0;
+
+    // discharge
+    for (i_ring = 0; i_ring < rout.rout_param.n_outlets; i_ring++) {
+        rout.discharge[i_ring] = 0.0;
+    }
 
     if (mpi_rank == VIC_MPI_ROOT) {
         int    *ivar = NULL;
         double *dvar = NULL;
 
         size_t  i;
-        size_t  j;
         size_t  i1start;
         size_t  d3count[3];
         size_t  d3start[3];
@@ -67,18 +80,6 @@ rout_init(void)
             sizeof(*dvar));
         check_alloc_status(dvar, "Memory allocation error.");
 
-        // The Ring
-        for (j = 0; j < rout.rout_param.n_outlets; j++) {
-            for (i = 0; i < rout.rout_param.n_timesteps; i++) {
-                rout.ring[j * rout.rout_param.n_timesteps + i] = 0.0;
-            }
-        }
-
-        // discharge
-        for (j = 0; j < global_domain.ncells_active; j++) {
-            rout.discharge[j] = 0.0;
-        }
-
         // source2outlet_ind: source to outlet index mapping
         get_nc_field_int(&(filenames.rout_params),
                          "source2outlet_ind",
@@ -207,4 +208,162 @@ rout_init(void)
         free(ivar);
         free(dvar);
     }
+
+    // hand the sources and outlets to the processes that own their cells
+    rout_decompose();
+
+    // keep only the nonzero part of the unit hydrographs
+    compress_unit_hydrograph();
+}
+
+/******************************************************************************
+ * @brief    Build the sparse unit hydrographs of the local sources.
+ * @details  The sources are sorted by outlet, keeping their original order
+ *           within an outlet, so the convolution adds the contributions to an
+ *           outlet in the same order as before. For each source only the
+ *           window between its first and last nonzero unit hydrograph value
+ *           is kept, contiguous in uh_data; uh_lag is the position of the
+ *           window in the ring. Steps that would fall beyond the end of the
+ *           ring are dropped, as in the dense convolution. With
+ *           ROUT_SPARSE_UH = FALSE the window is the whole unit hydrograph,
+ *           which gives the dense convolution.
+ *****************************************************************************/
+void
+compress_unit_hydrograph(void)
+{
+    extern option_struct options;
+    extern rout_struct   rout;
+
+    size_t               n_sources;
+    size_t               n_timesteps;
+    size_t               i_source;
+    size_t               j_source;
+    size_t               i_outlet;
+    size_t               i_timestep;
+    size_t               first;
+    size_t               last;
+    size_t               lag;
+    size_t               n_uh;
+    size_t              *order = NULL;
+    size_t              *pos = NULL;
+    size_t              *source2outlet_ind = NULL;
+    size_t              *source_local_ind = NULL;
+    int                 *source_time_offset = NULL;
+    double              *uh = NULL;
+
+    n_sources = rout.rout_param.n_sources;
+    n_timesteps = rout.rout_param.n_timesteps;
+    uh = rout.rout_param.unit_hydrograph;
+
+    // counting sort of the sources by outlet
+    rout.rout_param.outlet_source_start = calloc(
+        rout.rout_param.n_outlets + 1,
+        sizeof(*rout.rout_param.outlet_source_start));
+    check_alloc_status(rout.rout_param.outlet_source_start,
+                       "Memory allocation error.");
+    for (i_source = 0; i_source < n_sources; i_source++) {
+        i_outlet = rout.rout_param.source2outlet_ind[i_source];
+        if (i_outlet >= rout.rout_param.n_outlets) {
+            log_err("invalid outlet %zu for source %zu", i_outlet, i_source);
+        }
+        rout.rout_param.outlet_source_start[i_outlet + 1]++;
+    }
+    for (i_outlet = 0; i_outlet < rout.rout_param.n_outlets; i_outlet++) {
+        rout.rout_param.outlet_source_start[i_outlet + 1] +=
+            rout.rout_param.outlet_source_start[i_outlet];
+    }
+    pos = malloc((rout.rout_param.n_outlets + 1) * sizeof(*pos));
+    check_alloc_status(pos, "Memory allocation error.");
+    for (i_outlet = 0; i_outlet < rout.rout_param.n_outlets; i_outlet++) {
+        pos[i_outlet] = rout.rout_param.outlet_source_start[i_outlet];
+    }
+    order = malloc((n_sources + 1) * sizeof(*order));
+    check_alloc_status(order, "Memory allocation error.");
+    for (i_source = 0; i_source < n_sources; i_source++) {
+        i_outlet = rout.rout_param.source2outlet_ind[i_source];
+        order[pos[i_outlet]++] = i_source;
+    }
+    free(pos);
+
+    // reorder the source arrays
+    source2outlet_ind = malloc((n_sources + 1) * sizeof(*source2outlet_ind));
+    check_alloc_status(source2outlet_ind, "Memory allocation error.");
+    source_local_ind = malloc((n_sources + 1) * sizeof(*source_local_ind));
+    check_alloc_status(source_local_ind, "Memory allocation error.");
+    source_time_offset = malloc((n_sources + 1) *
+                                sizeof(*source_time_offset));
+    check_alloc_status(source_time_offset, "Memory allocation error.");
+    for (j_source = 0; j_source < n_sources; j_source++) {
+        i_source = order[j_source];
+        source2outlet_ind[j_source] =
+            rout.rout_param.source2outlet_ind[i_source];
+        source_local_ind[j_source] = rout.rout_param.source_local_ind[i_source];
+        source_time_offset[j_source] =
+            rout.rout_param.source_time_offset[i_source];
+    }
+    free(rout.rout_param.source2outlet_ind);
+    free(rout.rout_param.source_local_ind);
+    free(rout.rout_param.source_time_offset);
+    rout.rout_param.source2outlet_ind = source2outlet_ind;
+    rout.rout_param.source_local_ind = source_local_ind;
+    rout.rout_param.source_time_offset = source_time_offset;
+
+    // nonzero window of each unit hydrograph
+    rout.rout_param.uh_lag = malloc((n_sources + 1) *
+                                    sizeof(*rout.rout_param.uh_lag));
+    check_alloc_status(rout.rout_param.uh_lag, "Memory allocation error.");
+    rout.rout_param.uh_start = malloc((n_sources + 1) *
+                                      sizeof(*rout.rout_param.uh_start));
+    check_alloc_status(rout.rout_param.uh_start, "Memory allocation error.");
+    rout.rout_param.uh_data = malloc((n_sources * n_timesteps + 1) *
+                                     sizeof(*rout.rout_param.uh_data));
+    check_alloc_status(rout.rout_param.uh_data, "Memory allocation error.");
+
+    n_uh = 0;
+    for (j_source = 0; j_source < n_sources; j_source++) {
+        i_source = order[j_source];
+        first = n_timesteps;
+        last = 0;
+        for (i_timestep = 0; i_timestep < n_timesteps; i_timestep++) {
+            if (uh[i_timestep * n_sources + i_source] != 0.) {
+                if (first == n_timesteps) {
+                    first = i_timestep;
+                }
+                last = i_timestep + 1;
+            }
+        }
+        if (first == n_timesteps) {
+            // no runoff reaches the outlet from this source
+            first = 0;
+        }
+        if (!options.ROUT_SPARSE_UH) {
+            first = 0;
+            last = n_timesteps;
+        }
+        lag = (size_t) source_time_offset[j_source] + first;
+        if (lag + (last - first) > rout.rout_param.full_time_length) {
+            if (lag >= rout.rout_param.full_time_length) {
+                last = first;
+            }
+            else {
+                last = first + rout.rout_param.full_time_length - lag;
+            }
+        }
+        rout.rout_param.uh_lag[j_source] = lag;
+        rout.rout_param.uh_start[j_source] = n_uh;
+        for (i_timestep = first; i_timestep < last; i_timestep++) {
+            rout.rout_param.uh_data[n_uh++] =
+                uh[i_timestep * n_sources + i_source];
+        }
+    }
+    rout.rout_param.uh_start[n_sources] = n_uh;
+    rout.rout_param.uh_data = realloc(rout.rout_param.uh_data,
+                                      (n_uh + 1) *
+                                      sizeof(*rout.rout_param.uh_data));
+    check_alloc_status(rout.rout_param.uh_data, "Memory allocation error.");
+
+    // the dense unit hydrograph is not needed anymore
+    free(rout.rout_param.unit_hydrograph);
+    rout.rout_param.unit_hydrograph = NULL;
+    free(order);
 }
@@ -39,19 +39,39 @@ vic_restore_rout_extension(nameid_struct   *init_state_file,
 
     size_t             d2start[2];
     size_t             d2count[2];
+    size_t             i_outlet;
+    size_t             i_time;
+    double            *dvar = NULL;
 
     // write state variables
 
-    // routing ring
+    // routing ring; the master process takes the whole ring, the rings of
+    // the other processes stay zero so the sum over the processes is
+    // unchanged
     if (mpi_rank == VIC_MPI_ROOT) {
         d2start[0] = 0;
         d2start[1] = 0;
         d2count[0] = rout.rout_param.full_time_length;
         d2count[1] = rout.rout_param.n_outlets;
 
+        dvar = malloc(d2count[0] * d2count[1] * sizeof(*dvar));
+        check_alloc_status(dvar, "Memory allocation error.");
+
         get_nc_field_double(
             init_state_file,
             state_metadata[N_STATE_VARS + STATE_ROUT_RING].varname,
-            d2start, d2count, rout.ring);
+            d2start, d2count, dvar);
+
+        // the ring is kept as [outlet][routing_timestep] in memory
+        for (i_time = 0; i_time < d2count[0]; i_time++) {
+            for (i_outlet = 0; i_outlet < d2count[1]; i_outlet++) {
+                rout.ring[i_outlet * d2count[0] + i_time] =
+                    dvar[i_time * d2count[1] + i_outlet];
+            }
+        }
+
+        free(dvar);
     }
+    // the state file holds the ring starting at the current timestep
+    rout.ring_head = 0;
 }
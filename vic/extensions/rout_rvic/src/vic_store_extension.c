@@ -34,16 +34,46 @@ void
 vic_store_rout_extension(nc_file_struct *nc_state_file)
 {
     extern int         mpi_rank;
+    extern MPI_Comm    MPI_COMM_VIC;
     extern rout_struct rout;
 
     int                status;
     size_t             d2start[2];
+    size_t             nring;
+    size_t             i_outlet;
+    size_t             i_time;
     nc_var_struct     *nc_var;
+    double            *dvar = NULL;
+    double            *ring = NULL;
 
     // write state variables
 
-    // routing ring
+    // routing ring: the sum of the rings of all processes
+    nring = rout.rout_param.full_time_length * rout.rout_param.n_outlets;
     if (mpi_rank == VIC_MPI_ROOT) {
+        dvar = malloc(nring * sizeof(*dvar));
+        check_alloc_status(dvar, "Memory allocation error.");
+        ring = malloc(nring * sizeof(*ring));
+        check_alloc_status(ring, "Memory allocation error.");
+    }
+    status = MPI_Reduce(rout.ring, ring, nring, MPI_DOUBLE, MPI_SUM,
+                        VIC_MPI_ROOT, MPI_COMM_VIC);
+    check_mpi_status(status, "MPI error.");
+
+    if (mpi_rank == VIC_MPI_ROOT) {
+        // the file holds the ring as [routing_timestep][outlet] starting at
+        // the current timestep
+        for (i_time = 0; i_time < rout.rout_param.full_time_length;
+             i_time++) {
+            for (i_outlet = 0; i_outlet < rout.rout_param.n_outlets;
+                 i_outlet++) {
+                dvar[i_time * rout.rout_param.n_outlets + i_outlet] =
+                    ring[i_outlet * rout.rout_param.full_time_length +
+                         (rout.ring_head + i_time) %
+                         rout.rout_param.full_time_length];
+            }
+        }
+
         d2start[0] = 0;
         d2start[1] = 0;
         nc_var = &(nc_state_file->nc_vars[N_STATE_VARS + STATE_ROUT_RING]);
@@ -51,8 +81,11 @@ vic_store_rout_extension(nc_file_struct *nc_state_file)
         status =
             nc_put_vara_double(nc_state_file->nc_id, nc_var->nc_varid, d2start,
                                nc_var->nc_counts,
-                               rout.ring);
+                               dvar);
         check_nc_status(status, "Error writing values.");
+
+        free(dvar);
+        free(ring);
     }
 }
 
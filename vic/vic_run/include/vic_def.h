@@ -75,6 +75,10 @@
 #define MIN_SUBDAILY_STEPS_PER_DAY  4
 #define MAX_SUBDAILY_STEPS_PER_DAY  1440
 
+// Scratch arena
+#define SCRATCH_ALIGN      16     /**< alignment of scratch memory (bytes) */
+#define SCRATCH_BLOCK_SIZE 65536  /**< minimum size of a scratch block (bytes) */
+
 #ifndef WET
 #define WET 0
 #define DRY 1
@@ -92,7 +96,10 @@ extern size_t NR;       /**< array index for force struct that indicates
                              the model step avarage or sum */
 extern size_t NF;       /**< array index loop counter limit for force
                              struct that indicates the SNOW_STEP values */
-char          vic_run_ref_str[MAXSTRING];
+extern char   vic_run_ref_str[MAXSTRING]; /**< reference to the grid cell
+                                               and timestep run by the
+                                               thread, for error messages */
+#pragma omp threadprivate(vic_run_ref_str)
 
 /******************************************************************************
  * @brief   Snow Density parametrizations
@@ -285,6 +292,39 @@ typedef struct {
     bool INIT_STATE;     /**< TRUE = initialize model state from file */
     bool SAVE_STATE;     /**< TRUE = save state file */
 
+    // parallel execution options
+    unsigned short int FORCE_IO_MODE; /**< IO_MODE_ROOT = forcing is read on the
+                                         master process and scattered (default);
+                                         IO_MODE_PARALLEL = each process reads
+                                         the part of the forcing grid that
+                                         covers its own cells */
+    unsigned short int HIST_IO_MODE; /**< IO_MODE_ROOT = history output is
+                                        gathered on the master process and
+                                        written there (default);
+                                        IO_MODE_PARALLEL = all processes write
+                                        to the history files collectively */
+    unsigned short int DECOMP_METHOD; /**< method used to distribute the grid
+                                         cells over the MPI processes */
+    unsigned short int CELL_SCHEDULE; /**< OpenMP schedule of the grid cell
+                                         loop in vic_image_run */
+    int CELL_CHUNK_SIZE; /**< chunk size of the OpenMP schedule; 0 = OpenMP
+                            default */
+    bool CELL_COST_ORDER; /**< TRUE = run the cells of a process in
+                             descending order of their measured cost */
+    bool PIPELINE_IO; /**< TRUE = read the forcing of the next timestep and
+                         write the history of the previous timestep while
+                         the current timestep is run */
+    size_t IO_SERVER_RANKS; /**< number of processes reserved for writing
+                               the history files; they get no grid cells */
+    size_t FORCE_BLOCK_STEPS; /**< number of model timesteps of forcing that
+                                 are read at once and kept in memory */
+    bool CONTIGUOUS_STATE; /**< TRUE = the model state of all cells of a
+                              process is kept in contiguous arrays ordered
+                              [cell][veg][band] */
+    bool ROUT_SPARSE_UH; /**< TRUE = the routing convolution only uses the
+                            nonzero part of each unit hydrograph; FALSE = the
+                            whole unit hydrograph */
+
     // output options
     size_t Noutstreams;  /**< Number of output stream */
 } option_struct;
@@ -29,6 +29,410 @@
 
 #include <vic_def.h>
 
+/******************************************************************************
+ * @brief   This structure stores the arguments of func_atmos_energy_bal()
+ *****************************************************************************/
+typedef struct {
+    double Ra;
+    double Tair;
+    double atmos_density;
+    double InSensible;
+    double *SensibleHeat;
+} atmos_energy_bal_args_struct;
+
+/******************************************************************************
+ * @brief   This structure stores the arguments of func_atmos_moist_bal()
+ *****************************************************************************/
+typedef struct {
+    double InLatentHeat;
+    double Lv;
+    double Ra;
+    double atmos_density;
+    double gamma;
+    double vp;                    /**< atmospheric vapor pressure */
+
+    double *LatentHeat;
+} atmos_moist_bal_args_struct;
+
+/******************************************************************************
+ * @brief   This structure stores the arguments of func_canopy_energy_bal()
+ *****************************************************************************/
+typedef struct {
+    // General Model Parameters
+    double delta_t;
+    double elevation;
+
+    double *Wmax;
+    double *Wcr;
+    double *Wpwp;
+    double *frost_fract;
+
+    // Atmopheric Condition and Forcings
+    double AirDens;
+    double EactAir;
+    double Press;
+    double Le;
+    double Tcanopy;
+    double Vpd;
+    double shortwave;
+    double Catm;
+    double *dryFrac;
+
+    double *Evap;
+    double *Ra;
+    double *Ra_used;
+    double Rainfall;
+    double *Wind;
+
+    // Vegetation Terms
+    unsigned int veg_class;
+
+    double *displacement;
+    double *ref_height;
+    double *roughness;
+
+    double *root;
+    double *CanopLayerBnd;
+
+    // Water Flux Terms
+    double IntRain;
+    double IntSnow;
+
+    double *Wdew;
+
+    layer_data_struct *layer;
+    veg_var_struct *veg_var;
+
+    // Energy Flux Terms
+    double LongOverIn;
+    double LongUnderOut;
+    double NetShortOver;
+
+    double *AdvectedEnergy;
+    double *LatentHeat;
+    double *LatentHeatSub;
+    double *LongOverOut;
+    double *NetLongOver;
+    double *NetRadiation;
+    double *RefreezeEnergy;
+    double *SensibleHeat;
+    double *VaporMassFlux;
+} canopy_energy_bal_args_struct;
+
+/******************************************************************************
+ * @brief   This structure stores the parameters, states and work arrays of
+ *          fda_heat_eqn()
+ *****************************************************************************/
+typedef struct {
+    // model and soil parameters, states at the start of the time step
+    double deltat;
+    int NOFLUX;
+    int EXP_TRANS;
+    double *T0;
+    double *moist;
+    double *ice;
+    double *kappa;
+    double *Cs;
+    double *max_moist;
+    double *bubble;
+    double *expt;
+    double *alpha;
+    double *beta;
+    double *gamma;
+    double *Zsum;
+    double Dp;
+    double *bulk_dens_min;
+    double *soil_dens_min;
+    double *quartz;
+    double *bulk_density;
+    double *soil_density;
+    double *organic;
+    double *depth;
+    size_t Nlayers;
+
+    // set by fda_heat_eqn() when it is initialized
+    double Ts;                    /**< surface temperature boundary (C) */
+    double Tb;                    /**< bottom temperature boundary (C) */
+    double Bexp;                  /**< exponential grid transformation */
+
+    // states of the last residual calculation
+    double ice_new[MAX_NODES];
+    double Cs_new[MAX_NODES];
+    double kappa_new[MAX_NODES];
+    double DT[MAX_NODES];
+    double DT_down[MAX_NODES];
+    double DT_up[MAX_NODES];
+    double Dkappa[MAX_NODES];
+} fda_heat_eqn_workspace_struct;
+
+/******************************************************************************
+ * @brief   This structure stores the arguments of IceEnergyBalance()
+ *****************************************************************************/
+typedef struct {
+    double Dt;                    /**< Model time step (seconds) */
+    double Ra;                    /**< Aerodynamic resistance (s/m) */
+    double *Ra_used;              /**< Aerodynamic resistance (s/m) after stability correction */
+    double Z;                     /**< Reference height (m) */
+    double Z0;                    /**< surface roughness height (m) */
+    double Wind;                  /**< Wind speed (m/s) */
+    double ShortRad;              /**< Net incident shortwave radiation (W/m2) */
+    double LongRadIn;             /**< Incoming longwave radiation (W/m2) */
+    double AirDens;               /**< Density of air (kg/m3) */
+    double Lv;                    /**< Latent heat of vaporization (J/kg3) */
+    double Tair;                  /**< Air temperature (C) */
+    double Press;                 /**< Air pressure (Pa) */
+    double Vpd;                   /**< Vapor pressure deficit (Pa) */
+    double EactAir;               /**< Actual vapor pressure of air (Pa) */
+    double Rain;                  /**< Rain fall (m/timestep) */
+    double SurfaceLiquidWater;    /**< Liquid water in the surface layer (m) */
+    double *RefreezeEnergy;       /**< Refreeze energy (W/m2) */
+    double *vapor_flux;           /**< Total mass flux of water vapor to or from snow (m/timestep) */
+    double *blowing_flux;         /**< Mass flux of water vapor to or from blowing snow (m/timestep) */
+    double *surface_flux;         /**< Mass flux of water vapor to or from snow pack (m/timestep) */
+    double *AdvectedEnergy;       /**< Energy advected by precipitation (W/m2) */
+    double Tfreeze;
+    double AvgCond;
+    double SWconducted;
+    double *qf;                   /**< Ground Heat Flux (W/m2) */
+    double *LatentHeat;           /**< Latent heat exchange at surface (W/m2) */
+    double *LatentHeatSub;        /**< Latent heat exchange at surface (W/m2) due to sublimation */
+    double *SensibleHeat;         /**< Sensible heat exchange at surface (W/m2) */
+    double *LongRadOut;
+} ice_energy_bal_args_struct;
+
+/******************************************************************************
+ * @brief   This structure stores the arguments of SnowPackEnergyBalance()
+ *****************************************************************************/
+typedef struct {
+    // General Model Parameters
+    double Dt;                    /**< Model time step (sec) */
+    double Ra;                    /**< Aerodynamic resistance (s/m) */
+    double *Ra_used;              /**< Aerodynamic resistance (s/m) after stability correction */
+
+    // Vegetation Parameters
+    double Z;                     /**< Reference height (m) */
+    double *Z0;                   /**< surface roughness height (m) */
+
+    // Atmospheric Forcing Variables
+    double AirDens;               /**< Density of air (kg/m3) */
+    double EactAir;               /**< Actual vapor pressure of air (Pa) */
+    double LongSnowIn;            /**< Incoming longwave radiation (W/m2) */
+    double Lv;                    /**< Latent heat of vaporization (J/kg3) */
+    double Press;                 /**< Air pressure (Pa) */
+    double Rain;                  /**< Rain fall (m/timestep) */
+    double NetShortUnder;         /**< Net incident shortwave radiation (W/m2) */
+    double Vpd;                   /**< Vapor pressure deficit (Pa) */
+    double Wind;                  /**< Wind speed (m/s) */
+
+    // Snowpack Variables
+    double OldTSurf;              /**< Surface temperature during previous time step */
+    double SnowCoverFract;        /**< Fraction of area covered by snow */
+    double SnowDepth;             /**< Depth of snowpack (m) */
+    double SnowDensity;           /**< Density of snowpack (kg/m^3) */
+    double SurfaceLiquidWater;    /**< Liquid water in the surface layer (m) */
+    double SweSurfaceLayer;       /**< Snow water equivalent in surface layer (m) */
+
+    // Energy Balance Components
+    double Tair;                  /**< Canopy air / Air temperature (C) */
+    double TGrnd;                 /**< Ground surface temperature (C) */
+
+    double *AdvectedEnergy;       /**< Energy advected by precipitation (W/m2) */
+    double *AdvectedSensibleHeat; /**< Sensible heat advected from snow-free area into snow covered area (W/m^2) */
+    double *DeltaColdContent;     /**< Change in cold content of surface layer (W/m2) */
+    double *GroundFlux;           /**< Ground Heat Flux (W/m2) */
+    double *LatentHeat;           /**< Latent heat exchange at surface (W/m2) */
+    double *LatentHeatSub;        /**< Latent heat of sublimation exchange at surface (W/m2) */
+    double *NetLongUnder;         /**< Net longwave radiation at snowpack surface (W/m^2) */
+    double *RefreezeEnergy;       /**< Refreeze energy (W/m2) */
+    double *SensibleHeat;         /**< Sensible heat exchange at surface (W/m2) */
+    double *vapor_flux;           /**< Mass flux of water vapor to or from the intercepted snow (m/timestep) */
+    double *blowing_flux;         /**< Mass flux of water vapor from blowing snow. (m/timestep) */
+    double *surface_flux;         /**< Mass flux of water vapor from pack snow. (m/timestep) */
+} snow_pack_energy_bal_args_struct;
+
+/******************************************************************************
+ * @brief   This structure stores a block of the scratch arena
+ *****************************************************************************/
+typedef struct scratch_block_struct {
+    struct scratch_block_struct *prev; /**< previous block of the arena */
+    char *data;                   /**< start of the memory of this block */
+    size_t size;                  /**< size of the block (bytes) */
+    size_t used;                  /**< bytes in use */
+    size_t start;                 /**< top of the arena when the block was
+                                     started (bytes) */
+    size_t high_water;            /**< largest top of the arena seen while
+                                     this block was in use (bytes) */
+} scratch_block_struct;
+
+/******************************************************************************
+ * @brief   This structure stores a scratch arena for short-lived work arrays
+ *****************************************************************************/
+typedef struct {
+    scratch_block_struct *block;  /**< current block of the arena */
+} scratch_arena_struct;
+
+/******************************************************************************
+ * @brief   This structure stores the arguments of soil_thermal_eqn()
+ *****************************************************************************/
+typedef struct {
+    double TL;
+    double TU;
+    double T0;
+    double moist;
+    double max_moist;
+    double bubble;
+    double expt;
+    double ice0;
+    double A;
+    double B;
+    double C;
+    double D;
+    double E;
+    int EXP_TRANS;
+    int node;
+} soil_thermal_eqn_args_struct;
+
+/******************************************************************************
+ * @brief   This structure stores the difference equation coefficients of
+ *          solve_T_profile(), which are reused for as long as FIRST_SOLN[0]
+ *          is false
+ *****************************************************************************/
+typedef struct {
+    double A[MAX_NODES];
+    double B[MAX_NODES];
+    double C[MAX_NODES];
+    double D[MAX_NODES];
+    double E[MAX_NODES];
+} solve_T_profile_workspace_struct;
+
+/******************************************************************************
+ * @brief   This structure stores the arguments of func_surf_energy_bal()
+ *****************************************************************************/
+typedef struct {
+    // general model terms
+    int VEG;
+    int veg_class;
+    double delta_t;
+
+    // soil layer terms
+    double Cs1;
+    double Cs2;
+    double D1;
+    double D2;
+    double T1_old;
+    double T2;
+    double Ts_old;
+    double *Told_node;
+    double bubble;
+    double dp;
+    double expt;
+    double ice0;
+    double kappa1;
+    double kappa2;
+    double max_moist;
+    double moist;
+
+    double *root;
+    double *CanopLayerBnd;
+
+    // meteorological forcing terms
+    int UnderStory;
+    int overstory;
+
+    double NetShortBare;          /**< net SW that reaches bare ground */
+    double NetShortGrnd;          /**< net SW that penetrates snowpack */
+    double NetShortSnow;          /**< net SW that reaches snow surface */
+    double Tair;                  /**< temperature of canopy air or atmosphere */
+    double atmos_density;
+    double atmos_pressure;
+    double emissivity;
+    double LongBareIn;            /**< incoming LW to snow-free surface */
+    double LongSnowIn;            /**< incoming LW to snow surface - if INCLUDE_SNOW */
+    double surf_atten;
+    double vp;
+    double vpd;
+    double shortwave;
+    double Catm;
+    double *dryFrac;
+
+    double *Wdew;
+    double *displacement;
+    double *ra;
+    double *Ra_veg;
+    double *Ra_used;
+    double rainfall;
+    double *ref_height;
+    double *roughness;
+    double *wind;
+
+    // latent heat terms
+    double Le;
+
+    // snowpack terms
+    double Advection;
+    double OldTSurf;
+    double Tsnow_surf;
+    double kappa_snow;            /**< snow conductance / depth */
+    double melt_energy;           /**< energy consumed in reducing the snowpack coverage */
+    double snow_coverage;         /**< snowpack coverage fraction */
+    double snow_density;
+    double snow_swq;
+    double snow_water;
+
+    double *deltaCC;
+    double *refreeze_energy;
+    double *vapor_flux;
+    double *blowing_flux;
+    double *surface_flux;
+
+    // soil node terms
+    int Nnodes;
+
+    double *Cs_node;
+    double *T_node;
+    double *Tnew_node;
+    char *Tnew_fbflag;
+    unsigned *Tnew_fbcount;
+    double *alpha;
+    double *beta;
+    double *bubble_node;
+    double *Zsum_node;
+    double *expt_node;
+    double *gamma;
+    double *ice_node;
+    double *kappa_node;
+    double *max_moist_node;
+    double *moist_node;
+
+    // model structures
+    soil_con_struct *soil_con;
+    layer_data_struct *layer;
+    veg_var_struct *veg_var;
+
+    // control flags
+    int INCLUDE_SNOW;
+    int NOFLUX;
+    int EXP_TRANS;
+    int SNOWING;
+
+    int *FIRST_SOLN;
+    solve_T_profile_workspace_struct *T_profile_ws;
+    scratch_arena_struct *scratch;
+
+    // returned energy balance terms
+    double *NetLongBare;          /**< net LW from snow-free ground */
+    double *NetLongSnow;          /**< net longwave from snow surface - if INCLUDE_SNOW */
+    double *T1;
+    double *deltaH;
+    double *fusion;
+    double *grnd_flux;
+    double *latent_heat;
+    double *latent_heat_sub;
+    double *sensible_heat;
+    double *snow_flux;
+    double *store_error;
+} surf_energy_bal_args_struct;
+
 void advect_carbon_storage(double, double, lake_var_struct *,
                            cell_data_struct *);
 void advect_snow_storage(double, double, double, snow_data_struct *);
@@ -40,6 +444,7 @@ double advected_sensible_heat(double, double, double, double, double);
 void alblake(double, double, double *, double *, double *, double *, double,
              double, double, unsigned int *, double, bool *, unsigned short int,
              double);
+scratch_block_struct *alloc_scratch_block(size_t);
 double arno_evap(layer_data_struct *, double, double, double, double, double,
                  double, double, double, double, double, double *);
 bool assert_close_double(double x, double y, double rtol, double abs_tol);
@@ -65,7 +470,7 @@ double calc_rainonly(double, double, double, double);
 double calc_rc(double, double, double, double, double, double, double, char);
 void calc_rc_ps(char, double, double, double, double *, double, double,
                 double *, double, double, double *, double, double, double,
-                double *, double *);
+                double *, double *, scratch_arena_struct *);
 double calc_snow_coverage(bool *, double, double, double, double, double,
                           double, double, double *, double, double *, double *,
                           double *);
@@ -84,7 +489,8 @@ double calc_surf_energy_bal(double, double, double, double, double, double,
                             double *, double *, force_data_struct *,
                             dmy_struct *, energy_bal_struct *,
                             layer_data_struct *, snow_data_struct *,
-                            soil_con_struct *, veg_var_struct *);
+                            soil_con_struct *, veg_var_struct *,
+                            scratch_arena_struct *);
 double calc_veg_displacement(double);
 double calc_veg_height(double);
 double calc_veg_roughness(double);
@@ -93,8 +499,6 @@ int CalcAerodynamic(bool, double, double, double, double, double, double *,
 double CalcBlowingSnow(double, double, unsigned int, double, double, double,
                        double, double, double, double, double, double, double,
                        double, int, int, double, double, double, double *);
-double CalcIcePackEnergyBalance(double Tsurf, ...);
-double CalcSnowPackEnergyBalance(double Tsurf, ...);
 double CalcSubFlux(double EactAir, double es, double Zrh, double AirDens,
                    double utshear, double ushear, double fe, double Tsnow,
                    double Tair, double U10, double Zo_salt, double F,
@@ -102,11 +506,13 @@ double CalcSubFlux(double EactAir, double es, double Zrh, double AirDens,
 void canopy_assimilation(char, double, double, double, double *, double, double,
                          double *, double, double, double *, double, char *,
                          double *, double *, double *, double *, double *,
-                         double *, double *, double *, double *, double *);
+                         double *, double *, double *, double *, double *,
+                         scratch_arena_struct *);
 double canopy_evap(layer_data_struct *, veg_var_struct *, bool,
                    unsigned short int, double *, double, double, double, double,
                    double, double, double, double, double *, double *, double *,
-                   double *, double *, double *, double, double, double *);
+                   double *, double *, double *, double, double, double *,
+                   scratch_arena_struct *);
 void colavg(double *, double *, double *, double, double *, int, double,
             double);
 double compute_coszen(double, double, double, unsigned short int, unsigned int);
@@ -118,7 +524,8 @@ void compute_runoff_and_asat(soil_con_struct *, double *, double, double *,
                              double *);
 double calc_Q12(double, double, double, double, double);
 void compute_soil_resp(int, double *, double, double, double *, double *,
-                       double, double, double, double *, double *, double *);
+                       double, double, double, double *, double *, double *,
+                       scratch_arena_struct *);
 void compute_soil_layer_thermal_properties(layer_data_struct *, double *,
                                            double *, double *, double *,
                                            double *, double *, double *,
@@ -164,16 +571,16 @@ int estimate_layer_ice_content_quick_flux(layer_data_struct *, double *,
 double estimate_T1(double, double, double, double, double, double, double,
                    double, double, double);
 void faparl(double *, double, double, double, double, double *, double *);
-void fda_heat_eqn(double *, double *, int, int, ...);
+void fda_heat_eqn(double *, double *, int, int, void *, ...);
 void fdjac3(double *, double *, double *, double *, double *, void (*vecfunc)(
-                double *, double *, int, int, ...), int);
+                double *, double *, int, int, void *, ...), int, void *);
 void find_0_degree_fronts(energy_bal_struct *, double *, double *, int);
 void free_2d_double(size_t *shape, double **array);
 void free_3d_double(size_t *shape, double ***array);
-double func_atmos_energy_bal(double, va_list);
-double func_atmos_moist_bal(double, va_list);
-double func_canopy_energy_bal(double, va_list);
-double func_surf_energy_bal(double, va_list);
+double func_atmos_energy_bal(double, void *);
+double func_atmos_moist_bal(double, void *);
+double func_canopy_energy_bal(double, void *);
+double func_surf_energy_bal(double, void *);
 double (*funcd)(double z, double es, double Wind, double AirDens, double ZO,
                 double EactAir, double F, double hsalt, double phi_r,
                 double ushear,
@@ -190,12 +597,13 @@ int ice_melt(double, double, double *, double, snow_data_struct *,
              double, double, double, double, double, double, double, double,
              double, double *, double *, double *, double *, double *, double *,
              double *, double *, double *);
-double IceEnergyBalance(double, va_list);
+double IceEnergyBalance(double, void *);
 void iceform(double *, double *, double, double, double *, int, double, double,
              double, double *, double *, double *, double *, double);
 void icerad(double, double, double, double *, double *, double *);
 void initialize_lake(lake_var_struct *, lake_con_struct, soil_con_struct *,
                      cell_data_struct *, bool);
+void initialize_scratch_arena(scratch_arena_struct *);
 int lakeice(double, double, double, double, double, double *, double, double *,
             double *, double, double);
 void latent_heat_from_snow(double, double, double, double, double, double,
@@ -209,16 +617,19 @@ void malloc_2d_double(size_t *shape, double ***array);
 void malloc_3d_double(size_t *shape, double ****array);
 void MassRelease(double *, double *, double *, double *);
 double maximum_unfrozen_water(double, double, double, double);
+double maximum_unfrozen_water_deriv(double, double, double, double);
 double new_snow_density(double);
-int newt_raph(void (*vecfunc)(double *, double *, int, int,
-                              ...), double *, int);
+int newt_raph(void (*vecfunc)(double *, double *, int, int, void *,
+                              ...), double *, int, bool, void *);
 double penman(double, double, double, double, double, double, double);
 void photosynth(char, double, double, double, double, double, double, double,
                 double, double, char *, double *, double *, double *, double *,
                 double *);
-void polint(double xa[], double ya[], int n, double x, double *y, double *dy);
+void polint(double xa[], double ya[], int n, double x, double *y, double *dy,
+            double c[], double d[]);
 void prepare_full_energy(cell_data_struct *, energy_bal_struct *,
-                         soil_con_struct *, double *, double *);
+                         soil_con_struct *, double *, double *,
+                         scratch_arena_struct *);
 double qromb(
     double (*sub_with_height)(), double es, double Wind, double AirDens, double ZO, double EactAir, double F, double hsalt, double phi_r, double ushear, double Zrh, double a,
     double b);
@@ -228,10 +639,15 @@ void rescale_snow_storage(double, double, snow_data_struct *);
 void rescale_soil_veg_fluxes(double, double, cell_data_struct *,
                              veg_var_struct *);
 void rhoinit(double *, double);
-double root_brent(double, double, double (*Function)(double, va_list), ...);
+double root_brent(double, double, double (*Function)(double, void *), void *);
 double rtnewt(double x1, double x2, double xacc, double Ur, double Zr);
 int runoff(cell_data_struct *, energy_bal_struct *, soil_con_struct *, double,
            double *, int);
+void *scratch_alloc(scratch_arena_struct *, size_t);
+void *scratch_calloc(scratch_arena_struct *, size_t, size_t);
+void scratch_free(scratch_arena_struct *);
+size_t scratch_mark(scratch_arena_struct *);
+void scratch_release(scratch_arena_struct *, size_t);
 void set_node_parameters(double *, double *, double *, double *, double *,
                          double *, double *, double *, double *, double *,
                          double *, int, int);
@@ -254,15 +670,18 @@ int snow_melt(double, double, double, double, double *, double, double *,
               double *, double *, double *, double *, double *, double *,
               double *, double *, double *, double *, int, int, int,
               snow_data_struct *);
-double SnowPackEnergyBalance(double, va_list);
+double SnowPackEnergyBalance(double, void *);
 void soil_carbon_balance(soil_con_struct *, energy_bal_struct *,
-                         cell_data_struct *, veg_var_struct *);
+                         cell_data_struct *, veg_var_struct *,
+                         scratch_arena_struct *);
 double soil_conductivity(double, double, double, double, double, double, double,
                          double);
-double soil_thermal_eqn(double, va_list);
-double solve_atmos_energy_bal(double Tcanopy, ...);
-double solve_atmos_moist_bal(double, ...);
-double solve_canopy_energy_bal(double Tfoliage, ...);
+double soil_conductivity_deriv(double, double, double, double, double, double,
+                               double, double);
+double soil_thermal_eqn(double, void *);
+int solve_cell(force_data_struct *, all_vars_struct *, dmy_struct *,
+               global_param_struct *, lake_con_struct *, soil_con_struct *,
+               veg_con_struct *, veg_lib_struct *, scratch_arena_struct *);
 int solve_lake(double, double, double, double, double, double, double, double,
                double, double, lake_var_struct *, soil_con_struct, double,
                double, dmy_struct, double);
@@ -276,11 +695,11 @@ double solve_snow(char, double, double, double, double, double, double, double,
                   size_t, int, int *, double *, double *, dmy_struct *,
                   force_data_struct *, energy_bal_struct *, layer_data_struct *,
                   snow_data_struct *, soil_con_struct *, veg_var_struct *);
-double solve_surf_energy_bal(double Tsurf, ...);
 int solve_T_profile(double *, double *, char *, unsigned int *, double *,
                     double *, double *, double *, double, double *, double *,
                     double *, double *, double *, double *, double *, double,
-                    int, int *, int, int, int);
+                    int, int *, int, int, int,
+                    solve_T_profile_workspace_struct *);
 int solve_T_profile_implicit(double *, double *, char *, unsigned int *,
                              double *, double *, double *, double *, double,
                              double *, double *, double *, double *, double *,
@@ -299,7 +718,8 @@ int surface_fluxes(bool, double, double, double, double, double *, double *,
                    unsigned short int, force_data_struct *, dmy_struct *,
                    energy_bal_struct *, global_param_struct *,
                    cell_data_struct *, snow_data_struct *, soil_con_struct *,
-                   veg_var_struct *, double, double, double, double *);
+                   veg_var_struct *, double, double, double, double *,
+                   scratch_arena_struct *);
 double svp(double);
 double svp_slope(double);
 void temp_area(double, double, double, double *, double *, double *, double *,
@@ -309,21 +729,22 @@ void tracer_mixer(double *, int *, double *, int, double, double, double *);
 void transpiration(layer_data_struct *, veg_var_struct *, unsigned short int,
                    double, double, double, double, double, double, double,
                    double, double *, double *, double *, double *, double *,
-                   double *, double, double, double *);
+                   double *, double, double, double *, scratch_arena_struct *);
 double transport_with_height(double z, double es, double Wind, double AirDens,
                              double ZO, double EactAir, double F, double hsalt,
                              double phi_r, double ushear, double Zrh);
 double trapzd(
     double (*funcd)(), double es, double Wind, double AirDens, double ZO, double EactAir, double F, double hsalt, double phi_r, double ushear, double Zrh, double a, double b,
-    int n);
+    int n, double s);
 void tridia(int, double *, double *, double *, double *, double *);
 void tridiag(double *, double *, double *, double *, unsigned int);
 int vic_run(force_data_struct *, all_vars_struct *, dmy_struct *,
             global_param_struct *, lake_con_struct *, soil_con_struct *,
-            veg_con_struct *, veg_lib_struct *);
+            veg_con_struct *, veg_lib_struct *, scratch_arena_struct *);
 double volumetric_heat_capacity(double, double, double, double);
 int water_balance(lake_var_struct *, lake_con_struct, double, all_vars_struct *,
-                  int, int, double, soil_con_struct, veg_con_struct);
+                  int, int, double, soil_con_struct, veg_con_struct,
+                  scratch_arena_struct *);
 int water_energy_balance(int, double *, double *, double, double, double,
                          double, double, double, double, double, double, double,
                          double, double, double, double *, double *, double *,
@@ -289,15 +289,18 @@ qromb(double (*funcd)(),
     double                   ss, dss;
     double                   s[param.BLOWING_MAX_ITER + 1];
     double                   h[param.BLOWING_MAX_ITER + 2];
+    double                   c[param.BLOWING_K + 1];
+    double                   d[param.BLOWING_K + 1];
     int                      j;
 
+    s[0] = 0.0;
     h[1] = 1.0;
     for (j = 1; j <= param.BLOWING_MAX_ITER; j++) {
         s[j] = trapzd(funcd, es, Wind, AirDens, ZO, EactAir, F, hsalt, phi_r,
-                      ushear, Zrh, a, b, j);
+                      ushear, Zrh, a, b, j, s[j - 1]);
         if (j >= param.BLOWING_K) {
             polint(&h[j - param.BLOWING_K], &s[j - param.BLOWING_K],
-                   param.BLOWING_K, 0.0, &ss, &dss);
+                   param.BLOWING_K, 0.0, &ss, &dss, c, d);
             if (fabs(dss) <= DBL_EPSILON * fabs(ss)) {
                 return ss;
             }
@@ -309,6 +312,7 @@ qromb(double (*funcd)(),
 
 /******************************************************************************
  * @brief    Interpolate a set of N points by fitting a polynomial of degree N-1
+ * @details  c and d are work arrays of n + 1 elements owned by the caller.
  *****************************************************************************/
 void
 polint(double  xa[],
@@ -316,20 +320,15 @@ polint(double  xa[],
        int     n,
        double  x,
        double *y,
-       double *dy)
+       double *dy,
+       double  c[],
+       double  d[])
 {
-    int     i, m, ns;
-    double  den, dif, dift, ho, hp, w;
-    double *c = NULL;
-    double *d = NULL;
+    int    i, m, ns;
+    double den, dif, dift, ho, hp, w;
 
     ns = 1;
     dif = fabs(x - xa[1]);
-    c = (double *)malloc((size_t) ((n + 1) * sizeof(double)));
-    check_alloc_status(c, "Memory allocation error.");
-    d = (double *)malloc((size_t) ((n + 1) * sizeof(double)));
-    check_alloc_status(d, "Memory allocation error.");
-
 
     for (i = 1; i <= n; i++) {
         if ((dift = fabs(x - xa[i])) < dif) {
@@ -354,12 +353,11 @@ polint(double  xa[],
         }
         *y += (*dy = (2 * ns < (n - m) ? c[ns + 1] : d[ns--]));
     }
-    free(d);
-    free(c);
 }
 
 /******************************************************************************
  * @brief    Compute the nth stage of refinement of an extended trapezoidal rule.
+ * @details  s is the result of stage n - 1 and is not used when n == 1.
  *****************************************************************************/
 double
 trapzd(double (*funcd)(),
@@ -375,16 +373,12 @@ trapzd(double (*funcd)(),
        double   Zrh,
        double   a,
        double   b,
-       int      n)
+       int      n,
+       double   s)
 {
     double x, tnm, sum, del;
     int    it, j;
 
-    // TODO: remove use of static variables (see GH #735), for now:
-    // make static variables thread safe
-    static double s;
-    #pragma omp threadprivate(s)
-
     if (n == 1) {
         return (s = 0.5 *
                     (b -
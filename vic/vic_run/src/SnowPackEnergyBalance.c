@@ -35,12 +35,14 @@
  *****************************************************************************/
 double
 SnowPackEnergyBalance(double  TSurf,
-                      va_list ap)
+                      void   *args)
 {
     extern option_struct     options;
     extern parameters_struct param;
 
-    /* Define Variable Argument List */
+    const snow_pack_energy_bal_args_struct *p = args;
+
+    /* Define Arguments */
 
     /* General Model Parameters */
     double  Dt;                   /* Model time step (sec) */
@@ -110,63 +112,52 @@ SnowPackEnergyBalance(double  TSurf,
     double BlowingMassFlux;       /* Mass flux of water vapor from blowing snow. (kg/m2s) */
     double SurfaceMassFlux;       /* Mass flux of water vapor from pack snow. (kg/m2s) */
 
-    /* Assign the elements of the array to the appropriate variables.  The list
-       is traversed as if the elements are doubles, because:
-
-       In the variable-length part of variable-length argument lists, the old
-       ``default argument promotions'' apply: arguments of type double are
-       always promoted (widened) to type double, and types char and short int
-       are promoted to int. Therefore, it is never correct to invoke
-       va_arg(argp, double); instead you should always use va_arg(argp,
-       double).
-
-       (quoted from the comp.lang.c FAQ list)
-     */
+    /* Unpack the arguments */
 
     /* General Model Parameters */
-    Dt = (double) va_arg(ap, double);
-    Ra = (double) va_arg(ap, double);
-    Ra_used = (double *) va_arg(ap, double *);
+    Dt = p->Dt;
+    Ra = p->Ra;
+    Ra_used = p->Ra_used;
 
     /* Vegetation Parameters */
-    Z = (double) va_arg(ap, double);
-    Z0 = (double *) va_arg(ap, double *);
+    Z = p->Z;
+    Z0 = p->Z0;
 
     /* Atmospheric Forcing Variables */
-    AirDens = (double) va_arg(ap, double);
-    EactAir = (double) va_arg(ap, double);
-    LongSnowIn = (double) va_arg(ap, double);
-    Lv = (double) va_arg(ap, double);
-    Press = (double) va_arg(ap, double);
-    Rain = (double) va_arg(ap, double);
-    NetShortUnder = (double) va_arg(ap, double);
-    Vpd = (double) va_arg(ap, double);
-    Wind = (double) va_arg(ap, double);
+    AirDens = p->AirDens;
+    EactAir = p->EactAir;
+    LongSnowIn = p->LongSnowIn;
+    Lv = p->Lv;
+    Press = p->Press;
+    Rain = p->Rain;
+    NetShortUnder = p->NetShortUnder;
+    Vpd = p->Vpd;
+    Wind = p->Wind;
 
     /* Snowpack Variables */
-    OldTSurf = (double) va_arg(ap, double);
-    SnowCoverFract = (double) va_arg(ap, double);
-    SnowDepth = (double) va_arg(ap, double);
-    SnowDensity = (double) va_arg(ap, double);
-    SurfaceLiquidWater = (double) va_arg(ap, double);
-    SweSurfaceLayer = (double) va_arg(ap, double);
+    OldTSurf = p->OldTSurf;
+    SnowCoverFract = p->SnowCoverFract;
+    SnowDepth = p->SnowDepth;
+    SnowDensity = p->SnowDensity;
+    SurfaceLiquidWater = p->SurfaceLiquidWater;
+    SweSurfaceLayer = p->SweSurfaceLayer;
 
     /* Energy Balance Components */
-    Tair = (double) va_arg(ap, double);
-    TGrnd = (double) va_arg(ap, double);
-
-    AdvectedEnergy = (double *) va_arg(ap, double *);
-    AdvectedSensibleHeat = (double *)va_arg(ap, double *);
-    DeltaColdContent = (double *) va_arg(ap, double *);
-    GroundFlux = (double *) va_arg(ap, double *);
-    LatentHeat = (double *) va_arg(ap, double *);
-    LatentHeatSub = (double *) va_arg(ap, double *);
-    NetLongUnder = (double *) va_arg(ap, double *);
-    RefreezeEnergy = (double *) va_arg(ap, double *);
-    SensibleHeat = (double *) va_arg(ap, double *);
-    vapor_flux = (double *) va_arg(ap, double *);
-    blowing_flux = (double *) va_arg(ap, double *);
-    surface_flux = (double *) va_arg(ap, double *);
+    Tair = p->Tair;
+    TGrnd = p->TGrnd;
+
+    AdvectedEnergy = p->AdvectedEnergy;
+    AdvectedSensibleHeat = p->AdvectedSensibleHeat;
+    DeltaColdContent = p->DeltaColdContent;
+    GroundFlux = p->GroundFlux;
+    LatentHeat = p->LatentHeat;
+    LatentHeatSub = p->LatentHeatSub;
+    NetLongUnder = p->NetLongUnder;
+    RefreezeEnergy = p->RefreezeEnergy;
+    SensibleHeat = p->SensibleHeat;
+    vapor_flux = p->vapor_flux;
+    blowing_flux = p->blowing_flux;
+    surface_flux = p->surface_flux;
 
     /* Calculate active temp for energy balance as average of old and new  */
 
@@ -68,6 +68,8 @@ calc_atmos_energy_bal(double    InOverSensible,
     double                   T_upper;
     double                   Tcanopy;
 
+    atmos_energy_bal_args_struct args;
+
     F = 1;
 
     // compute incoming sensible heat
@@ -86,6 +88,13 @@ calc_atmos_energy_bal(double    InOverSensible,
 
     (*LatentHeatSub) = (LatentHeatSubOver + LatentHeatSubUnder);
 
+    // arguments of the canopy air energy balance
+    args.Ra = Ra;
+    args.Tair = Tair;
+    args.atmos_density = atmos_density;
+    args.InSensible = InSensible;
+    args.SensibleHeat = SensibleHeat;
+
     /******************************
        Find Canopy Air Temperature
     ******************************/
@@ -99,9 +108,7 @@ calc_atmos_energy_bal(double    InOverSensible,
         T_upper = (Tair) + param.CANOPY_DT;
 
         // iterate for canopy air temperature
-        Tcanopy = root_brent(T_lower, T_upper,
-                             func_atmos_energy_bal, Ra, Tair, atmos_density,
-                             InSensible, SensibleHeat);
+        Tcanopy = root_brent(T_lower, T_upper, func_atmos_energy_bal, &args);
 
         if (Tcanopy <= -998) {
             if (options.TFALLBACK) {
@@ -126,29 +133,10 @@ calc_atmos_energy_bal(double    InOverSensible,
     }
 
     // compute variables based on final temperature
-    (*Error) = solve_atmos_energy_bal(Tcanopy, Ra, Tair, atmos_density,
-                                      InSensible, SensibleHeat);
+    (*Error) = func_atmos_energy_bal(Tcanopy, &args);
     return(Tcanopy);
 }
 
-/******************************************************************************
- * @brief    Dummy function to allow calling func_atmos_energy_bal() directly.
- *****************************************************************************/
-double
-solve_atmos_energy_bal(double Tcanopy,
-                       ...)
-{
-    va_list ap;
-
-    double  error;
-
-    va_start(ap, Tcanopy);
-    error = func_atmos_energy_bal(Tcanopy, ap);
-    va_end(ap);
-
-    return error;
-}
-
 /******************************************************************************
  * @brief    Dummy function to allow calling error_calc_atmos_energy_bal()
  *           directly.
@@ -213,24 +201,6 @@ error_print_atmos_energy_bal(double  Tcanopy,
     return(ERROR);
 }
 
-/******************************************************************************
- * @brief   Dummy function to allow calling func_atmos_moist_bal() directly.
- *****************************************************************************/
-double
-solve_atmos_moist_bal(double VPcanopy,
-                      ...)
-{
-    va_list ap;
-
-    double  error;
-
-    va_start(ap, VPcanopy);
-    error = func_atmos_moist_bal(VPcanopy, ap);
-    va_end(ap);
-
-    return error;
-}
-
 /******************************************************************************
  * @brief    Dummy function to allow calling error_print_atmos_moist_bal()
  *           directly.
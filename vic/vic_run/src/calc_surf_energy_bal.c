@@ -34,59 +34,60 @@
  *           Brent method.
  *****************************************************************************/
 double
-calc_surf_energy_bal(double             Le,
-                     double             LongUnderIn,
-                     double             NetLongSnow,        // net LW at snow surface
-                     double             NetShortGrnd,        // net SW transmitted thru snow
-                     double             NetShortSnow,        // net SW at snow surface
-                     double             OldTSurf,
-                     double             ShortUnderIn,
-                     double             SnowAlbedo,
-                     double             SnowLatent,
-                     double             SnowLatentSub,
-                     double             SnowSensible,
-                     double             Tair,        // T of canopy or air
-                     double             VPDcanopy,
-                     double             VPcanopy,
-                     double             delta_coverage,        // change in coverage fraction
-                     double             dp,
-                     double             ice0,
-                     double             melt_energy,
-                     double             moist,
-                     double             snow_coverage,
-                     double             snow_depth,
-                     double             BareAlbedo,
-                     double             surf_atten,
-                     double            *aero_resist,
-                     double            *aero_resist_veg,
-                     double            *aero_resist_used,
-                     double            *displacement,
-                     double            *melt,
-                     double            *ppt,
-                     double             rainfall,
-                     double            *ref_height,
-                     double            *roughness,
-                     double             snowfall,
-                     double            *wind,
-                     double            *root,
-                     int                INCLUDE_SNOW,
-                     int                UnderStory,
-                     size_t             Nnodes,
-                     size_t             Nveg,
-                     double             dt,
-                     size_t             hidx,
-                     unsigned short     iveg,
-                     int                overstory,
-                     unsigned short     veg_class,
-                     double            *CanopLayerBnd,
-                     double            *dryFrac,
-                     force_data_struct *force,
-                     dmy_struct        *dmy,
-                     energy_bal_struct *energy,
-                     layer_data_struct *layer,
-                     snow_data_struct  *snow,
-                     soil_con_struct   *soil_con,
-                     veg_var_struct    *veg_var)
+calc_surf_energy_bal(double                Le,
+                     double                LongUnderIn,
+                     double                NetLongSnow,        // net LW at snow surface
+                     double                NetShortGrnd,        // net SW transmitted thru snow
+                     double                NetShortSnow,        // net SW at snow surface
+                     double                OldTSurf,
+                     double                ShortUnderIn,
+                     double                SnowAlbedo,
+                     double                SnowLatent,
+                     double                SnowLatentSub,
+                     double                SnowSensible,
+                     double                Tair,        // T of canopy or air
+                     double                VPDcanopy,
+                     double                VPcanopy,
+                     double                delta_coverage,        // change in coverage fraction
+                     double                dp,
+                     double                ice0,
+                     double                melt_energy,
+                     double                moist,
+                     double                snow_coverage,
+                     double                snow_depth,
+                     double                BareAlbedo,
+                     double                surf_atten,
+                     double               *aero_resist,
+                     double               *aero_resist_veg,
+                     double               *aero_resist_used,
+                     double               *displacement,
+                     double               *melt,
+                     double               *ppt,
+                     double                rainfall,
+                     double               *ref_height,
+                     double               *roughness,
+                     double                snowfall,
+                     double               *wind,
+                     double               *root,
+                     int                   INCLUDE_SNOW,
+                     int                   UnderStory,
+                     size_t                Nnodes,
+                     size_t                Nveg,
+                     double                dt,
+                     size_t                hidx,
+                     unsigned short        iveg,
+                     int                   overstory,
+                     unsigned short        veg_class,
+                     double               *CanopLayerBnd,
+                     double               *dryFrac,
+                     force_data_struct    *force,
+                     dmy_struct           *dmy,
+                     energy_bal_struct    *energy,
+                     layer_data_struct    *layer,
+                     snow_data_struct     *snow,
+                     soil_con_struct      *soil_con,
+                     veg_var_struct       *veg_var,
+                     scratch_arena_struct *scratch)
 {
     extern option_struct     options;
     extern parameters_struct param;
@@ -151,6 +152,9 @@ calc_surf_energy_bal(double             Le,
     double                   TmpNetShortSnow;
     double                   old_swq, old_depth;
 
+    surf_energy_bal_args_struct      args;
+    solve_T_profile_workspace_struct T_profile_ws;
+
     /**************************************************
        Set All Variables For Use
     **************************************************/
@@ -260,6 +264,107 @@ calc_surf_energy_bal(double             Le,
     Zsum_node = soil_con->Zsum_node;
     ice_node = energy->ice;
 
+    // arguments of the surface energy balance
+    args.VEG = VEG;
+    args.veg_class = veg_class;
+    args.delta_t = delta_t;
+    args.Cs1 = Cs1;
+    args.Cs2 = Cs2;
+    args.D1 = D1;
+    args.D2 = D2;
+    args.T1_old = T1_old;
+    args.T2 = T2;
+    args.Ts_old = Ts_old;
+    args.Told_node = energy->T;
+    args.bubble = bubble;
+    args.dp = dp;
+    args.expt = expt;
+    args.ice0 = ice0;
+    args.kappa1 = kappa1;
+    args.kappa2 = kappa2;
+    args.max_moist = max_moist;
+    args.moist = moist;
+    args.root = root;
+    args.CanopLayerBnd = CanopLayerBnd;
+    args.UnderStory = UnderStory;
+    args.overstory = overstory;
+    args.NetShortBare = NetShortBare;
+    args.NetShortGrnd = NetShortGrnd;
+    args.NetShortSnow = TmpNetShortSnow;
+    args.Tair = Tair;
+    args.atmos_density = atmos_density;
+    args.atmos_pressure = atmos_pressure;
+    args.emissivity = emissivity;
+    args.LongBareIn = LongBareIn;
+    args.LongSnowIn = LongSnowIn;
+    args.surf_atten = surf_atten;
+    args.vp = VPcanopy;
+    args.vpd = VPDcanopy;
+    args.shortwave = atmos_shortwave;
+    args.Catm = atmos_Catm;
+    args.dryFrac = dryFrac;
+    args.Wdew = &Wdew;
+    args.displacement = displacement;
+    args.ra = aero_resist;
+    args.Ra_veg = aero_resist_veg;
+    args.Ra_used = aero_resist_used;
+    args.rainfall = rainfall;
+    args.ref_height = ref_height;
+    args.roughness = roughness;
+    args.wind = wind;
+    args.Le = Le;
+    args.Advection = energy->advection;
+    args.OldTSurf = OldTSurf;
+    args.Tsnow_surf = Tsnow_surf;
+    args.kappa_snow = kappa_snow;
+    args.melt_energy = melt_energy;
+    args.snow_coverage = snow_coverage;
+    args.snow_density = snow->density;
+    args.snow_swq = snow->swq;
+    args.snow_water = snow->surf_water;
+    args.deltaCC = &energy->deltaCC;
+    args.refreeze_energy = &energy->refreeze_energy;
+    args.vapor_flux = &snow->vapor_flux;
+    args.blowing_flux = &snow->blowing_flux;
+    args.surface_flux = &snow->surface_flux;
+    args.Nnodes = (int) Nnodes;
+    args.Cs_node = Cs_node;
+    args.T_node = T_node;
+    args.Tnew_node = Tnew_node;
+    args.Tnew_fbflag = Tnew_fbflag;
+    args.Tnew_fbcount = Tnew_fbcount;
+    args.alpha = alpha;
+    args.beta = beta;
+    args.bubble_node = bubble_node;
+    args.Zsum_node = Zsum_node;
+    args.expt_node = expt_node;
+    args.gamma = gamma;
+    args.ice_node = ice_node;
+    args.kappa_node = kappa_node;
+    args.max_moist_node = max_moist_node;
+    args.moist_node = moist_node;
+    args.soil_con = soil_con;
+    args.layer = layer;
+    args.veg_var = veg_var;
+    args.INCLUDE_SNOW = INCLUDE_SNOW;
+    args.NOFLUX = options.NOFLUX;
+    args.EXP_TRANS = options.EXP_TRANS;
+    args.SNOWING = snow->snow;
+    args.FIRST_SOLN = FIRST_SOLN;
+    args.T_profile_ws = &T_profile_ws;
+    args.scratch = scratch;
+    args.NetLongBare = &NetLongBare;
+    args.NetLongSnow = &TmpNetLongSnow;
+    args.T1 = &T1;
+    args.deltaH = &energy->deltaH;
+    args.fusion = &energy->fusion;
+    args.grnd_flux = &energy->grnd_flux;
+    args.latent_heat = &energy->latent;
+    args.latent_heat_sub = &energy->latent_sub;
+    args.sensible_heat = &energy->sensible;
+    args.snow_flux = &energy->snow_flux;
+    args.store_error = &energy->error;
+
     /**************************************************
        Find Surface Temperature Using Root Brent Method
     **************************************************/
@@ -298,34 +403,8 @@ calc_surf_energy_bal(double             Le,
             tmpNnodes = Nnodes;
         }
 
-        Tsurf = root_brent(T_lower, T_upper, func_surf_energy_bal,
-                           VEG, veg_class, delta_t, Cs1, Cs2, D1, D2,
-                           T1_old, T2, Ts_old, energy->T, bubble, dp, expt,
-                           ice0, kappa1, kappa2, max_moist, moist, root,
-                           CanopLayerBnd, UnderStory, overstory, NetShortBare,
-                           NetShortGrnd, TmpNetShortSnow, Tair, atmos_density,
-                           atmos_pressure, emissivity, LongBareIn, LongSnowIn,
-                           surf_atten, VPcanopy, VPDcanopy, atmos_shortwave,
-                           atmos_Catm, dryFrac, &Wdew, displacement,
-                           aero_resist, aero_resist_veg, aero_resist_used,
-                           rainfall, ref_height,
-                           roughness, wind, Le, energy->advection, OldTSurf,
-                           Tsnow_surf, kappa_snow, melt_energy, snow_coverage,
-                           snow->density, snow->swq, snow->surf_water,
-                           &energy->deltaCC, &energy->refreeze_energy,
-                           &snow->vapor_flux, &snow->blowing_flux,
-                           &snow->surface_flux, tmpNnodes, Cs_node, T_node,
-                           Tnew_node, Tnew_fbflag, Tnew_fbcount, alpha, beta,
-                           bubble_node, Zsum_node, expt_node, gamma, ice_node,
-                           kappa_node, max_moist_node, moist_node, soil_con,
-                           layer, veg_var, INCLUDE_SNOW, options.NOFLUX,
-                           options.EXP_TRANS,
-                           snow->snow, FIRST_SOLN, &NetLongBare,
-                           &TmpNetLongSnow, &T1, &energy->deltaH,
-                           &energy->fusion, &energy->grnd_flux,
-                           &energy->latent, &energy->latent_sub,
-                           &energy->sensible, &energy->snow_flux,
-                           &energy->error);
+        args.Nnodes = tmpNnodes;
+        Tsurf = root_brent(T_lower, T_upper, func_surf_energy_bal, &args);
 
         if (Tsurf <= -998) {
             if (options.TFALLBACK) {
@@ -418,37 +497,8 @@ calc_surf_energy_bal(double             Le,
             tmpNnodes = Nnodes;
             FIRST_SOLN[0] = true;
 
-            Tsurf = root_brent(T_lower, T_upper,
-                               func_surf_energy_bal, VEG, veg_class,
-                               delta_t, Cs1, Cs2, D1, D2, T1_old, T2, Ts_old,
-                               energy->T, bubble, dp, expt, ice0, kappa1,
-                               kappa2, max_moist, moist, root, CanopLayerBnd,
-                               UnderStory, overstory, NetShortBare,
-                               NetShortGrnd,
-                               TmpNetShortSnow, Tair, atmos_density,
-                               atmos_pressure, emissivity, LongBareIn,
-                               LongSnowIn, surf_atten, VPcanopy, VPDcanopy,
-                               atmos_shortwave, atmos_Catm, dryFrac, &Wdew,
-                               displacement, aero_resist, aero_resist_veg,
-                               aero_resist_used,
-                               rainfall, ref_height, roughness, wind, Le,
-                               energy->advection, OldTSurf, Tsnow_surf,
-                               kappa_snow, melt_energy, snow_coverage,
-                               snow->density, snow->swq, snow->surf_water,
-                               &energy->deltaCC, &energy->refreeze_energy,
-                               &snow->vapor_flux, &snow->blowing_flux,
-                               &snow->surface_flux, tmpNnodes, Cs_node, T_node,
-                               Tnew_node, Tnew_fbflag, Tnew_fbcount, alpha,
-                               beta, bubble_node, Zsum_node, expt_node, gamma,
-                               ice_node, kappa_node, max_moist_node,
-                               moist_node, soil_con, layer, veg_var,
-                               INCLUDE_SNOW, options.NOFLUX, options.EXP_TRANS,
-                               snow->snow,
-                               FIRST_SOLN, &NetLongBare, &TmpNetLongSnow, &T1,
-                               &energy->deltaH, &energy->fusion,
-                               &energy->grnd_flux, &energy->latent,
-                               &energy->latent_sub, &energy->sensible,
-                               &energy->snow_flux, &energy->error);
+            args.Nnodes = tmpNnodes;
+            Tsurf = root_brent(T_lower, T_upper, func_surf_energy_bal, &args);
 
             if (Tsurf <= -998) {
                 if (options.TFALLBACK) {
@@ -549,37 +599,8 @@ calc_surf_energy_bal(double             Le,
         FIRST_SOLN[0] = true;
     }
 
-    error = solve_surf_energy_bal(Tsurf, VEG, veg_class, delta_t, Cs1,
-                                  Cs2, D1, D2, T1_old, T2, Ts_old, energy->T,
-                                  bubble, dp, expt, ice0, kappa1, kappa2,
-                                  max_moist, moist, root, CanopLayerBnd,
-                                  UnderStory, overstory, NetShortBare,
-                                  NetShortGrnd, TmpNetShortSnow, Tair,
-                                  atmos_density, atmos_pressure, emissivity,
-                                  LongBareIn, LongSnowIn, surf_atten, VPcanopy,
-                                  VPDcanopy, atmos_shortwave, atmos_Catm,
-                                  dryFrac, &Wdew, displacement, aero_resist,
-                                  aero_resist_veg, aero_resist_used, rainfall,
-                                  ref_height,
-                                  roughness, wind, Le, energy->advection,
-                                  OldTSurf, Tsnow_surf, kappa_snow,
-                                  melt_energy, snow_coverage, snow->density,
-                                  snow->swq, snow->surf_water,
-                                  &energy->deltaCC, &energy->refreeze_energy,
-                                  &snow->vapor_flux, &snow->blowing_flux,
-                                  &snow->surface_flux, (int) Nnodes, Cs_node,
-                                  T_node, Tnew_node, Tnew_fbflag, Tnew_fbcount,
-                                  alpha, beta, bubble_node, Zsum_node,
-                                  expt_node, gamma, ice_node, kappa_node,
-                                  max_moist_node, moist_node, soil_con, layer,
-                                  veg_var, INCLUDE_SNOW, options.NOFLUX,
-                                  options.EXP_TRANS,
-                                  snow->snow, FIRST_SOLN, &NetLongBare,
-                                  &TmpNetLongSnow, &T1, &energy->deltaH,
-                                  &energy->fusion, &energy->grnd_flux,
-                                  &energy->latent, &energy->latent_sub,
-                                  &energy->sensible, &energy->snow_flux,
-                                  &energy->error);
+    args.Nnodes = (int) Nnodes;
+    error = func_surf_energy_bal(Tsurf, &args);
     if (error == ERROR) {
         return(ERROR);
     }
@@ -750,24 +771,6 @@ calc_surf_energy_bal(double             Le,
     return (Tsurf);
 }
 
-/******************************************************************************
- * @brief    Dummy function to allow calling func_surf_energy_bal() directly.
- *****************************************************************************/
-double
-solve_surf_energy_bal(double Tsurf,
-                      ...)
-{
-    va_list ap;
-
-    double  error;
-
-    va_start(ap, Tsurf);
-    error = func_surf_energy_bal(Tsurf, ap);
-    va_end(ap);
-
-    return error;
-}
-
 /******************************************************************************
  * @brief    Dummy function to allow calling error_print_surf_energy_bal()
  *           directly.
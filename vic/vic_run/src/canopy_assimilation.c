@@ -30,29 +30,30 @@
  * @brief    Calculate GPP, Raut, and NPP for veg cover with multi-layer canopy
  *****************************************************************************/
 void
-canopy_assimilation(char    Ctype,
-                    double  MaxCarboxRate,
-                    double  MaxETransport,
-                    double  CO2Specificity,
-                    double *NscaleFactor,
-                    double  Tfoliage,
-                    double  SWdown,
-                    double *aPAR,
-                    double  elevation,
-                    double  Catm,
-                    double *CanopLayerBnd,
-                    double  LAItotal,
-                    char   *mode,
-                    double *rsLayer,
-                    double *rc,
-                    double *Ci,
-                    double *GPP,
-                    double *Rdark,
-                    double *Rphoto,
-                    double *Rmaint,
-                    double *Rgrowth,
-                    double *Raut,
-                    double *NPP)
+canopy_assimilation(char                  Ctype,
+                    double                MaxCarboxRate,
+                    double                MaxETransport,
+                    double                CO2Specificity,
+                    double               *NscaleFactor,
+                    double                Tfoliage,
+                    double                SWdown,
+                    double               *aPAR,
+                    double                elevation,
+                    double                Catm,
+                    double               *CanopLayerBnd,
+                    double                LAItotal,
+                    char                 *mode,
+                    double               *rsLayer,
+                    double               *rc,
+                    double               *Ci,
+                    double               *GPP,
+                    double               *Rdark,
+                    double               *Rphoto,
+                    double               *Rmaint,
+                    double               *Rgrowth,
+                    double               *Raut,
+                    double               *NPP,
+                    scratch_arena_struct *scratch)
 {
     extern option_struct     options;
     extern parameters_struct param;
@@ -66,6 +67,7 @@ canopy_assimilation(char    Ctype,
     double                   RdarkLayer;
     double                   RphotoLayer;
     double                   gc; /* 1/rs */
+    size_t                   scratch_top;
 
     /* calculate scale height based on average temperature in the column */
     h = calc_scale_height(Tfoliage, elevation);
@@ -74,8 +76,8 @@ canopy_assimilation(char    Ctype,
        temperature is equal air_temp */
     pz = CONST_PSTD * exp(-(double) elevation / h);
 
-    CiLayer = calloc(options.Ncanopy, sizeof(*CiLayer));
-    check_alloc_status(CiLayer, "Memory allocation error.");
+    scratch_top = scratch_mark(scratch);
+    CiLayer = scratch_calloc(scratch, options.Ncanopy, sizeof(*CiLayer));
 
     if (!strcasecmp(mode, "ci")) {
         /* Assume a default leaf-internal CO2; compute assimilation,
@@ -190,5 +192,5 @@ canopy_assimilation(char    Ctype,
     *Raut = *Rmaint + *Rgrowth;
     *NPP = *GPP - *Raut;
 
-    free((char*) CiLayer);
+    scratch_release(scratch, scratch_top);
 }
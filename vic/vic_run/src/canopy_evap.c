@@ -33,30 +33,33 @@
 /******************************************************************************
  * @brief    Calculation of evaporation from the canopy, including the
  *           possibility of potential evaporation exhausting ppt+canopy storage
+ * @details  scratch is only used for the transpiration and may be NULL if
+ *           CALC_EVAP is false.
  *****************************************************************************/
 double
-canopy_evap(layer_data_struct *layer,
-            veg_var_struct    *veg_var,
-            bool               CALC_EVAP,
-            unsigned short     veg_class,
-            double            *Wdew,
-            double             delta_t,
-            double             rad,
-            double             vpd,
-            double             net_short,
-            double             air_temp,
-            double             ra,
-            double             elevation,
-            double             ppt,
-            double            *Wmax,
-            double            *Wcr,
-            double            *Wpwp,
-            double            *frost_fract,
-            double            *root,
-            double            *dryFrac,
-            double             shortwave,
-            double             Catm,
-            double            *CanopLayerBnd)
+canopy_evap(layer_data_struct    *layer,
+            veg_var_struct       *veg_var,
+            bool                  CALC_EVAP,
+            unsigned short        veg_class,
+            double               *Wdew,
+            double                delta_t,
+            double                rad,
+            double                vpd,
+            double                net_short,
+            double                air_temp,
+            double                ra,
+            double                elevation,
+            double                ppt,
+            double               *Wmax,
+            double               *Wcr,
+            double               *Wpwp,
+            double               *frost_fract,
+            double               *root,
+            double               *dryFrac,
+            double                shortwave,
+            double                Catm,
+            double               *CanopLayerBnd,
+            scratch_arena_struct *scratch)
 {
     /** declare global variables **/
     extern veg_lib_struct *vic_run_veg_lib;
@@ -145,7 +148,7 @@ canopy_evap(layer_data_struct *layer,
         transpiration(layer, veg_var, veg_class, rad, vpd, net_short,
                       air_temp, ra, *dryFrac, delta_t, elevation, Wmax, Wcr,
                       Wpwp, layertransp, frost_fract, root, shortwave, Catm,
-                      CanopLayerBnd);
+                      CanopLayerBnd, scratch);
     }
 
     veg_var->canopyevap = canopyevap;
@@ -166,26 +169,27 @@ canopy_evap(layer_data_struct *layer,
  * @brief    Calculate the transpiration from the canopy.
  *****************************************************************************/
 void
-transpiration(layer_data_struct *layer,
-              veg_var_struct    *veg_var,
-              unsigned short     veg_class,
-              double             rad,
-              double             vpd,
-              double             net_short,
-              double             air_temp,
-              double             ra,
-              double             dryFrac,
-              double             delta_t,
-              double             elevation,
-              double            *Wmax,
-              double            *Wcr,
-              double            *Wpwp,
-              double            *layertransp,
-              double            *frost_fract,
-              double            *root,
-              double             shortwave,
-              double             Catm,
-              double            *CanopLayerBnd)
+transpiration(layer_data_struct    *layer,
+              veg_var_struct       *veg_var,
+              unsigned short        veg_class,
+              double                rad,
+              double                vpd,
+              double                net_short,
+              double                air_temp,
+              double                ra,
+              double                dryFrac,
+              double                delta_t,
+              double                elevation,
+              double               *Wmax,
+              double               *Wcr,
+              double               *Wpwp,
+              double               *layertransp,
+              double               *frost_fract,
+              double               *root,
+              double                shortwave,
+              double                Catm,
+              double               *CanopLayerBnd,
+              scratch_arena_struct *scratch)
 {
     extern veg_lib_struct   *vic_run_veg_lib;
     extern option_struct     options;
@@ -204,6 +208,7 @@ transpiration(layer_data_struct *layer,
     double                   gc;
     double                  *gsLayer = NULL;
     size_t                   cidx;
+    size_t                   scratch_top;
 
     /**********************************************************************
        EVAPOTRANSPIRATION
@@ -320,7 +325,7 @@ transpiration(layer_data_struct *layer,
                        veg_var->NscaleFactor, air_temp, shortwave,
                        veg_var->aPARLayer, elevation, Catm,
                        CanopLayerBnd, veg_var->LAI, gsm_inv, vpd,
-                       veg_var->rsLayer, &(veg_var->rc));
+                       veg_var->rsLayer, &(veg_var->rc), scratch);
         }
 
         /* compute transpiration */
@@ -371,9 +376,10 @@ transpiration(layer_data_struct *layer,
     else {
         /* Initialize conductances for aggregation over soil layers */
         gc = 0;
+        scratch_top = scratch_mark(scratch);
         if (options.CARBON) {
-            gsLayer = calloc(options.Ncanopy, sizeof(*gsLayer));
-            check_alloc_status(gsLayer, "Memory allocation error.");
+            gsLayer = scratch_calloc(scratch, options.Ncanopy,
+                                     sizeof(*gsLayer));
             for (cidx = 0; cidx < options.Ncanopy; cidx++) {
                 gsLayer[cidx] = 0;
             }
@@ -424,7 +430,8 @@ transpiration(layer_data_struct *layer,
                                veg_var->NscaleFactor, air_temp, shortwave,
                                veg_var->aPARLayer, elevation, Catm,
                                CanopLayerBnd, veg_var->LAI, gsm_inv, vpd,
-                               veg_var->rsLayer, &(veg_var->rc));
+                               veg_var->rsLayer, &(veg_var->rc),
+                               scratch);
                 }
 
                 /* compute transpiration */
@@ -488,9 +495,7 @@ transpiration(layer_data_struct *layer,
             }
         }
 
-        if (options.CARBON) {
-            free((char *) gsLayer);
-        }
+        scratch_release(scratch, scratch_top);
     }
 
     /****************************************************************
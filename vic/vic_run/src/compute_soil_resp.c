@@ -30,18 +30,19 @@
  * @brief    Calculate soil respiration (heterotrophic respiration, or Rh).
  *****************************************************************************/
 void
-compute_soil_resp(int     Nnodes,
-                  double *dZ,
-                  double  dZTot,
-                  double  dt,
-                  double *T,
-                  double *w,
-                  double  CLitter,
-                  double  CInter,
-                  double  CSlow,
-                  double *RhLitter,
-                  double *RhInterTot,
-                  double *RhSlowTot)
+compute_soil_resp(int                   Nnodes,
+                  double               *dZ,
+                  double                dZTot,
+                  double                dt,
+                  double               *T,
+                  double               *w,
+                  double                CLitter,
+                  double                CInter,
+                  double                CSlow,
+                  double               *RhLitter,
+                  double               *RhInterTot,
+                  double               *RhSlowTot,
+                  scratch_arena_struct *scratch)
 {
     extern parameters_struct param;
 
@@ -56,22 +57,17 @@ compute_soil_resp(int     Nnodes,
     double                  *CSlowNode = NULL;
     double                  *RhInter = NULL;
     double                  *RhSlow = NULL;
+    size_t                   scratch_top;
 
     /* Allocate temp arrays */
-    TK = calloc(Nnodes, sizeof(*TK));
-    check_alloc_status(TK, "Memory allocation error.");
-    fTSoil = calloc(Nnodes, sizeof(*fTSoil));
-    check_alloc_status(fTSoil, "Memory allocation error.");
-    fMSoil = calloc(Nnodes, sizeof(*fMSoil));
-    check_alloc_status(fMSoil, "Memory allocation error.");
-    CInterNode = calloc(Nnodes, sizeof(*CInterNode));
-    check_alloc_status(CInterNode, "Memory allocation error.");
-    CSlowNode = calloc(Nnodes, sizeof(*CSlowNode));
-    check_alloc_status(CSlowNode, "Memory allocation error.");
-    RhInter = calloc(Nnodes, sizeof(*RhInter));
-    check_alloc_status(RhInter, "Memory allocation error.");
-    RhSlow = calloc(Nnodes, sizeof(*RhSlow));
-    check_alloc_status(RhSlow, "Memory allocation error.");
+    scratch_top = scratch_mark(scratch);
+    TK = scratch_calloc(scratch, Nnodes, sizeof(*TK));
+    fTSoil = scratch_calloc(scratch, Nnodes, sizeof(*fTSoil));
+    fMSoil = scratch_calloc(scratch, Nnodes, sizeof(*fMSoil));
+    CInterNode = scratch_calloc(scratch, Nnodes, sizeof(*CInterNode));
+    CSlowNode = scratch_calloc(scratch, Nnodes, sizeof(*CSlowNode));
+    RhInter = scratch_calloc(scratch, Nnodes, sizeof(*RhInter));
+    RhSlow = scratch_calloc(scratch, Nnodes, sizeof(*RhSlow));
 
     /* Compute Lloyd-Taylor temperature dependence */
     Tref = 10. + CONST_TKFRZ; /* reference temperature of 10 C */
@@ -194,11 +190,5 @@ compute_soil_resp(int     Nnodes,
         *RhSlowTot += RhSlow[i];
     }
 
-    free((char *) TK);
-    free((char *) fTSoil);
-    free((char *) fMSoil);
-    free((char *) CInterNode);
-    free((char *) CSlowNode);
-    free((char *) RhInter);
-    free((char *) RhSlow);
+    scratch_release(scratch, scratch_top);
 }
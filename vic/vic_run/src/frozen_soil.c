@@ -147,41 +147,39 @@ calc_layer_average_thermal_props(energy_bal_struct *energy,
  *           space, and first order in time.
  *****************************************************************************/
 int
-solve_T_profile(double   *T,
-                double   *T0,
-                char     *Tfbflag,
-                unsigned *Tfbcount,
-                double   *Zsum,
-                double   *kappa,
-                double   *Cs,
-                double   *moist,
-                double    deltat,
-                double   *max_moist,
-                double   *bubble,
-                double   *expt,
-                double   *ice,
-                double   *alpha,
-                double   *beta,
-                double   *gamma,
-                double    Dp,
-                int       Nnodes,
-                int      *FIRST_SOLN,
-                int       FS_ACTIVE,
-                int       NOFLUX,
-                int       EXP_TRANS)
+solve_T_profile(double                           *T,
+                double                           *T0,
+                char                             *Tfbflag,
+                unsigned                         *Tfbcount,
+                double                           *Zsum,
+                double                           *kappa,
+                double                           *Cs,
+                double                           *moist,
+                double                            deltat,
+                double                           *max_moist,
+                double                           *bubble,
+                double                           *expt,
+                double                           *ice,
+                double                           *alpha,
+                double                           *beta,
+                double                           *gamma,
+                double                            Dp,
+                int                               Nnodes,
+                int                              *FIRST_SOLN,
+                int                               FS_ACTIVE,
+                int                               NOFLUX,
+                int                               EXP_TRANS,
+                solve_T_profile_workspace_struct *ws)
 {
-    double *aa, *bb, *cc, *dd, *ee, Bexp;
+    double *A, *B, *C, *D, *E, Bexp;
     int     Error;
     int     j;
 
-    // TODO: remove use of static variables (see GH #735), for now:
-    // make static variables thread safe
-    static double A[MAX_NODES];
-    static double B[MAX_NODES];
-    static double C[MAX_NODES];
-    static double D[MAX_NODES];
-    static double E[MAX_NODES];
-    #pragma omp threadprivate(A, B, C, D, E)
+    A = ws->A;
+    B = ws->B;
+    C = ws->C;
+    D = ws->D;
+    E = ws->E;
 
     if (FIRST_SOLN[0]) {
         if (EXP_TRANS) {
@@ -229,19 +227,13 @@ solve_T_profile(double   *T,
         }
     }
 
-    aa = &A[0];
-    bb = &B[0];
-    cc = &C[0];
-    dd = &D[0];
-    ee = &E[0];
-
     for (j = 0; j < Nnodes; j++) {
         T[j] = T0[j];
     }
 
     Error = calc_soil_thermal_fluxes(Nnodes, T, T0, Tfbflag, Tfbcount, moist,
-                                     max_moist, ice, bubble, expt, gamma, aa,
-                                     bb, cc, dd, ee, FS_ACTIVE, NOFLUX,
+                                     max_moist, ice, bubble, expt, gamma, A,
+                                     B, C, D, E, FS_ACTIVE, NOFLUX,
                                      EXP_TRANS);
 
     return (Error);
@@ -282,11 +274,13 @@ solve_T_profile_implicit(double   *T,                               // update
                          double   *organic,                    // soil parameter
                          double   *depth)                     // soil parameter
 {
-    extern option_struct options;
-    int                  n, Error;
-    double               res[MAX_NODES];
-    void                 (*vecfunc)(double *, double *, int, int, ...);
-    int                  j;
+    extern option_struct          options;
+    int                           n, Error;
+    double                        res[MAX_NODES];
+    void                          (*vecfunc)(double *, double *, int, int,
+                                             void *, ...);
+    int                           j;
+    fda_heat_eqn_workspace_struct ws;
 
     if (FIRST_SOLN[0]) {
         FIRST_SOLN[0] = false;
@@ -302,15 +296,43 @@ solve_T_profile_implicit(double   *T,                               // update
         n = Nnodes - 1;
     }
 
-    fda_heat_eqn(&T[1], res, n, 1, deltat, NOFLUX, EXP_TRANS, T0,
-                 moist, ice, kappa, Cs, max_moist, bubble, expt,
-                 alpha, beta, gamma, Zsum, Dp, bulk_dens_min, soil_dens_min,
-                 quartz, bulk_density, soil_density, organic, depth,
-                 options.Nlayer);
+    ws.deltat = deltat;
+    ws.NOFLUX = NOFLUX;
+    ws.EXP_TRANS = EXP_TRANS;
+    ws.T0 = T0;
+    ws.moist = moist;
+    ws.ice = ice;
+    ws.kappa = kappa;
+    ws.Cs = Cs;
+    ws.max_moist = max_moist;
+    ws.bubble = bubble;
+    ws.expt = expt;
+    ws.alpha = alpha;
+    ws.beta = beta;
+    ws.gamma = gamma;
+    ws.Zsum = Zsum;
+    ws.Dp = Dp;
+    ws.bulk_dens_min = bulk_dens_min;
+    ws.soil_dens_min = soil_dens_min;
+    ws.quartz = quartz;
+    ws.bulk_density = bulk_density;
+    ws.soil_density = soil_density;
+    ws.organic = organic;
+    ws.depth = depth;
+    ws.Nlayers = options.Nlayer;
+    fda_heat_eqn(&T[1], res, n, 1, &ws);
 
     // modified Newton-Raphson to solve for new T
     vecfunc = &(fda_heat_eqn);
-    Error = newt_raph(vecfunc, &T[1], n);
+    Error = newt_raph(vecfunc, &T[1], n, true, &ws);
+    if (Error) {
+        // retry with the forward difference Jacobian, from the previous
+        // time step's profile T0 that fda_heat_eqn() set as the first guess
+        for (j = 1; j <= n; j++) {
+            T[j] = T0[j];
+        }
+        Error = newt_raph(vecfunc, &T[1], n, false, &ws);
+    }
 
     // update temperature boundaries
     if (Error == 0) {
@@ -378,6 +400,8 @@ calc_soil_thermal_fluxes(int       Nnodes,
     double                   oldT;
     double                   Tlast[MAX_NODES];
 
+    soil_thermal_eqn_args_struct args;
+
     Error = 0;
     Done = false;
     ItCount = 0;
@@ -418,12 +442,24 @@ calc_soil_thermal_fluxes(int       Nnodes,
                 }
             }
             else {
+                args.TL = T[j + 1];
+                args.TU = T[j - 1];
+                args.T0 = T0[j];
+                args.moist = moist[j];
+                args.max_moist = max_moist[j];
+                args.bubble = bubble[j];
+                args.expt = expt[j];
+                args.ice0 = ice[j];
+                args.A = A[j];
+                args.B = B[j];
+                args.C = C[j];
+                args.D = D[j];
+                args.E = E[j];
+                args.EXP_TRANS = EXP_TRANS;
+                args.node = j;
                 T[j] =
                     root_brent(T0[j] - (param.SOIL_DT), T0[j] + (param.SOIL_DT),
-                               soil_thermal_eqn,
-                               T[j + 1], T[j - 1], T0[j], moist[j],
-                               max_moist[j], bubble[j], expt[j], ice[j],
-                               A[j], B[j], C[j], D[j], E[j], EXP_TRANS, j);
+                               soil_thermal_eqn, &args);
                 if (T[j] <= -998) {
                     if (options.TFALLBACK) {
                         T[j] = T0[j];
@@ -470,17 +506,24 @@ calc_soil_thermal_fluxes(int       Nnodes,
                 }
             }
             else {
+                args.TL = T[Nnodes - 1];
+                args.TU = T[Nnodes - 2];
+                args.T0 = T0[Nnodes - 1];
+                args.moist = moist[Nnodes - 1];
+                args.max_moist = max_moist[Nnodes - 1];
+                args.bubble = bubble[j];
+                args.expt = expt[Nnodes - 1];
+                args.ice0 = ice[Nnodes - 1];
+                args.A = A[j];
+                args.B = B[j];
+                args.C = C[j];
+                args.D = D[j];
+                args.E = E[j];
+                args.EXP_TRANS = EXP_TRANS;
+                args.node = j;
                 T[Nnodes - 1] = root_brent(T0[Nnodes - 1] - param.SOIL_DT,
                                            T0[Nnodes - 1] + param.SOIL_DT,
-                                           soil_thermal_eqn,
-                                           T[Nnodes - 1],
-                                           T[Nnodes - 2], T0[Nnodes - 1],
-                                           moist[Nnodes - 1],
-                                           max_moist[Nnodes - 1],
-                                           bubble[j], expt[Nnodes - 1],
-                                           ice[Nnodes - 1],
-                                           A[j], B[j], C[j], D[j], E[j],
-                                           EXP_TRANS, j);
+                                           soil_thermal_eqn, &args);
                 if (T[j] <= -998) {
                     if (options.TFALLBACK) {
                         T[j] = T0[j];
@@ -640,12 +683,22 @@ error_print_solve_T_profile(double  T,
 /******************************************************************************
  * @brief    Heat Equation for implicit scheme (used to calculate residual of
  *           the heat equation) passed from solve_T_profile_implicit
+ *
+ * @details  workspace is a fda_heat_eqn_workspace_struct holding the model
+ *           parameters and initial states. init == 1 sets the boundary
+ *           temperatures and the initial guess, init == 0 calculates the
+ *           residuals (all of them if focus == -1), and init == 2 returns the
+ *           analytic tridiagonal Jacobian of the residuals in the sub-, main
+ *           and super-diagonal arrays passed as the variable arguments. The
+ *           Jacobian is evaluated at the states left behind by the preceding
+ *           full residual calculation.
  *****************************************************************************/
 void
 fda_heat_eqn(double T_2[],
              double res[],
              int    n,
              int    init,
+             void  *workspace,
              ...)
 {
     char    PAST_BOTTOM;
@@ -654,82 +707,89 @@ fda_heat_eqn(double T_2[],
     int     i;
     size_t  lidx;
     int     focus, left, right;
+    double *jac_a, *jac_b, *jac_c;
+    double  c1, cu, cd, ct, zfac;
+    double  dDkappa_lo, dDkappa_self, dDkappa_hi;
+    double  dice[MAX_NODES], dCs[MAX_NODES], dkappa[MAX_NODES];
+    double  dCs_dice;
 
     // argument list handling
     va_list arg_addr;
 
-    // TODO: remove use of static variables (see GH #735), for now:
-    // make static variables thread safe
-    static double  deltat;
-    static int     NOFLUX;
-    static int     EXP_TRANS;
-    static double *T0;
-    static double *moist;
-    static double *ice;
-    static double *kappa;
-    static double *Cs;
-    static double *max_moist;
-    static double *bubble;
-    static double *expt;
-    static double *alpha;
-    static double *beta;
-    static double *gamma;
-    static double *Zsum;
-    static double  Dp;
-    static double *bulk_dens_min;
-    static double *soil_dens_min;
-    static double *quartz;
-    static double *bulk_density;
-    static double *soil_density;
-    static double *organic;
-    static double *depth;
-    static size_t  Nlayers;
+    fda_heat_eqn_workspace_struct *p = workspace;
+    double                         deltat;
+    int                            NOFLUX;
+    int                            EXP_TRANS;
+    double                        *T0;
+    double                        *moist;
+    double                        *ice;
+    double                        *kappa;
+    double                        *Cs;
+    double                        *max_moist;
+    double                        *bubble;
+    double                        *expt;
+    double                        *alpha;
+    double                        *beta;
+    double                        *gamma;
+    double                        *Zsum;
+    double                         Dp;
+    double                        *bulk_dens_min;
+    double                        *soil_dens_min;
+    double                        *quartz;
+    double                        *bulk_density;
+    double                        *soil_density;
+    double                        *organic;
+    double                        *depth;
+    size_t                         Nlayers;
 
     // variables used to calculate residual of the heat equation
     // defined here
-    static double Ts;
-    static double Tb;
+    double                         Ts;
+    double                         Tb;
 
     // locally used variables
-    static double ice_new[MAX_NODES], Cs_new[MAX_NODES], kappa_new[MAX_NODES];
-    static double DT[MAX_NODES], DT_down[MAX_NODES], DT_up[MAX_NODES];
-    static double Dkappa[MAX_NODES];
-    static double Bexp;
-
-    #pragma omp threadprivate(deltat, NOFLUX, EXP_TRANS, T0, moist, ice, \
-    kappa, Cs, max_moist, bubble, expt, alpha, beta, gamma, Zsum, Dp, \
-    bulk_dens_min, soil_dens_min, quartz, bulk_density, soil_density, organic, \
-    depth, Nlayers, Ts, Tb, ice_new, Cs_new, kappa_new, DT, DT_down, DT_up, \
-    Dkappa, Bexp)
+    double                        *ice_new, *Cs_new, *kappa_new;
+    double                        *DT, *DT_down, *DT_up;
+    double                        *Dkappa;
+    double                         Bexp;
+
+    deltat = p->deltat;
+    NOFLUX = p->NOFLUX;
+    EXP_TRANS = p->EXP_TRANS;
+    T0 = p->T0;
+    moist = p->moist;
+    ice = p->ice;
+    kappa = p->kappa;
+    Cs = p->Cs;
+    max_moist = p->max_moist;
+    bubble = p->bubble;
+    expt = p->expt;
+    alpha = p->alpha;
+    beta = p->beta;
+    gamma = p->gamma;
+    Zsum = p->Zsum;
+    Dp = p->Dp;
+    bulk_dens_min = p->bulk_dens_min;
+    soil_dens_min = p->soil_dens_min;
+    quartz = p->quartz;
+    bulk_density = p->bulk_density;
+    soil_density = p->soil_density;
+    organic = p->organic;
+    depth = p->depth;
+    Nlayers = p->Nlayers;
+    Ts = p->Ts;
+    Tb = p->Tb;
+    Bexp = p->Bexp;
+    ice_new = p->ice_new;
+    Cs_new = p->Cs_new;
+    kappa_new = p->kappa_new;
+    DT = p->DT;
+    DT_down = p->DT_down;
+    DT_up = p->DT_up;
+    Dkappa = p->Dkappa;
 
     // initialize variables if init==1
     if (init == 1) {
-        va_start(arg_addr, init);
-        deltat = va_arg(arg_addr, double);
-        NOFLUX = va_arg(arg_addr, int);
-        EXP_TRANS = va_arg(arg_addr, int);
-        T0 = va_arg(arg_addr, double *);
-        moist = va_arg(arg_addr, double *);
-        ice = va_arg(arg_addr, double *);
-        kappa = va_arg(arg_addr, double *);
-        Cs = va_arg(arg_addr, double *);
-        max_moist = va_arg(arg_addr, double *);
-        bubble = va_arg(arg_addr, double *);
-        expt = va_arg(arg_addr, double *);
-        alpha = va_arg(arg_addr, double *);
-        beta = va_arg(arg_addr, double *);
-        gamma = va_arg(arg_addr, double *);
-        Zsum = va_arg(arg_addr, double *);
-        Dp = va_arg(arg_addr, double);
-        bulk_dens_min = va_arg(arg_addr, double *);
-        soil_dens_min = va_arg(arg_addr, double *);
-        quartz = va_arg(arg_addr, double *);
-        bulk_density = va_arg(arg_addr, double *);
-        soil_density = va_arg(arg_addr, double *);
-        organic = va_arg(arg_addr, double *);
-        depth = va_arg(arg_addr, double *);
-        Nlayers = va_arg(arg_addr, size_t);
-
         if (EXP_TRANS) {
             if (!NOFLUX) {
                 Bexp = logf(Dp + 1.) / (double)(n + 1);
@@ -749,12 +809,121 @@ fda_heat_eqn(double T_2[],
         for (i = 0; i < n; i++) {
             T_2[i] = T0[i + 1];
         }
+        p->Ts = Ts;
+        p->Tb = Tb;
+        p->Bexp = Bexp;
+    }
+    // calculate the analytic Jacobian if init==2
+    else if (init == 2) {
+        va_start(arg_addr, workspace);
+        jac_a = va_arg(arg_addr, double *);
+        jac_b = va_arg(arg_addr, double *);
+        jac_c = va_arg(arg_addr, double *);
+        va_end(arg_addr);
+
+        // volumetric_heat_capacity() is linear in the ice fraction when the
+        // total moisture is held constant
+        dCs_dice = volumetric_heat_capacity(0., -1., 1., 0.) -
+                   volumetric_heat_capacity(0., 0., 0., 0.);
+
+        // derivatives of the ice content, heat capacity and conductivity of
+        // each node with respect to its own temperature
+        lidx = 0;
+        Lsum = 0.;
+        PAST_BOTTOM = false;
+        for (i = 0; i < n + 1; i++) {
+            dice[i] = 0.;
+            dCs[i] = 0.;
+            dkappa[i] = 0.;
+            if (i >= 1 && ice_new[i] > 0.) {
+                dice[i] = -maximum_unfrozen_water_deriv(T_2[i - 1],
+                                                        max_moist[i],
+                                                        bubble[i], expt[i]);
+                dCs[i] = dCs_dice * dice[i];
+                dkappa[i] = -dice[i] *
+                            soil_conductivity_deriv(moist[i],
+                                                    moist[i] - ice_new[i],
+                                                    soil_dens_min[lidx],
+                                                    bulk_dens_min[lidx],
+                                                    quartz[lidx],
+                                                    soil_density[lidx],
+                                                    bulk_density[lidx],
+                                                    organic[lidx]);
+            }
+            if (Zsum[i] > Lsum + depth[lidx] && !PAST_BOTTOM) {
+                Lsum += depth[lidx];
+                lidx++;
+                if (lidx == Nlayers) {
+                    PAST_BOTTOM = true;
+                    lidx = Nlayers - 1;
+                }
+            }
+        }
+
+        for (i = 0; i < n; i++) {
+            // write the residual as
+            // c1 * Dkappa * DT + kappa * (cd * DT_down - cu * DT_up + ct * DT)
+            if (!EXP_TRANS) {
+                c1 = 1. / (alpha[i] * alpha[i]);
+                cd = 1. / (gamma[i] * 0.5 * alpha[i]);
+                cu = 1. / (beta[i] * 0.5 * alpha[i]);
+                ct = 0.;
+            }
+            else {
+                zfac = Bexp * (Zsum[i + 1] + 1.);
+                c1 = 1. / (4. * zfac * zfac);
+                cd = 1. / (zfac * zfac);
+                cu = cd;
+                ct = -1. / (2. * Bexp * (Zsum[i + 1] + 1.) *
+                            (Zsum[i + 1] + 1.));
+            }
+
+            // Dkappa is kappa_new[i + 2] - kappa_new[i], except for the
+            // bottom node with a no flux boundary
+            dDkappa_lo = -dkappa[i];
+            if (i < n - 1) {
+                dDkappa_self = 0.;
+                dDkappa_hi = dkappa[i + 2];
+            }
+            else if (!NOFLUX) {
+                dDkappa_self = 0.;
+                dDkappa_hi = 0.;
+            }
+            else {
+                dDkappa_self = dkappa[i + 1];
+                dDkappa_hi = 0.;
+            }
+
+            jac_b[i] = c1 * DT[i] * dDkappa_self +
+                       dkappa[i + 1] * (cd * DT_down[i] - cu * DT_up[i] +
+                                        ct * DT[i]) -
+                       kappa_new[i + 1] * (cd + cu) +
+                       CONST_RHOICE * CONST_LATICE * dice[i + 1] / deltat -
+                       (dCs[i + 1] * (T_2[i] - T0[i + 1]) + Cs_new[i + 1] +
+                        (Cs_new[i + 1] - Cs[i + 1]) + T_2[i] * dCs[i + 1]) /
+                       deltat;
+            if (i > 0) {
+                jac_a[i] = c1 * (-Dkappa[i] + DT[i] * dDkappa_lo) +
+                           kappa_new[i + 1] * (cu - ct);
+            }
+            else {
+                jac_a[i] = 0.;
+            }
+            if (i < n - 1) {
+                jac_c[i] = c1 * (Dkappa[i] + DT[i] * dDkappa_hi) +
+                           kappa_new[i + 1] * (cd + ct);
+            }
+            else {
+                jac_c[i] = 0.;
+            }
+        }
     }
     // calculate residuals if init==0
     else {
         // get the range of columns to calculate
-        va_start(arg_addr, init);
+        va_start(arg_addr, workspace);
         focus = va_arg(arg_addr, int);
+        va_end(arg_addr);
 
         // calculate all entries if focus == -1
         if (focus == -1) {
@@ -31,8 +31,10 @@
  *****************************************************************************/
 double
 func_atmos_energy_bal(double  Tcanopy,
-                      va_list ap)
+                      void   *args)
 {
+    const atmos_energy_bal_args_struct *p = args;
+
     double  Ra;
     double  Tair;
     double  atmos_density;
@@ -43,12 +45,12 @@ func_atmos_energy_bal(double  Tcanopy,
     // internal routine variables
     double  Error;
 
-    // extract variables from va_arg
-    Ra = (double)  va_arg(ap, double);
-    Tair = (double)  va_arg(ap, double);
-    atmos_density = (double)  va_arg(ap, double);
-    InSensible = (double)  va_arg(ap, double);
-    SensibleHeat = (double *)va_arg(ap, double *);
+    // extract variables from the argument struct
+    Ra = p->Ra;
+    Tair = p->Tair;
+    atmos_density = p->atmos_density;
+    InSensible = p->InSensible;
+    SensibleHeat = p->SensibleHeat;
 
     // compute sensible heat flux between canopy and atmosphere
     (*SensibleHeat) = calc_sensible_heat(atmos_density, Tair, Tcanopy, Ra);
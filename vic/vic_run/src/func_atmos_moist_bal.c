@@ -31,8 +31,10 @@
  *****************************************************************************/
 double
 func_atmos_moist_bal(double  VPcanopy,
-                     va_list ap)
+                     void   *args)
 {
+    const atmos_moist_bal_args_struct *p = args;
+
     double  InLatentHeat;
     double  Lv;
     double  Ra;
@@ -45,15 +47,15 @@ func_atmos_moist_bal(double  VPcanopy,
     // internal routine variables
     double  Error;
 
-    // extract variables from va_arg
-    InLatentHeat = (double)  va_arg(ap, double);
-    Lv = (double)  va_arg(ap, double);
-    Ra = (double)  va_arg(ap, double);
-    atmos_density = (double)  va_arg(ap, double);
-    gamma = (double)  va_arg(ap, double);
-    vp = (double)  va_arg(ap, double);
+    // extract variables from the argument struct
+    InLatentHeat = p->InLatentHeat;
+    Lv = p->Lv;
+    Ra = p->Ra;
+    atmos_density = p->atmos_density;
+    gamma = p->gamma;
+    vp = p->vp;
 
-    LatentHeat = (double *) va_arg(ap, double *);
+    LatentHeat = p->LatentHeat;
 
     // compute sensible heat flux between canopy and atmosphere
     (*LatentHeat) = Lv * calc_sensible_heat(atmos_density, vp, VPcanopy,
@@ -33,11 +33,13 @@
  *****************************************************************************/
 double
 func_canopy_energy_bal(double  Tfoliage,
-                       va_list ap)
+                       void   *args)
 {
     extern option_struct     options;
     extern parameters_struct param;
 
+    const canopy_energy_bal_args_struct *p = args;
+
     /* General Model Parameters */
     double                   delta_t;
     double                   elevation;
@@ -107,64 +109,64 @@ func_canopy_energy_bal(double  Tfoliage,
     /** Read variables from variable length argument list **/
 
     /* General Model Parameters */
-    delta_t = (double) va_arg(ap, double);
-    elevation = (double) va_arg(ap, double);
+    delta_t = p->delta_t;
+    elevation = p->elevation;
 
-    Wmax = (double *) va_arg(ap, double *);
-    Wcr = (double *) va_arg(ap, double *);
-    Wpwp = (double *) va_arg(ap, double *);
-    frost_fract = (double *) va_arg(ap, double *);
+    Wmax = p->Wmax;
+    Wcr = p->Wcr;
+    Wpwp = p->Wpwp;
+    frost_fract = p->frost_fract;
 
     /* Atmopheric Condition and Forcings */
-    AirDens = (double) va_arg(ap, double);
-    EactAir = (double) va_arg(ap, double);
-    Press = (double) va_arg(ap, double);
-    Le = (double) va_arg(ap, double);
-    Tcanopy = (double) va_arg(ap, double);
-    Vpd = (double) va_arg(ap, double);
-    shortwave = (double) va_arg(ap, double);
-    Catm = (double) va_arg(ap, double);
-    dryFrac = (double *) va_arg(ap, double *);
-
-    Evap = (double *) va_arg(ap, double *);
-    Ra = (double *) va_arg(ap, double *);
-    Ra_used = (double *) va_arg(ap, double *);
-    Rainfall = (double) va_arg(ap, double);
-    Wind = (double *) va_arg(ap, double *);
+    AirDens = p->AirDens;
+    EactAir = p->EactAir;
+    Press = p->Press;
+    Le = p->Le;
+    Tcanopy = p->Tcanopy;
+    Vpd = p->Vpd;
+    shortwave = p->shortwave;
+    Catm = p->Catm;
+    dryFrac = p->dryFrac;
+
+    Evap = p->Evap;
+    Ra = p->Ra;
+    Ra_used = p->Ra_used;
+    Rainfall = p->Rainfall;
+    Wind = p->Wind;
 
     /* Vegetation Terms */
-    veg_class = (unsigned int) va_arg(ap, unsigned int);
+    veg_class = p->veg_class;
 
-    displacement = (double *) va_arg(ap, double *);
-    ref_height = (double *) va_arg(ap, double *);
-    roughness = (double *) va_arg(ap, double *);
+    displacement = p->displacement;
+    ref_height = p->ref_height;
+    roughness = p->roughness;
 
-    root = (double *) va_arg(ap, double *);
-    CanopLayerBnd = (double *) va_arg(ap, double *);
+    root = p->root;
+    CanopLayerBnd = p->CanopLayerBnd;
 
     /* Water Flux Terms */
-    IntRain = (double) va_arg(ap, double);
-    IntSnow = (double) va_arg(ap, double);
+    IntRain = p->IntRain;
+    IntSnow = p->IntSnow;
 
-    Wdew = (double *) va_arg(ap, double *);
+    Wdew = p->Wdew;
 
-    layer = (layer_data_struct *) va_arg(ap, layer_data_struct *);
-    veg_var = (veg_var_struct *) va_arg(ap, veg_var_struct *);
+    layer = p->layer;
+    veg_var = p->veg_var;
 
     /* Energy Flux Terms */
-    LongOverIn = (double) va_arg(ap, double);
-    LongUnderOut = (double) va_arg(ap, double);
-    NetShortOver = (double) va_arg(ap, double);
-
-    AdvectedEnergy = (double *) va_arg(ap, double *);
-    LatentHeat = (double *) va_arg(ap, double *);
-    LatentHeatSub = (double *) va_arg(ap, double *);
-    LongOverOut = (double *) va_arg(ap, double *);
-    NetLongOver = (double *) va_arg(ap, double *);
-    NetRadiation = (double *) va_arg(ap, double *);
-    RefreezeEnergy = (double *) va_arg(ap, double *);
-    SensibleHeat = (double *) va_arg(ap, double *);
-    VaporMassFlux = (double *) va_arg(ap, double *);
+    LongOverIn = p->LongOverIn;
+    LongUnderOut = p->LongUnderOut;
+    NetShortOver = p->NetShortOver;
+
+    AdvectedEnergy = p->AdvectedEnergy;
+    LatentHeat = p->LatentHeat;
+    LatentHeatSub = p->LatentHeatSub;
+    LongOverOut = p->LongOverOut;
+    NetLongOver = p->NetLongOver;
+    NetRadiation = p->NetRadiation;
+    RefreezeEnergy = p->RefreezeEnergy;
+    SensibleHeat = p->SensibleHeat;
+    VaporMassFlux = p->VaporMassFlux;
 
     /* Calculate the net radiation at the canopy surface, using the canopy
        temperature.  The outgoing longwave is subtracted twice, because the
@@ -239,11 +241,13 @@ func_canopy_energy_bal(double  Tfoliage,
 
         *Wdew = IntRain * MM_PER_M;
         prec = Rainfall * MM_PER_M;
+        // no transpiration is computed here, so no scratch arena is needed
         *Evap = canopy_evap(layer, veg_var, false,
                             veg_class, Wdew, delta_t, *NetRadiation,
                             Vpd, NetShortOver, Tcanopy, Ra_used[1],
                             elevation, prec, Wmax, Wcr, Wpwp, frost_fract,
-                            root, dryFrac, shortwave, Catm, CanopLayerBnd);
+                            root, dryFrac, shortwave, Catm, CanopLayerBnd,
+                            NULL);
         *Wdew /= MM_PER_M;
 
         *LatentHeat = Le * (*Evap) * CONST_RHOFW;
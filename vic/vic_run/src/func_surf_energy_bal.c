@@ -37,11 +37,13 @@
  *****************************************************************************/
 double
 func_surf_energy_bal(double  Ts,
-                     va_list ap)
+                     void   *args)
 {
     extern parameters_struct param;
     extern option_struct     options;
 
+    const surf_energy_bal_args_struct *p = args;
+
     /* define routine input variables */
 
     /* general model terms */
@@ -171,7 +173,9 @@ func_surf_energy_bal(double  Ts,
     int                EXP_TRANS;
     int                SNOWING;
 
-    int               *FIRST_SOLN;
+    int                              *FIRST_SOLN;
+    solve_T_profile_workspace_struct *T_profile_ws;
+    scratch_arena_struct             *scratch;
 
     /* returned energy balance terms */
     double            *NetLongBare; // net LW from snow-free ground
@@ -215,129 +219,131 @@ func_surf_energy_bal(double  Ts,
     double             ga_average;
 
     /************************************
-       Read variables from variable list
+       Read variables from argument struct
     ************************************/
 
     /* general model terms */
-    VEG = (int) va_arg(ap, int);
-    veg_class = (int) va_arg(ap, int);
-    delta_t = (double) va_arg(ap, double);
+    VEG = p->VEG;
+    veg_class = p->veg_class;
+    delta_t = p->delta_t;
 
     /* soil layer terms */
-    Cs1 = (double) va_arg(ap, double);
-    Cs2 = (double) va_arg(ap, double);
-    D1 = (double) va_arg(ap, double);
-    D2 = (double) va_arg(ap, double);
-    T1_old = (double) va_arg(ap, double);
-    T2 = (double) va_arg(ap, double);
-    Ts_old = (double) va_arg(ap, double);
-    Told_node = (double *) va_arg(ap, double *);
-    bubble = (double) va_arg(ap, double);
-    dp = (double) va_arg(ap, double);
-    expt = (double) va_arg(ap, double);
-    ice0 = (double) va_arg(ap, double);
-    kappa1 = (double) va_arg(ap, double);
-    kappa2 = (double) va_arg(ap, double);
-    max_moist = (double) va_arg(ap, double);
-    moist = (double) va_arg(ap, double);
-
-    root = (double  *) va_arg(ap, double  *);
-    CanopLayerBnd = (double *) va_arg(ap, double *);
+    Cs1 = p->Cs1;
+    Cs2 = p->Cs2;
+    D1 = p->D1;
+    D2 = p->D2;
+    T1_old = p->T1_old;
+    T2 = p->T2;
+    Ts_old = p->Ts_old;
+    Told_node = p->Told_node;
+    bubble = p->bubble;
+    dp = p->dp;
+    expt = p->expt;
+    ice0 = p->ice0;
+    kappa1 = p->kappa1;
+    kappa2 = p->kappa2;
+    max_moist = p->max_moist;
+    moist = p->moist;
+
+    root = p->root;
+    CanopLayerBnd = p->CanopLayerBnd;
 
     /* meteorological forcing terms */
-    UnderStory = (int) va_arg(ap, int);
-    overstory = (int) va_arg(ap, int);
-
-    NetShortBare = (double) va_arg(ap, double);
-    NetShortGrnd = (double) va_arg(ap, double);
-    NetShortSnow = (double) va_arg(ap, double);
-    Tair = (double) va_arg(ap, double);
-    atmos_density = (double) va_arg(ap, double);
-    atmos_pressure = (double) va_arg(ap, double);
-    emissivity = (double) va_arg(ap, double);
-    LongBareIn = (double) va_arg(ap, double);
-    LongSnowIn = (double) va_arg(ap, double);
-    surf_atten = (double) va_arg(ap, double);
-    vp = (double) va_arg(ap, double);
-    vpd = (double) va_arg(ap, double);
-    shortwave = (double) va_arg(ap, double);
-    Catm = (double) va_arg(ap, double);
-    dryFrac = (double *) va_arg(ap, double *);
-
-    Wdew = (double *) va_arg(ap, double *);
-    displacement = (double *) va_arg(ap, double *);
-    ra = (double *) va_arg(ap, double *);
-    Ra_veg = (double *) va_arg(ap, double *);
-    Ra_used = (double *) va_arg(ap, double *);
-    rainfall = (double) va_arg(ap, double);
-    ref_height = (double *) va_arg(ap, double *);
-    roughness = (double *) va_arg(ap, double *);
-    wind = (double *) va_arg(ap, double *);
+    UnderStory = p->UnderStory;
+    overstory = p->overstory;
+
+    NetShortBare = p->NetShortBare;
+    NetShortGrnd = p->NetShortGrnd;
+    NetShortSnow = p->NetShortSnow;
+    Tair = p->Tair;
+    atmos_density = p->atmos_density;
+    atmos_pressure = p->atmos_pressure;
+    emissivity = p->emissivity;
+    LongBareIn = p->LongBareIn;
+    LongSnowIn = p->LongSnowIn;
+    surf_atten = p->surf_atten;
+    vp = p->vp;
+    vpd = p->vpd;
+    shortwave = p->shortwave;
+    Catm = p->Catm;
+    dryFrac = p->dryFrac;
+
+    Wdew = p->Wdew;
+    displacement = p->displacement;
+    ra = p->ra;
+    Ra_veg = p->Ra_veg;
+    Ra_used = p->Ra_used;
+    rainfall = p->rainfall;
+    ref_height = p->ref_height;
+    roughness = p->roughness;
+    wind = p->wind;
 
     /* latent heat terms */
-    Le = (double) va_arg(ap, double);
+    Le = p->Le;
 
     /* snowpack terms */
-    Advection = (double) va_arg(ap, double);
-    OldTSurf = (double) va_arg(ap, double);
-    Tsnow_surf = (double) va_arg(ap, double);
-    kappa_snow = (double) va_arg(ap, double);
-    melt_energy = (double) va_arg(ap, double);
-    snow_coverage = (double) va_arg(ap, double);
-    snow_density = (double) va_arg(ap, double);
-    snow_swq = (double) va_arg(ap, double);
-    snow_water = (double) va_arg(ap, double);
-
-    deltaCC = (double *) va_arg(ap, double *);
-    refreeze_energy = (double *) va_arg(ap, double *);
-    vapor_flux = (double *) va_arg(ap, double *);
-    blowing_flux = (double *) va_arg(ap, double *);
-    surface_flux = (double *) va_arg(ap, double *);
+    Advection = p->Advection;
+    OldTSurf = p->OldTSurf;
+    Tsnow_surf = p->Tsnow_surf;
+    kappa_snow = p->kappa_snow;
+    melt_energy = p->melt_energy;
+    snow_coverage = p->snow_coverage;
+    snow_density = p->snow_density;
+    snow_swq = p->snow_swq;
+    snow_water = p->snow_water;
+
+    deltaCC = p->deltaCC;
+    refreeze_energy = p->refreeze_energy;
+    vapor_flux = p->vapor_flux;
+    blowing_flux = p->blowing_flux;
+    surface_flux = p->surface_flux;
 
     /* soil node terms */
-    Nnodes = (int) va_arg(ap, int);
-
-    Cs_node = (double *) va_arg(ap, double *);
-    T_node = (double *) va_arg(ap, double *);
-    Tnew_node = (double *) va_arg(ap, double *);
-    Tnew_fbflag = (char *) va_arg(ap, char *);
-    Tnew_fbcount = (unsigned *) va_arg(ap, unsigned *);
-    alpha = (double *) va_arg(ap, double *);
-    beta = (double *) va_arg(ap, double *);
-    bubble_node = (double *) va_arg(ap, double *);
-    Zsum_node = (double *) va_arg(ap, double *);
-    expt_node = (double *) va_arg(ap, double *);
-    gamma = (double *) va_arg(ap, double *);
-    ice_node = (double *) va_arg(ap, double *);
-    kappa_node = (double *) va_arg(ap, double *);
-    max_moist_node = (double *) va_arg(ap, double *);
-    moist_node = (double *) va_arg(ap, double *);
+    Nnodes = p->Nnodes;
+
+    Cs_node = p->Cs_node;
+    T_node = p->T_node;
+    Tnew_node = p->Tnew_node;
+    Tnew_fbflag = p->Tnew_fbflag;
+    Tnew_fbcount = p->Tnew_fbcount;
+    alpha = p->alpha;
+    beta = p->beta;
+    bubble_node = p->bubble_node;
+    Zsum_node = p->Zsum_node;
+    expt_node = p->expt_node;
+    gamma = p->gamma;
+    ice_node = p->ice_node;
+    kappa_node = p->kappa_node;
+    max_moist_node = p->max_moist_node;
+    moist_node = p->moist_node;
 
     /* model structures */
-    soil_con = (soil_con_struct *) va_arg(ap, soil_con_struct *);
-    layer = (layer_data_struct *) va_arg(ap, layer_data_struct *);
-    veg_var = (veg_var_struct *) va_arg(ap, veg_var_struct *);
+    soil_con = p->soil_con;
+    layer = p->layer;
+    veg_var = p->veg_var;
 
     /* control flags */
-    INCLUDE_SNOW = (int) va_arg(ap, int);
-    NOFLUX = (int) va_arg(ap, int);
-    EXP_TRANS = (int) va_arg(ap, int);
-    SNOWING = (int) va_arg(ap, int);
+    INCLUDE_SNOW = p->INCLUDE_SNOW;
+    NOFLUX = p->NOFLUX;
+    EXP_TRANS = p->EXP_TRANS;
+    SNOWING = p->SNOWING;
 
-    FIRST_SOLN = (int *) va_arg(ap, int *);
+    FIRST_SOLN = p->FIRST_SOLN;
+    T_profile_ws = p->T_profile_ws;
+    scratch = p->scratch;
 
     /* returned energy balance terms */
-    NetLongBare = (double *) va_arg(ap, double *);
-    NetLongSnow = (double *) va_arg(ap, double *);
-    T1 = (double *) va_arg(ap, double *);
-    deltaH = (double *) va_arg(ap, double *);
-    fusion = (double *) va_arg(ap, double *);
-    grnd_flux = (double *) va_arg(ap, double *);
-    latent_heat = (double *) va_arg(ap, double *);
-    latent_heat_sub = (double *) va_arg(ap, double *);
-    sensible_heat = (double *) va_arg(ap, double *);
-    snow_flux = (double *) va_arg(ap, double *);
-    store_error = (double *) va_arg(ap, double *);
+    NetLongBare = p->NetLongBare;
+    NetLongSnow = p->NetLongSnow;
+    T1 = p->T1;
+    deltaH = p->deltaH;
+    fusion = p->fusion;
+    grnd_flux = p->grnd_flux;
+    latent_heat = p->latent_heat;
+    latent_heat_sub = p->latent_heat_sub;
+    sensible_heat = p->sensible_heat;
+    snow_flux = p->snow_flux;
+    store_error = p->store_error;
 
     /* take additional variables from soil_con structure */
     b_infilt = soil_con->b_infilt;
@@ -458,7 +464,7 @@ func_surf_energy_bal(double  Ts,
                                     max_moist_node, bubble_node,
                                     expt_node, ice_node, alpha, beta, gamma, dp,
                                     Nnodes, FIRST_SOLN, FS_ACTIVE, NOFLUX,
-                                    EXP_TRANS);
+                                    EXP_TRANS, T_profile_ws);
         }
 
         if ((int) Error == ERROR) {
@@ -755,7 +761,8 @@ func_surf_energy_bal(double  Ts,
                                delta_t, NetBareRad, vpd, NetShortBare,
                                Tair, Ra_veg[1], elevation, rainfall,
                                Wmax, Wcr, Wpwp, frost_fract, root,
-                               dryFrac, shortwave, Catm, CanopLayerBnd);
+                               dryFrac, shortwave, Catm, CanopLayerBnd,
+                               scratch);
             Evap *= veg_var->fcanopy;
             for (i = 0; i < options.Nlayer; i++) {
                 layer[i].transp *= veg_var->fcanopy;
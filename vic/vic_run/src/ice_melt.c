@@ -104,6 +104,8 @@ ice_melt(double            z2,
     double                   Ls;
     double                   melt_energy = 0.;
 
+    ice_energy_bal_args_struct args;
+
     SnowFall = snowfall / MM_PER_M; /* convert to m */
     RainFall = rainfall / MM_PER_M; /* convert to m */
     IceMelt = 0.0;
@@ -221,18 +223,40 @@ ice_melt(double            z2,
     blowing_flux = snow->blowing_flux;
     surface_flux = snow->surface_flux;
 
+    // arguments of the ice pack energy balance
+    args.Dt = delta_t;
+    args.Ra = aero_resist;
+    args.Ra_used = aero_resist_used;
+    args.Z = z2;
+    args.Z0 = Z0;
+    args.Wind = wind;
+    args.ShortRad = net_short;
+    args.LongRadIn = longwave;
+    args.AirDens = density;
+    args.Lv = Le;
+    args.Tair = air_temp;
+    args.Press = pressure * PA_PER_KPA;
+    args.Vpd = vpd * PA_PER_KPA;
+    args.EactAir = vp * PA_PER_KPA;
+    args.Rain = RainFall;
+    args.SurfaceLiquidWater = snow->surf_water;
+    args.RefreezeEnergy = &RefreezeEnergy;
+    args.vapor_flux = &vapor_flux;
+    args.blowing_flux = &blowing_flux;
+    args.surface_flux = &surface_flux;
+    args.AdvectedEnergy = &advection;
+    args.Tfreeze = Tcutoff;
+    args.AvgCond = avgcond;
+    args.SWconducted = SWconducted;
+    args.qf = &SnowFlux;
+    args.LatentHeat = &latent_heat;
+    args.LatentHeatSub = &latent_heat_sub;
+    args.SensibleHeat = &sensible_heat;
+    args.LongRadOut = &LWnet;
+
     /* Calculate the surface energy balance for snow_temp = 0.0 */
 
-    Qnet = CalcIcePackEnergyBalance((double) 0.0, delta_t, aero_resist,
-                                    aero_resist_used, z2, Z0, wind, net_short,
-                                    longwave, density, Le, air_temp,
-                                    pressure * PA_PER_KPA, vpd * PA_PER_KPA,
-                                    vp * PA_PER_KPA,
-                                    RainFall, snow->surf_water, &RefreezeEnergy,
-                                    &vapor_flux, &blowing_flux, &surface_flux,
-                                    &advection, Tcutoff, avgcond, SWconducted,
-                                    &SnowFlux, &latent_heat, &latent_heat_sub,
-                                    &sensible_heat, &LWnet);
+    Qnet = IceEnergyBalance((double) 0.0, &args);
 
     snow->vapor_flux = vapor_flux;
     snow->surface_flux = surface_flux;
@@ -349,18 +373,7 @@ ice_melt(double            z2,
             snow->surf_temp =
                 root_brent((double) (snow->surf_temp - param.SNOW_DT),
                            (double) (snow->surf_temp + param.SNOW_DT),
-                           IceEnergyBalance, delta_t,
-                           aero_resist, aero_resist_used, z2, Z0,
-                           wind, net_short, longwave, density,
-                           Le, air_temp, pressure * PA_PER_KPA,
-                           vpd * PA_PER_KPA, vp * PA_PER_KPA,
-                           RainFall,
-                           snow->surf_water, &RefreezeEnergy,
-                           &vapor_flux, &blowing_flux,
-                           &surface_flux, &advection, Tcutoff,
-                           avgcond, SWconducted, &SnowFlux,
-                           &latent_heat, &latent_heat_sub,
-                           &sensible_heat, &LWnet);
+                           IceEnergyBalance, &args);
 
             if (snow->surf_temp <= -998) {
                 if (options.TFALLBACK) {
@@ -397,19 +410,7 @@ ice_melt(double            z2,
             snow->surf_temp = 999;
         }
         if (snow->surf_temp > -998 && snow->surf_temp < 999) {
-            Qnet = CalcIcePackEnergyBalance(snow->surf_temp, delta_t,
-                                            aero_resist, aero_resist_used, z2,
-                                            Z0, wind, net_short, longwave,
-                                            density, Le, air_temp,
-                                            pressure * PA_PER_KPA,
-                                            vpd * PA_PER_KPA,
-                                            vp * PA_PER_KPA, RainFall,
-                                            snow->surf_water, &RefreezeEnergy,
-                                            &vapor_flux, &blowing_flux,
-                                            &surface_flux, &advection, Tcutoff,
-                                            avgcond, SWconducted, &SnowFlux,
-                                            &latent_heat, &latent_heat_sub,
-                                            &sensible_heat, &LWnet);
+            Qnet = IceEnergyBalance(snow->surf_temp, &args);
 
             snow->vapor_flux = vapor_flux;
             snow->surface_flux = surface_flux;
@@ -609,26 +610,6 @@ ice_melt(double            z2,
     return (0);
 }
 
-/******************************************************************************
- * @brief    Dummy function to make a direct call to IceEnergyBalance()
- *           possible.
- *****************************************************************************/
-double
-CalcIcePackEnergyBalance(double Tsurf,
-                         ...)
-{
-    va_list ap;                 /* Used in traversing variable argument list
-                                 */
-    double  Qnet;                /* Net energy exchange at the IcePack snow
-                                    surface (W/m^2) */
-
-    va_start(ap, Tsurf);
-    Qnet = IceEnergyBalance(Tsurf, ap);
-    va_end(ap);
-
-    return Qnet;
-}
-
 /******************************************************************************
  * @brief    Dummy function to make a direct call to
  *           ErrorPrintIcePackEnergyBalance() possible.
@@ -1806,15 +1806,16 @@ energycalc(double *finaltemp,
  * @brief    This routine calculates the water balance of the lake.
  *****************************************************************************/
 int
-water_balance(lake_var_struct *lake,
-              lake_con_struct  lake_con,
-              double           dt,
-              all_vars_struct *all_vars,
-              int              iveg,
-              int              band,
-              double           lakefrac,
-              soil_con_struct  soil_con,
-              veg_con_struct   veg_con)
+water_balance(lake_var_struct      *lake,
+              lake_con_struct       lake_con,
+              double                dt,
+              all_vars_struct      *all_vars,
+              int                   iveg,
+              int                   band,
+              double                lakefrac,
+              soil_con_struct       soil_con,
+              veg_con_struct        veg_con,
+              scratch_arena_struct *scratch)
 {
     extern option_struct       options;
     extern parameters_struct   param;
@@ -1844,6 +1845,7 @@ water_balance(lake_var_struct *lake,
     double                    *delta_moist = NULL;
     double                    *moist = NULL;
     double                     max_newfraction;
+    size_t                     scratch_top;
 
     cell = all_vars->cell;
     veg_var = all_vars->veg_var;
@@ -1852,10 +1854,9 @@ water_balance(lake_var_struct *lake,
 
     frost_fract = soil_con.frost_fract;
 
-    delta_moist = calloc(options.Nlayer, sizeof(*delta_moist));
-    check_alloc_status(delta_moist, "Memory allocation error.");
-    moist = calloc(options.Nlayer, sizeof(*moist));
-    check_alloc_status(moist, "Memory allocation error.");
+    scratch_top = scratch_mark(scratch);
+    delta_moist = scratch_calloc(scratch, options.Nlayer, sizeof(*delta_moist));
+    moist = scratch_calloc(scratch, options.Nlayer, sizeof(*moist));
 
     /**********************************************************************
     * 1. Preliminary stuff
@@ -2299,8 +2300,7 @@ water_balance(lake_var_struct *lake,
         advect_carbon_storage(lakefrac, newfraction, lake, &(cell[iveg][band]));
     }
 
-    free((char*) delta_moist);
-    free((char*) moist);
+    scratch_release(scratch, scratch_top);
 
     return(0);
 }
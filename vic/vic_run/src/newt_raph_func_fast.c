@@ -34,15 +34,24 @@
 /******************************************************************************
  * @brief    Newton-Raphson method to solve non-linear system adapted from
  *           "Numerical Recipes"
+ * @details  If ANALYTIC_JACOBIAN is true, vecfunc is asked for the tridiagonal
+ *           Jacobian (init == 2) instead of approximating it with forward
+ *           differences. The forward difference Jacobian is used for any trial
+ *           in which the analytic one is not usable. params is passed on to
+ *           vecfunc.
  *****************************************************************************/
 int
-newt_raph(void (*vecfunc)(double x[], double fvec[], int n, int init, ...),
+newt_raph(void (*vecfunc)(double x[], double fvec[], int n, int init,
+                          void *params, ...),
           double x[],
-          int n)
+          int n,
+          bool ANALYTIC_JACOBIAN,
+          void *params)
 {
     extern parameters_struct param;
 
     int                      k, i, Error;
+    bool                     USE_FDJAC;
     double                   errx, errf, fvec[MAX_NODES], p[MAX_NODES];
     double                   a[MAX_NODES], b[MAX_NODES], c[MAX_NODES];
 
@@ -50,7 +59,7 @@ newt_raph(void (*vecfunc)(double x[], double fvec[], int n, int init, ...),
 
     for (k = 0; k < param.NEWT_RAPH_MAXTRIAL; k++) {
         // calculate function value for all nodes, i.e. focus = -1
-        (*vecfunc)(x, fvec, n, 0, -1);
+        (*vecfunc)(x, fvec, n, 0, params, -1);
 
         // stop if TOLF is satisfied
         errf = 0.0;
@@ -62,7 +71,21 @@ newt_raph(void (*vecfunc)(double x[], double fvec[], int n, int init, ...),
         }
 
         // calculate the Jacobian
-        fdjac3(x, fvec, a, b, c, vecfunc, n);
+        USE_FDJAC = true;
+        if (ANALYTIC_JACOBIAN) {
+            (*vecfunc)(x, fvec, n, 2, params, a, b, c);
+            USE_FDJAC = false;
+            for (i = 0; i < n; i++) {
+                if (!isfinite(a[i]) || !isfinite(b[i]) || !isfinite(c[i]) ||
+                    b[i] == 0.) {
+                    USE_FDJAC = true;
+                    break;
+                }
+            }
+        }
+        if (USE_FDJAC) {
+            fdjac3(x, fvec, a, b, c, vecfunc, n, params);
+        }
 
         for (i = 0; i < n; i++) {
             p[i] = -fvec[i];
@@ -113,8 +136,10 @@ fdjac3(double x[],
        double a[],
        double b[],
        double c[],
-       void (*vecfunc)(double x[], double fvec[], int n, int init, ...),
-       int n)
+       void (*vecfunc)(double x[], double fvec[], int n, int init,
+                       void *params, ...),
+       int n,
+       void *params)
 {
     extern parameters_struct param;
 
@@ -131,7 +156,7 @@ fdjac3(double x[],
         h = x[j] - temp;
 
         // only update column j-1, j and j+1, caused by change in x[j]
-        (*vecfunc)(x, f, n, 0, j);
+        (*vecfunc)(x, f, n, 0, params, j);
 
         x[j] = temp;
 
@@ -89,22 +89,23 @@ calc_rc(double rs,
  * @brief    Calculate canopy resistance rc as a function of photosynthetic.
  *****************************************************************************/
 void
-calc_rc_ps(char    Ctype,
-           double  MaxCarboxRate,
-           double  MaxETransport,
-           double  CO2Specificity,
-           double *NscaleFactor,
-           double  tair,
-           double  shortwave,
-           double *aPAR,
-           double  elevation,
-           double  Catm,
-           double *CanopLayerBnd,
-           double  lai,
-           double  gsm_inv,
-           double  vpd,
-           double *rsLayer,
-           double *rc)
+calc_rc_ps(char                  Ctype,
+           double                MaxCarboxRate,
+           double                MaxETransport,
+           double                CO2Specificity,
+           double               *NscaleFactor,
+           double                tair,
+           double                shortwave,
+           double               *aPAR,
+           double                elevation,
+           double                Catm,
+           double               *CanopLayerBnd,
+           double                lai,
+           double                gsm_inv,
+           double                vpd,
+           double               *rsLayer,
+           double               *rc,
+           scratch_arena_struct *scratch)
 {
     extern option_struct     options;
     extern parameters_struct param;
@@ -154,7 +155,8 @@ calc_rc_ps(char    Ctype,
                         &Rmaint0,
                         &Rgrowth0,
                         &Raut0,
-                        &NPP0);
+                        &NPP0,
+                        scratch);
 
     /* calculate vapor pressure deficit factor */
     vpdfactor = 1 - vpd / param.CANOPY_CLOSURE;
@@ -34,19 +34,21 @@
  *           ground heat flux solution.
  *****************************************************************************/
 void
-prepare_full_energy(cell_data_struct  *cell,
-                    energy_bal_struct *energy,
-                    soil_con_struct   *soil_con,
-                    double            *moist0,
-                    double            *ice0)
+prepare_full_energy(cell_data_struct     *cell,
+                    energy_bal_struct    *energy,
+                    soil_con_struct      *soil_con,
+                    double               *moist0,
+                    double               *ice0,
+                    scratch_arena_struct *scratch)
 {
     extern option_struct options;
 
     size_t               i;
     layer_data_struct   *layer = NULL;
+    size_t               scratch_top;
 
-    layer = calloc(options.Nlayer, sizeof(*layer));
-    check_alloc_status(layer, "Memory allocation error.");
+    scratch_top = scratch_mark(scratch);
+    layer = scratch_calloc(scratch, options.Nlayer, sizeof(*layer));
 
     for (i = 0; i < options.Nlayer; i++) {
         layer[i] = cell->layer[i];
@@ -93,5 +95,5 @@ prepare_full_energy(cell_data_struct  *cell,
     energy->kappa[1] = layer[1].kappa;
     energy->Cs[1] = layer[1].Cs;
 
-    free((char *) layer);
+    scratch_release(scratch, scratch_top);
 }
@@ -60,18 +60,17 @@
 * @param LowerBound Lower bound for root
 * @param UpperBound Upper bound for root
 * @param Function
-* @param ap Variable arguments
+* @param params Arguments passed through to Function
 * @return b
 ******************************************************************************/
 double
 root_brent(double LowerBound,
            double UpperBound,
-           double (*Function)(double Estimate, va_list ap),
-           ...)
+           double (*Function)(double Estimate, void *params),
+           void *params)
 {
     extern parameters_struct param;
 
-    va_list                  ap; /* Used in traversing variable argument list */
     double                   a;
     double                   b;
     double                   c;
@@ -92,13 +91,10 @@ root_brent(double LowerBound,
     int                      i;
     int                      j;
 
-    /* initialize variable argument list */
     a = LowerBound;
     b = UpperBound;
-    va_start(ap, Function);
-    fa = Function(a, ap);
-    va_start(ap, Function);
-    fb = Function(b, ap);
+    fa = Function(a, params);
+    fb = Function(b, params);
 
     which_err = 0;
 
@@ -107,7 +103,6 @@ root_brent(double LowerBound,
         log_warn("lower and upper bounds %f and %f "
                  "failed to bracket the root because the given function was "
                  "not defined at either point.", a, b);
-        va_end(ap);
         return(ERROR);
     }
 
@@ -126,16 +121,14 @@ root_brent(double LowerBound,
         }
 
         c = 0.5 * (last_bad + last_good);
-        va_start(ap, Function);
-        fc = Function(c, ap);
+        fc = Function(c, params);
 
         /* search for valid point via bisection */
         j = 0;
         while (fc == ERROR && j < param.ROOT_BRENT_MAXITER) {
             last_bad = c;
             c = 0.5 * (last_bad + last_good);
-            va_start(ap, Function);
-            fc = Function(c, ap);
+            fc = Function(c, params);
             j++;
         }
 
@@ -146,7 +139,6 @@ root_brent(double LowerBound,
                      "undefined values while attempting to "
                      "bracket the root between %f and %f. Driver info: %s.",
                      LowerBound, UpperBound, vic_run_ref_str);
-            va_end(ap);
             return(ERROR);
         }
         else {
@@ -172,16 +164,13 @@ root_brent(double LowerBound,
         if (which_err == 0) { // No undefined values were encountered
             a -= param.ROOT_BRENT_TSTEP;
             b += param.ROOT_BRENT_TSTEP;
-            va_start(ap, Function);
-            fa = Function(a, ap);
-            va_start(ap, Function);
-            fb = Function(b, ap);
+            fa = Function(a, params);
+            fb = Function(b, params);
         }
         else { // Undefined values were encountered
             if (which_err == -1) { // Undefined values encountered in the lower direction
                 b += param.ROOT_BRENT_TSTEP;
-                va_start(ap, Function);
-                fb = Function(b, ap);
+                fb = Function(b, params);
                 if (fb == ERROR) {
                     /* Undefined function values in both directions - give up */
                     log_warn("the given function "
@@ -189,22 +178,19 @@ root_brent(double LowerBound,
                              "attempting to bracket the root "
                              "between %f and %f. Driver info: %s.",
                              LowerBound, UpperBound, vic_run_ref_str);
-                    va_end(ap);
                     return(ERROR);
                 }
                 last_good = a;
             }
             else { // Undefined values encountered in the upper direction
                 a -= param.ROOT_BRENT_TSTEP;
-                va_start(ap, Function);
-                fa = Function(a, ap);
+                fa = Function(a, params);
                 if (fa == ERROR) {
                     /* Undefined function values in both directions - give up */
                     log_warn("the given function produced undefined "
                              "values while attempting to bracket the root "
                              "between %f and %f. Driver info: %s.",
                              LowerBound, UpperBound, vic_run_ref_str);
-                    va_end(ap);
                     return(ERROR);
                 }
                 last_good = b;
@@ -212,14 +198,12 @@ root_brent(double LowerBound,
 
             /* search for valid point via bisection */
             c = 0.5 * (last_good + last_bad);
-            va_start(ap, Function);
-            fc = Function(c, ap);
+            fc = Function(c, params);
             i = 0;
             while (fc == ERROR && i < param.ROOT_BRENT_MAXITER) {
                 last_bad = c;
                 c = 0.5 * (last_bad + last_good);
-                va_start(ap, Function);
-                fc = Function(c, ap);
+                fc = Function(c, params);
                 i++;
             }
 
@@ -229,7 +213,6 @@ root_brent(double LowerBound,
                          "values while attempting to bracket the root between "
                          "%f and %f. Driver info: %s.",
                          LowerBound, UpperBound, vic_run_ref_str);
-                va_end(ap);
                 return(ERROR);
             }
             else {
@@ -251,7 +234,6 @@ root_brent(double LowerBound,
         log_warn("lower and upper bounds %f and %f failed to "
                  "bracket the root. Driver info: %s.",
                  a, b, vic_run_ref_str);
-        va_end(ap);
         return(ERROR);
     }
 
@@ -282,7 +264,6 @@ root_brent(double LowerBound,
         m = 0.5 * (c - b);
 
         if (fabs(m) <= tol || fb == 0) {
-            va_end(ap);
             return b;
         }
         else {
@@ -328,14 +309,12 @@ root_brent(double LowerBound,
             a = b;
             fa = fb;
             b += (fabs(d) > tol) ? d : ((m > 0) ? tol : -tol);
-            va_start(ap, Function);
-            fb = Function(b, ap);
+            fb = Function(b, params);
 
             // Catch ERROR values returned from Function
             if (fb == ERROR) {
                 log_warn("iteration %d: temperature = %.4f. Driver info: %s.",
                          i + 1, b, vic_run_ref_str);
-                va_end(ap);
                 return(ERROR);
             }
         }
@@ -343,6 +322,5 @@ root_brent(double LowerBound,
     /* If we get here, there were too many iterations */
     log_warn("too many iterations. Driver info: %s.",
              vic_run_ref_str);
-    va_end(ap);
     return(ERROR);
 }
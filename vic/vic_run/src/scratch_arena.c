@@ -0,0 +1,195 @@
+/******************************************************************************
+ * @section DESCRIPTION
+ *
+ * Scratch arena for short-lived work arrays.
+ *
+ * Memory is handed out from large blocks by bumping a pointer, so the work
+ * arrays that vic_run() and the drivers need for a single cell or time step
+ * do not go through malloc and free. Allocations are released in stack order:
+ * scratch_mark() returns the current top of the arena and scratch_release()
+ * frees everything allocated since. Once the arena has grown to the largest
+ * amount of memory needed at any one time it stops calling malloc altogether.
+ *
+ * An arena must only be used by one thread at a time. The drivers own one
+ * arena per thread and pass it down to the routines that need work arrays.
+ *
+ * @section LICENSE
+ *
+ * The Variable Infiltration Capacity (VIC) macroscale hydrological model
+ * Copyright (C) 2016 The Computational Hydrology Group, Department of Civil
+ * and Environmental Engineering, University of Washington.
+ *
+ * The VIC model is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *****************************************************************************/
+
+#include <vic_run.h>
+
+/******************************************************************************
+ * @brief    Initialize an empty scratch arena.
+ *****************************************************************************/
+void
+initialize_scratch_arena(scratch_arena_struct *scratch)
+{
+    scratch->block = NULL;
+}
+
+/******************************************************************************
+ * @brief    Allocate a scratch block that holds size bytes.
+ *****************************************************************************/
+scratch_block_struct *
+alloc_scratch_block(size_t size)
+{
+    scratch_block_struct *block;
+    size_t                header;
+
+    header = (sizeof(*block) + SCRATCH_ALIGN - 1) / SCRATCH_ALIGN *
+             SCRATCH_ALIGN;
+    block = malloc(header + size);
+    check_alloc_status(block, "Memory allocation error.");
+    block->prev = NULL;
+    block->data = (char *) block + header;
+    block->size = size;
+    block->used = 0;
+    block->start = 0;
+    block->high_water = 0;
+
+    return block;
+}
+
+/******************************************************************************
+ * @brief    Allocate nbytes of uninitialized scratch memory.
+ * @details  The memory is valid until the arena is released to a mark taken
+ *           before this call.
+ *****************************************************************************/
+void *
+scratch_alloc(scratch_arena_struct *scratch,
+              size_t                nbytes)
+{
+    scratch_block_struct *block;
+    size_t                size;
+    void                 *ptr;
+
+    nbytes = (nbytes + SCRATCH_ALIGN - 1) / SCRATCH_ALIGN * SCRATCH_ALIGN;
+
+    if (scratch->block == NULL ||
+        scratch->block->used + nbytes > scratch->block->size) {
+        // start a new block that is at least twice as large as the current
+        size = SCRATCH_BLOCK_SIZE;
+        if (scratch->block != NULL && 2 * scratch->block->size > size) {
+            size = 2 * scratch->block->size;
+        }
+        if (nbytes > size) {
+            size = nbytes;
+        }
+        block = alloc_scratch_block(size);
+        if (scratch->block != NULL) {
+            block->prev = scratch->block;
+            block->start = scratch->block->start + scratch->block->used;
+        }
+        scratch->block = block;
+    }
+
+    ptr = scratch->block->data + scratch->block->used;
+    scratch->block->used += nbytes;
+
+    return ptr;
+}
+
+/******************************************************************************
+ * @brief    Allocate zero-initialized scratch memory for nmemb elements of
+ *           size bytes, like calloc().
+ *****************************************************************************/
+void *
+scratch_calloc(scratch_arena_struct *scratch,
+               size_t                nmemb,
+               size_t                size)
+{
+    void *ptr;
+
+    ptr = scratch_alloc(scratch, nmemb * size);
+    memset(ptr, 0, nmemb * size);
+
+    return ptr;
+}
+
+/******************************************************************************
+ * @brief    Return the current top of the scratch arena.
+ *****************************************************************************/
+size_t
+scratch_mark(scratch_arena_struct *scratch)
+{
+    if (scratch->block == NULL) {
+        return 0;
+    }
+
+    return scratch->block->start + scratch->block->used;
+}
+
+/******************************************************************************
+ * @brief    Release all scratch memory allocated since mark was taken.
+ * @details  Blocks that were added because the arena ran full are freed. When
+ *           the arena is released completely the first block is replaced by
+ *           one that holds everything that was needed at the same time, so
+ *           that from then on a single block serves the whole cell or time
+ *           step.
+ *****************************************************************************/
+void
+scratch_release(scratch_arena_struct *scratch,
+                size_t                mark)
+{
+    scratch_block_struct *block;
+    size_t                high_water;
+
+    if (scratch->block == NULL) {
+        return;
+    }
+
+    high_water = scratch->block->start + scratch->block->used;
+    while (scratch->block->prev != NULL && scratch->block->start >= mark) {
+        block = scratch->block;
+        scratch->block = block->prev;
+        if (block->high_water > high_water) {
+            high_water = block->high_water;
+        }
+        free(block);
+    }
+    if (high_water > scratch->block->high_water) {
+        scratch->block->high_water = high_water;
+    }
+    if (mark < scratch->block->start + scratch->block->used) {
+        scratch->block->used = mark - scratch->block->start;
+    }
+
+    if (mark == 0 && scratch->block->high_water > scratch->block->size) {
+        high_water = scratch->block->high_water;
+        free(scratch->block);
+        scratch->block = alloc_scratch_block(high_water);
+    }
+}
+
+/******************************************************************************
+ * @brief    Free all memory of the scratch arena.
+ *****************************************************************************/
+void
+scratch_free(scratch_arena_struct *scratch)
+{
+    scratch_block_struct *block;
+
+    while (scratch->block != NULL) {
+        block = scratch->block;
+        scratch->block = block->prev;
+        free(block);
+    }
+}
@@ -125,6 +125,8 @@ snow_intercept(double             Dt,
     double                   shortwave; //
     double                   Catm; //
 
+    canopy_energy_bal_args_struct args;
+
     AirDens = force->density[hidx];
     EactAir = force->vp[hidx];
     Press = force->pressure[hidx];
@@ -286,6 +288,50 @@ snow_intercept(double             Dt,
         *Tfoliage = Tcanopy;
     }
 
+    // arguments of the canopy energy balance
+    args.delta_t = Dt;
+    args.elevation = soil_con->elevation;
+    args.Wmax = soil_con->max_moist;
+    args.Wcr = soil_con->Wcr;
+    args.Wpwp = soil_con->Wpwp;
+    args.frost_fract = soil_con->frost_fract;
+    args.AirDens = AirDens;
+    args.EactAir = EactAir;
+    args.Press = Press;
+    args.Le = Le;
+    args.Tcanopy = Tcanopy;
+    args.Vpd = Vpd;
+    args.shortwave = shortwave;
+    args.Catm = Catm;
+    args.dryFrac = dryFrac;
+    args.Evap = &Evap;
+    args.Ra = Ra;
+    args.Ra_used = Ra_used;
+    args.Rainfall = *RainFall;
+    args.Wind = Wind;
+    args.veg_class = veg_class;
+    args.displacement = displacement;
+    args.ref_height = ref_height;
+    args.roughness = roughness;
+    args.root = root;
+    args.CanopLayerBnd = CanopLayerBnd;
+    args.IntRain = IntRainOrg;
+    args.IntSnow = *IntSnow;
+    args.Wdew = IntRain;
+    args.layer = layer;
+    args.veg_var = veg_var;
+    args.LongOverIn = LongOverIn;
+    args.LongUnderOut = LongUnderOut;
+    args.AdvectedEnergy = AdvectedEnergy;
+    args.LatentHeat = LatentHeat;
+    args.LatentHeatSub = LatentHeatSub;
+    args.LongOverOut = LongOverOut;
+    args.NetLongOver = NetLongOver;
+    args.NetRadiation = &NetRadiation;
+    args.RefreezeEnergy = &RefreezeEnergy;
+    args.SensibleHeat = SensibleHeat;
+    args.VaporMassFlux = VaporMassFlux;
+
     /* Calculate the net radiation at the canopy surface, using the canopy
        temperature.  The outgoing longwave is subtracted twice, because the
        canopy radiates in two directions */
@@ -297,21 +343,9 @@ snow_intercept(double             Dt,
 
         *AlbedoOver = param.SNOW_NEW_SNOW_ALB; // albedo of intercepted snow in canopy
         *NetShortOver = (1. - *AlbedoOver) * ShortOverIn; // net SW in canopy
+        args.NetShortOver = *NetShortOver;
 
-        Qnet = solve_canopy_energy_bal(0., Dt, soil_con->elevation,
-                                       soil_con->max_moist, soil_con->Wcr,
-                                       soil_con->Wpwp, soil_con->frost_fract,
-                                       AirDens, EactAir, Press, Le, Tcanopy,
-                                       Vpd, shortwave, Catm, dryFrac, &Evap,
-                                       Ra, Ra_used, *RainFall, Wind, veg_class,
-                                       displacement, ref_height, roughness,
-                                       root, CanopLayerBnd, IntRainOrg,
-                                       *IntSnow, IntRain, layer, veg_var,
-                                       LongOverIn, LongUnderOut, *NetShortOver,
-                                       AdvectedEnergy, LatentHeat,
-                                       LatentHeatSub, LongOverOut, NetLongOver,
-                                       &NetRadiation, &RefreezeEnergy,
-                                       SensibleHeat, VaporMassFlux);
+        Qnet = func_canopy_energy_bal(0., &args);
 
         if (Qnet != 0) {
             /* Intercepted snow not melting - need to find temperature */
@@ -331,31 +365,14 @@ snow_intercept(double             Dt,
         /* No snow in canopy */
         *AlbedoOver = bare_albedo;
         *NetShortOver = (1. - *AlbedoOver) * ShortOverIn; // net SW in canopy
+        args.NetShortOver = *NetShortOver;
         Qnet = -9999;
         Tupper = (*Tfoliage) + param.SNOW_DT;
         Tlower = (*Tfoliage) - param.SNOW_DT;
     }
 
     if (Tupper != MISSING && Tlower != MISSING) {
-        *Tfoliage = root_brent(Tlower, Tupper,
-                               func_canopy_energy_bal, Dt,
-                               soil_con->elevation, soil_con->max_moist,
-                               soil_con->Wcr, soil_con->Wpwp,
-                               soil_con->frost_fract,
-                               AirDens, EactAir, Press, Le,
-                               Tcanopy, Vpd, shortwave, Catm, dryFrac,
-                               &Evap, Ra, Ra_used, *RainFall, Wind,
-                               veg_class, displacement, ref_height,
-                               roughness, root, CanopLayerBnd, IntRainOrg,
-                               *IntSnow,
-                               IntRain, layer, veg_var,
-                               LongOverIn, LongUnderOut,
-                               *NetShortOver,
-                               AdvectedEnergy,
-                               LatentHeat, LatentHeatSub,
-                               LongOverOut, NetLongOver, &NetRadiation,
-                               &RefreezeEnergy, SensibleHeat,
-                               VaporMassFlux);
+        *Tfoliage = root_brent(Tlower, Tupper, func_canopy_energy_bal, &args);
 
         if (*Tfoliage <= -998) {
             if (options.TFALLBACK) {
@@ -396,20 +413,7 @@ snow_intercept(double             Dt,
             }
         }
 
-        Qnet = solve_canopy_energy_bal(*Tfoliage, Dt, soil_con->elevation,
-                                       soil_con->max_moist, soil_con->Wcr,
-                                       soil_con->Wpwp, soil_con->frost_fract,
-                                       AirDens, EactAir, Press, Le, Tcanopy,
-                                       Vpd, shortwave, Catm, dryFrac, &Evap,
-                                       Ra, Ra_used, *RainFall, Wind, veg_class,
-                                       displacement, ref_height, roughness,
-                                       root, CanopLayerBnd, IntRainOrg,
-                                       *IntSnow, IntRain, layer, veg_var,
-                                       LongOverIn, LongUnderOut, *NetShortOver,
-                                       AdvectedEnergy, LatentHeat,
-                                       LatentHeatSub, LongOverOut, NetLongOver,
-                                       &NetRadiation, &RefreezeEnergy,
-                                       SensibleHeat, VaporMassFlux);
+        Qnet = func_canopy_energy_bal(*Tfoliage, &args);
     }
 
     if (*IntSnow <= 0) {
@@ -560,24 +564,6 @@ snow_intercept(double             Dt,
     return(0);
 }
 
-/******************************************************************************
-* @brief    Dummy function to make a direct call to func_canopy_energy_bal()
-*           possible.
-******************************************************************************/
-double
-solve_canopy_energy_bal(double Tfoliage,
-                        ...)
-{
-    va_list ap;
-    double  Qnet;
-
-    va_start(ap, Tfoliage);
-    Qnet = func_canopy_energy_bal(Tfoliage, ap);
-    va_end(ap);
-
-    return Qnet;
-}
-
 /******************************************************************************
 * @brief    Dummy function to make a direct call to
 *           error_print_canopy_energy_bal() possible.
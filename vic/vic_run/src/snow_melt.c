@@ -100,6 +100,8 @@ snow_melt(double            Le,
     double                   advected_sensible_heat;
     double                   melt_energy = 0.;
 
+    snow_pack_energy_bal_args_struct args;
+
     SnowFall = snowfall / MM_PER_M; /* convet to m */
     RainFall = rainfall / MM_PER_M; /* convet to m */
 
@@ -167,23 +169,45 @@ snow_melt(double            Le,
     Ice += SnowFall;
     snow->surf_water += RainFall;
 
+    // arguments of the snow pack energy balance
+    args.Dt = delta_t;
+    args.Ra = aero_resist;
+    args.Ra_used = aero_resist_used;
+    args.Z = z2;
+    args.Z0 = Z0;
+    args.AirDens = density;
+    args.EactAir = vp;
+    args.LongSnowIn = LongSnowIn;
+    args.Lv = Le;
+    args.Press = pressure;
+    args.Rain = RainFall;
+    args.NetShortUnder = NetShortSnow;
+    args.Vpd = vpd;
+    args.Wind = wind;
+    args.OldTSurf = (*OldTSurf);
+    args.SnowCoverFract = coverage;
+    args.SnowDepth = snow->depth;
+    args.SnowDensity = snow->density;
+    args.SurfaceLiquidWater = snow->surf_water;
+    args.SweSurfaceLayer = SurfaceSwq;
+    args.Tair = Tcanopy;
+    args.TGrnd = Tgrnd;
+    args.AdvectedEnergy = &advection;
+    args.AdvectedSensibleHeat = &advected_sensible_heat;
+    args.DeltaColdContent = &deltaCC;
+    args.GroundFlux = &grnd_flux;
+    args.LatentHeat = &latent_heat;
+    args.LatentHeatSub = &latent_heat_sub;
+    args.NetLongUnder = NetLongSnow;
+    args.RefreezeEnergy = &RefreezeEnergy;
+    args.SensibleHeat = &sensible_heat;
+    args.vapor_flux = &snow->vapor_flux;
+    args.blowing_flux = &snow->blowing_flux;
+    args.surface_flux = &snow->surface_flux;
+
     /* Calculate the surface energy balance for snow_temp = 0.0 */
 
-    Qnet = CalcSnowPackEnergyBalance((double) 0.0, delta_t, aero_resist,
-                                     aero_resist_used, z2, Z0,
-                                     density, vp, LongSnowIn, Le, pressure,
-                                     RainFall, NetShortSnow, vpd,
-                                     wind, (*OldTSurf), coverage,
-                                     snow->depth, snow->density,
-                                     snow->surf_water, SurfaceSwq,
-                                     Tcanopy, Tgrnd,
-                                     &advection, &advected_sensible_heat,
-                                     &deltaCC,
-                                     &grnd_flux, &latent_heat,
-                                     &latent_heat_sub, NetLongSnow,
-                                     &RefreezeEnergy, &sensible_heat,
-                                     &snow->vapor_flux, &snow->blowing_flux,
-                                     &snow->surface_flux);
+    Qnet = SnowPackEnergyBalance((double) 0.0, &args);
 
     /* Check that snow swq exceeds minimum value for model stability */
     if (!UNSTABLE_SNOW) {
@@ -267,21 +291,7 @@ snow_melt(double            Le,
                 snow->surf_temp = root_brent(
                     (double) (snow->surf_temp - param.SNOW_DT),
                     (double) (snow->surf_temp + param.SNOW_DT),
-                    SnowPackEnergyBalance,
-                    delta_t, aero_resist, aero_resist_used, z2, Z0,
-                    density, vp, LongSnowIn, Le, pressure,
-                    RainFall, NetShortSnow, vpd,
-                    wind, (*OldTSurf), coverage,
-                    snow->depth, snow->density,
-                    snow->surf_water, SurfaceSwq,
-                    Tcanopy, Tgrnd,
-                    &advection, &advected_sensible_heat,
-                    &deltaCC,
-                    &grnd_flux, &latent_heat,
-                    &latent_heat_sub, NetLongSnow,
-                    &RefreezeEnergy, &sensible_heat,
-                    &snow->vapor_flux, &snow->blowing_flux,
-                    &snow->surface_flux);
+                    SnowPackEnergyBalance, &args);
 
                 if (snow->surf_temp <= -998) {
                     if (options.TFALLBACK) {
@@ -324,26 +334,7 @@ snow_melt(double            Le,
                 snow->surf_temp = 999;
             }
             if (snow->surf_temp > -998 && snow->surf_temp < 999) {
-                Qnet = CalcSnowPackEnergyBalance(snow->surf_temp,
-                                                 delta_t, aero_resist,
-                                                 aero_resist_used, z2, Z0,
-                                                 density, vp, LongSnowIn, Le,
-                                                 pressure,
-                                                 RainFall, NetShortSnow, vpd,
-                                                 wind, (*OldTSurf), coverage,
-                                                 snow->depth, snow->density,
-                                                 snow->surf_water, SurfaceSwq,
-                                                 Tcanopy, Tgrnd,
-                                                 &advection,
-                                                 &advected_sensible_heat,
-                                                 &deltaCC,
-                                                 &grnd_flux, &latent_heat,
-                                                 &latent_heat_sub,
-                                                 NetLongSnow, &RefreezeEnergy,
-                                                 &sensible_heat,
-                                                 &snow->vapor_flux,
-                                                 &snow->blowing_flux,
-                                                 &snow->surface_flux);
+                Qnet = SnowPackEnergyBalance(snow->surf_temp, &args);
 
                 /* since we iterated, the surface layer is below freezing and no snowmelt */
 
@@ -510,26 +501,6 @@ snow_melt(double            Le,
     return (0);
 }
 
-/******************************************************************************
- * @brief    Dummy function to make a direct call to SnowEnergyBalance()
- *           possible.
- *****************************************************************************/
-double
-CalcSnowPackEnergyBalance(double Tsurf,
-                          ...)
-{
-    va_list ap;                 /* Used in traversing variable argument list
-                                 */
-    double  Qnet;                /* Net energy exchange at the SnowPack snow
-                                    surface (W/m^2) */
-
-    va_start(ap, Tsurf);
-    Qnet = SnowPackEnergyBalance(Tsurf, ap);
-    va_end(ap);
-
-    return Qnet;
-}
-
 /******************************************************************************
  * @brief    Pass snow pack energy balance terms to
  *           ErrorPrintSnowPackEnergyBalance
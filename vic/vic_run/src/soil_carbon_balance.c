@@ -37,10 +37,11 @@
 *           slow pools is assumed to go to the atmosphere.
 ******************************************************************************/
 void
-soil_carbon_balance(soil_con_struct   *soil_con,
-                    energy_bal_struct *energy,
-                    cell_data_struct  *cell,
-                    veg_var_struct    *veg_var)
+soil_carbon_balance(soil_con_struct      *soil_con,
+                    energy_bal_struct    *energy,
+                    cell_data_struct     *cell,
+                    veg_var_struct       *veg_var,
+                    scratch_arena_struct *scratch)
 {
     extern option_struct       options;
     extern global_param_struct global_param;
@@ -58,6 +59,7 @@ soil_carbon_balance(soil_con_struct   *soil_con,
     double                     wtd;
     double                     w0;
     double                     w1;
+    size_t                     scratch_top;
 
     // Find subset of thermal nodes that span soil hydrologic layers
     dZTot = 0;
@@ -72,14 +74,11 @@ soil_carbon_balance(soil_con_struct   *soil_con,
     if (soil_con->Zsum_node[i] > dZTot) {
         Nnodes--;
     }
-    dZ = calloc(Nnodes, sizeof(*dZ));
-    check_alloc_status(dZ, "Memory allocation error");
-    dZCum = calloc(Nnodes, sizeof(*dZCum));
-    check_alloc_status(dZCum, "Memory allocation error");
-    T = calloc(Nnodes, sizeof(*T));
-    check_alloc_status(T, "Memory allocation error");
-    w = calloc(Nnodes, sizeof(*w));
-    check_alloc_status(w, "Memory allocation error");
+    scratch_top = scratch_mark(scratch);
+    dZ = scratch_calloc(scratch, Nnodes, sizeof(*dZ));
+    dZCum = scratch_calloc(scratch, Nnodes, sizeof(*dZCum));
+    T = scratch_calloc(scratch, Nnodes, sizeof(*T));
+    w = scratch_calloc(scratch, Nnodes, sizeof(*w));
 
     // Assign node thicknesses and temperatures for subset
     dZTot = 0;
@@ -160,7 +159,7 @@ soil_carbon_balance(soil_con_struct   *soil_con,
     // Compute carbon fluxes out of soil (evaluate fluxes at subset of thermal nodes and sum them)
     compute_soil_resp(Nnodes, dZ, dZTot, global_param.dt, T, w, cell->CLitter,
                       cell->CInter, cell->CSlow, &(cell->RhLitter),
-                      &(cell->RhInter), &(cell->RhSlow));
+                      &(cell->RhInter), &(cell->RhSlow), scratch);
     cell->RhLitter2Atm = param.SRESP_FAIR * cell->RhLitter;
     cell->RhTot = cell->RhLitter2Atm + cell->RhInter + cell->RhSlow;
 
@@ -180,8 +179,5 @@ soil_carbon_balance(soil_con_struct   *soil_con,
         (1 - param.SRESP_FINTER) - cell->RhSlow;
 
     // Free temporary dynamic arrays
-    free((char *) dZ);
-    free((char *) dZCum);
-    free((char *) T);
-    free((char *) w);
+    scratch_release(scratch, scratch_top);
 }
@@ -102,6 +102,65 @@ soil_conductivity(double moist,
     return (K);
 }
 
+/******************************************************************************
+* @brief    Derivative of soil_conductivity() with respect to the unfrozen
+*           water content Wu, holding the total moisture constant.
+*
+* @note     Only the frozen branch of soil_conductivity() depends on Wu; the
+*           derivative is zero for unfrozen or dry soil and where the
+*           conductivity is limited to its dry value.
+******************************************************************************/
+double
+soil_conductivity_deriv(double moist,
+                        double Wu,
+                        double soil_dens_min,
+                        double bulk_dens_min,
+                        double quartz,
+                        double soil_density,
+                        double bulk_density,
+                        double organic)
+{
+    double Ki = 2.2;    /* thermal conductivity of ice (W/mK) */
+    double Kw = 0.57;   /* thermal conductivity of water (W/mK) */
+    double Ksat;
+    double Kdry;
+    double Kdry_org = 0.05;
+    double Kdry_min;
+    double Ks;
+    double Ks_org = 0.25;
+    double Ks_min;
+    double Sr;
+    double porosity;
+
+    if (moist <= 0. || Wu == moist) {
+        return (0.);
+    }
+
+    Kdry_min =
+        (0.135 * bulk_dens_min +
+         64.7) / (soil_dens_min - 0.947 * bulk_dens_min);
+    Kdry = (1 - organic) * Kdry_min + organic * Kdry_org;
+
+    porosity = 1.0 - bulk_density / soil_density;
+    Sr = moist / porosity;
+
+    if (quartz < .2) {
+        Ks_min = pow(7.7, quartz) * pow(3.0, 1.0 - quartz);
+    }
+    else {
+        Ks_min = pow(7.7, quartz) * pow(2.2, 1.0 - quartz);
+    }
+    Ks = (1 - organic) * Ks_min + organic * Ks_org;
+
+    Ksat = pow(Ks, 1.0 - porosity) * pow(Ki, porosity - Wu) * pow(Kw, Wu);
+
+    if ((Ksat - Kdry) * Sr + Kdry < Kdry) {
+        return (0.);
+    }
+
+    return (Sr * Ksat * log(Kw / Ki));
+}
+
 /******************************************************************************
 * @brief    This subroutine calculates the soil volumetric heat capacity
             based on the fractional volume of its component parts.
@@ -818,3 +877,27 @@ maximum_unfrozen_water(double T,
 
     return (unfrozen);
 }
+
+/******************************************************************************
+* @brief    Derivative of maximum_unfrozen_water() with respect to
+*           temperature.
+******************************************************************************/
+double
+maximum_unfrozen_water_deriv(double T,
+                             double max_moist,
+                             double bubble,
+                             double expt)
+{
+    double unfrozen;
+
+    if (T >= 0.) {
+        return (0.);
+    }
+
+    unfrozen = maximum_unfrozen_water(T, max_moist, bubble, expt);
+    if (unfrozen <= 0. || unfrozen >= max_moist) {
+        return (0.);
+    }
+
+    return (-(2.0 / (expt - 3.0)) * unfrozen / T);
+}
@@ -31,8 +31,10 @@
 ******************************************************************************/
 double
 soil_thermal_eqn(double  T,
-                 va_list ap)
+                 void   *args)
 {
+    const soil_thermal_eqn_args_struct *p = args;
+
     double value;
 
     double TL;
@@ -54,21 +56,21 @@ soil_thermal_eqn(double  T,
     double flux_term1;
     double flux_term2;
 
-    TL = (double) va_arg(ap, double);
-    TU = (double) va_arg(ap, double);
-    T0 = (double) va_arg(ap, double);
-    moist = (double) va_arg(ap, double);
-    max_moist = (double) va_arg(ap, double);
-    bubble = (double) va_arg(ap, double);
-    expt = (double) va_arg(ap, double);
-    ice0 = (double) va_arg(ap, double);
-    A = (double) va_arg(ap, double);
-    B = (double) va_arg(ap, double);
-    C = (double) va_arg(ap, double);
-    D = (double) va_arg(ap, double);
-    E = (double) va_arg(ap, double);
-    EXP_TRANS = (int) va_arg(ap, int);
-    node = (int) va_arg(ap, int);
+    TL = p->TL;
+    TU = p->TU;
+    T0 = p->T0;
+    moist = p->moist;
+    max_moist = p->max_moist;
+    bubble = p->bubble;
+    expt = p->expt;
+    ice0 = p->ice0;
+    A = p->A;
+    B = p->B;
+    C = p->C;
+    D = p->D;
+    E = p->E;
+    EXP_TRANS = p->EXP_TRANS;
+    node = p->node;
 
     if (T < 0.) {
         ice = moist - maximum_unfrozen_water(T, max_moist, bubble, expt);
@@ -32,42 +32,43 @@
 * @brief        This routine computes all surface fluxes
 ******************************************************************************/
 int
-surface_fluxes(bool                 overstory,
-               double               BareAlbedo,
-               double               ice0,
-               double               moist0,
-               double               surf_atten,
-               double              *Melt,
-               double              *Le,
-               double              *aero_resist,
-               double              *displacement,
-               double              *gauge_correction,
-               double              *out_prec,
-               double              *out_rain,
-               double              *out_snow,
-               double              *ref_height,
-               double              *roughness,
-               double              *snow_inflow,
-               double              *wind,
-               double              *root,
-               size_t               Nlayers,
-               size_t               Nveg,
-               unsigned short       band,
-               double               dp,
-               unsigned short       iveg,
-               unsigned short       veg_class,
-               force_data_struct   *force,
-               dmy_struct          *dmy,
-               energy_bal_struct   *energy,
-               global_param_struct *gp,
-               cell_data_struct    *cell,
-               snow_data_struct    *snow,
-               soil_con_struct     *soil_con,
-               veg_var_struct      *veg_var,
-               double               lag_one,
-               double               sigma_slope,
-               double               fetch,
-               double              *CanopLayerBnd)
+surface_fluxes(bool                  overstory,
+               double                BareAlbedo,
+               double                ice0,
+               double                moist0,
+               double                surf_atten,
+               double               *Melt,
+               double               *Le,
+               double               *aero_resist,
+               double               *displacement,
+               double               *gauge_correction,
+               double               *out_prec,
+               double               *out_rain,
+               double               *out_snow,
+               double               *ref_height,
+               double               *roughness,
+               double               *snow_inflow,
+               double               *wind,
+               double               *root,
+               size_t                Nlayers,
+               size_t                Nveg,
+               unsigned short        band,
+               double                dp,
+               unsigned short        iveg,
+               unsigned short        veg_class,
+               force_data_struct    *force,
+               dmy_struct           *dmy,
+               energy_bal_struct    *energy,
+               global_param_struct  *gp,
+               cell_data_struct     *cell,
+               snow_data_struct     *snow,
+               soil_con_struct      *soil_con,
+               veg_var_struct       *veg_var,
+               double                lag_one,
+               double                sigma_slope,
+               double                fetch,
+               double               *CanopLayerBnd,
+               scratch_arena_struct *scratch)
 {
     extern veg_lib_struct   *vic_run_veg_lib;
     extern option_struct     options;
@@ -223,10 +224,13 @@ surface_fluxes(bool                 overstory,
     double            store_Rgrowth;
     double            store_Raut;
     double            store_NPP;
+    size_t            scratch_top;
+    size_t            scratch_step_top;
 
+    scratch_top = scratch_mark(scratch);
     if (options.CARBON) {
-        store_gsLayer = calloc(options.Ncanopy, sizeof(*store_gsLayer));
-        check_alloc_status(store_gsLayer, "Memory allocation error.");
+        store_gsLayer = scratch_calloc(scratch, options.Ncanopy,
+                                       sizeof(*store_gsLayer));
     }
 
     /***********************************************************************
@@ -393,10 +397,10 @@ surface_fluxes(bool                 overstory,
 
         // compute LAI and absorbed PAR per canopy layer
         if (options.CARBON && iveg < Nveg) {
-            LAIlayer = calloc(options.Ncanopy, sizeof(*LAIlayer));
-            check_alloc_status(LAIlayer, "Memory allocation error.");
-            faPAR = calloc(options.Ncanopy, sizeof(*faPAR));
-            check_alloc_status(faPAR, "Memory allocation error.");
+            scratch_step_top = scratch_mark(scratch);
+            LAIlayer = scratch_calloc(scratch, options.Ncanopy,
+                                      sizeof(*LAIlayer));
+            faPAR = scratch_calloc(scratch, options.Ncanopy, sizeof(*faPAR));
 
             /* Compute absorbed PAR per ground area per canopy layer (W/m2)
                normalized to PAR = 1 W, i.e. the canopy albedo in the PAR
@@ -427,8 +431,7 @@ surface_fluxes(bool                 overstory,
                     veg_var->aPAR += force->par[hidx] * faPAR[cidx] / 1e-10;
                 }
             }
-            free((char*) LAIlayer);
-            free((char*) faPAR);
+            scratch_release(scratch, scratch_step_top);
         }
 
         // Compute mass flux of blowing snow
@@ -619,7 +622,7 @@ surface_fluxes(bool                 overstory,
                                              dmy, &iter_soil_energy,
                                              iter_layer,
                                              &(iter_snow), soil_con,
-                                             &iter_soil_veg_var);
+                                             &iter_soil_veg_var, scratch);
 
                 if ((int) Tsurf == ERROR) {
                     // Return error flag to skip rest of grid cell
@@ -748,7 +751,8 @@ surface_fluxes(bool                 overstory,
                                     &(iter_soil_veg_var.Rmaint),
                                     &(iter_soil_veg_var.Rgrowth),
                                     &(iter_soil_veg_var.Raut),
-                                    &(iter_soil_veg_var.NPP));
+                                    &(iter_soil_veg_var.NPP),
+                                    scratch);
                 /* Adjust by fraction of canopy that was dry and account for any other inhibition`*/
                 dryFrac *= iter_soil_veg_var.NPPfactor;
                 iter_soil_veg_var.GPP *= dryFrac;
@@ -1062,9 +1066,7 @@ surface_fluxes(bool                 overstory,
         veg_var->Raut = store_Raut / (double) N_steps;
         veg_var->NPP = store_NPP / (double) N_steps;
 
-        free((char *) (store_gsLayer));
-
-        soil_carbon_balance(soil_con, energy, cell, veg_var);
+        soil_carbon_balance(soil_con, energy, cell, veg_var, scratch);
 
         // Update running total annual NPP
         if (veg_var->NPP > 0) {
@@ -1072,6 +1074,7 @@ surface_fluxes(bool                 overstory,
                                   gp->dt;
         }
     }
+    scratch_release(scratch, scratch_top);
 
     /********************************************************
        Compute Runoff, Baseflow, and Soil Moisture Transport
@@ -28,20 +28,51 @@
 #include <vic_run.h>
 
 veg_lib_struct *vic_run_veg_lib;
+char            vic_run_ref_str[MAXSTRING];
 
 /******************************************************************************
 * @brief        This subroutine controls the model core, it solves both the
 *               energy and water balance models, as well as frozen soils.
+* @details      The work arrays of the cell and time step come from the
+*               scratch arena, which is released in one go when solve_cell()
+*               returns, whether it succeeded or not.
 ******************************************************************************/
 int
-vic_run(force_data_struct   *force,
-        all_vars_struct     *all_vars,
-        dmy_struct          *dmy,
-        global_param_struct *gp,
-        lake_con_struct     *lake_con,
-        soil_con_struct     *soil_con,
-        veg_con_struct      *veg_con,
-        veg_lib_struct      *veg_lib)
+vic_run(force_data_struct    *force,
+        all_vars_struct      *all_vars,
+        dmy_struct           *dmy,
+        global_param_struct  *gp,
+        lake_con_struct      *lake_con,
+        soil_con_struct      *soil_con,
+        veg_con_struct       *veg_con,
+        veg_lib_struct       *veg_lib,
+        scratch_arena_struct *scratch)
+{
+    int    ErrorFlag;
+    size_t scratch_top;
+
+    scratch_top = scratch_mark(scratch);
+    ErrorFlag = solve_cell(force, all_vars, dmy, gp, lake_con, soil_con,
+                           veg_con, veg_lib, scratch);
+    scratch_release(scratch, scratch_top);
+
+    return (ErrorFlag);
+}
+
+/******************************************************************************
+* @brief        Solve the energy and water balance of one grid cell for one
+*               time step.
+******************************************************************************/
+int
+solve_cell(force_data_struct    *force,
+           all_vars_struct      *all_vars,
+           dmy_struct           *dmy,
+           global_param_struct  *gp,
+           lake_con_struct      *lake_con,
+           soil_con_struct      *soil_con,
+           veg_con_struct       *veg_con,
+           veg_lib_struct       *veg_lib,
+           scratch_arena_struct *scratch)
 {
     extern option_struct     options;
     extern parameters_struct param;
@@ -93,16 +124,14 @@ vic_run(force_data_struct   *force,
     energy_bal_struct       *energy;
     snow_data_struct        *snow;
 
-    out_prec = calloc(options.SNOW_BAND, sizeof(*out_prec));
-    check_alloc_status(out_prec, "Memory allocation error.");
-    out_rain = calloc(options.SNOW_BAND, sizeof(*out_rain));
-    check_alloc_status(out_rain, "Memory allocation error.");
-    out_snow = calloc(options.SNOW_BAND, sizeof(*out_snow));
-    check_alloc_status(out_snow, "Memory allocation error.");
-    Melt = calloc(options.SNOW_BAND, sizeof(*Melt));
-    check_alloc_status(Melt, "Memory allocation error.");
-    snow_inflow = calloc(options.SNOW_BAND, sizeof(*snow_inflow));
-    check_alloc_status(snow_inflow, "Memory allocation error.");
+    // work arrays of this cell and time step come from the scratch arena,
+    // which vic_run() releases in one go
+    out_prec = scratch_calloc(scratch, options.SNOW_BAND, sizeof(*out_prec));
+    out_rain = scratch_calloc(scratch, options.SNOW_BAND, sizeof(*out_rain));
+    out_snow = scratch_calloc(scratch, options.SNOW_BAND, sizeof(*out_snow));
+    Melt = scratch_calloc(scratch, options.SNOW_BAND, sizeof(*Melt));
+    snow_inflow = scratch_calloc(scratch, options.SNOW_BAND,
+                                 sizeof(*snow_inflow));
 
     // assign vic_run_veg_lib to veg_lib, so that the veg_lib for the correct
     // grid cell is used within vic_run. For simplicity sake, use vic_run_veg_lib
@@ -261,7 +290,8 @@ vic_run(force_data_struct   *force,
                     }
 
                     /* Soil thermal properties for the top two layers */
-                    prepare_full_energy(cell, energy, soil_con, &moist0, &ice0);
+                    prepare_full_energy(cell, energy, soil_con, &moist0, &ice0,
+                                        scratch);
 
                     /* Initialize final aerodynamic resistance values */
                     cell->aero_resist[0] = aero_resist[0];
@@ -334,7 +364,8 @@ vic_run(force_data_struct   *force,
                                                energy, gp, cell, snow,
                                                soil_con, veg_var, lag_one,
                                                sigma_slope, fetch,
-                                               veg_con[iveg].CanopLayerBnd);
+                                               veg_con[iveg].CanopLayerBnd,
+                                               scratch);
 
                     if (ErrorFlag == ERROR) {
                         return (ERROR);
@@ -472,17 +503,11 @@ vic_run(force_data_struct   *force,
 
         ErrorFlag = water_balance(lake_var, *lake_con, gp->dt, all_vars,
                                   iveg, band, lakefrac, *soil_con,
-                                  veg_con[iveg]);
+                                  veg_con[iveg], scratch);
         if (ErrorFlag == ERROR) {
             return (ERROR);
         }
     } // end if (options.LAKES && lake_con->lake_idx >= 0)
 
-    free((char *) (out_prec));
-    free((char *) (out_rain));
-    free((char *) (out_snow));
-    free((char *) (Melt));
-    free((char *) (snow_inflow));
-
     return (0);
 }